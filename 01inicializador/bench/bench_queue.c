@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "structures.h"
+#include "constants.h"
+// Las cabeceras de emisor y receptor comparten nombre: se incluyen por ruta
+#include "../../02emisor/include/queue_operations.h"
+#include "../../03receptor/include/queue_operations.h"
+
+/**
+ * Microbenchmarks de las colas
+ *
+ * Mide ns/op y fallos de caché por operación de las operaciones de cola
+ * que enlazan los trabajadores (02emisor/src/queue_operations.c y
+ * 03receptor/src/queue_operations.c, compilados aparte con sus propias
+ * cabeceras) sobre una SHM simulada en el heap (misma disposición:
+ * SharedMemory seguida de los arreglos de ambas colas, accedidos por offset).
+ *
+ *  - dequeue_encrypt, enqueue_decrypt: las del emisor (toma un slot libre,
+ *    publica el carácter).
+ *  - enqueue_encrypt, dequeue_decrypt_ordered: las del receptor (devuelve
+ *    el slot, extrae el menor text_index).
+ *
+ * Cada operación se mide en régimen estacionario con la cola en tamaño N:
+ *  - enqueue_*: N inserciones desde la cola vacía, luego reinicio O(1).
+ *  - dequeue_encrypt: N extracciones desde la cola llena.
+ *  - dequeue_decrypt_ordered: extrae el mínimo y reinserta el siguiente
+ *    text_index del patrón, de modo que la cola se mantiene en N.
+ *
+ * Los text_index siguen un patrón de desorden:
+ *  - sorted:   en orden (el mínimo siempre está en head)
+ *  - reversed: decrecientes (el mínimo siempre es el último encolado)
+ *  - window:   permutados dentro de ventanas de BENCH_WINDOW (emisores en carrera)
+ *  - random:   uniformes
+ *
+ * Los fallos de caché se leen con perf_event_open (sólo espacio de usuario);
+ * si el kernel no lo permite se reportan como n/d.
+ *
+ * Uso: ./bench_queue [--max N] [--op NOMBRE] [--pattern NOMBRE] [--csv]
+ */
+
+#define BENCH_DEFAULT_MAX   10000000L
+#define BENCH_FIFO_OPS      20000000L   // Operaciones FIFO por medición
+#define BENCH_SCAN_BUDGET   50000000L   // Elementos recorridos por medición ordenada
+#define BENCH_MIN_OPS       8L
+#define BENCH_WINDOW        64
+
+typedef enum { PAT_SORTED, PAT_REVERSED, PAT_WINDOW, PAT_RANDOM, PAT_COUNT } Pattern;
+static const char* PATTERN_NAMES[PAT_COUNT] = { "sorted", "reversed", "window", "random" };
+
+typedef enum {
+    OP_ENQ_ENCRYPT, OP_DEQ_ENCRYPT, OP_ENQ_DECRYPT, OP_DEQ_ORDERED, OP_COUNT
+} Operation;
+static const char* OP_NAMES[OP_COUNT] = {
+    "enqueue_encrypt", "dequeue_encrypt", "enqueue_decrypt", "dequeue_decrypt_ordered"
+};
+
+typedef struct {
+    int  fd_llc;     // PERF_COUNT_HW_CACHE_MISSES
+    int  fd_l1d;     // L1D read misses
+} PerfCounters;
+
+typedef struct {
+    double ns_op;
+    double llc_op;   // < 0 si no hay contador
+    double l1d_op;
+    long   ops;
+} Measurement;
+
+static volatile long g_sink;    // Evita que el compilador elimine los bucles
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/* text_index del i-ésimo carácter emitido según el patrón (siempre < INT_MAX) */
+static int pattern_text(Pattern p, long i) {
+    switch (p) {
+    case PAT_SORTED:   return (int)i;
+    case PAT_REVERSED: return INT_MAX / 2 - (int)i;
+    case PAT_WINDOW: {
+        long base = i - i % BENCH_WINDOW;
+        // 37 es impar y BENCH_WINDOW potencia de 2: biyección dentro de la ventana
+        return (int)(base + ((i % BENCH_WINDOW) * 37 + (i / BENCH_WINDOW) * 11) % BENCH_WINDOW);
+    }
+    case PAT_RANDOM:   return (int)(splitmix64((uint64_t)i) & 0x3fffffff);
+    default:           return 0;
+    }
+}
+
+/* ---------- Contadores de hardware ---------- */
+
+static int perf_open(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_init(PerfCounters* pc) {
+    pc->fd_llc = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    pc->fd_l1d = perf_open(PERF_TYPE_HW_CACHE,
+                           PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+}
+
+static void perf_start(const PerfCounters* pc) {
+    int fds[2] = { pc->fd_llc, pc->fd_l1d };
+    for (int i = 0; i < 2; i++) {
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static double perf_stop(int fd, long ops) {
+    if (fd < 0) return -1.0;
+    uint64_t v = 0;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &v, sizeof(v)) != (ssize_t)sizeof(v)) return -1.0;
+    return (double)v / (double)ops;
+}
+
+/* ---------- SHM simulada ---------- */
+
+static SharedMemory* arena_create(long capacity) {
+    size_t bytes = sizeof(SharedMemory) + 2 * (size_t)capacity * sizeof(SlotRef);
+    SharedMemory* shm = calloc(1, bytes);
+    if (!shm) return NULL;
+    shm->encrypt_queue.capacity = (int)capacity;
+    shm->encrypt_queue.array_offset = sizeof(SharedMemory);
+    shm->decrypt_queue.capacity = (int)capacity;
+    shm->decrypt_queue.array_offset = sizeof(SharedMemory) + (size_t)capacity * sizeof(SlotRef);
+    return shm;
+}
+
+static void queue_reset(Queue* q, int size) {
+    q->head = 0;
+    q->tail = 0;
+    q->size = size;
+}
+
+/* ---------- Mediciones ---------- */
+
+static long fifo_rounds(long n) {
+    long r = BENCH_FIFO_OPS / n;
+    return r < 1 ? 1 : r;
+}
+
+/**
+ * @brief Mide una operación FIFO en rondas de N operaciones
+ *
+ * Entre rondas la cola se reinicia en O(1) (head/tail/size), sin tocar
+ * el arreglo: los datos de la ronda anterior siguen siendo válidos.
+ */
+static Measurement measure_fifo(SharedMemory* shm, Operation op, Pattern pat, long n, const PerfCounters* pc) {
+    Measurement m = { 0 };
+    Queue* q = (op == OP_ENQ_ENCRYPT || op == OP_DEQ_ENCRYPT) ? &shm->encrypt_queue : &shm->decrypt_queue;
+    long rounds = fifo_rounds(n);
+    long acc = 0;
+
+    // Llenado inicial (también calienta las páginas del arreglo)
+    queue_reset(q, 0);
+    for (long i = 0; i < n; i++) {
+        if (q == &shm->encrypt_queue) enqueue_encrypt_slot(shm, (int)i);
+        else                          enqueue_decrypt_slot(shm, (int)i, pattern_text(pat, i));
+    }
+
+    perf_start(pc);
+    uint64_t t0 = mono_ns();
+    for (long r = 0; r < rounds; r++) {
+        switch (op) {
+        case OP_ENQ_ENCRYPT:
+            queue_reset(q, 0);
+            for (long i = 0; i < n; i++) acc += enqueue_encrypt_slot(shm, (int)i);
+            break;
+        case OP_DEQ_ENCRYPT:
+            queue_reset(q, (int)n);
+            for (long i = 0; i < n; i++) acc += dequeue_encrypt_slot(shm);
+            break;
+        case OP_ENQ_DECRYPT:
+            queue_reset(q, 0);
+            for (long i = 0; i < n; i++) acc += enqueue_decrypt_slot(shm, (int)i, pattern_text(pat, r * n + i));
+            break;
+        default:
+            break;
+        }
+    }
+    uint64_t t1 = mono_ns();
+    m.ops = rounds * n;
+    m.llc_op = perf_stop(pc->fd_llc, m.ops);
+    m.l1d_op = perf_stop(pc->fd_l1d, m.ops);
+    m.ns_op = (double)(t1 - t0) / (double)m.ops;
+    g_sink = acc;
+    return m;
+}
+
+/**
+ * @brief Mide dequeue_decrypt_slot_ordered con la cola estable en N
+ *
+ * Cada extracción va seguida de la inserción del siguiente text_index del
+ * patrón (incluida en la medición; es O(1) frente a la búsqueda O(N)).
+ */
+static Measurement measure_ordered(SharedMemory* shm, Pattern pat, long n, const PerfCounters* pc) {
+    Measurement m = { 0 };
+    long ops = BENCH_SCAN_BUDGET / n;
+    if (ops < BENCH_MIN_OPS) ops = BENCH_MIN_OPS;
+    if (ops > BENCH_FIFO_OPS) ops = BENCH_FIFO_OPS;
+    long acc = 0;
+
+    queue_reset(&shm->decrypt_queue, 0);
+    for (long i = 0; i < n; i++) enqueue_decrypt_slot(shm, (int)(i % n), pattern_text(pat, i));
+
+    long next = n;
+    perf_start(pc);
+    uint64_t t0 = mono_ns();
+    for (long i = 0; i < ops; i++) {
+        SlotInfo s = dequeue_decrypt_slot_ordered(shm);
+        acc += s.text_index;
+        enqueue_decrypt_slot(shm, s.slot_index, pattern_text(pat, next++));
+    }
+    uint64_t t1 = mono_ns();
+    m.ops = ops;
+    m.llc_op = perf_stop(pc->fd_llc, ops);
+    m.l1d_op = perf_stop(pc->fd_l1d, ops);
+    m.ns_op = (double)(t1 - t0) / (double)ops;
+    g_sink = acc;
+    return m;
+}
+
+/* ---------- Salida ---------- */
+
+static void print_counter(double v) {
+    if (v < 0.0) printf(" %12s", "n/d");
+    else         printf(" %12.3f", v);
+}
+
+static void print_row(int csv, Operation op, Pattern pat, int uses_pattern, long n, const Measurement* m) {
+    const char* pname = uses_pattern ? PATTERN_NAMES[pat] : "-";
+    if (csv) {
+        printf("%s,%s,%ld,%ld,%.3f,", OP_NAMES[op], pname, n, m->ops, m->ns_op);
+        if (m->llc_op >= 0.0) printf("%.4f", m->llc_op);
+        printf(",");
+        if (m->l1d_op >= 0.0) printf("%.4f", m->l1d_op);
+        printf("\n");
+        return;
+    }
+    printf("  %-24s %-9s %10ld %12.2f", OP_NAMES[op], pname, n, m->ns_op);
+    print_counter(m->llc_op);
+    print_counter(m->l1d_op);
+    printf("\n");
+}
+
+static int find_name(const char* s, const char* const* names, int count) {
+    for (int i = 0; i < count; i++) if (strcmp(s, names[i]) == 0) return i;
+    return -1;
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso: %s [--max N] [--op NOMBRE] [--pattern NOMBRE] [--csv]\n", argv0);
+    fprintf(stderr, "  Operaciones: ");
+    for (int i = 0; i < OP_COUNT; i++) fprintf(stderr, "%s ", OP_NAMES[i]);
+    fprintf(stderr, "\n  Patrones:    ");
+    for (int i = 0; i < PAT_COUNT; i++) fprintf(stderr, "%s ", PATTERN_NAMES[i]);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[]) {
+    long max_n = BENCH_DEFAULT_MAX;
+    int only_op = -1, only_pat = -1, csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) { csv = 1; continue; }
+        if (i + 1 >= argc) { print_usage(argv[0]); return 1; }
+        if (strcmp(argv[i], "--max") == 0) {
+            max_n = atol(argv[++i]);
+            if (max_n < 1 || max_n > MAX_BUFFER_SIZE) { print_usage(argv[0]); return 1; }
+        } else if (strcmp(argv[i], "--op") == 0) {
+            if ((only_op = find_name(argv[++i], OP_NAMES, OP_COUNT)) < 0) { print_usage(argv[0]); return 1; }
+        } else if (strcmp(argv[i], "--pattern") == 0) {
+            if ((only_pat = find_name(argv[++i], PATTERN_NAMES, PAT_COUNT)) < 0) { print_usage(argv[0]); return 1; }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    PerfCounters pc;
+    perf_init(&pc);
+
+    if (csv) {
+        printf("op,pattern,size,ops,ns_per_op,llc_misses_per_op,l1d_misses_per_op\n");
+    } else {
+        printf("\nMicrobenchmarks de colas (tamaños 1..%ld, ventana %d)\n", max_n, BENCH_WINDOW);
+        if (pc.fd_llc < 0 && pc.fd_l1d < 0)
+            printf(YELLOW "  ! perf_event_open no disponible: fallos de caché sin medir\n" RESET);
+        printf("\n  %-24s %-9s %10s %12s %12s %12s\n", "Operación", "Patrón", "Tamaño", "ns/op",
+               "LLC miss/op", "L1D miss/op");
+    }
+
+    for (int op = 0; op < OP_COUNT; op++) {
+        if (only_op >= 0 && op != only_op) continue;
+        // El patrón sólo afecta a las colas con text_index
+        int uses_pattern = (op == OP_ENQ_DECRYPT || op == OP_DEQ_ORDERED);
+        for (int pat = 0; pat < PAT_COUNT; pat++) {
+            if (!uses_pattern && pat > 0) break;
+            if (uses_pattern && only_pat >= 0 && pat != only_pat) continue;
+            for (long n = 1; n <= max_n; n *= 10) {
+                SharedMemory* shm = arena_create(n);
+                if (!shm) {
+                    fprintf(stderr, RED "[ERROR] Sin memoria para N=%ld\n" RESET, n);
+                    return 1;
+                }
+                Measurement m = (op == OP_DEQ_ORDERED)
+                    ? measure_ordered(shm, (Pattern)pat, n, &pc)
+                    : measure_fifo(shm, (Operation)op, (Pattern)pat, n, &pc);
+                print_row(csv, (Operation)op, (Pattern)pat, uses_pattern, n, &m);
+                fflush(stdout);
+                free(shm);
+            }
+        }
+        if (!csv) printf("\n");
+    }
+
+    if (pc.fd_llc >= 0) close(pc.fd_llc);
+    if (pc.fd_l1d >= 0) close(pc.fd_l1d);
+    return 0;
+}
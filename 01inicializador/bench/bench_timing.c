@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "structures.h"
+#include "timebase.h"
+
+/**
+ * Benchmark de Fuentes de Tiempo
+ *
+ * Compara el costo por llamada (ns/op) de las funciones de tiempo que
+ * usaba el bucle caliente (time(NULL), localtime + strftime) contra la
+ * base de tiempo compartida (TSC calibrado o CLOCK_MONOTONIC), y mide la
+ * resolución efectiva de cada reloj (menor incremento observado).
+ *
+ * Uso: ./bench_timing [iteraciones]
+ */
+
+#define DEFAULT_ITERS 5000000L
+
+static volatile uint64_t g_sink;    // Evita que el compilador elimine los bucles
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t op_time(void) { return (uint64_t)time(NULL); }
+
+static uint64_t op_localtime_strftime(void) {
+    char buf[32];
+    time_t t = time(NULL);
+    struct tm* tm = localtime(&t);
+    strftime(buf, sizeof(buf), "%H:%M:%S", tm);
+    return (uint64_t)buf[7];
+}
+
+static uint64_t op_clock(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+static uint64_t op_realtime(void)        { return op_clock(CLOCK_REALTIME); }
+static uint64_t op_monotonic(void)       { return op_clock(CLOCK_MONOTONIC); }
+static uint64_t op_monotonic_coarse(void){ return op_clock(CLOCK_MONOTONIC_COARSE); }
+static uint64_t op_timebase(void)        { return timebase_now_ns(); }
+
+static uint64_t op_timebase_hms(void) {
+    char buf[16];
+    timebase_format_hms(timebase_now_ns(), buf, sizeof(buf));
+    return (uint64_t)buf[7];
+}
+
+/* Menor incremento no nulo observado entre lecturas consecutivas */
+static uint64_t resolution_ns(uint64_t (*fn)(void), uint64_t scale) {
+    uint64_t best = UINT64_MAX;
+    uint64_t prev = fn();
+    for (int i = 0; i < 200000; i++) {
+        uint64_t cur = fn();
+        if (cur > prev && (cur - prev) * scale < best) best = (cur - prev) * scale;
+        prev = cur;
+    }
+    return best;
+}
+
+static void run(const char* name, uint64_t (*fn)(void), long iters, uint64_t scale) {
+    uint64_t acc = 0;
+    for (long i = 0; i < iters / 100; i++) acc += fn();   // Calentamiento
+
+    uint64_t t0 = mono_ns();
+    for (long i = 0; i < iters; i++) acc += fn();
+    uint64_t t1 = mono_ns();
+    g_sink = acc;
+
+    double ns_op = (double)(t1 - t0) / (double)iters;
+    if (scale) {
+        uint64_t res = resolution_ns(fn, scale);
+        if (res == UINT64_MAX) printf("  %-34s %10.2f ns/op   resolución: > ventana de medición\n", name, ns_op);
+        else                   printf("  %-34s %10.2f ns/op   resolución: %llu ns\n", name, ns_op,
+                                      (unsigned long long)res);
+    } else {
+        printf("  %-34s %10.2f ns/op\n", name, ns_op);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long iters = (argc > 1) ? atol(argv[1]) : DEFAULT_ITERS;
+    if (iters <= 0) iters = DEFAULT_ITERS;
+
+    TimeBase tb;
+    timebase_calibrate(&tb);
+
+    printf("Base de tiempo: %s", timebase_source_name(&tb));
+    if (tb.source == TIME_SOURCE_TSC) printf(" (%.3f GHz)", 1.0 / tb.ns_per_tick);
+    printf("\nIteraciones: %ld\n\n", iters);
+
+    printf("Llamadas anteriores (por carácter):\n");
+    run("time(NULL) [resolución 1 s]",  op_time,                iters, 0);
+    run("localtime + strftime",         op_localtime_strftime,  iters / 10, 0);
+
+    printf("\nRelojes del sistema:\n");
+    run("clock_gettime(REALTIME)",      op_realtime,            iters, 1);
+    run("clock_gettime(MONOTONIC)",     op_monotonic,           iters, 1);
+    run("clock_gettime(MONOTONIC_COARSE)", op_monotonic_coarse, iters, 1);
+
+    printf("\nBase de tiempo compartida:\n");
+    run("timebase_now_ns",              op_timebase,            iters, 1);
+    run("timebase_format_hms",          op_timebase_hms,        iters, 0);
+
+    return 0;
+}
@@ -35,6 +35,11 @@
 #define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
 #define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
 #define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+// Etapas intermedias: base + número de etapa (ver instance_sem_n)
+#define SEM_NAME_STAGE_QUEUE    "/sem_stage_queue"
+#define SEM_NAME_STAGE_ITEMS    "/sem_stage_items"
+// Difusión: base + número de grupo de receptores
+#define SEM_NAME_GROUP_ITEMS    "/sem_group_items"
 
 // Permisos para objetos IPC y archivos
 #define IPC_PERMS 0666
@@ -54,4 +59,10 @@
  */
 #define PAGE_SIZE 4096
 
+// Alineación de los resúmenes de integridad (los receptores los actualizan con atómicos)
+#define INTEGRITY_CACHE_LINE 64
+
+// Ventana de reordenamiento de la salida ordenada (--sink) por omisión
+#define SINK_DEFAULT_WINDOW (256 * 1024)
+
 #endif // CONSTANTS_H
@@ -0,0 +1,31 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stddef.h>
+#include "structures.h"
+
+/*
+ * Modo demonio (--daemon SOCKET): el inicializador conserva el segmento,
+ * los semáforos y las colas y recibe nuevos lotes de entrada por un
+ * socket Unix, mientras emisores y receptores siguen corriendo:
+ *  - daemon_parse_size: "64M", "512K", "1G" o bytes -> bytes.
+ *  - daemon_listen: crea el socket de control (antes de crear la SHM).
+ *  - daemon_run: espera el primer lote y atiende pedidos hasta SIGTERM
+ *    (lo envía el finalizador) o SIGINT; borra el socket al salir.
+ *  - daemon_submit: cliente (--submit) que envía un lote y espera el
+ *    resultado.
+ * Protocolo: una conexión por lote; el cliente envía una "ruta [CLAVE]"
+ * por línea (mismo formato que --jobs) y cierra su lado de escritura; el
+ * demonio responde una línea "OK lote=N ..." o "ERR motivo" cuando el lote
+ * terminó de escribirse y verificarse.
+ */
+#define DAEMON_DEFAULT_CAPACITY (16 * 1024 * 1024)
+#define DAEMON_DEFAULT_JOBS     1024
+#define DAEMON_IO_TIMEOUT_S     5
+
+int daemon_parse_size(const char* s, size_t* out);
+int daemon_listen(const char* socket_path);
+int daemon_run(SharedMemory* shm, int listen_fd, const char* socket_path, unsigned char default_key);
+int daemon_submit(const char* socket_path, int count, char* specs[]);
+
+#endif // DAEMON_H
@@ -0,0 +1,17 @@
+#ifndef INTEGRITY_H
+#define INTEGRITY_H
+
+#include "structures.h"
+
+/*
+ * Resúmenes de integridad de la entrada:
+ *  - compute_integrity_digests: CRC32C de cada bloque de INTEGRITY_CHUNK_SIZE
+ *    (en paralelo, un hilo por CPU) y raíz Merkle en shm->integrity_root.
+ *    Debe llamarse después de copiar el archivo a la SHM. Con etapas
+ *    intermedias el CRC esperado es el de la entrada transformada, y cada
+ *    etapa checksum recibe los suyos y su raíz en Stage.digest_root. Con
+ *    difusión se copian a los resúmenes de cada grupo.
+ */
+int compute_integrity_digests(SharedMemory* shm, int* threads_used);
+
+#endif // INTEGRITY_H
@@ -0,0 +1,43 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "structures.h"
+
+/*
+ * Tabla de trabajos (varios archivos en un mismo segmento):
+ *  - JobSpec: archivo y clave pedidos por línea de comandos.
+ *  - job_spec_parse: interpreta "ruta[:CLAVE]" (CLAVE = 2 hex).
+ *  - job_list_load / job_list_read: agrega los trabajos de un archivo de
+ *    lista o de un flujo (una "ruta [CLAVE]" por línea, '#' comenta).
+ *  - load_job_inputs: lee todos los archivos, arma la tabla Job (start,
+ *    length, key) y retorna la entrada concatenada.
+ *  - plan_job_inputs / read_job_inputs: lo mismo en dos pasos (tabla a
+ *    partir de los tamaños, luego lectura directa en un buffer); los usa
+ *    el demonio para cargar cada lote en file_data sin copia intermedia.
+ *  - publish_jobs: copia la tabla a la región jobs_offset de la SHM.
+ */
+typedef struct {
+    char          path[JOB_NAME_MAX];
+    unsigned char key;
+} JobSpec;
+
+typedef struct {
+    JobSpec* items;
+    int      count;
+    int      capacity;
+} JobSpecList;
+
+int  job_spec_parse(const char* spec, unsigned char default_key, JobSpec* out);
+int  job_spec_append(JobSpecList* list, const JobSpec* spec);
+int  job_list_load(const char* list_path, unsigned char default_key, JobSpecList* list);
+int  job_list_read(FILE* f, const char* name, unsigned char default_key, JobSpecList* list);
+void job_spec_list_free(JobSpecList* list);
+
+unsigned char* load_job_inputs(const JobSpecList* list, Job* jobs, size_t* total_size);
+int  plan_job_inputs(const JobSpecList* list, Job* jobs, size_t* total_size);
+int  read_job_inputs(const Job* jobs, int count, unsigned char* dst);
+void publish_jobs(SharedMemory* shm, const Job* jobs, int count);
+
+#endif // JOBS_H
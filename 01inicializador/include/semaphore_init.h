@@ -16,6 +16,14 @@
  *       * DECRYPT_ITEMS: 0
  *   - No realiza unlink; otros procesos deben poder abrirlos.
  *
+ * initialize_stage_semaphores(stage_count) / cleanup_stage_semaphores(stage_count)
+ *   - Crean (QUEUE = 1, ITEMS = 0) o eliminan los semáforos de cada etapa
+ *     intermedia.
+ *
+ * initialize_group_semaphores(group_count) / cleanup_group_semaphores(group_count)
+ *   - Crean (ITEMS = 0) o eliminan el semáforo de items de cada grupo de
+ *     receptores de la difusión.
+ *
  * cleanup_semaphores()
  *   - Elimina los semáforos nombrados (sem_unlink) si existen.
  *   - Está pensado para el finalizador, no para el inicializador.
@@ -29,6 +37,10 @@
  */
 
 int initialize_semaphores(int buffer_size);
+int initialize_stage_semaphores(int stage_count);
+void cleanup_stage_semaphores(int stage_count);
+int initialize_group_semaphores(int group_count);
+void cleanup_group_semaphores(int group_count);
 int cleanup_semaphores(void);
 void print_semaphore_values(void);
 void wake_all_blocked_processes(int buffer_size);
@@ -0,0 +1,35 @@
+#ifndef SETUP_H
+#define SETUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "structures.h"
+
+/* Opciones del modo demonio, de la fuente en streaming, de la salida ordenada, de las etapas y de la difusión */
+typedef struct {
+    const char* socket_path;    // NULL = corrida única
+    size_t      capacity;       // 0 = DAEMON_DEFAULT_CAPACITY / STREAM_DEFAULT_CAPACITY
+    int         stream;         // --stream: el archivo posicional es un flujo ("-" = stdin)
+    size_t      sink_window;    // --sink: ventana de reordenamiento (0 = salida a archivos)
+    const char* stages_path;    // --stages: etapas intermedias (NULL = sin etapas)
+    int         groups;         // --groups: grupos de receptores de la difusión (0 = sin difusión)
+    int         listen_fd;      // Socket del demonio ya escuchando (-1 = corrida única)
+} DaemonOptions;
+
+/*
+ * Creación del segmento (también la enlazan 07puente y 09lanzador):
+ *  - setup_print_usage: uso del inicializador.
+ *  - setup_pipeline: valida ARCHIVO BUFFER CLAVE [opciones], crea e
+ *    inicializa la SHM y los semáforos de la instancia y devuelve el
+ *    segmento adjunto. NULL en error (el socket del demonio, si llegó a
+ *    crearse, ya se borró).
+ *  - setup_from_jobs: crea el segmento sin leer archivos, con la tabla de
+ *    trabajos y los CRC32C por bloque que manda el origen de 07puente.
+ *    file_data queda en cero. NULL en error.
+ */
+void          setup_print_usage(const char* argv0);
+SharedMemory* setup_pipeline(int argc, char* argv[], DaemonOptions* daemon);
+SharedMemory* setup_from_jobs(int buffer_size, unsigned char encryption_key, const Job* jobs, int job_count,
+                              const uint32_t* chunk_crcs, int chunk_count);
+
+#endif // SETUP_H
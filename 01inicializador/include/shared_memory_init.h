@@ -6,13 +6,18 @@
 
 /*
  * Creación y gestión de la memoria compartida:
- *  - create_shared_memory: reserva el segmento con todas las regiones necesarias.
+ *  - create_shared_memory: reserva el segmento con todas las regiones necesarias
+ *    (incluidas las colas de las etapas intermedias y las marcas de la
+ *    difusión, si las hay).
  *  - attach_shared_memory / detach_shared_memory: adjunta/desadjunta el segmento.
  *  - cleanup_shared_memory: elimina el segmento (solo debe usarlo el finalizador).
  *  - initialize_buffer_slots / copy_file_to_shared_memory: inicialización de datos.
- *  - get_buffer_pointer / get_file_data_pointer: accesos convenientes por offset.
+ *  - get_file_data_pointer / get_integrity_pointer / get_jobs_pointer:
+ *    accesos convenientes por offset.
+ *  - integrity_chunk_count: bloques de INTEGRITY_CHUNK_SIZE para file_size bytes.
  */
-SharedMemory* create_shared_memory(int buffer_size, int file_size);
+SharedMemory* create_shared_memory(int buffer_size, int file_size, int data_span, int job_count,
+                                   int sink_window, const Stage* stages, int stage_count, int group_count);
 SharedMemory* attach_shared_memory(key_t key);
 int  detach_shared_memory(SharedMemory* shm);
 int  cleanup_shared_memory(SharedMemory* shm);
@@ -20,7 +25,9 @@ int  cleanup_shared_memory(SharedMemory* shm);
 void initialize_buffer_slots(SharedMemory* shm, int buffer_size);
 void copy_file_to_shared_memory(SharedMemory* shm, unsigned char* file_data, int file_size);
 
-CharacterSlot*   get_buffer_pointer(SharedMemory* shm);
 unsigned char*   get_file_data_pointer(SharedMemory* shm);
+ChunkDigest*     get_integrity_pointer(SharedMemory* shm);
+Job*             get_jobs_pointer(SharedMemory* shm);
+size_t           integrity_chunk_count(int file_size);
 
 #endif // SHARED_MEMORY_INIT_H
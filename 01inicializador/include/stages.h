@@ -0,0 +1,19 @@
+#ifndef STAGES_H
+#define STAGES_H
+
+#include "structures.h"
+
+/*
+ * Etapas intermedias (--stages ARCHIVO):
+ *  - stage_list_load: lee una etapa por línea, "op [PARAM]" ('#' comenta):
+ *      xor CLAVE      cifra con CLAVE (2 hex)
+ *      upper / lower  mayúsculas / minúsculas ASCII
+ *      filter [BYTE]  reemplaza los no imprimibles por BYTE (2 hex, '?')
+ *      checksum       CRC32C por bloque de lo que pasa por la etapa
+ *    Deja op y param en stages[0..count); el resto de cada Stage en cero.
+ * compute_integrity_digests aplica las etapas a cada bloque para calcular
+ * lo que esperan las etapas checksum y los receptores.
+ */
+int stage_list_load(const char* path, Stage* stages, int* count);
+
+#endif // STAGES_H
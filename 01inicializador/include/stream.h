@@ -0,0 +1,27 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <limits.h>
+#include "structures.h"
+#include "jobs.h"
+
+/*
+ * Fuente en streaming (--stream): la entrada es la entrada estándar ("-"),
+ * una tubería o un FIFO y no se conoce su tamaño. file_data es un anillo
+ * de file_capacity bytes que el inicializador llena mientras los emisores
+ * lo consumen:
+ *  - stream_prepare_job: trabajo único de la fuente ("-" -> "stdin", la
+ *    salida es <RECEPTOR_OUT_DIR>/stdin.txt).
+ *  - stream_run: abre la fuente y la copia al anillo hasta el fin de la
+ *    entrada, SIGINT o SIGTERM (lo envía el finalizador); al terminar
+ *    publica el total definitivo y la raíz Merkle.
+ * Los índices de texto son int: un flujo se corta en STREAM_MAX_BYTES.
+ */
+#define STREAM_DEFAULT_CAPACITY (1024 * 1024)
+#define STREAM_READ_MAX         (64 * 1024)
+#define STREAM_MAX_BYTES        ((INT_MAX / INTEGRITY_CHUNK_SIZE) * INTEGRITY_CHUNK_SIZE)
+
+void stream_prepare_job(const JobSpec* spec, Job* job);
+int  stream_run(SharedMemory* shm, const char* source);
+
+#endif // STREAM_H
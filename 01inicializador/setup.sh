@@ -13,6 +13,13 @@ WHITE='\033[0;37m'
 RESET='\033[0m'
 BOLD='\033[1m'
 
+# Instancia: "./setup.sh --instance NOMBRE" o IPC_INSTANCE. Los programas
+# y los make lanzados desde el menú la heredan por el entorno.
+if [ "$1" = "--instance" ] && [ -n "$2" ]; then
+    export IPC_INSTANCE="$2"
+fi
+INSTANCE="${IPC_INSTANCE:-}"
+
 # Banner del programa
 show_banner() {
     clear
@@ -20,6 +27,7 @@ show_banner() {
     echo -e "${BOLD}${CYAN}║         SETUP - SISTEMA DE COMUNICACIÓN IPC                ║${RESET}"
     echo -e "${BOLD}${CYAN}║              Inicializador de Memoria Compartida           ║${RESET}"
     echo -e "${BOLD}${CYAN}╚════════════════════════════════════════════════════════════╝${RESET}"
+    [ -n "$INSTANCE" ] && echo -e "${CYAN}Instancia: ${INSTANCE}${RESET}"
     echo ""
 }
 
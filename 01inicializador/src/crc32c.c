@@ -0,0 +1,146 @@
+#include <string.h>
+#include <pthread.h>
+#include "crc32c.h"
+
+/**
+ * Módulo CRC32C
+ *
+ * Camino rápido: instrucción crc32 de SSE4.2 (8 bytes por instrucción),
+ * elegida en tiempo de ejecución con __builtin_cpu_supports. Si no está,
+ * se usa una tabla de 256 entradas.
+ *
+ * Aritmética en GF(2) para el modo incremental (como crc32_combine de zlib):
+ * desplazar un CRC crudo n bytes equivale a multiplicarlo por x^(8n) mod P.
+ * Así un receptor puede sumar (XOR) la contribución de cada byte que escribe
+ * sin conocer los demás bytes del bloque ni el orden de llegada.
+ */
+
+#define CRC32C_POLY 0x82F63B78u
+#define CRC32C_X0   0x80000000u   // x^0 en representación reflejada
+
+static uint32_t g_table[256];
+static uint32_t g_x2n[32];        // x^(2^k) mod P
+static int      g_hw = 0;
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+
+uint32_t crc32c_multiply(uint32_t a, uint32_t b) {
+    uint32_t m = CRC32C_X0, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+static void crc32c_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        g_table[i] = c;
+    }
+    g_x2n[0] = CRC32C_X0 >> 1;    // x^1
+    for (int k = 1; k < 32; k++) g_x2n[k] = crc32c_multiply(g_x2n[k - 1], g_x2n[k - 1]);
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    g_hw = __builtin_cpu_supports("sse4.2") != 0;
+#endif
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_raw_hw(uint32_t crc, const unsigned char* p, size_t len) {
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c = __builtin_ia32_crc32di(c, v);
+        p += 8;
+        len -= 8;
+    }
+    uint32_t c32 = (uint32_t)c;
+    while (len--) c32 = __builtin_ia32_crc32qi(c32, *p++);
+    return c32;
+}
+#endif
+
+static uint32_t crc32c_raw_sw(uint32_t crc, const unsigned char* p, size_t len) {
+    while (len--) crc = (crc >> 8) ^ g_table[(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+/**
+ * @brief CRC32C estándar de data, continuando desde crc (0 para empezar)
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t len) {
+    pthread_once(&g_once, crc32c_init);
+    const unsigned char* p = (const unsigned char*)data;
+#if defined(__x86_64__)
+    if (g_hw) return ~crc32c_raw_hw(~crc, p, len);
+#endif
+    return ~crc32c_raw_sw(~crc, p, len);
+}
+
+int crc32c_hw_available(void) {
+    pthread_once(&g_once, crc32c_init);
+    return g_hw;
+}
+
+/**
+ * @brief CRC crudo de un único byte (contribución en la última posición)
+ */
+uint32_t crc32c_byte_raw(unsigned char b) {
+    pthread_once(&g_once, crc32c_init);
+    return g_table[b];
+}
+
+/**
+ * @brief x^(8n) mod P: factor que desplaza un CRC crudo n bytes de ceros
+ */
+uint32_t crc32c_x8n(uint64_t nbytes) {
+    pthread_once(&g_once, crc32c_init);
+    uint32_t p = CRC32C_X0;
+    int k = 3;                    // 8n = n * 2^3
+    while (nbytes) {
+        if (nbytes & 1) p = crc32c_multiply(g_x2n[k & 31], p);
+        nbytes >>= 1;
+        k++;
+    }
+    return p;
+}
+
+/**
+ * @brief Convierte el CRC crudo de len bytes al CRC32C estándar
+ *
+ * El CRC estándar usa valor inicial ~0 y XOR final ~0; por linealidad
+ * crc32c(M) = raw(M) ^ ~(~0 · x^(8·len)).
+ */
+uint32_t crc32c_from_raw(uint32_t raw, uint64_t len) {
+    return raw ^ ~crc32c_multiply(crc32c_x8n(len), 0xFFFFFFFFu);
+}
+
+/**
+ * @brief Raíz Merkle: cada nodo es el CRC32C de sus dos hijos concatenados
+ *
+ * Un nodo sin hermano sube sin cambios. Se calcula en el mismo arreglo.
+ *
+ * @param level Hojas (se sobrescriben)
+ * @param n Cantidad de hojas
+ * @return Raíz (0 si n == 0)
+ */
+uint32_t crc32c_merkle_root(uint32_t* level, size_t n) {
+    if (n == 0) return 0;
+    while (n > 1) {
+        size_t m = 0;
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            uint32_t pair[2] = { level[i], level[i + 1] };
+            level[m++] = crc32c(0, pair, sizeof pair);
+        }
+        if (n & 1) level[m++] = level[n - 1];
+        n = m;
+    }
+    return level[0];
+}
@@ -0,0 +1,413 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "daemon.h"
+#include "jobs.h"
+#include "integrity.h"
+#include "crc32c.h"
+#include "shared_memory_init.h"
+#include "constants.h"
+#include "instance.h"
+
+/**
+ * Módulo Demonio
+ *
+ * Reutiliza el segmento para varios lotes de entrada. Cuando un lote
+ * termina (batch_done), todos los slots volvieron a estar libres y las
+ * colas quedaron en su estado inicial, así que publicar el siguiente no
+ * requiere tocarlas: se reinician los contadores, se lee la entrada
+ * directamente en file_data y se recalculan los CRC32C.
+ *
+ * Orden de publicación (ver batch_current en structures.h):
+ *   1. batch_seq pasa a impar (lote nuevo en curso).
+ *   2. total_chars_in_file = 0 y current_txt_index = 0 bajo el mutex
+ *      global: ningún emisor puede tomar índices mientras se reemplaza
+ *      la entrada.
+ *   3. Tabla de trabajos, file_data y resúmenes de integridad.
+ *   4. total_chars_in_file = nuevo tamaño (release).
+ *   5. batch_seq pasa a par y FUTEX_WAKE: los emisores que esperaban con
+ *      la entrada agotada vuelven a tomar índices.
+ * Los receptores ven el cambio de lote en el primer carácter nuevo y
+ * reabren sus salidas; el que escribe el último carácter publica
+ * batch_done y despierta al demonio.
+ */
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_stop(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static double elapsed_ms(const struct timespec* a, const struct timespec* b) {
+    return (double)(b->tv_sec - a->tv_sec) * 1e3 + (double)(b->tv_nsec - a->tv_nsec) / 1e6;
+}
+
+int daemon_parse_size(const char* s, size_t* out) {
+    char* end = NULL;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (errno || end == s || *s == '-') return ERROR;
+    switch (toupper((unsigned char)*end)) {
+        case 'G': v <<= 10; /* fall through */
+        case 'M': v <<= 10; /* fall through */
+        case 'K': v <<= 10; end++; break;
+        case '\0': break;
+        default: return ERROR;
+    }
+    if (*end != '\0' || v == 0 || v > (unsigned long long)INT_MAX) return ERROR;
+    *out = (size_t)v;
+    return SUCCESS;
+}
+
+static int fill_address(struct sockaddr_un* addr, const char* socket_path) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr->sun_path)) {
+        fprintf(stderr, RED "[ERROR] Ruta de socket demasiado larga: '%s'\n" RESET, socket_path);
+        return ERROR;
+    }
+    strcpy(addr->sun_path, socket_path);
+    return SUCCESS;
+}
+
+/**
+ * @brief Crea el socket de control
+ *
+ * Un archivo de socket que no acepta conexiones quedó de un demonio
+ * anterior y se reemplaza; si acepta, hay otro demonio escuchando.
+ *
+ * @return Descriptor en escucha o -1
+ */
+int daemon_listen(const char* socket_path) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, socket_path) != SUCCESS) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        fprintf(stderr, RED "[ERROR] socket: %s\n" RESET, strerror(errno));
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        fprintf(stderr, RED "[ERROR] Ya hay un demonio escuchando en %s\n" RESET, socket_path);
+        close(fd);
+        return -1;
+    }
+    if (errno == ECONNREFUSED) unlink(socket_path);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, 16) == -1) {
+        fprintf(stderr, RED "[ERROR] No se pudo escuchar en %s: %s\n" RESET, socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void futex_wake_all(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/* Espera a que los receptores completen el lote; ERROR si se pidió salir */
+static int wait_batch_done(SharedMemory* shm, uint32_t batch) {
+    for (;;) {
+        uint32_t done = __atomic_load_n(&shm->batch_done, __ATOMIC_ACQUIRE);
+        if (done == batch) return SUCCESS;
+        if (g_stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return ERROR;
+        syscall(SYS_futex, &shm->batch_done, FUTEX_WAIT, done, NULL, NULL, 0);
+    }
+}
+
+/* Bloques cuyo CRC32C escrito no coincide con el esperado */
+static int count_bad_chunks(SharedMemory* shm) {
+    const ChunkDigest* d = get_integrity_pointer(shm);
+    int bad = 0;
+    for (int c = 0; c < shm->integrity_chunks; c++) {
+        uint32_t len = (uint32_t)MIN(INTEGRITY_CHUNK_SIZE, shm->file_data_size - c * INTEGRITY_CHUNK_SIZE);
+        uint32_t written = __atomic_load_n(&d[c].written_bytes, __ATOMIC_ACQUIRE);
+        if (written != len || crc32c_from_raw(d[c].written_crc, len) != d[c].expected_crc) bad++;
+    }
+    return bad;
+}
+
+/**
+ * @brief Reemplaza la entrada del segmento por un lote nuevo
+ *
+ * @param jobs Tabla ya armada por plan_job_inputs
+ * @return Número del lote publicado, 0 si la lectura falló (el lote queda
+ *         vacío y ya completo, para que nadie espere caracteres)
+ */
+static uint32_t publish_batch(SharedMemory* shm, sem_t* mutex, const Job* jobs, int count, int total) {
+    uint32_t seq = __atomic_load_n(&shm->batch_seq, __ATOMIC_RELAXED) + 1;
+    uint32_t batch = (seq + 1) / 2;
+    __atomic_store_n(&shm->batch_seq, seq, __ATOMIC_RELEASE);
+
+    while (sem_wait(mutex) == -1 && errno == EINTR) {}
+    __atomic_store_n(&shm->total_chars_in_file, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->current_txt_index, 0, __ATOMIC_RELEASE);
+    sem_post(mutex);
+
+    shm->total_chars_processed = 0;
+    shm->chars_enqueued = 0;
+    shm->batch_written = 0;
+
+    int ok = read_job_inputs(jobs, count, get_file_data_pointer(shm)) == SUCCESS;
+    if (ok) {
+        publish_jobs(shm, jobs, count);
+        strncpy(shm->input_filename, jobs[0].input_filename, sizeof(shm->input_filename) - 1);
+        shm->input_filename[sizeof(shm->input_filename) - 1] = '\0';
+        shm->encryption_key = jobs[0].key;
+        shm->file_data_size = total;
+        shm->integrity_chunks = (int)integrity_chunk_count(total);
+        memset(get_integrity_pointer(shm), 0, (size_t)shm->integrity_chunks * sizeof(ChunkDigest));
+        ok = compute_integrity_digests(shm, NULL) == SUCCESS;
+    }
+    if (!ok) {
+        shm->job_count = 0;
+        shm->file_data_size = 0;
+        shm->integrity_chunks = 0;
+        total = 0;
+    }
+
+    __atomic_store_n(&shm->total_chars_in_file, total, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->batch_seq, seq + 1, __ATOMIC_RELEASE);
+    futex_wake_all(&shm->batch_seq);
+    if (!ok) {
+        __atomic_store_n(&shm->batch_done, batch, __ATOMIC_RELEASE);
+        return 0;
+    }
+    return batch;
+}
+
+static void reply(int fd, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void reply(int fd, const char* fmt, ...) {
+    char line[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= sizeof(line)) n = (int)sizeof(line) - 1;
+    if (write(fd, line, (size_t)n) < 0) {
+        // El cliente se fue: el lote igual quedó procesado
+    }
+}
+
+/* Espera el lote, lo verifica y lo informa por consola y al cliente (fd >= 0) */
+static void finish_batch(SharedMemory* shm, uint32_t batch, const struct timespec* t0, int fd) {
+    if (wait_batch_done(shm, batch) != SUCCESS) {
+        printf(YELLOW "[DEMONIO] Lote %u interrumpido: el sistema está finalizando\n" RESET, batch);
+        if (fd >= 0) reply(fd, "ERR lote %u interrumpido: el sistema está finalizando\n", batch);
+        return;
+    }
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = elapsed_ms(t0, &t1);
+    int bad = count_bad_chunks(shm);
+    if (bad == 0) {
+        printf(GREEN "[DEMONIO] Lote %u: %d trabajo(s), %d bytes en %.3f ms, raíz %08x\n" RESET,
+               batch, shm->job_count, shm->file_data_size, ms, shm->integrity_root);
+        if (fd >= 0) {
+            reply(fd, "OK lote=%u trabajos=%d bytes=%d ms=%.3f raiz=%08x\n",
+                  batch, shm->job_count, shm->file_data_size, ms, shm->integrity_root);
+        }
+    } else {
+        printf(RED "[DEMONIO] Lote %u: %d bloque(s) con CRC32C distinto\n" RESET, batch, bad);
+        if (fd >= 0) reply(fd, "ERR lote=%u bloques_con_error=%d\n", batch, bad);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Atiende una conexión: lee el lote, lo publica y responde
+ */
+static void serve_request(SharedMemory* shm, sem_t* mutex, int fd, Job* jobs, unsigned char default_key) {
+    struct timeval tv = { DAEMON_IO_TIMEOUT_S, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    int in = dup(fd);
+    FILE* f = in == -1 ? NULL : fdopen(in, "r");
+    if (!f) {
+        if (in != -1) close(in);
+        reply(fd, "ERR sin recursos para leer el pedido\n");
+        return;
+    }
+    JobSpecList list = { NULL, 0, 0 };
+    int rc = job_list_read(f, "pedido", default_key, &list);
+    int timed_out = ferror(f);
+    fclose(f);
+
+    size_t total = 0;
+    if (rc != SUCCESS || timed_out) {
+        reply(fd, "ERR pedido inválido o incompleto\n");
+    } else if (list.count == 0) {
+        reply(fd, "ERR el pedido no tiene trabajos\n");
+    } else if (list.count > shm->job_capacity) {
+        reply(fd, "ERR %d trabajos superan la capacidad de %d\n", list.count, shm->job_capacity);
+    } else if (plan_job_inputs(&list, jobs, &total) != SUCCESS) {
+        reply(fd, "ERR no se pudo leer la entrada (ver la consola del inicializador)\n");
+    } else if (total > (size_t)shm->file_capacity) {
+        reply(fd, "ERR %zu bytes superan la capacidad de %d\n", total, shm->file_capacity);
+    } else {
+        struct timespec t0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        uint32_t batch = publish_batch(shm, mutex, jobs, list.count, (int)total);
+        if (batch == 0) {
+            reply(fd, "ERR no se pudo leer la entrada (ver la consola del inicializador)\n");
+        } else {
+            printf(CYAN "[DEMONIO] Lote %u publicado: %d trabajo(s), %zu bytes\n" RESET, batch, list.count, total);
+            finish_batch(shm, batch, &t0, fd);
+        }
+    }
+    job_spec_list_free(&list);
+}
+
+/**
+ * @brief Bucle del demonio
+ *
+ * @param shm Segmento ya inicializado con el primer lote
+ * @param listen_fd Socket de daemon_listen
+ * @param default_key Clave de los trabajos que no indican una
+ * @return SUCCESS o ERROR
+ */
+int daemon_run(SharedMemory* shm, int listen_fd, const char* socket_path, unsigned char default_key) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_stop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sem_t* mutex = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    Job* jobs = malloc((size_t)shm->job_capacity * sizeof(Job));
+    if (mutex == SEM_FAILED || !jobs) {
+        fprintf(stderr, RED "[ERROR] No se pudo preparar el demonio\n" RESET);
+        if (mutex != SEM_FAILED) sem_close(mutex);
+        free(jobs);
+        close(listen_fd);
+        unlink(socket_path);
+        return ERROR;
+    }
+
+    printf(CYAN "\n[DEMONIO] Escuchando en %s (capacidad: %d bytes, %d trabajos por lote)\n" RESET,
+           socket_path, shm->file_capacity, shm->job_capacity);
+    fflush(stdout);
+
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    finish_batch(shm, batch_current(shm), &t0, -1);
+
+    while (!g_stop && !__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            fprintf(stderr, RED "[ERROR] accept: %s\n" RESET, strerror(errno));
+            break;
+        }
+        serve_request(shm, mutex, fd, jobs, default_key);
+        close(fd);
+    }
+
+    printf(MAGENTA "\n[DEMONIO] Terminando: %u lote(s) completos\n" RESET,
+           __atomic_load_n(&shm->batch_done, __ATOMIC_ACQUIRE));
+    close(listen_fd);
+    unlink(socket_path);
+    sem_close(mutex);
+    free(jobs);
+    return SUCCESS;
+}
+
+/* "ruta:CLAVE" -> ruta absoluta y clave (si la trae) */
+static int submit_line(const char* spec, char* line, size_t line_sz) {
+    JobSpec js;
+    if (job_spec_parse(spec, 0, &js) != SUCCESS) return ERROR;
+    size_t plen = strlen(js.path);
+    int has_key = strlen(spec) == plen + 3;
+
+    char abs[PATH_MAX];
+    if (!realpath(js.path, abs)) {
+        fprintf(stderr, RED "[ERROR] '%s': %s\n" RESET, js.path, strerror(errno));
+        return ERROR;
+    }
+    int n = has_key ? snprintf(line, line_sz, "%s %02X\n", abs, js.key)
+                    : snprintf(line, line_sz, "%s\n", abs);
+    return (n > 0 && (size_t)n < line_sz) ? SUCCESS : ERROR;
+}
+
+static int write_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return ERROR;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Envía un lote al demonio y muestra su respuesta
+ *
+ * Las rutas se envían absolutas: el demonio las abre desde su propio
+ * directorio de trabajo.
+ *
+ * @param count Cantidad de especificaciones "ARCHIVO[:CLAVE]"
+ * @return SUCCESS si el demonio respondió OK
+ */
+int daemon_submit(const char* socket_path, int count, char* specs[]) {
+    struct sockaddr_un addr;
+    if (fill_address(&addr, socket_path) != SUCCESS) return ERROR;
+    if (count < 1) {
+        fprintf(stderr, RED "[ERROR] Indique al menos un archivo\n" RESET);
+        return ERROR;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+        fprintf(stderr, RED "[ERROR] No se pudo conectar a %s: %s\n" RESET, socket_path, strerror(errno));
+        if (fd != -1) close(fd);
+        return ERROR;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    char line[PATH_MAX + 8];
+    for (int i = 0; i < count; i++) {
+        if (submit_line(specs[i], line, sizeof(line)) != SUCCESS || write_all(fd, line, strlen(line)) != SUCCESS) {
+            close(fd);
+            return ERROR;
+        }
+    }
+    shutdown(fd, SHUT_WR);
+
+    char resp[256];
+    size_t got = 0;
+    for (;;) {
+        ssize_t n = read(fd, resp + got, sizeof(resp) - 1 - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += (size_t)n;
+        if (got == sizeof(resp) - 1) break;
+    }
+    close(fd);
+    resp[got] = '\0';
+    if (got == 0) {
+        fprintf(stderr, RED "[ERROR] El demonio cerró la conexión sin responder\n" RESET);
+        return ERROR;
+    }
+    fputs(resp, stdout);
+    return strncmp(resp, "OK", 2) == 0 ? SUCCESS : ERROR;
+}
@@ -18,17 +18,16 @@
  */
 
 /**
- * @brief Procesa el archivo de entrada
+ * @brief Lee un archivo de entrada completo en memoria
  * 
- * Lee el archivo completo en memoria, realiza validaciones de tamaño
- * y contenido, imprime estadísticas básicas y retorna el buffer con
- * los datos leídos.
+ * Realiza las validaciones de tamaño (vacío, MAX_FILE_SIZE) sin imprimir
+ * estadísticas, para poder cargar muchos trabajos sin ruido.
  * 
- * @param filename Nombre del archivo a procesar
+ * @param filename Nombre del archivo a leer
  * @param file_size Puntero donde se almacenará el tamaño del archivo
- * @return Puntero al buffer con los datos, NULL si hay error
+ * @return Puntero al buffer con los datos (liberar con free), NULL si hay error
  */
-unsigned char* process_input_file(const char* filename, size_t* file_size) {
+unsigned char* read_input_file(const char* filename, size_t* file_size) {
     FILE* input_file = fopen(filename, "r");
     if (input_file == NULL) {
         fprintf(stderr, RED "[ERROR] No se pudo abrir el archivo '%s': %s\n" RESET,
@@ -73,11 +72,27 @@ unsigned char* process_input_file(const char* filename, size_t* file_size) {
     }
     fclose(input_file);
 
-    print_file_statistics(data, size);
     *file_size = size;
     return data;
 }
 
+/**
+ * @brief Procesa el archivo de entrada
+ * 
+ * Lee el archivo completo en memoria, realiza validaciones de tamaño
+ * y contenido, imprime estadísticas básicas y retorna el buffer con
+ * los datos leídos.
+ * 
+ * @param filename Nombre del archivo a procesar
+ * @param file_size Puntero donde se almacenará el tamaño del archivo
+ * @return Puntero al buffer con los datos, NULL si hay error
+ */
+unsigned char* process_input_file(const char* filename, size_t* file_size) {
+    unsigned char* data = read_input_file(filename, file_size);
+    if (data) print_file_statistics(data, *file_size);
+    return data;
+}
+
 /**
  * @brief Analiza y muestra estadísticas del contenido del archivo
  * 
@@ -106,23 +121,6 @@ void print_file_statistics(const unsigned char* data, size_t size) {
     printf("    - Otros caracteres: %zu\n", others);
 }
 
-/**
- * @brief Lee un carácter específico de la memoria compartida
- * 
- * Accede a la memoria compartida y retorna el carácter ubicado
- * en la posición solicitada, realizando validaciones de límites.
- * 
- * @param shm Puntero a la estructura de memoria compartida
- * @param position Posición del carácter a leer
- * @return El carácter en la posición indicada, '\0' si la posición es inválida
- */
-char read_char_at_position(SharedMemory* shm, int position) {
-    if (position < 0) return '\0';
-    if ((size_t)position >= (size_t)shm->file_data_size) return '\0';
-    unsigned char* file_data = (unsigned char*)((char*)shm + shm->file_data_offset);
-    return (char)file_data[position];
-}
-
 /**
  * @brief Verifica la integridad de los datos en memoria compartida
  * 
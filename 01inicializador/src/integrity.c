@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "integrity.h"
+#include "crc32c.h"
+#include "shared_memory_init.h"
+#include "constants.h"
+
+/**
+ * Módulo de Integridad (inicializador)
+ *
+ * Calcula el CRC32C esperado de cada bloque de la entrada ya copiada a la
+ * SHM. Los bloques son independientes, así que se reparten en rangos
+ * contiguos entre hilos; con la instrucción crc32 el costo queda dominado
+ * por el ancho de banda de memoria.
+ *
+ * Los receptores acumulan después el CRC de lo que escriben (ver
+ * 03receptor/src/integrity.c) y el finalizador compara ambos.
+ *
+ * Con etapas intermedias los receptores escriben la entrada ya
+ * transformada: cada bloque se copia, se le aplican las etapas en orden y
+ * el CRC esperado es el del resultado. Cada etapa checksum recibe además
+ * el CRC de lo que le llega (sus propios resúmenes y raíz Merkle).
+ *
+ * Con difusión cada grupo de receptores escribe la entrada completa: los
+ * grupos 1..N-1 reciben una copia de los CRC esperados en sus resúmenes
+ * (la raíz es la misma para todos).
+ */
+
+#define INTEGRITY_MAX_THREADS 64
+
+typedef struct {
+    SharedMemory* shm;
+    const unsigned char* data;
+    int          file_size;
+    ChunkDigest* digests;
+    size_t       first;
+    size_t       last;        // Exclusivo
+    int          failed;
+} DigestJob;
+
+/* CRC esperado de un bloque que atraviesa las etapas intermedias */
+static uint32_t staged_crc(SharedMemory* shm, unsigned char* buf, size_t c, size_t len) {
+    for (int k = 0; k < shm->stage_count; k++) {
+        Stage* st = &shm->stages[k];
+        if (st->op == STAGE_OP_CHECKSUM) {
+            ChunkDigest* d = (ChunkDigest*)((char*)shm + st->digest_offset);
+            d[c].expected_crc = crc32c(0, buf, len);
+            continue;
+        }
+        for (size_t i = 0; i < len; i++) buf[i] = stage_apply(st->op, st->param, buf[i]);
+    }
+    return crc32c(0, buf, len);
+}
+
+static void* digest_worker(void* arg) {
+    DigestJob* job = (DigestJob*)arg;
+    unsigned char* buf = NULL;
+    if (job->shm->stage_count > 0 && !(buf = malloc(INTEGRITY_CHUNK_SIZE))) {
+        job->failed = 1;
+        return NULL;
+    }
+    for (size_t c = job->first; c < job->last; c++) {
+        size_t off = c * INTEGRITY_CHUNK_SIZE;
+        size_t len = MIN((size_t)INTEGRITY_CHUNK_SIZE, (size_t)job->file_size - off);
+        if (buf) {
+            memcpy(buf, job->data + off, len);
+            job->digests[c].expected_crc = staged_crc(job->shm, buf, c, len);
+        } else {
+            job->digests[c].expected_crc = crc32c(0, job->data + off, len);
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+static uint32_t merkle_of(const ChunkDigest* digests, uint32_t* level, size_t n) {
+    for (size_t c = 0; c < n; c++) level[c] = digests[c].expected_crc;
+    return crc32c_merkle_root(level, n);
+}
+
+/**
+ * @brief Calcula los CRC32C por bloque y la raíz Merkle de la entrada
+ *
+ * @param shm Memoria compartida con file_data e integrity_offset configurados
+ * @param threads_used Hilos utilizados (puede ser NULL)
+ * @return SUCCESS o ERROR
+ */
+int compute_integrity_digests(SharedMemory* shm, int* threads_used) {
+    size_t n = (size_t)shm->integrity_chunks;
+    ChunkDigest* digests = get_integrity_pointer(shm);
+    const unsigned char* data = get_file_data_pointer(shm);
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = ncpu > 0 ? (size_t)ncpu : 1;
+    if (threads > INTEGRITY_MAX_THREADS) threads = INTEGRITY_MAX_THREADS;
+    if (threads > n) threads = n ? n : 1;
+
+    DigestJob jobs[INTEGRITY_MAX_THREADS];
+    pthread_t tids[INTEGRITY_MAX_THREADS];
+    size_t started = 1;
+    for (size_t t = 0; t < threads; t++) {
+        jobs[t] = (DigestJob){ shm, data, shm->file_data_size, digests, t * n / threads, (t + 1) * n / threads, 0 };
+    }
+    // El hilo principal toma el primer rango
+    for (size_t t = 1; t < threads; t++, started++) {
+        if (pthread_create(&tids[t], NULL, digest_worker, &jobs[t]) != 0) break;
+    }
+    digest_worker(&jobs[0]);
+    for (size_t t = 1; t < started; t++) pthread_join(tids[t], NULL);
+    for (size_t t = started; t < threads; t++) digest_worker(&jobs[t]);
+
+    for (size_t t = 0; t < threads; t++) {
+        if (jobs[t].failed) return ERROR;
+    }
+
+    uint32_t* level = malloc((n ? n : 1) * sizeof(uint32_t));
+    if (!level) return ERROR;
+    shm->integrity_root = merkle_of(digests, level, n);
+    for (int g = 1; g < shm->group_count; g++) {
+        ChunkDigest* gd = (ChunkDigest*)((char*)shm + shm->groups[g].digest_offset);
+        for (size_t c = 0; c < n; c++) gd[c].expected_crc = digests[c].expected_crc;
+    }
+    for (int k = 0; k < shm->stage_count; k++) {
+        Stage* st = &shm->stages[k];
+        if (st->digest_offset) {
+            st->digest_root = merkle_of((ChunkDigest*)((char*)shm + st->digest_offset), level, n);
+        }
+    }
+    free(level);
+
+    if (threads_used) *threads_used = (int)threads;
+    return SUCCESS;
+}
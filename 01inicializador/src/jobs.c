@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "jobs.h"
+#include "file_processor.h"
+#include "shared_memory_init.h"
+#include "constants.h"
+
+/**
+ * Módulo de Trabajos
+ *
+ * Permite cargar varios archivos de entrada en un mismo segmento: cada
+ * trabajo ocupa un tramo contiguo de file_data y del espacio de
+ * text_index, con su propia clave. Emisores y receptores siguen tomando
+ * índices de un único contador, así que el costo de crear la SHM, los
+ * semáforos y las colas se paga una sola vez para todos los archivos.
+ */
+
+static int is_hex_key(const char* s) {
+    return isxdigit((unsigned char)s[0]) && isxdigit((unsigned char)s[1]) && s[2] == '\0';
+}
+
+/**
+ * @brief Interpreta "ruta[:CLAVE]"
+ *
+ * @param spec Texto del argumento
+ * @param default_key Clave si spec no la indica
+ * @param out Trabajo resultante
+ * @return SUCCESS o ERROR (ruta vacía o demasiado larga)
+ */
+int job_spec_parse(const char* spec, unsigned char default_key, JobSpec* out) {
+    size_t len = strlen(spec);
+    const char* colon = strrchr(spec, ':');
+    out->key = default_key;
+    if (colon && is_hex_key(colon + 1)) {
+        unsigned int k = 0;
+        (void)sscanf(colon + 1, "%2x", &k);
+        out->key = (unsigned char)k;
+        len = (size_t)(colon - spec);
+    }
+    if (len == 0 || len >= sizeof(out->path)) {
+        fprintf(stderr, RED "[ERROR] Trabajo inválido: '%s'\n" RESET, spec);
+        return ERROR;
+    }
+    memcpy(out->path, spec, len);
+    out->path[len] = '\0';
+    return SUCCESS;
+}
+
+int job_spec_append(JobSpecList* list, const JobSpec* spec) {
+    if (list->count >= MAX_JOBS) {
+        fprintf(stderr, RED "[ERROR] Demasiados trabajos (máximo %d)\n" RESET, MAX_JOBS);
+        return ERROR;
+    }
+    if (list->count == list->capacity) {
+        int cap = list->capacity ? list->capacity * 2 : 16;
+        JobSpec* items = realloc(list->items, (size_t)cap * sizeof(JobSpec));
+        if (!items) {
+            fprintf(stderr, RED "[ERROR] Sin memoria para la lista de trabajos\n" RESET);
+            return ERROR;
+        }
+        list->items = items;
+        list->capacity = cap;
+    }
+    list->items[list->count++] = *spec;
+    return SUCCESS;
+}
+
+/**
+ * @brief Agrega los trabajos de un archivo de lista
+ *
+ * @return SUCCESS o ERROR
+ */
+int job_list_load(const char* list_path, unsigned char default_key, JobSpecList* list) {
+    FILE* f = fopen(list_path, "r");
+    if (!f) {
+        perror(list_path);
+        return ERROR;
+    }
+    int rc = job_list_read(f, list_path, default_key, list);
+    fclose(f);
+    return rc;
+}
+
+/**
+ * @brief Agrega los trabajos leídos de un flujo hasta EOF
+ *
+ * Cada línea es "ruta [CLAVE]"; las líneas vacías y las que empiezan con
+ * '#' se ignoran. Lo usan --jobs y el canal de control del demonio.
+ *
+ * @param f Flujo abierto para lectura (no se cierra)
+ * @param name Nombre para los mensajes de error
+ * @return SUCCESS o ERROR
+ */
+int job_list_read(FILE* f, const char* name, unsigned char default_key, JobSpecList* list) {
+    char line[JOB_NAME_MAX + 16];
+    int lineno = 0;
+    int rc = SUCCESS;
+    while (rc == SUCCESS && fgets(line, sizeof(line), f)) {
+        lineno++;
+        size_t len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        while (len > 0 && isspace((unsigned char)line[len - 1])) line[--len] = '\0';
+        char* start = line;
+        while (isspace((unsigned char)*start)) start++;
+        if (*start == '\0' || *start == '#') continue;
+
+        JobSpec spec;
+        spec.key = default_key;
+        char* sep = strrchr(start, ' ');
+        if (!sep) sep = strrchr(start, '\t');
+        if (sep && is_hex_key(sep + 1)) {
+            unsigned int k = 0;
+            (void)sscanf(sep + 1, "%2x", &k);
+            spec.key = (unsigned char)k;
+            while (sep > start && isspace((unsigned char)sep[-1])) sep--;
+            *sep = '\0';
+        }
+        if (strlen(start) >= sizeof(spec.path)) {
+            fprintf(stderr, RED "[ERROR] %s:%d: ruta demasiado larga\n" RESET, name, lineno);
+            rc = ERROR;
+            break;
+        }
+        strcpy(spec.path, start);
+        rc = job_spec_append(list, &spec);
+    }
+    return rc;
+}
+
+void job_spec_list_free(JobSpecList* list) {
+    free(list->items);
+    list->items = NULL;
+    list->count = list->capacity = 0;
+}
+
+static const char* path_base(const char* path) {
+    const char* p = strrchr(path, '/');
+    return p ? p + 1 : path;
+}
+
+static int cmp_base(const void* a, const void* b) {
+    return strcmp(path_base(*(const char* const*)a), path_base(*(const char* const*)b));
+}
+
+/* Los receptores escriben en <dir>/<basename>.txt: dos trabajos con el
+ * mismo nombre base pisarían el mismo archivo de salida */
+static int check_unique_outputs(const JobSpecList* list) {
+    const char** names = malloc((size_t)list->count * sizeof(char*));
+    if (!names) return ERROR;
+    for (int i = 0; i < list->count; i++) names[i] = list->items[i].path;
+    qsort(names, (size_t)list->count, sizeof(char*), cmp_base);
+
+    int rc = SUCCESS;
+    for (int i = 1; i < list->count && rc == SUCCESS; i++) {
+        if (strcmp(path_base(names[i - 1]), path_base(names[i])) == 0) {
+            fprintf(stderr, RED "[ERROR] '%s' y '%s' tendrían el mismo archivo de salida\n" RESET,
+                    names[i - 1], names[i]);
+            rc = ERROR;
+        }
+    }
+    free(names);
+    return rc;
+}
+
+/**
+ * @brief Lee todos los trabajos y arma la tabla
+ *
+ * @param list Trabajos pedidos (al menos uno)
+ * @param jobs Tabla de salida (list->count entradas)
+ * @param total_size Suma de los tamaños
+ * @return Entrada concatenada en orden (liberar con free), NULL si hay error
+ */
+unsigned char* load_job_inputs(const JobSpecList* list, Job* jobs, size_t* total_size) {
+    if (check_unique_outputs(list) != SUCCESS) return NULL;
+
+    unsigned char* all = NULL;
+    size_t total = 0, cap = 0;
+    for (int i = 0; i < list->count; i++) {
+        size_t size = 0;
+        unsigned char* data = read_input_file(list->items[i].path, &size);
+        if (!data) {
+            free(all);
+            return NULL;
+        }
+        if (size > (size_t)INT_MAX - total) {
+            fprintf(stderr, RED "[ERROR] Los trabajos superan %d bytes en total\n" RESET, INT_MAX);
+            free(data);
+            free(all);
+            return NULL;
+        }
+        if (total + size > cap) {
+            size_t ncap = cap ? cap : size;
+            while (ncap < total + size) ncap *= 2;
+            unsigned char* grown = realloc(all, ncap);
+            if (!grown) {
+                fprintf(stderr, RED "[ERROR] Sin memoria para los trabajos\n" RESET);
+                free(data);
+                free(all);
+                return NULL;
+            }
+            all = grown;
+            cap = ncap;
+        }
+        memcpy(all + total, data, size);
+        free(data);
+
+        memset(&jobs[i], 0, sizeof(jobs[i]));
+        jobs[i].start  = (int)total;
+        jobs[i].length = (int)size;
+        jobs[i].key    = list->items[i].key;
+        memcpy(jobs[i].input_filename, list->items[i].path, sizeof(jobs[i].input_filename));
+        total += size;
+    }
+
+    *total_size = total;
+    return all;
+}
+
+/**
+ * @brief Arma la tabla de trabajos a partir del tamaño de cada archivo
+ *
+ * No lee el contenido: el demonio valida el lote completo (salidas
+ * únicas, archivos no vacíos, capacidad) antes de tocar la SHM y después
+ * lo lee directamente en file_data con read_job_inputs.
+ *
+ * @param list Trabajos pedidos (al menos uno)
+ * @param jobs Tabla de salida (list->count entradas)
+ * @param total_size Suma de los tamaños
+ * @return SUCCESS o ERROR
+ */
+int plan_job_inputs(const JobSpecList* list, Job* jobs, size_t* total_size) {
+    if (check_unique_outputs(list) != SUCCESS) return ERROR;
+
+    size_t total = 0;
+    for (int i = 0; i < list->count; i++) {
+        struct stat st;
+        if (stat(list->items[i].path, &st) == -1 || !S_ISREG(st.st_mode)) {
+            fprintf(stderr, RED "[ERROR] No se pudo abrir el archivo '%s'\n" RESET, list->items[i].path);
+            return ERROR;
+        }
+        size_t size = (size_t)st.st_size;
+        if (size == 0 || size > (size_t)MAX_FILE_SIZE || size > (size_t)INT_MAX - total) {
+            fprintf(stderr, RED "[ERROR] Tamaño inválido para '%s': %zu bytes\n" RESET, list->items[i].path, size);
+            return ERROR;
+        }
+        memset(&jobs[i], 0, sizeof(jobs[i]));
+        jobs[i].start  = (int)total;
+        jobs[i].length = (int)size;
+        jobs[i].key    = list->items[i].key;
+        memcpy(jobs[i].input_filename, list->items[i].path, sizeof(jobs[i].input_filename));
+        total += size;
+    }
+    *total_size = total;
+    return SUCCESS;
+}
+
+/**
+ * @brief Lee cada trabajo en su tramo [start, start + length) de dst
+ *
+ * @return SUCCESS o ERROR (si un archivo cambió de tamaño desde plan_job_inputs)
+ */
+int read_job_inputs(const Job* jobs, int count, unsigned char* dst) {
+    for (int i = 0; i < count; i++) {
+        int fd = open(jobs[i].input_filename, O_RDONLY);
+        if (fd == -1) {
+            fprintf(stderr, RED "[ERROR] No se pudo abrir el archivo '%s': %s\n" RESET,
+                    jobs[i].input_filename, strerror(errno));
+            return ERROR;
+        }
+        size_t done = 0, want = (size_t)jobs[i].length;
+        while (done < want) {
+            ssize_t n = read(fd, dst + jobs[i].start + done, want - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+        close(fd);
+        if (done != want) {
+            fprintf(stderr, RED "[ERROR] Lectura incompleta de '%s': %zu de %zu bytes\n" RESET,
+                    jobs[i].input_filename, done, want);
+            return ERROR;
+        }
+    }
+    return SUCCESS;
+}
+
+void publish_jobs(SharedMemory* shm, const Job* jobs, int count) {
+    memcpy(get_jobs_pointer(shm), jobs, (size_t)count * sizeof(Job));
+    shm->job_count = count;
+}
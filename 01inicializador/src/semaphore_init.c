@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include "semaphore_init.h"
 #include "constants.h"
+#include "instance.h"
 
 /**
  * Módulo de Inicialización de Semáforos
@@ -73,23 +74,23 @@ int initialize_semaphores(int buffer_size) {
 
     printf("  • Creando semáforos POSIX nombrados:\n");
 
-    if (create_named_semaphore(SEM_NAME_GLOBAL_MUTEX,   1, &g)  != SUCCESS) return ERROR;
-    if (create_named_semaphore(SEM_NAME_ENCRYPT_QUEUE,  1, &eq) != SUCCESS) { close_handle(g); return ERROR; }
-    if (create_named_semaphore(SEM_NAME_DECRYPT_QUEUE,  1, &dq) != SUCCESS) { close_handle(g); close_handle(eq); return ERROR; }
-    if (create_named_semaphore(SEM_NAME_ENCRYPT_SPACES, (unsigned int)buffer_size, &es) != SUCCESS) {
+    if (create_named_semaphore(instance_sem(SEM_NAME_GLOBAL_MUTEX),   1, &g)  != SUCCESS) return ERROR;
+    if (create_named_semaphore(instance_sem(SEM_NAME_ENCRYPT_QUEUE),  1, &eq) != SUCCESS) { close_handle(g); return ERROR; }
+    if (create_named_semaphore(instance_sem(SEM_NAME_DECRYPT_QUEUE),  1, &dq) != SUCCESS) { close_handle(g); close_handle(eq); return ERROR; }
+    if (create_named_semaphore(instance_sem(SEM_NAME_ENCRYPT_SPACES), (unsigned int)buffer_size, &es) != SUCCESS) {
         close_handle(g); close_handle(eq); close_handle(dq); return ERROR;
     }
-    if (create_named_semaphore(SEM_NAME_DECRYPT_ITEMS,  0, &di) != SUCCESS) {
+    if (create_named_semaphore(instance_sem(SEM_NAME_DECRYPT_ITEMS),  0, &di) != SUCCESS) {
         close_handle(g); close_handle(eq); close_handle(dq); close_handle(es);
         return ERROR;
     }
 
     // Imprimir nombres creados
-    printf("    - %s\n", SEM_NAME_GLOBAL_MUTEX);
-    printf("    - %s\n", SEM_NAME_ENCRYPT_QUEUE);
-    printf("    - %s\n", SEM_NAME_DECRYPT_QUEUE);
-    printf("    - %s (valor inicial: %d)\n", SEM_NAME_ENCRYPT_SPACES, buffer_size);
-    printf("    - %s (valor inicial: 0)\n",   SEM_NAME_DECRYPT_ITEMS);
+    printf("    - %s\n", instance_sem(SEM_NAME_GLOBAL_MUTEX));
+    printf("    - %s\n", instance_sem(SEM_NAME_ENCRYPT_QUEUE));
+    printf("    - %s\n", instance_sem(SEM_NAME_DECRYPT_QUEUE));
+    printf("    - %s (valor inicial: %d)\n", instance_sem(SEM_NAME_ENCRYPT_SPACES), buffer_size);
+    printf("    - %s (valor inicial: 0)\n",   instance_sem(SEM_NAME_DECRYPT_ITEMS));
 
     // Mostrar valores de arranque
     print_semaphore_values();
@@ -99,6 +100,66 @@ int initialize_semaphores(int buffer_size) {
     return SUCCESS;
 }
 
+/**
+ * @brief Crea los dos semáforos de cada etapa intermedia
+ *
+ * SEM_NAME_STAGE_QUEUE protege la cola de la etapa (valor 1) y
+ * SEM_NAME_STAGE_ITEMS cuenta los slots que esperan en ella (valor 0).
+ *
+ * @param stage_count Cantidad de etapas
+ * @return SUCCESS o ERROR (los ya creados se eliminan)
+ */
+int initialize_stage_semaphores(int stage_count) {
+    for (int k = 0; k < stage_count; k++) {
+        sem_t *q = NULL, *it = NULL;
+        if (create_named_semaphore(instance_sem_n(SEM_NAME_STAGE_QUEUE, k), 1, &q) != SUCCESS ||
+            create_named_semaphore(instance_sem_n(SEM_NAME_STAGE_ITEMS, k), 0, &it) != SUCCESS) {
+            close_handle(q);
+            cleanup_stage_semaphores(k + 1);
+            return ERROR;
+        }
+        printf("    - %s, %s\n", instance_sem_n(SEM_NAME_STAGE_QUEUE, k),
+               instance_sem_n(SEM_NAME_STAGE_ITEMS, k));
+        close_handle(q);
+        close_handle(it);
+    }
+    return SUCCESS;
+}
+
+void cleanup_stage_semaphores(int stage_count) {
+    for (int k = 0; k < stage_count; k++) {
+        sem_unlink(instance_sem_n(SEM_NAME_STAGE_QUEUE, k));
+        sem_unlink(instance_sem_n(SEM_NAME_STAGE_ITEMS, k));
+    }
+}
+
+/**
+ * @brief Crea el semáforo de items de cada grupo de la difusión
+ *
+ * SEM_NAME_GROUP_ITEMS cuenta las publicaciones que el grupo todavía no
+ * reclamó (valor 0); la cola de desencriptación sigue protegida por
+ * DECRYPT_QUEUE.
+ *
+ * @param group_count Cantidad de grupos
+ * @return SUCCESS o ERROR (los ya creados se eliminan)
+ */
+int initialize_group_semaphores(int group_count) {
+    for (int g = 0; g < group_count; g++) {
+        sem_t* it = NULL;
+        if (create_named_semaphore(instance_sem_n(SEM_NAME_GROUP_ITEMS, g), 0, &it) != SUCCESS) {
+            cleanup_group_semaphores(g);
+            return ERROR;
+        }
+        printf("    - %s\n", instance_sem_n(SEM_NAME_GROUP_ITEMS, g));
+        close_handle(it);
+    }
+    return SUCCESS;
+}
+
+void cleanup_group_semaphores(int group_count) {
+    for (int g = 0; g < group_count; g++) sem_unlink(instance_sem_n(SEM_NAME_GROUP_ITEMS, g));
+}
+
 /**
  * @brief Elimina todos los semáforos del sistema
  * 
@@ -110,11 +171,11 @@ int initialize_semaphores(int buffer_size) {
  */
 int cleanup_semaphores(void) {
     int ok = SUCCESS;
-    if (sem_unlink(SEM_NAME_GLOBAL_MUTEX)   == -1 && errno != ENOENT) ok = ERROR;
-    if (sem_unlink(SEM_NAME_ENCRYPT_QUEUE)  == -1 && errno != ENOENT) ok = ERROR;
-    if (sem_unlink(SEM_NAME_DECRYPT_QUEUE)  == -1 && errno != ENOENT) ok = ERROR;
-    if (sem_unlink(SEM_NAME_ENCRYPT_SPACES) == -1 && errno != ENOENT) ok = ERROR;
-    if (sem_unlink(SEM_NAME_DECRYPT_ITEMS)  == -1 && errno != ENOENT) ok = ERROR;
+    if (sem_unlink(instance_sem(SEM_NAME_GLOBAL_MUTEX))   == -1 && errno != ENOENT) ok = ERROR;
+    if (sem_unlink(instance_sem(SEM_NAME_ENCRYPT_QUEUE))  == -1 && errno != ENOENT) ok = ERROR;
+    if (sem_unlink(instance_sem(SEM_NAME_DECRYPT_QUEUE))  == -1 && errno != ENOENT) ok = ERROR;
+    if (sem_unlink(instance_sem(SEM_NAME_ENCRYPT_SPACES)) == -1 && errno != ENOENT) ok = ERROR;
+    if (sem_unlink(instance_sem(SEM_NAME_DECRYPT_ITEMS))  == -1 && errno != ENOENT) ok = ERROR;
 
     if (ok == SUCCESS) {
         printf(GREEN "  ✓ Semáforos POSIX eliminados correctamente\n" RESET);
@@ -159,30 +220,30 @@ void print_semaphore_values(void) {
 
     printf("\n  • Valores actuales de semáforos POSIX:\n");
 
-    if (get_value_of(SEM_NAME_GLOBAL_MUTEX, &v) == SUCCESS)
-        printf("    %s: %d (mutex global)\n", SEM_NAME_GLOBAL_MUTEX, v);
+    if (get_value_of(instance_sem(SEM_NAME_GLOBAL_MUTEX), &v) == SUCCESS)
+        printf("    %s: %d (mutex global)\n", instance_sem(SEM_NAME_GLOBAL_MUTEX), v);
     else
-        printf("    %s: <no disponible>\n", SEM_NAME_GLOBAL_MUTEX);
+        printf("    %s: <no disponible>\n", instance_sem(SEM_NAME_GLOBAL_MUTEX));
 
-    if (get_value_of(SEM_NAME_ENCRYPT_QUEUE, &v) == SUCCESS)
-        printf("    %s: %d (mutex cola encriptación)\n", SEM_NAME_ENCRYPT_QUEUE, v);
+    if (get_value_of(instance_sem(SEM_NAME_ENCRYPT_QUEUE), &v) == SUCCESS)
+        printf("    %s: %d (mutex cola encriptación)\n", instance_sem(SEM_NAME_ENCRYPT_QUEUE), v);
     else
-        printf("    %s: <no disponible>\n", SEM_NAME_ENCRYPT_QUEUE);
+        printf("    %s: <no disponible>\n", instance_sem(SEM_NAME_ENCRYPT_QUEUE));
 
-    if (get_value_of(SEM_NAME_DECRYPT_QUEUE, &v) == SUCCESS)
-        printf("    %s: %d (mutex cola desencriptación)\n", SEM_NAME_DECRYPT_QUEUE, v);
+    if (get_value_of(instance_sem(SEM_NAME_DECRYPT_QUEUE), &v) == SUCCESS)
+        printf("    %s: %d (mutex cola desencriptación)\n", instance_sem(SEM_NAME_DECRYPT_QUEUE), v);
     else
-        printf("    %s: <no disponible>\n", SEM_NAME_DECRYPT_QUEUE);
+        printf("    %s: <no disponible>\n", instance_sem(SEM_NAME_DECRYPT_QUEUE));
 
-    if (get_value_of(SEM_NAME_ENCRYPT_SPACES, &v) == SUCCESS)
-        printf("    %s: %d (espacios disponibles)\n", SEM_NAME_ENCRYPT_SPACES, v);
+    if (get_value_of(instance_sem(SEM_NAME_ENCRYPT_SPACES), &v) == SUCCESS)
+        printf("    %s: %d (espacios disponibles)\n", instance_sem(SEM_NAME_ENCRYPT_SPACES), v);
     else
-        printf("    %s: <no disponible>\n", SEM_NAME_ENCRYPT_SPACES);
+        printf("    %s: <no disponible>\n", instance_sem(SEM_NAME_ENCRYPT_SPACES));
 
-    if (get_value_of(SEM_NAME_DECRYPT_ITEMS, &v) == SUCCESS)
-        printf("    %s: %d (items para leer)\n", SEM_NAME_DECRYPT_ITEMS, v);
+    if (get_value_of(instance_sem(SEM_NAME_DECRYPT_ITEMS), &v) == SUCCESS)
+        printf("    %s: %d (items para leer)\n", instance_sem(SEM_NAME_DECRYPT_ITEMS), v);
     else
-        printf("    %s: <no disponible>\n", SEM_NAME_DECRYPT_ITEMS);
+        printf("    %s: <no disponible>\n", instance_sem(SEM_NAME_DECRYPT_ITEMS));
 
     printf("\n");
 }
@@ -198,8 +259,8 @@ void print_semaphore_values(void) {
  * @param buffer_size Tamaño del buffer circular
  */
 void wake_all_blocked_processes(int buffer_size) {
-    sem_t *es = sem_open(SEM_NAME_ENCRYPT_SPACES, 0);
-    sem_t *di = sem_open(SEM_NAME_DECRYPT_ITEMS, 0);
+    sem_t *es = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    sem_t *di = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
 
     if (es != SEM_FAILED) {
         for (int i = 0; i < buffer_size; i++) sem_post(es);
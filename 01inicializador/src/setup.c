@@ -0,0 +1,571 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+#include "constants.h"
+#include "structures.h"
+#include "shared_memory_init.h"
+#include "queue_manager.h"
+#include "file_processor.h"
+#include "semaphore_init.h"
+#include "timebase.h"
+#include "integrity.h"
+#include "crc32c.h"
+#include "jobs.h"
+#include "instance.h"
+#include "daemon.h"
+#include "stream.h"
+#include "stages.h"
+#include "setup.h"
+
+/**
+ * Creación del Segmento
+ *
+ * Lo que el inicializador hace antes de quedar como demonio o alimentador:
+ * valida los argumentos, lee la entrada, crea y llena la SHM (buffer,
+ * datos, resúmenes CRC32C, colas y carriles) y crea los semáforos POSIX.
+ * 09lanzador la enlaza para crear el segmento en su propio proceso y
+ * 07puente para crear el del destino con la entrada que describe el origen.
+ */
+
+/*
+ * Parseo de clave hex.
+ */
+static unsigned char parse_encryption_key(const char* key_str) {
+    unsigned char key = 0;
+    (void)sscanf(key_str, "%2hhx", &key);
+    return key;
+}
+
+void setup_print_usage(const char* argv0) {
+    fprintf(stderr, "Uso: %s <archivo_entrada> <tamaño_buffer> <clave_encriptación> [--lanes N]\n", argv0);
+    fprintf(stderr, "       [--job ARCHIVO[:CLAVE]]... [--jobs LISTA] [--instance NOMBRE]\n");
+    fprintf(stderr, "       [--daemon SOCKET [--capacity BYTES]] [--stream [--capacity BYTES]]\n");
+    fprintf(stderr, "       [--sink [--sink-window BYTES]] [--stages ARCHIVO] [--groups N]\n");
+    fprintf(stderr, "       %s --submit SOCKET ARCHIVO[:CLAVE]...\n", argv0);
+    fprintf(stderr, "Ejemplo: %s assets/data.txt 500 AA\n", argv0);
+    fprintf(stderr, "Ejemplo: %s a.txt 500 AA --job b.txt:5C --job c.txt\n", argv0);
+    fprintf(stderr, "Ejemplo: %s a.txt 500 AA --daemon /tmp/ipc.sock --capacity 64M\n", argv0);
+    fprintf(stderr, "Ejemplo: generador | %s - 500 AA --stream --capacity 256K\n", argv0);
+    fprintf(stderr, "Ejemplo: %s a.txt 500 AA --sink   (y: receptor --sink - auto | consumidor)\n", argv0);
+    fprintf(stderr, "Ejemplo: %s a.txt 500 AA --stages etapas.txt   (y: etapa 0 & etapa 1 & ...)\n", argv0);
+    fprintf(stderr, "Ejemplo: %s a.txt 500 AA --groups 2   (y: receptor --group 0 auto & receptor --group 1 auto)\n", argv0);
+}
+
+/*
+ * Validación de argumentos. El archivo posicional es el primer trabajo;
+ * --job y --jobs agregan más (con la clave posicional por omisión).
+ */
+static int validate_arguments(int argc, char* argv[], int* lanes_out, JobSpecList* jobs, DaemonOptions* daemon) {
+    if (argc < 4) {
+        fprintf(stderr, RED "[ERROR] Número incorrecto de argumentos\n" RESET);
+        setup_print_usage(argv[0]);
+        return ERROR;
+    }
+
+    if (strcmp(argv[1], "-") != 0 && access(argv[1], F_OK) == -1) {
+        fprintf(stderr, RED "[ERROR] El archivo '%s' no existe\n" RESET, argv[1]);
+        return ERROR;
+    }
+
+    long bs = strtol(argv[2], NULL, 10);
+    if (bs < MIN_BUFFER_SIZE || bs > INT_MAX) {
+        fprintf(stderr, RED "[ERROR] Tamaño de buffer inválido (>= %d requerido)\n" RESET, MIN_BUFFER_SIZE);
+        return ERROR;
+    }
+
+    if (strlen(argv[3]) != 2) {
+        fprintf(stderr, RED "[ERROR] La clave debe ser hexadecimal de 2 caracteres (ej: AA)\n" RESET);
+        return ERROR;
+    }
+    unsigned char key = parse_encryption_key(argv[3]);
+
+    JobSpec first;
+    if (strlen(argv[1]) >= sizeof(first.path)) {
+        fprintf(stderr, RED "[ERROR] Ruta demasiado larga: '%s'\n" RESET, argv[1]);
+        return ERROR;
+    }
+    strcpy(first.path, argv[1]);
+    first.key = key;
+    if (job_spec_append(jobs, &first) != SUCCESS) return ERROR;
+
+    *lanes_out = 0;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--stream") == 0) {
+            daemon->stream = 1;
+            continue;
+        }
+        if (strcmp(argv[i], "--sink") == 0) {
+            if (!daemon->sink_window) daemon->sink_window = SINK_DEFAULT_WINDOW;
+            continue;
+        }
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!val) {
+            setup_print_usage(argv[0]);
+            return ERROR;
+        }
+        if (strcmp(argv[i], "--lanes") == 0) {
+            long lanes = strtol(val, NULL, 10);
+            if (lanes < 1 || lanes > MAX_LANES || lanes > bs) {
+                fprintf(stderr, RED "[ERROR] Carriles inválidos (1..%d y <= tamaño del buffer)\n" RESET, MAX_LANES);
+                return ERROR;
+            }
+            *lanes_out = (int)lanes;
+        } else if (strcmp(argv[i], "--job") == 0) {
+            JobSpec spec;
+            if (job_spec_parse(val, key, &spec) != SUCCESS || job_spec_append(jobs, &spec) != SUCCESS) {
+                return ERROR;
+            }
+        } else if (strcmp(argv[i], "--jobs") == 0) {
+            if (job_list_load(val, key, jobs) != SUCCESS) return ERROR;
+        } else if (strcmp(argv[i], "--daemon") == 0) {
+            daemon->socket_path = val;
+        } else if (strcmp(argv[i], "--stages") == 0) {
+            daemon->stages_path = val;
+        } else if (strcmp(argv[i], "--groups") == 0) {
+            char* end = NULL;
+            long groups = strtol(val, &end, 10);
+            if (*end != '\0' || groups < 1 || groups > MAX_GROUPS) {
+                fprintf(stderr, RED "[ERROR] Grupos inválidos (1..%d)\n" RESET, MAX_GROUPS);
+                return ERROR;
+            }
+            daemon->groups = (int)groups;
+        } else if (strcmp(argv[i], "--sink-window") == 0) {
+            if (daemon_parse_size(val, &daemon->sink_window) != SUCCESS) {
+                fprintf(stderr, RED "[ERROR] Ventana de salida inválida: '%s' (ej: 256K)\n" RESET, val);
+                return ERROR;
+            }
+        } else if (strcmp(argv[i], "--capacity") == 0) {
+            if (daemon_parse_size(val, &daemon->capacity) != SUCCESS) {
+                fprintf(stderr, RED "[ERROR] Capacidad inválida: '%s' (ej: 64M)\n" RESET, val);
+                return ERROR;
+            }
+        } else {
+            fprintf(stderr, RED "[ERROR] Opción desconocida: %s\n" RESET, argv[i]);
+            setup_print_usage(argv[0]);
+            return ERROR;
+        }
+        i++;
+    }
+    if (daemon->capacity && !daemon->socket_path && !daemon->stream) {
+        fprintf(stderr, RED "[ERROR] --capacity sólo tiene sentido con --daemon o --stream\n" RESET);
+        return ERROR;
+    }
+    if (daemon->stream && (jobs->count > 1 || daemon->socket_path)) {
+        fprintf(stderr, RED "[ERROR] --stream no admite --job, --jobs ni --daemon\n" RESET);
+        return ERROR;
+    }
+    if (daemon->sink_window && daemon->socket_path) {
+        fprintf(stderr, RED "[ERROR] --sink no admite --daemon\n" RESET);
+        return ERROR;
+    }
+    if (daemon->stages_path && (*lanes_out || daemon->socket_path || daemon->stream)) {
+        fprintf(stderr, RED "[ERROR] --stages no admite --lanes, --daemon ni --stream\n" RESET);
+        return ERROR;
+    }
+    if (daemon->groups && (*lanes_out || daemon->socket_path || daemon->stream ||
+                           daemon->sink_window || daemon->stages_path)) {
+        fprintf(stderr, RED "[ERROR] --groups no admite --lanes, --daemon, --stream, --sink ni --stages\n" RESET);
+        return ERROR;
+    }
+    if (!daemon->stream && strcmp(argv[1], "-") == 0) {
+        fprintf(stderr, RED "[ERROR] La entrada estándar ('-') requiere --stream\n" RESET);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Cabecera del segmento recién creado: contadores en cero, modos según
+ * daemon y base de tiempo calibrada. La tabla de trabajos la publica
+ * quien llama.
+ */
+static void init_header(SharedMemory* shm, int buffer_size, unsigned char encryption_key,
+                        const char* input_filename, size_t file_size, const DaemonOptions* daemon) {
+    shm->shm_id                 = instance_shm_key();
+    strncpy(shm->instance, instance_name(), sizeof(shm->instance) - 1);
+    shm->buffer_size            = buffer_size;
+    shm->encryption_key         = encryption_key;
+    shm->current_txt_index      = 0;
+    shm->total_chars_in_file    = (int)file_size;
+    shm->total_chars_processed  = 0;
+    shm->total_emisores         = 0;
+    shm->active_emisores        = 0;
+    shm->total_receptores       = 0;
+    shm->active_receptores      = 0;
+    shm->workers_exit_seq       = 0;
+    shm->shutdown_flag          = 0;
+    shm->shutdown_relays        = 0;
+    shm->chars_enqueued         = 0;
+    shm->end_of_stream          = 0;
+    shm->eos_relays             = 0;
+    strncpy(shm->input_filename, input_filename, sizeof(shm->input_filename) - 1);
+    shm->input_filename[sizeof(shm->input_filename) - 1] = '\0';
+    shm->file_data_size         = (int)file_size;
+    shm->integrity_chunks       = (int)integrity_chunk_count((int)file_size);
+    shm->daemon_pid             = daemon->socket_path ? getpid() : 0;
+    shm->batch_seq              = 2;    // Lote 1
+    shm->batch_done             = 0;
+    shm->batch_written          = 0;
+    shm->stream                 = daemon->stream;
+    shm->stream_eof             = 0;
+    shm->stream_feeder_pid      = daemon->stream ? getpid() : 0;
+    shm->stream_seq             = 0;
+    shm->stream_waiters         = 0;
+    shm->stream_feeder_waiting  = 0;
+    shm->stream_wake_at         = 0;
+    shm->sink_pid               = 0;
+    shm->sink_committed         = 0;
+    shm->sink_waiters           = 0;
+    shm->sink_seq               = 0;
+    shm->sink_flusher_waiting   = 0;
+    shm->sink_wake_at           = 0;
+    shm->sink_writes            = 0;
+    shm->sink_dropped           = 0;
+    shm->emisor_stats_count = 0;
+    shm->receptor_stats_count = 0;
+    memset(shm->emisor_stats, 0, sizeof(shm->emisor_stats));
+    memset(shm->receptor_stats, 0, sizeof(shm->receptor_stats));
+    memset(shm->receptor_latency, 0, sizeof(shm->receptor_latency));
+    timebase_calibrate(&shm->timebase);
+}
+
+/**
+ * @brief Crea e inicializa el segmento de la instancia
+ *
+ * @param argc Cantidad de argumentos (argv[0] es el programa)
+ * @param argv ARCHIVO BUFFER CLAVE y las opciones del inicializador
+ * @param daemon Opciones leídas; listen_fd queda abierto con --daemon
+ * @return SHM adjunta e inicializada, NULL en error (ya informado)
+ */
+SharedMemory* setup_pipeline(int argc, char* argv[], DaemonOptions* daemon) {
+    JobSpecList job_specs = { NULL, 0, 0 };
+    int lanes = 0;
+    *daemon = (DaemonOptions){ NULL, 0, 0, 0, NULL, 0, -1 };
+    Stage stages[MAX_STAGES];
+    int stage_count = 0;
+    if (validate_arguments(argc, argv, &lanes, &job_specs, daemon) == ERROR ||
+        (daemon->stages_path && stage_list_load(daemon->stages_path, stages, &stage_count) != SUCCESS)) {
+        job_spec_list_free(&job_specs);
+        return NULL;
+    }
+    if (daemon->socket_path && (daemon->listen_fd = daemon_listen(daemon->socket_path)) == -1) {
+        job_spec_list_free(&job_specs);
+        return NULL;
+    }
+
+    char* input_filename = argv[1];
+    int buffer_size = atoi(argv[2]);
+    unsigned char encryption_key = parse_encryption_key(argv[3]);
+    int job_count = job_specs.count;
+
+    printf(CYAN "[INFO] Parámetros de inicialización:\n" RESET);
+    printf("  • Archivo de entrada: %s\n", input_filename);
+    printf("  • Tamaño del buffer: %d slots\n", buffer_size);
+    printf("  • Clave de encriptación: 0x%02X (binario: ", encryption_key);
+    for (int i = 7; i >= 0; i--) printf("%d", (encryption_key >> i) & 1);
+    printf(")\n");
+    if (instance_name()[0]) printf("  • Instancia: %s\n", instance_name());
+    if (lanes > 0) printf("  • Modo carriles: %d productores independientes\n", lanes);
+    if (job_count > 1) printf("  • Trabajos: %d archivos en un mismo segmento\n", job_count);
+    if (daemon->socket_path) printf("  • Modo demonio: lotes nuevos por %s\n", daemon->socket_path);
+    if (daemon->stream) printf("  • Modo streaming: la entrada se lee mientras corren los emisores\n");
+    if (daemon->sink_window) printf("  • Salida ordenada: ventana de %zu bytes (receptor --sink DESTINO)\n", daemon->sink_window);
+    if (stage_count > 0) {
+        printf("  • Etapas intermedias:");
+        for (int k = 0; k < stage_count; k++) {
+            printf(" %s%s", k ? "→ " : "", stage_op_name(stages[k].op));
+            if (stages[k].op == STAGE_OP_XOR || stages[k].op == STAGE_OP_FILTER) printf(" %02X", stages[k].param);
+        }
+        printf("\n");
+    }
+    if (daemon->groups) printf("  • Difusión: %d grupos de receptores ven cada carácter\n", daemon->groups);
+    printf("\n");
+
+    // Paso 1: leer archivo de entrada (en streaming se lee después, en stream_run)
+    size_t file_size = 0;
+    Job* jobs = calloc((size_t)job_count, sizeof(Job));
+    unsigned char* file_data = NULL;
+    if (daemon->stream) {
+        printf(YELLOW "[PASO 1] Fuente en streaming: sin lectura previa\n" RESET);
+        if (jobs) stream_prepare_job(&job_specs.items[0], jobs);
+    } else {
+        printf(YELLOW "[PASO 1] Procesando archivo de entrada...\n" RESET);
+        file_data = jobs ? load_job_inputs(&job_specs, jobs, &file_size) : NULL;
+    }
+    job_spec_list_free(&job_specs);
+    if (!jobs || (!file_data && !daemon->stream)) {
+        fprintf(stderr, RED "[ERROR] No se pudo procesar el archivo de entrada\n" RESET);
+        free(jobs);
+        if (daemon->listen_fd != -1) unlink(daemon->socket_path);
+        return NULL;
+    }
+    if (daemon->stream) {
+        printf(GREEN "  ✓ Trabajo único: %s\n" RESET, jobs[0].input_filename);
+    } else if (job_count > 1) {
+        print_file_statistics(file_data, file_size);
+        printf(GREEN "  ✓ %d trabajos procesados: %zu bytes leídos\n" RESET, job_count, file_size);
+    } else {
+        print_file_statistics(file_data, file_size);
+        printf(GREEN "  ✓ Archivo procesado: %zu bytes leídos\n" RESET, file_size);
+    }
+
+    // Paso 2: crear SHM con todas las regiones necesarias. En modo demonio
+    // file_data y la tabla de trabajos se dimensionan para los lotes futuros;
+    // en streaming file_data es el anillo y los resúmenes cubren el flujo máximo
+    printf(YELLOW "\n[PASO 2] Creando memoria compartida...\n" RESET);
+    int file_capacity = (int)file_size;
+    int data_span = (int)file_size;
+    int job_capacity = job_count;
+    if (daemon->socket_path) {
+        size_t cap = daemon->capacity ? daemon->capacity : MAX(file_size, (size_t)DAEMON_DEFAULT_CAPACITY);
+        if (cap < file_size) {
+            fprintf(stderr, RED "[ERROR] La capacidad (%zu bytes) no alcanza para el primer lote (%zu)\n" RESET,
+                    cap, file_size);
+            cap = 0;
+        }
+        file_capacity = (int)cap;
+        data_span = file_capacity;
+        job_capacity = MAX(job_count, DAEMON_DEFAULT_JOBS);
+    } else if (daemon->stream) {
+        file_capacity = (int)(daemon->capacity ? daemon->capacity : STREAM_DEFAULT_CAPACITY);
+        data_span = STREAM_MAX_BYTES;
+    }
+    SharedMemory* shm = file_capacity > 0
+                      ? create_shared_memory(buffer_size, file_capacity, data_span, job_capacity,
+                                             (int)daemon->sink_window, stages, stage_count, daemon->groups) : NULL;
+    if (!shm) {
+        free(file_data);
+        free(jobs);
+        if (daemon->listen_fd != -1) unlink(daemon->socket_path);
+        return NULL;
+    }
+
+    printf(GREEN "  ✓ Memoria compartida creada\n" RESET);
+    printf("  • ID de memoria: 0x%08X\n", (unsigned)instance_shm_key());
+    printf("  • Tamaño total (aprox.): %zu bytes\n",
+           (size_t)sizeof(SharedMemory)
+         + (size_t)buffer_size * sizeof(CharacterSlot)
+         + (size_t)file_capacity
+         + (size_t)buffer_size * sizeof(int) * 2 /* SlotRef estimado: 2 ints */
+    );
+
+    // Paso 3: inicialización de metadatos
+    printf(YELLOW "\n[PASO 3] Inicializando estructura de memoria compartida...\n" RESET);
+    init_header(shm, buffer_size, encryption_key, input_filename, file_size, daemon);
+    publish_jobs(shm, jobs, job_count);
+    printf(GREEN "  ✓ Estructura inicializada\n" RESET);
+    printf("  • Base de tiempo: %s", timebase_source_name(&shm->timebase));
+    if (shm->timebase.source == TIME_SOURCE_TSC) {
+        printf(" (%.3f GHz)", 1.0 / shm->timebase.ns_per_tick);
+    }
+    printf("\n");
+
+    // Paso 4: slots del buffer
+    printf(YELLOW "\n[PASO 4] Inicializando buffer de caracteres...\n" RESET);
+    initialize_buffer_slots(shm, buffer_size);
+    printf(GREEN "  ✓ %d slots de caracteres inicializados\n" RESET, buffer_size);
+
+    if (daemon->stream) {
+        // Pasos 5 y 6 en streaming: el alimentador llena el anillo y encadena los CRC32C
+        printf(YELLOW "\n[PASO 5] Preparando el anillo de entrada...\n" RESET);
+        printf(GREEN "  ✓ Anillo de %d bytes (se llena al leer la fuente)\n" RESET, file_capacity);
+        printf(YELLOW "\n[PASO 6] Resúmenes de integridad...\n" RESET);
+        printf(GREEN "  ✓ CRC32C de cada bloque de %d KiB a medida que llega la entrada\n" RESET,
+               INTEGRITY_CHUNK_SIZE / 1024);
+    } else {
+        // Paso 5: datos del archivo dentro de SHM
+        printf(YELLOW "\n[PASO 5] Copiando datos del archivo a memoria compartida...\n" RESET);
+        copy_file_to_shared_memory(shm, file_data, (int)file_size);
+        printf(GREEN "  ✓ Datos del archivo copiados a memoria compartida\n" RESET);
+
+        // Paso 6: CRC32C por bloque para la verificación del finalizador
+        printf(YELLOW "\n[PASO 6] Calculando resúmenes de integridad...\n" RESET);
+        struct timespec crc_t0, crc_t1;
+        int crc_threads = 0;
+        clock_gettime(CLOCK_MONOTONIC, &crc_t0);
+        if (compute_integrity_digests(shm, &crc_threads) == ERROR) {
+            fprintf(stderr, RED "[ERROR] No se pudieron calcular los CRC32C\n" RESET);
+            cleanup_shared_memory(shm);
+            free(file_data);
+            free(jobs);
+            if (daemon->listen_fd != -1) unlink(daemon->socket_path);
+            return NULL;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &crc_t1);
+        printf(GREEN "  ✓ %d bloques de %d KiB (CRC32C %s, %d hilos, %.3f ms)\n" RESET,
+               shm->integrity_chunks, INTEGRITY_CHUNK_SIZE / 1024,
+               crc32c_hw_available() ? "por hardware" : "por tabla", crc_threads,
+               (double)(crc_t1.tv_sec - crc_t0.tv_sec) * 1e3 + (double)(crc_t1.tv_nsec - crc_t0.tv_nsec) / 1e6);
+        printf("  • Raíz Merkle: %08x\n", shm->integrity_root);
+    }
+
+    // Paso 7: colas
+    printf(YELLOW "\n[PASO 7] Inicializando colas de sincronización...\n" RESET);
+    initialize_queues(shm, buffer_size);
+    initialize_lanes(shm, buffer_size, lanes);
+    printf(GREEN "  ✓ Cola de encriptación inicializada con %d posiciones\n" RESET, buffer_size);
+    printf(GREEN "  ✓ Cola de desencriptación inicializada (vacía)\n" RESET);
+
+    // Paso 8: semáforos POSIX
+    printf(YELLOW "\n[PASO 8] Inicializando semáforos POSIX...\n" RESET);
+    if (initialize_semaphores(buffer_size) == ERROR || initialize_stage_semaphores(stage_count) == ERROR ||
+        initialize_group_semaphores(daemon->groups) == ERROR) {
+        fprintf(stderr, RED "[ERROR] No se pudieron inicializar los semáforos POSIX\n" RESET);
+        cleanup_shared_memory(shm);
+        free(file_data);
+        free(jobs);
+        if (daemon->listen_fd != -1) unlink(daemon->socket_path);
+        return NULL;
+    }
+
+    printf(GREEN "  ✓ Semáforos POSIX creados e inicializados\n" RESET);
+    printf("  • %s = 1\n",  instance_sem(SEM_NAME_GLOBAL_MUTEX));
+    printf("  • %s = 1\n",  instance_sem(SEM_NAME_ENCRYPT_QUEUE));
+    printf("  • %s = 1\n",  instance_sem(SEM_NAME_DECRYPT_QUEUE));
+    printf("  • %s = %d\n", instance_sem(SEM_NAME_ENCRYPT_SPACES), buffer_size);
+    printf("  • %s = 0\n",  instance_sem(SEM_NAME_DECRYPT_ITEMS));
+    if (stage_count > 0) {
+        printf("  • %s0..%d = 1, %s0..%d = 0\n", SEM_NAME_STAGE_QUEUE, stage_count - 1,
+               SEM_NAME_STAGE_ITEMS, stage_count - 1);
+    }
+    if (daemon->groups > 0) printf("  • %s0..%d = 0\n", SEM_NAME_GROUP_ITEMS, daemon->groups - 1);
+
+    // Resumen
+    printf(BOLD GREEN "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD GREEN "║              INICIALIZACIÓN COMPLETADA                   ║\n" RESET);
+    printf(BOLD GREEN "╚══════════════════════════════════════════════════════════╝\n" RESET);
+
+    printf(WHITE "\nResumen del sistema:\n" RESET);
+    printf("  • Memoria compartida ID: 0x%08X\n", (unsigned)instance_shm_key());
+    printf("  • Buffer circular: %d slots\n", buffer_size);
+    if (job_count > 1) {
+        printf("  • Trabajos: %d (%zu bytes en total)\n", job_count, file_size);
+        int shown = MIN(job_count, 8);
+        for (int j = 0; j < shown; j++) {
+            printf("    - %s: %d bytes desde %d, clave 0x%02X\n", jobs[j].input_filename,
+                   jobs[j].length, jobs[j].start, jobs[j].key);
+        }
+        if (job_count > shown) printf("    ... y %d más\n", job_count - shown);
+    } else if (daemon->stream) {
+        printf("  • Fuente: %s (streaming, anillo de %d bytes)\n", input_filename, file_capacity);
+        printf("  • Clave XOR: 0x%02X\n", encryption_key);
+    } else {
+        printf("  • Archivo fuente: %s (%zu bytes)\n", input_filename, file_size);
+        printf("  • Clave XOR: 0x%02X\n", encryption_key);
+    }
+    if (!daemon->stream) {
+        printf("  • Integridad: %d bloques CRC32C, raíz %08x\n", shm->integrity_chunks, shm->integrity_root);
+    }
+    if (lanes > 0) printf("  • Carriles: %d (un emisor por carril)\n", lanes);
+    if (shm->sink_window) printf("  • Salida ordenada: ventana de %d bytes\n", shm->sink_window);
+    for (int k = 0; k < shm->stage_count; k++) {
+        printf("  • Etapa %d: %s", k, stage_op_name(shm->stages[k].op));
+        if (shm->stages[k].digest_offset) printf(" (raíz esperada %08x)", shm->stages[k].digest_root);
+        printf("\n");
+    }
+    if (shm->group_count > 0) {
+        printf("  • Difusión: %d grupos sobre la cola de desencriptación (el slot se libera con el más lento)\n",
+               shm->group_count);
+    }
+    printf("  • Semáforos POSIX: %s, %s, %s, %s, %s\n",
+           instance_sem(SEM_NAME_GLOBAL_MUTEX), instance_sem(SEM_NAME_ENCRYPT_QUEUE), instance_sem(SEM_NAME_DECRYPT_QUEUE),
+           instance_sem(SEM_NAME_ENCRYPT_SPACES), instance_sem(SEM_NAME_DECRYPT_ITEMS));
+
+    printf(CYAN "\n[INFO] El sistema está listo para recibir emisores y receptores\n" RESET);
+    printf(CYAN "[INFO] Use los siguientes comandos para iniciar los procesos:\n" RESET);
+    if (instance_name()[0]) {
+        printf("  • Emisor:      ./emisor --instance %s auto|manual [clave]\n", instance_name());
+        printf("  • Receptor:    ./receptor --instance %s auto|manual [clave]\n", instance_name());
+        printf("  • Finalizador: ./finalizador --instance %s\n", instance_name());
+    } else {
+        printf("  • Emisor:      ./emisor auto|manual [clave]\n");
+        printf("  • Receptor:    ./receptor auto|manual [clave]\n");
+        printf("  • Finalizador: ./finalizador\n");
+    }
+    if (shm->stage_count > 0) {
+        printf("  • Etapas:      ./etapa%s%s N (uno o más procesos por etapa, N = 0..%d)\n",
+               instance_name()[0] ? " --instance " : "", instance_name(), shm->stage_count - 1);
+    }
+    if (shm->group_count > 0) {
+        printf("  • Grupos:      ./receptor%s%s --group G auto (G = 0..%d; el grupo 0 escribe out/<archivo>.txt)\n",
+               instance_name()[0] ? " --instance " : "", instance_name(), shm->group_count - 1);
+    }
+    if (shm->sink_window) {
+        printf("  • Destino:     un receptor con --sink -|FIFO|unix:SOCKET envía la salida en orden\n");
+    }
+
+    // Limpieza local del buffer del archivo (la SHM permanece)
+    free(file_data);
+    free(jobs);
+
+    return shm;
+}
+
+/**
+ * @brief Crea el segmento a partir de una tabla de trabajos, sin leer archivos
+ *
+ * Lo usa 07puente del lado de destino: el origen manda su tabla de
+ * trabajos y los CRC32C esperados de cada bloque, y el segmento queda
+ * igual al de un inicializador con esa entrada salvo file_data, que
+ * queda en cero porque el único emisor es el puente.
+ *
+ * @param buffer_size Slots del buffer circular
+ * @param encryption_key Clave por omisión (la de cada trabajo va en la tabla)
+ * @param jobs Tabla de trabajos contigua desde 0 (job_count entradas)
+ * @param chunk_crcs CRC32C esperado de cada bloque de INTEGRITY_CHUNK_SIZE
+ * @param chunk_count Bloques de la entrada (integrity_chunk_count del total)
+ * @return SHM adjunta e inicializada, o NULL en error
+ */
+SharedMemory* setup_from_jobs(int buffer_size, unsigned char encryption_key, const Job* jobs, int job_count,
+                              const uint32_t* chunk_crcs, int chunk_count) {
+    DaemonOptions none = { .listen_fd = -1 };
+    if (buffer_size < MIN_BUFFER_SIZE || job_count < 1 || job_count > MAX_JOBS) {
+        fprintf(stderr, RED "[ERROR] Segmento inválido: %d slots, %d trabajos\n" RESET, buffer_size, job_count);
+        return NULL;
+    }
+    size_t file_size = (size_t)jobs[job_count - 1].start + (size_t)jobs[job_count - 1].length;
+    if (file_size == 0 || file_size > INT_MAX || (size_t)chunk_count != integrity_chunk_count((int)file_size)) {
+        fprintf(stderr, RED "[ERROR] Segmento inválido: %zu bytes en %d bloques\n" RESET, file_size, chunk_count);
+        return NULL;
+    }
+    uint32_t* level = malloc((size_t)chunk_count * sizeof(uint32_t));
+    if (!level) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para los resúmenes de integridad\n" RESET);
+        return NULL;
+    }
+
+    SharedMemory* shm = create_shared_memory(buffer_size, (int)file_size, (int)file_size, job_count,
+                                             0, NULL, 0, 0);
+    if (!shm) {
+        free(level);
+        return NULL;
+    }
+    init_header(shm, buffer_size, encryption_key, jobs[0].input_filename, file_size, &none);
+    publish_jobs(shm, jobs, job_count);
+    Job* table = get_jobs_pointer(shm);
+    for (int j = 0; j < job_count; j++) table[j].chars_written = 0;
+    initialize_buffer_slots(shm, buffer_size);
+
+    ChunkDigest* digests = get_integrity_pointer(shm);
+    for (int c = 0; c < chunk_count; c++) {
+        digests[c].expected_crc = chunk_crcs[c];
+        level[c] = chunk_crcs[c];
+    }
+    shm->integrity_root = crc32c_merkle_root(level, (size_t)chunk_count);
+    free(level);
+
+    initialize_queues(shm, buffer_size);
+    initialize_lanes(shm, buffer_size, 0);
+    if (initialize_semaphores(buffer_size) == ERROR) {
+        fprintf(stderr, RED "[ERROR] No se pudieron inicializar los semáforos POSIX\n" RESET);
+        cleanup_shared_memory(shm);
+        return NULL;
+    }
+    return shm;
+}
@@ -9,6 +9,7 @@
 #include "shared_memory_init.h"
 #include "constants.h"
 #include "structures.h"
+#include "instance.h"
 
 /**
  * Módulo de Inicialización de Memoria Compartida
@@ -19,6 +20,9 @@
  * 2. Buffer circular de CharacterSlot
  * 3. Datos del archivo de entrada
  * 4. Arrays para las colas de encriptación y desencriptación
+ * 5. Resúmenes CRC32C por bloque (ChunkDigest)
+ * 6. Tabla de trabajos y ventana de salida ordenada
+ * 7. Colas de las etapas intermedias y resúmenes de sus etapas checksum
  */
 
 /**
@@ -50,29 +54,61 @@ static unsigned long long read_shmmax_bytes(void) {
  * - Buffer circular de CharacterSlot[buffer_size]
  * - Datos del archivo file_data[file_size]
  * - Arrays para las colas: 2 * SlotRef[buffer_size]
+ * - Resúmenes de integridad: ChunkDigest[ceil(file_size / INTEGRITY_CHUNK_SIZE)],
+ *   alineados a línea de caché
  * 
  * @param buffer_size Tamaño del buffer circular
  * @param file_size Tamaño del archivo de entrada
+ * @param data_span Índices de texto que cubren los resúmenes de integridad
+ * @param sink_window Bytes de la ventana de salida ordenada (0 = sin ventana)
+ * @param stage_count Etapas intermedias (una cola SlotRef[buffer_size] cada una)
+ * @param checksum_stages Etapas checksum (resúmenes como los de la salida)
+ * @param group_count Grupos de difusión (0 = sin difusión)
  * @param base_size_out Puntero para almacenar tamaño de estructura base
  * @param buffer_bytes_out Puntero para almacenar tamaño del buffer
  * @param file_bytes_out Puntero para almacenar tamaño de datos del archivo
  * @param enc_queue_bytes_out Puntero para almacenar tamaño de cola de encriptación
  * @param dec_queue_bytes_out Puntero para almacenar tamaño de cola de desencriptación
+ * @param digest_bytes_out Puntero para almacenar tamaño de los resúmenes de integridad
+ * @param job_bytes_out Puntero para almacenar tamaño de la tabla de trabajos
+ * @param sink_bytes_out Puntero para almacenar tamaño de la ventana de salida ordenada
+ * @param stage_bytes_out Puntero para almacenar tamaño de colas y resúmenes de etapas
+ * @param group_bytes_out Puntero para almacenar tamaño de las marcas y resúmenes de grupos
  * @param page_size_out Puntero para almacenar tamaño de página del sistema
  * @return Tamaño total alineado necesario para el segmento
  */
-static size_t compute_total_size_aligned(int buffer_size, int file_size,
+static size_t compute_total_size_aligned(int buffer_size, int file_size, int data_span, int job_count,
+                                         int sink_window, int stage_count, int checksum_stages,
+                                         int group_count,
                                          size_t* base_size_out,
                                          size_t* buffer_bytes_out,
                                          size_t* file_bytes_out,
                                          size_t* enc_queue_bytes_out,
                                          size_t* dec_queue_bytes_out,
+                                         size_t* digest_bytes_out,
+                                         size_t* job_bytes_out,
+                                         size_t* sink_bytes_out,
+                                         size_t* stage_bytes_out,
+                                         size_t* group_bytes_out,
                                          size_t* page_size_out) {
     size_t base_size        = sizeof(SharedMemory);
     size_t buffer_bytes     = (size_t)buffer_size * sizeof(CharacterSlot);
     size_t file_bytes       = (size_t)file_size;
     size_t enc_queue_bytes  = (size_t)buffer_size * sizeof(SlotRef);
     size_t dec_queue_bytes  = (size_t)buffer_size * sizeof(SlotRef);
+    size_t digest_bytes     = INTEGRITY_CACHE_LINE
+                            + integrity_chunk_count(data_span) * sizeof(ChunkDigest);
+    size_t job_bytes        = sizeof(Job) + (size_t)job_count * sizeof(Job);
+    size_t sink_bytes       = sink_window > 0 ? INTEGRITY_CACHE_LINE + 2 * (size_t)sink_window : 0;
+    size_t stage_bytes      = (size_t)stage_count * (size_t)buffer_size * sizeof(SlotRef)
+                            + (size_t)checksum_stages * (INTEGRITY_CACHE_LINE
+                                + integrity_chunk_count(data_span) * sizeof(ChunkDigest));
+    // Difusión: una máscara por posición del anillo y los resúmenes de los grupos 1..N-1
+    size_t group_bytes      = group_count > 0
+                            ? INTEGRITY_CACHE_LINE + (size_t)buffer_size * sizeof(uint32_t)
+                              + (size_t)(group_count - 1) * (INTEGRITY_CACHE_LINE
+                                + integrity_chunk_count(data_span) * sizeof(ChunkDigest))
+                            : 0;
 
     long pg = sysconf(_SC_PAGESIZE);
     size_t page_size = (pg > 0) ? (size_t)pg : (size_t)PAGE_SIZE;
@@ -81,7 +117,12 @@ static size_t compute_total_size_aligned(int buffer_size, int file_size,
                  + buffer_bytes
                  + file_bytes
                  + enc_queue_bytes
-                 + dec_queue_bytes;
+                 + dec_queue_bytes
+                 + digest_bytes
+                 + job_bytes
+                 + sink_bytes
+                 + stage_bytes
+                 + group_bytes;
 
     size_t aligned = ((total + page_size - 1) / page_size) * page_size;
 
@@ -90,6 +131,11 @@ static size_t compute_total_size_aligned(int buffer_size, int file_size,
     if (file_bytes_out)      *file_bytes_out       = file_bytes;
     if (enc_queue_bytes_out) *enc_queue_bytes_out  = enc_queue_bytes;
     if (dec_queue_bytes_out) *dec_queue_bytes_out  = dec_queue_bytes;
+    if (digest_bytes_out)    *digest_bytes_out     = digest_bytes;
+    if (job_bytes_out)       *job_bytes_out        = job_bytes;
+    if (sink_bytes_out)      *sink_bytes_out       = sink_bytes;
+    if (stage_bytes_out)     *stage_bytes_out      = stage_bytes;
+    if (group_bytes_out)     *group_bytes_out      = group_bytes;
     if (page_size_out)       *page_size_out        = page_size;
 
     return aligned;
@@ -101,25 +147,44 @@ static size_t compute_total_size_aligned(int buffer_size, int file_size,
  * Crea un nuevo segmento de memoria compartida con el tamaño necesario
  * para todas las regiones del sistema. Configura los offsets y capacidades
  * de las colas para su uso posterior. La disposición física es:
- * [SharedMemory][CharacterSlot buffer][file_data][enc_queue][dec_queue]
+ * [SharedMemory][CharacterSlot buffer][file_data][enc_queue][dec_queue][digests][jobs][sink][etapas][grupos]
  * 
  * @param buffer_size Tamaño del buffer circular
- * @param file_size Tamaño del archivo de entrada
+ * @param file_size Bytes reservados para la entrada (todos los trabajos)
+ * @param data_span Índices de texto que cubren los resúmenes de integridad
+ *                  (file_size, salvo en streaming, donde file_data es un anillo)
+ * @param job_count Entradas reservadas en la tabla de trabajos
+ * @param sink_window Bytes de la ventana de salida ordenada (0 = sin ventana)
+ * @param stages Etapas intermedias (op y param; se copian a shm->stages)
+ * @param stage_count Cantidad de etapas (0 = sin etapas)
+ * @param group_count Grupos de receptores de la difusión (0 = sin difusión)
  * @return Puntero a la estructura SharedMemory, NULL si hay error
  */
-SharedMemory* create_shared_memory(int buffer_size, int file_size) {
-    key_t key = SHM_BASE_KEY;
+SharedMemory* create_shared_memory(int buffer_size, int file_size, int data_span, int job_count,
+                                   int sink_window, const Stage* stages, int stage_count, int group_count) {
+    key_t key = instance_shm_key();
+    int checksum_stages = 0;
+    for (int k = 0; k < stage_count; k++) checksum_stages += stages[k].op == STAGE_OP_CHECKSUM;
 
     // Cálculo de tamaños y alineación
-    size_t base_size, buffer_bytes, file_bytes, enc_q_bytes, dec_q_bytes, page_sz;
-    size_t total_size = compute_total_size_aligned(buffer_size, file_size,
+    size_t base_size, buffer_bytes, file_bytes, enc_q_bytes, dec_q_bytes, digest_bytes, job_bytes, sink_bytes;
+    size_t stage_bytes, group_bytes, page_sz;
+    size_t total_size = compute_total_size_aligned(buffer_size, file_size, data_span, job_count, sink_window,
+                                                   stage_count, checksum_stages, group_count,
                                                    &base_size, &buffer_bytes, &file_bytes,
-                                                   &enc_q_bytes, &dec_q_bytes, &page_sz);
+                                                   &enc_q_bytes, &dec_q_bytes, &digest_bytes,
+                                                   &job_bytes, &sink_bytes, &stage_bytes, &group_bytes,
+                                                   &page_sz);
 
     printf("  • Tamaño base de estructura: %zu bytes\n", base_size);
     printf("  • Tamaño del buffer: %zu bytes (%d slots)\n", buffer_bytes, buffer_size);
     printf("  • Tamaño de datos del archivo: %d bytes\n", file_size);
     printf("  • Tamaño arrays de colas: %zu + %zu bytes\n", enc_q_bytes, dec_q_bytes);
+    printf("  • Tamaño resúmenes CRC32C: %zu bytes\n", digest_bytes);
+    printf("  • Tamaño tabla de trabajos: %zu bytes (%d trabajos)\n", job_bytes, job_count);
+    if (sink_window > 0) printf("  • Tamaño ventana de salida ordenada: %zu bytes\n", sink_bytes);
+    if (stage_count > 0) printf("  • Tamaño colas y resúmenes de %d etapas: %zu bytes\n", stage_count, stage_bytes);
+    if (group_count > 0) printf("  • Tamaño marcas y resúmenes de %d grupos: %zu bytes\n", group_count, group_bytes);
     printf("  • Tamaño total alineado: %zu bytes\n", total_size);
 
     // Validación contra shmmax
@@ -131,9 +196,16 @@ SharedMemory* create_shared_memory(int buffer_size, int file_size) {
         return NULL;
     }
 
-    // Intentar eliminar memoria previa con la misma key
+    // Intentar eliminar memoria previa con la misma key. Si pertenece a
+    // otra instancia (colisión de claves) no se toca.
     int old_shmid = shmget(key, 0, 0);
     if (old_shmid != -1) {
+        SharedMemory* old = (SharedMemory*)shmat(old_shmid, NULL, SHM_RDONLY);
+        if (old != (void*)-1) {
+            int foreign = instance_check(old) != SUCCESS;
+            shmdt(old);
+            if (foreign) return NULL;
+        }
         printf(YELLOW "  ! Memoria compartida existente detectada, eliminando...\n" RESET);
         if (shmctl(old_shmid, IPC_RMID, NULL) == -1) {
             fprintf(stderr, RED "  [ADVERTENCIA] No se pudo eliminar memoria previa\n" RESET);
@@ -160,7 +232,7 @@ SharedMemory* create_shared_memory(int buffer_size, int file_size) {
     memset(shm, 0, total_size);
 
     // Configurar offsets y capacidades (orden físico):
-    // [SharedMemory][CharacterSlot buffer][file_data][enc_queue_array][dec_queue_array]
+    // [SharedMemory][CharacterSlot buffer][file_data][enc_queue_array][dec_queue_array][digests][jobs][sink][etapas][grupos]
     shm->buffer_offset = sizeof(SharedMemory);
     shm->file_data_offset = shm->buffer_offset + buffer_bytes;
 
@@ -170,6 +242,52 @@ SharedMemory* create_shared_memory(int buffer_size, int file_size) {
     shm->decrypt_queue.capacity   = buffer_size;
     shm->decrypt_queue.array_offset = shm->encrypt_queue.array_offset + enc_q_bytes;
 
+    size_t digest_start = shm->decrypt_queue.array_offset + dec_q_bytes;
+    shm->integrity_offset = (digest_start + INTEGRITY_CACHE_LINE - 1) & ~(size_t)(INTEGRITY_CACHE_LINE - 1);
+    shm->integrity_chunks = (int)integrity_chunk_count(file_size);
+    shm->file_capacity = file_size;
+    shm->job_capacity = job_count;
+
+    size_t jobs_start = shm->integrity_offset + integrity_chunk_count(data_span) * sizeof(ChunkDigest);
+    shm->jobs_offset = (jobs_start + _Alignof(Job) - 1) & ~(size_t)(_Alignof(Job) - 1);
+
+    shm->sink_window = sink_window;
+    size_t sink_start = shm->jobs_offset + (size_t)job_count * sizeof(Job);
+    shm->sink_offset = (sink_start + INTEGRITY_CACHE_LINE - 1) & ~(size_t)(INTEGRITY_CACHE_LINE - 1);
+
+    // Etapas: primero las colas, después los resúmenes de cada etapa checksum
+    size_t stage_start = shm->sink_offset + (sink_window > 0 ? 2 * (size_t)sink_window : 0);
+    stage_start = (stage_start + _Alignof(SlotRef) - 1) & ~(size_t)(_Alignof(SlotRef) - 1);
+    shm->stage_count = stage_count;
+    for (int k = 0; k < stage_count; k++) {
+        Stage* st = &shm->stages[k];
+        st->op = stages[k].op;
+        st->param = stages[k].param;
+        st->queue.capacity = buffer_size;
+        st->queue.array_offset = stage_start;
+        stage_start += (size_t)buffer_size * sizeof(SlotRef);
+    }
+    for (int k = 0; k < stage_count; k++) {
+        if (shm->stages[k].op != STAGE_OP_CHECKSUM) continue;
+        stage_start = (stage_start + INTEGRITY_CACHE_LINE - 1) & ~(size_t)(INTEGRITY_CACHE_LINE - 1);
+        shm->stages[k].digest_offset = stage_start;
+        stage_start += integrity_chunk_count(data_span) * sizeof(ChunkDigest);
+    }
+
+    // Grupos: las marcas del anillo y los resúmenes propios (el grupo 0 usa los de la salida)
+    shm->group_count = group_count;
+    if (group_count > 0) {
+        size_t group_start = (stage_start + INTEGRITY_CACHE_LINE - 1) & ~(size_t)(INTEGRITY_CACHE_LINE - 1);
+        shm->bcast_done_offset = group_start;
+        group_start += (size_t)buffer_size * sizeof(uint32_t);
+        shm->groups[0].digest_offset = shm->integrity_offset;
+        for (int g = 1; g < group_count; g++) {
+            group_start = (group_start + INTEGRITY_CACHE_LINE - 1) & ~(size_t)(INTEGRITY_CACHE_LINE - 1);
+            shm->groups[g].digest_offset = group_start;
+            group_start += integrity_chunk_count(data_span) * sizeof(ChunkDigest);
+        }
+    }
+
     return shm;
 }
 
@@ -188,7 +306,7 @@ void initialize_buffer_slots(SharedMemory* shm, int buffer_size) {
     for (int i = 0; i < buffer_size; i++) {
         buffer[i].ascii_value = 0;
         buffer[i].slot_index  = i + 1;  // Índices de 1..N
-        buffer[i].timestamp   = 0;
+        buffer[i].emit_ns     = 0;
         buffer[i].is_valid    = 0;
         buffer[i].text_index  = -1;
         buffer[i].emisor_pid  = 0;
@@ -285,7 +403,7 @@ int detach_shared_memory(SharedMemory* shm) {
  * @return SUCCESS si la operación fue exitosa, ERROR en caso contrario
  */
 int cleanup_shared_memory(SharedMemory* shm) {
-    key_t key = SHM_BASE_KEY;
+    key_t key = instance_shm_key();
     int shmid = shmget(key, 0, 0);
     if (shmid == -1) return ERROR;
 
@@ -304,9 +422,17 @@ int cleanup_shared_memory(SharedMemory* shm) {
  * compartida usando los offsets configurados. Evitan el uso directo
  * de aritmética de punteros.
  */
-CharacterSlot* get_buffer_pointer(SharedMemory* shm) {
-    return (CharacterSlot*)((char*)shm + shm->buffer_offset);
-}
 unsigned char* get_file_data_pointer(SharedMemory* shm) {
     return (unsigned char*)((char*)shm + shm->file_data_offset);
 }
+ChunkDigest* get_integrity_pointer(SharedMemory* shm) {
+    return (ChunkDigest*)((char*)shm + shm->integrity_offset);
+}
+Job* get_jobs_pointer(SharedMemory* shm) {
+    return (Job*)((char*)shm + shm->jobs_offset);
+}
+
+size_t integrity_chunk_count(int file_size) {
+    if (file_size <= 0) return 0;
+    return ((size_t)file_size + INTEGRITY_CHUNK_SIZE - 1) / INTEGRITY_CHUNK_SIZE;
+}
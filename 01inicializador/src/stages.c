@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "stages.h"
+#include "constants.h"
+
+/**
+ * Módulo de Etapas Intermedias (inicializador)
+ *
+ * Interpreta el archivo de --stages. El inicializador no ejecuta las
+ * etapas: sólo las describe en la SHM (op, param y su cola); los procesos
+ * 08etapa las atienden.
+ */
+
+static const struct {
+    const char* name;
+    int         op;
+} g_ops[] = {
+    { "xor",      STAGE_OP_XOR },
+    { "upper",    STAGE_OP_UPPER },
+    { "lower",    STAGE_OP_LOWER },
+    { "filter",   STAGE_OP_FILTER },
+    { "checksum", STAGE_OP_CHECKSUM },
+};
+
+static int parse_hex_byte(const char* s, unsigned char* out) {
+    if (strlen(s) != 2 || !isxdigit((unsigned char)s[0]) || !isxdigit((unsigned char)s[1])) return 0;
+    unsigned int v = 0;
+    (void)sscanf(s, "%2x", &v);
+    *out = (unsigned char)v;
+    return 1;
+}
+
+/**
+ * @brief Lee el archivo de etapas
+ *
+ * @param path Ruta del archivo
+ * @param stages Destino (MAX_STAGES entradas)
+ * @param count Etapas leídas
+ * @return SUCCESS o ERROR (línea inválida, demasiadas etapas o ninguna)
+ */
+int stage_list_load(const char* path, Stage* stages, int* count) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return ERROR;
+    }
+    char line[128];
+    int lineno = 0;
+    int rc = SUCCESS;
+    *count = 0;
+    while (rc == SUCCESS && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* name = strtok(line, " \t\r\n");
+        if (!name) continue;
+        char* arg = strtok(NULL, " \t\r\n");
+        char* extra = strtok(NULL, " \t\r\n");
+
+        int op = 0;
+        for (size_t i = 0; i < sizeof(g_ops) / sizeof(g_ops[0]); i++) {
+            if (strcmp(name, g_ops[i].name) == 0) op = g_ops[i].op;
+        }
+        unsigned char param = 0;
+        int ok = op != 0 && !extra;
+        if (ok && op == STAGE_OP_XOR) {
+            ok = arg && parse_hex_byte(arg, &param);
+        } else if (ok && op == STAGE_OP_FILTER) {
+            param = '?';
+            ok = !arg || parse_hex_byte(arg, &param);
+        } else if (ok) {
+            ok = !arg;
+        }
+        if (!ok) {
+            fprintf(stderr, RED "[ERROR] %s:%d: etapa inválida (xor CLAVE | upper | lower | "
+                                "filter [BYTE] | checksum)\n" RESET, path, lineno);
+            rc = ERROR;
+        } else if (*count == MAX_STAGES) {
+            fprintf(stderr, RED "[ERROR] %s:%d: más de %d etapas\n" RESET, path, lineno, MAX_STAGES);
+            rc = ERROR;
+        } else {
+            memset(&stages[*count], 0, sizeof(Stage));
+            stages[*count].op = op;
+            stages[*count].param = param;
+            (*count)++;
+        }
+    }
+    fclose(f);
+    if (rc == SUCCESS && *count == 0) {
+        fprintf(stderr, RED "[ERROR] %s: no define ninguna etapa\n" RESET, path);
+        rc = ERROR;
+    }
+    return rc;
+}
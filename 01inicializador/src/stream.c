@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "stream.h"
+#include "crc32c.h"
+#include "shared_memory_init.h"
+#include "constants.h"
+#include "instance.h"
+
+/**
+ * Módulo de Streaming (alimentador)
+ *
+ * El byte del índice i vive en file_data[i % file_capacity]. Los emisores
+ * leen su carácter antes de avanzar current_txt_index (ver
+ * get_next_text_index), así que el alimentador puede escribir el índice j
+ * en cuanto j < current_txt_index + file_capacity: el anillo lleno frena
+ * la lectura de la fuente y la contrapresión llega hasta quien escribe en
+ * la tubería.
+ *
+ * Publicación de bytes nuevos:
+ *   1. read() directo en el anillo (nunca cruza el final del anillo ni el
+ *      de un bloque de integridad).
+ *   2. file_data_size, longitud del trabajo y total_chars_in_file
+ *      (seq_cst): los emisores toman los índices nuevos.
+ *   3. stream_seq++ y FUTEX_WAKE si hay emisores esperando datos.
+ *
+ * Integridad: el CRC32C de cada bloque se encadena a medida que llega. El
+ * tamaño final se desconoce mientras los receptores escriben, así que
+ * ellos cuentan todo bloque como completo; al terminar la fuente el CRC del
+ * último bloque se extiende con ceros hasta INTEGRITY_CHUNK_SIZE, que es
+ * exactamente lo que acumulan (ver 03receptor/src/integrity.c).
+ */
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_stop(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static double elapsed_ms(const struct timespec* a, const struct timespec* b) {
+    return (double)(b->tv_sec - a->tv_sec) * 1e3 + (double)(b->tv_nsec - a->tv_nsec) / 1e6;
+}
+
+static void futex_wake_all(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static int should_stop(SharedMemory* shm) {
+    return g_stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE);
+}
+
+void stream_prepare_job(const JobSpec* spec, Job* job) {
+    memset(job, 0, sizeof(*job));
+    job->key = spec->key;
+    if (strcmp(spec->path, "-") == 0) {
+        strcpy(job->input_filename, "stdin");
+    } else {
+        memcpy(job->input_filename, spec->path, sizeof(job->input_filename));
+    }
+}
+
+/* Despierta a los emisores que esperan datos o el fin de la fuente */
+static void notify_readers(SharedMemory* shm) {
+    __atomic_add_fetch(&shm->stream_seq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&shm->stream_waiters, __ATOMIC_SEQ_CST)) futex_wake_all(&shm->stream_seq);
+}
+
+/**
+ * @brief Espera espacio libre en el anillo
+ *
+ * Con el anillo lleno anota en stream_wake_at el current_txt_index que
+ * libera STREAM_READ_MAX bytes (o un cuarto del anillo) y duerme en
+ * current_txt_index: el emisor que lo alcanza baja stream_feeder_waiting
+ * y lo despierta. Esperar un tramo y no un byte evita un FUTEX_WAKE por
+ * carácter.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param produced Bytes ya publicados
+ * @param stall_ms Tiempo acumulado con el anillo lleno (se actualiza)
+ * @return Bytes libres, o -1 si hay que terminar
+ */
+static int wait_for_space(SharedMemory* shm, int produced, double* stall_ms) {
+    int cap = shm->file_capacity;
+    int want = MAX(1, MIN(cap / 4, STREAM_READ_MAX));
+    struct timespec t0, t1;
+    int stalled = 0;
+    for (;;) {
+        int cur = __atomic_load_n(&shm->current_txt_index, __ATOMIC_SEQ_CST);
+        long long space = (long long)cur + cap - produced;
+        if (space > 0 || should_stop(shm)) {
+            __atomic_store_n(&shm->stream_feeder_waiting, 0, __ATOMIC_RELAXED);
+            if (stalled) {
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                *stall_ms += elapsed_ms(&t0, &t1);
+            }
+            return space > 0 ? (int)space : -1;
+        }
+        if (!stalled) {
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            stalled = 1;
+        }
+        __atomic_store_n(&shm->stream_wake_at, produced - cap + want, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->stream_feeder_waiting, 1, __ATOMIC_SEQ_CST);
+        // Un emisor que avanzó después de la lectura de arriba cambió la palabra: no se duerme
+        if (__atomic_load_n(&shm->current_txt_index, __ATOMIC_SEQ_CST) != cur) continue;
+        syscall(SYS_futex, &shm->current_txt_index, FUTEX_WAIT, cur, NULL, NULL, 0);
+    }
+}
+
+/* CRC de un bloque parcial extendido con ceros hasta INTEGRITY_CHUNK_SIZE */
+static uint32_t pad_chunk_crc(uint32_t crc, size_t filled) {
+    static const unsigned char zeros[4096];
+    size_t pad = INTEGRITY_CHUNK_SIZE - filled;
+    while (pad > 0) {
+        size_t n = MIN(pad, sizeof(zeros));
+        crc = crc32c(crc, zeros, n);
+        pad -= n;
+    }
+    return crc;
+}
+
+/**
+ * @brief Cierra el flujo: último bloque, raíz Merkle y fin de flujo
+ *
+ * stream_eof se publica después del total definitivo. Si los emisores ya
+ * encolaron todo, ninguno va a ver stream_eof en publish_enqueued: el
+ * alimentador deposita el marcador de fin de flujo (el CAS sobre
+ * end_of_stream evita un segundo marcador si un emisor llega a la vez).
+ */
+static void finish_stream(SharedMemory* shm, int produced, uint32_t chunk_crc) {
+    ChunkDigest* digests = get_integrity_pointer(shm);
+    int chunks = produced / INTEGRITY_CHUNK_SIZE;
+    size_t tail = (size_t)produced % INTEGRITY_CHUNK_SIZE;
+    if (tail) digests[chunks++].expected_crc = pad_chunk_crc(chunk_crc, tail);
+    shm->integrity_chunks = chunks;
+
+    uint32_t* leaves = chunks > 0 ? malloc((size_t)chunks * sizeof(uint32_t)) : NULL;
+    if (leaves) {
+        for (int c = 0; c < chunks; c++) leaves[c] = digests[c].expected_crc;
+        shm->integrity_root = crc32c_merkle_root(leaves, (size_t)chunks);
+        free(leaves);
+    } else {
+        shm->integrity_root = 0;
+    }
+
+    __atomic_store_n(&shm->stream_eof, 1, __ATOMIC_SEQ_CST);
+    notify_readers(shm);
+
+    if (__atomic_load_n(&shm->chars_enqueued, __ATOMIC_SEQ_CST) == (uint32_t)produced) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&shm->end_of_stream, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            sem_t* items = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+            if (items != SEM_FAILED) {
+                sem_post(items);
+                sem_close(items);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copia la fuente al anillo hasta el fin de la entrada
+ *
+ * Corre en el inicializador después de crear el segmento, así que abrir
+ * un FIFO sin escritor bloquea aquí y no antes de que existan los IPC.
+ *
+ * @param shm Segmento inicializado en modo streaming
+ * @param source Ruta de la fuente o "-" para la entrada estándar
+ * @return SUCCESS o ERROR (la fuente no se pudo abrir o leer)
+ */
+int stream_run(SharedMemory* shm, const char* source) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_stop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    int from_stdin = strcmp(source, "-") == 0;
+    printf(CYAN "\n[STREAM] Leyendo %s (anillo de %d bytes)\n" RESET,
+           from_stdin ? "la entrada estándar" : source, shm->file_capacity);
+    fflush(stdout);
+
+    int fd = STDIN_FILENO;
+    if (!from_stdin) {
+        do {
+            fd = open(source, O_RDONLY | O_CLOEXEC);
+        } while (fd == -1 && errno == EINTR && !should_stop(shm));
+    }
+    int rc = SUCCESS;
+    if (fd == -1 && !should_stop(shm)) {
+        fprintf(stderr, RED "[ERROR] No se pudo abrir %s: %s\n" RESET, source, strerror(errno));
+        rc = ERROR;
+    }
+
+    unsigned char* ring = get_file_data_pointer(shm);
+    ChunkDigest* digests = get_integrity_pointer(shm);
+    Job* job = get_jobs_pointer(shm);
+    int cap = shm->file_capacity;
+    int produced = 0;
+    uint32_t chunk_crc = 0;
+    unsigned long reads = 0;
+    double stall_ms = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    while (fd != -1 && !should_stop(shm)) {
+        if (produced >= STREAM_MAX_BYTES) {
+            fprintf(stderr, YELLOW "[STREAM] Límite de %d bytes alcanzado: se corta el flujo\n" RESET,
+                    STREAM_MAX_BYTES);
+            break;
+        }
+        int space = wait_for_space(shm, produced, &stall_ms);
+        if (space < 0) break;
+
+        int pos = produced % cap;
+        int n = MIN(space, cap - pos);
+        n = MIN(n, STREAM_READ_MAX);
+        n = MIN(n, INTEGRITY_CHUNK_SIZE - produced % INTEGRITY_CHUNK_SIZE);
+        ssize_t r = read(fd, ring + pos, (size_t)n);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, RED "[ERROR] Lectura de %s: %s\n" RESET, source, strerror(errno));
+            rc = ERROR;
+            break;
+        }
+        if (r == 0) break;
+
+        chunk_crc = crc32c(chunk_crc, ring + pos, (size_t)r);
+        produced += (int)r;
+        reads++;
+        if (produced % INTEGRITY_CHUNK_SIZE == 0) {
+            digests[produced / INTEGRITY_CHUNK_SIZE - 1].expected_crc = chunk_crc;
+            shm->integrity_chunks = produced / INTEGRITY_CHUNK_SIZE;
+            chunk_crc = 0;
+        }
+        __atomic_store_n(&shm->file_data_size, produced, __ATOMIC_RELAXED);
+        __atomic_store_n(&job->length, produced, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->total_chars_in_file, produced, __ATOMIC_SEQ_CST);
+        notify_readers(shm);
+    }
+    if (fd > STDIN_FILENO) close(fd);
+
+    finish_stream(shm, produced, chunk_crc);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = elapsed_ms(&t0, &t1);
+
+    printf(MAGENTA "\n[STREAM] Fin del flujo%s: %d bytes en %lu lecturas (%.3f ms)\n" RESET,
+           g_stop ? " (interrumpido)" : "", produced, reads, ms);
+    printf("  • Anillo lleno: %.3f ms esperando a los emisores\n", stall_ms);
+    printf("  • Integridad: %d bloques CRC32C, raíz %08x\n", shm->integrity_chunks, shm->integrity_root);
+    return rc;
+}
@@ -25,6 +25,11 @@
 #define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
 #define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
 #define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+// Etapas intermedias: base + número de etapa (ver instance_sem_n)
+#define SEM_NAME_STAGE_QUEUE    "/sem_stage_queue"
+#define SEM_NAME_STAGE_ITEMS    "/sem_stage_items"
+// Difusión: base + número de grupo de receptores
+#define SEM_NAME_GROUP_ITEMS    "/sem_group_items"
 
 // Permisos para objetos IPC y archivos
 #define IPC_PERMS 0666
@@ -0,0 +1,34 @@
+#ifndef EMISOR_H
+#define EMISOR_H
+
+#include <semaphore.h>
+#include "structures.h"
+
+/* Semáforos de la instancia, ya abiertos por quien llama */
+typedef struct {
+    sem_t* global;
+    sem_t* encrypt_queue;
+    sem_t* decrypt_queue;      // Con etapas, la cola de la etapa 0
+    sem_t* encrypt_spaces;
+    sem_t* decrypt_items;      // Con etapas, los items de la etapa 0
+    sem_t* group_items[MAX_GROUPS];  // Difusión: uno por grupo (shm->group_count)
+} EmisorSems;
+
+typedef struct {
+    int           mode;             // MODE_AUTO o MODE_MANUAL
+    int           has_custom_key;   // 0 = la clave de cada trabajo
+    unsigned char custom_key;
+    int           delay_ms;         // Retardo por carácter en modo AUTO
+} EmisorOptions;
+
+/*
+ * Cuerpo del emisor, separado de main para que 09lanzador lo corra en un
+ * hijo de fork sin exec:
+ *  - emisor_run: instala SIGINT/SIGTERM/SIGUSR1, se registra, toma un
+ *    carril si hay, emite hasta agotar la entrada o la finalización y se
+ *    desregistra. El segmento ya adjunto (con timebase_attach hecho) y los
+ *    semáforos los abre y cierra quien llama. SUCCESS o ERROR.
+ */
+int emisor_run(SharedMemory* shm, const EmisorSems* sems, const EmisorOptions* opt);
+
+#endif // EMISOR_H
@@ -0,0 +1,21 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include <signal.h>
+#include <semaphore.h>
+#include <sys/types.h>
+#include "structures.h"
+
+/*
+ * Modo carriles del emisor (shm->lane_count > 0, ver structures.h):
+ *  - claim_lane / release_lane: toma o libera un carril (bajo el mutex global).
+ *  - lane_acquire_slot: espera (futex, sin busy-wait) a que el próximo slot
+ *    del carril esté libre. ERROR si llega la finalización.
+ *  - lane_publish: publica el ítem escrito en ese slot para los receptores.
+ */
+Lane* claim_lane(SharedMemory* shm, pid_t pid, sem_t* sem_global);
+void  release_lane(Lane* lane, sem_t* sem_global);
+int   lane_acquire_slot(SharedMemory* shm, Lane* lane, volatile sig_atomic_t* stop, int* slot_index);
+void  lane_publish(Lane* lane);
+
+#endif // LANES_H
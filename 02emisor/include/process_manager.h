@@ -1,14 +1,33 @@
 #ifndef PROCESS_MANAGER_H
 #define PROCESS_MANAGER_H
 
+#include <signal.h>
 #include <sys/types.h>
 #include <semaphore.h>
 #include "structures.h"
 
-int get_next_text_index(SharedMemory* shm, sem_t* sem_global);
+int get_next_text_index(SharedMemory* shm, sem_t* sem_global, char* ch);
+int claim_next_text_index(SharedMemory* shm, char* ch);
 int register_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global);
 int unregister_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global);
-void save_emisor_stats(SharedMemory* shm, pid_t pid, int chars_sent, 
-                       time_t start_time, time_t end_time, sem_t* sem_global);
+WorkerStats* claim_emisor_stats(SharedMemory* shm, pid_t pid, sem_t* sem_global);
+int input_exhausted(SharedMemory* shm);
+int wait_next_batch(SharedMemory* shm, volatile sig_atomic_t* stop);
+int wait_stream_data(SharedMemory* shm, volatile sig_atomic_t* stop);
+int wait_sink_window(SharedMemory* shm, volatile sig_atomic_t* stop);
+int publish_enqueued(SharedMemory* shm, sem_t* const* items, int n);
+
+/*
+ * Tras despertar de un semáforo de conteo: 1 si hay que terminar. El
+ * finalizador deposita un único token por semáforo; quien lo encuentra lo
+ * reenvía al siguiente bloqueado. En el encabezado (inline) porque el
+ * receptor tiene la misma y 09lanzador enlaza a los dos.
+ */
+static inline int relay_shutdown(SharedMemory* shm, sem_t* sem) {
+    if (!__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return 0;
+    __atomic_add_fetch(&shm->shutdown_relays, 1, __ATOMIC_RELAXED);
+    sem_post(sem);
+    return 1;
+}
 
 #endif
\ No newline at end of file
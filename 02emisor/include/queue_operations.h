@@ -1,10 +1,10 @@
-#ifndef QUEUE_OPERATIONS_H
-#define QUEUE_OPERATIONS_H
+#ifndef EMISOR_QUEUE_OPERATIONS_H
+#define EMISOR_QUEUE_OPERATIONS_H
 
 #include "structures.h"
 
 int dequeue_encrypt_slot(SharedMemory* shm);
-int enqueue_encrypt_slot(SharedMemory* shm, int slot_index);
+int requeue_encrypt_slot(SharedMemory* shm, int slot_index);
 int enqueue_decrypt_slot(SharedMemory* shm, int slot_index, int text_index);
 
 #endif
\ No newline at end of file
@@ -4,9 +4,8 @@
 #include <sys/types.h>
 #include "structures.h"
 
-SharedMemory* attach_shared_memory(key_t key);
-int detach_shared_memory(SharedMemory* shm);
 char read_char_at_position(SharedMemory* shm, int position);
+unsigned char job_key_at(SharedMemory* shm, int text_index);
 void store_character(SharedMemory* shm, int slot_index, unsigned char encrypted_char, 
                     int text_index, pid_t emisor_pid);
 
@@ -0,0 +1,31 @@
+#ifndef WORKER_STATS_H
+#define WORKER_STATS_H
+
+#include <stdint.h>
+#include <semaphore.h>
+#include "structures.h"
+
+/*
+ * Estadísticas por proceso (bloque WorkerStats propio en SHM; idéntico en
+ * emisor y receptor):
+ *  - worker_stats_bind: asocia el bloque del proceso (NULL desactiva registro).
+ *  - worker_stats_now_ns: reloj del run en nanosegundos (timebase).
+ *  - stats_sem_wait: sem_wait que cuenta esperas bloqueantes y tiempo bloqueado.
+ *  - stats_futex_wait: ídem para una espera en palabra futex (modo carriles del emisor).
+ *  - worker_stats_record_item: suma un carácter y su tiempo de servicio.
+ *  - worker_stats_bind_latency: asocia el bloque ReceptorLatency (sólo el receptor).
+ *  - worker_stats_record_latency: registra latencias emisión/cola/escritura.
+ *  - worker_stats_set_inflight: publica el índice de texto en curso (-1 = ninguno).
+ *  - worker_stats_finish: marca el fin de la ejecución del proceso.
+ */
+void     worker_stats_bind(WorkerStats* ws);
+uint64_t worker_stats_now_ns(void);
+int      stats_sem_wait(int sem_idx, sem_t* sem);
+void     stats_futex_wait(int sem_idx, uint32_t* word, uint32_t expected);
+void     worker_stats_record_item(uint64_t service_ns);
+void     worker_stats_bind_latency(ReceptorLatency* lat);
+void     worker_stats_record_latency(uint64_t emit_ns, uint64_t dequeue_ns, uint64_t write_ns);
+void     worker_stats_set_inflight(int text_index);
+void     worker_stats_finish(void);
+
+#endif // WORKER_STATS_H
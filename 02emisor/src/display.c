@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include "display.h"
 #include "constants.h"
+#include "timebase.h"
 
 /**
  * Módulo de Visualización del Emisor
@@ -92,8 +93,7 @@ void print_emission_status(SharedMemory* shm, int slot_index, char original,
     CharacterSlot* slot = &buffer[slot_index];
     
     char time_str[32];
-    struct tm* timeinfo = localtime(&slot->timestamp);
-    strftime(time_str, sizeof(time_str), "%H:%M:%S", timeinfo);
+    timebase_format_hms(slot->emit_ns, time_str, sizeof(time_str));
     
     char safe_display[10];
     get_safe_char_display(original, safe_display, sizeof(safe_display));
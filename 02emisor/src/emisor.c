@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+
+#include "constants.h"
+#include "emisor.h"
+#include "shared_memory_access.h"
+#include "queue_operations.h"
+#include "encoder.h"
+#include "process_manager.h"
+#include "display.h"
+#include "worker_stats.h"
+#include "lanes.h"
+
+/**
+ * Bucle del Emisor
+ *
+ * Todo lo que hace un emisor una vez adjunto al segmento: registrarse,
+ * tomar slots libres, encriptar el próximo carácter de la entrada,
+ * publicarlo para los receptores y desregistrarse al terminar. main
+ * (el binario emisor) y 09lanzador (en un hijo de fork) lo llaman con
+ * el segmento y los semáforos ya abiertos.
+ */
+
+static volatile sig_atomic_t should_terminate = 0;
+
+static void signal_handler(int sig) {
+    if (sig == SIGINT || sig == SIGTERM || sig == SIGUSR1) {
+        should_terminate = 1;
+    }
+}
+
+static void setup_signal_handlers(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+/* IPC_QUIET=1 omite el recuadro por carácter (corridas de benchmark) */
+static int quiet_mode(void) {
+    const char* q = getenv("IPC_QUIET");
+    return q && *q && strcmp(q, "0") != 0;
+}
+
+/*
+ * Entrada agotada. En una corrida única el emisor termina; en modo demonio
+ * espera el próximo lote y en streaming más datos o el fin de la fuente.
+ * Con salida ordenada también se llega aquí con la ventana llena: se
+ * espera a que el destino la libere. Retorna 1 si hay que salir del bucle.
+ */
+static int end_of_input(SharedMemory* shm) {
+    if (shm->sink_window && !input_exhausted(shm)) {
+        return wait_sink_window(shm, &should_terminate) != SUCCESS;
+    }
+    if (shm->stream) {
+        if (wait_stream_data(shm, &should_terminate) == SUCCESS) return 0;
+        if (shm->stream_eof) printf(YELLOW "\n[EMISOR %d] Fin del flujo de entrada\n" RESET, getpid());
+        return 1;
+    }
+    if (!shm->daemon_pid) {
+        printf(YELLOW "\n[EMISOR %d] Fin del archivo alcanzado\n" RESET, getpid());
+        return 1;
+    }
+    return wait_next_batch(shm, &should_terminate) != SUCCESS;
+}
+
+int emisor_run(SharedMemory* shm, const EmisorSems* sems, const EmisorOptions* opt) {
+    setup_signal_handlers();
+
+    // Con difusión cada publicación se anuncia a todos los grupos
+    sem_t* const* items = shm->group_count > 0 ? sems->group_items : &sems->decrypt_items;
+    int items_count = shm->group_count > 0 ? shm->group_count : 1;
+
+    pid_t my_pid = getpid();
+    register_emisor(shm, my_pid, sems->global);
+    worker_stats_bind(claim_emisor_stats(shm, my_pid, sems->global));
+
+    Lane* lane = NULL;
+    if (shm->lane_count > 0) {
+        lane = claim_lane(shm, my_pid, sems->global);
+        if (!lane) {
+            fprintf(stderr, RED "[ERROR] Modo carriles: los %d carriles ya tienen emisor\n" RESET,
+                    shm->lane_count);
+            unregister_emisor(shm, my_pid, sems->global);
+            return ERROR;
+        }
+        printf(GREEN "✓ Carril %d: slots %d..%d\n" RESET, (int)(lane - shm->lanes),
+               lane->first_slot, lane->first_slot + lane->capacity - 1);
+    }
+
+    printf(BOLD GREEN "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD GREEN "║              EMISOR PID %6d INICIADO                 ║\n" RESET, my_pid);
+    printf(BOLD GREEN "╚══════════════════════════════════════════════════════════╝\n" RESET);
+    printf("\n");
+
+    int chars_sent = 0;
+    int quiet = quiet_mode();
+    time_t start_time = time(NULL);
+
+    while (!should_terminate && !shm->shutdown_flag) {
+        // Todos los índices ya fueron asignados: no hace falta un espacio
+        if (input_exhausted(shm)) {
+            if (end_of_input(shm)) break;
+            continue;
+        }
+        int slot_index, txt_index;
+        char original_char;
+        uint64_t service_t0;
+        if (lane) {
+            // Modo carriles: slot propio, índice sin mutex global, sin colas compartidas
+            if (lane_acquire_slot(shm, lane, &should_terminate, &slot_index) != SUCCESS) break;
+            service_t0 = worker_stats_now_ns();
+            txt_index = claim_next_text_index(shm, &original_char);
+            if (txt_index < 0) {
+                if (end_of_input(shm)) break;
+                continue;
+            }
+        } else {
+            if (stats_sem_wait(SEM_IDX_ENCRYPT_SPACES, sems->encrypt_spaces) != 0) {
+                if (errno == EINTR) {
+                    if (should_terminate || shm->shutdown_flag) break;
+                    continue;
+                }
+                break;
+            }
+            if (relay_shutdown(shm, sems->encrypt_spaces)) break;
+            if (input_exhausted(shm)) {
+                // El espacio queda para otro emisor bloqueado, que también saldrá
+                sem_post(sems->encrypt_spaces);
+                if (end_of_input(shm)) break;
+                continue;
+            }
+            service_t0 = worker_stats_now_ns();
+
+            stats_sem_wait(SEM_IDX_ENCRYPT_QUEUE, sems->encrypt_queue);
+            slot_index = dequeue_encrypt_slot(shm);
+            sem_post(sems->encrypt_queue);
+
+            if (slot_index < 0) {
+                sem_post(sems->encrypt_spaces);
+                continue;
+            }
+
+            txt_index = get_next_text_index(shm, sems->global, &original_char);
+            if (txt_index < 0) {
+                stats_sem_wait(SEM_IDX_ENCRYPT_QUEUE, sems->encrypt_queue);
+                requeue_encrypt_slot(shm, slot_index);
+                sem_post(sems->encrypt_queue);
+                sem_post(sems->encrypt_spaces);
+                if (end_of_input(shm)) break;
+                continue;
+            }
+        }
+
+        unsigned char key = opt->has_custom_key ? opt->custom_key : job_key_at(shm, txt_index);
+        unsigned char encrypted = encrypt_character(original_char, key);
+        store_character(shm, slot_index, encrypted, txt_index, my_pid);
+
+        if (lane) {
+            lane_publish(lane);
+        } else {
+            stats_sem_wait(SEM_IDX_DECRYPT_QUEUE, sems->decrypt_queue);
+            enqueue_decrypt_slot(shm, slot_index, txt_index);
+            sem_post(sems->decrypt_queue);
+        }
+        worker_stats_set_inflight(-1);
+        for (int i = 0; i < items_count; i++) sem_post(items[i]);
+        if (publish_enqueued(shm, items, items_count) && !quiet) {
+            printf(YELLOW "\n[EMISOR %d] Último carácter publicado: marcador de fin de flujo enviado\n" RESET,
+                   getpid());
+        }
+        worker_stats_record_item(worker_stats_now_ns() - service_t0);
+
+        if (!quiet) print_emission_status(shm, slot_index, original_char, encrypted, txt_index);
+        chars_sent++;
+
+        // --- NUEVO: aplicar slowdown sólo en modo AUTO y sólo si delay_ms > 0 ---
+        if (opt->mode == MODE_AUTO && opt->delay_ms > 0) {
+            usleep((useconds_t)opt->delay_ms * 1000);
+        }
+
+        if (opt->mode == MODE_MANUAL) {
+            printf(CYAN "\nPresione ENTER..." RESET);
+            char buffer[10];
+            errno = 0;
+            if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
+                if (errno == EINTR || should_terminate || shm->shutdown_flag) break;
+            }
+        }
+    }
+
+    time_t end_time = time(NULL);
+    worker_stats_finish();
+
+    printf(BOLD YELLOW "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD YELLOW "║             EMISOR PID %6d FINALIZANDO               ║\n" RESET, my_pid);
+    printf(BOLD YELLOW "╚══════════════════════════════════════════════════════════╝\n" RESET);
+    printf("  • Caracteres enviados: %d\n", chars_sent);
+    printf("  • Tiempo: %d segundos\n", (int)(end_time - start_time));
+
+    release_lane(lane, sems->global);
+    unregister_emisor(shm, my_pid, sems->global);
+    return SUCCESS;
+}
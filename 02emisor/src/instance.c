@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include "instance.h"
+#include "constants.h"
+
+/**
+ * Módulo de Instancias
+ *
+ * El nombre de la instancia deriva todos los nombres IPC:
+ *  - clave System V: FNV-1a de 32 bits del nombre, sin el bit de signo y
+ *    con el bit 16 encendido (nunca coincide con SHM_BASE_KEY ni con
+ *    IPC_PRIVATE);
+ *  - semáforos: SEM_NAME_* seguido de "." y el nombre
+ *    (/dev/shm/sem.sem_global_mutex.NOMBRE); los de una etapa intermedia
+ *    llevan además el número de etapa antes del punto
+ *    (/dev/shm/sem.sem_stage_items2.NOMBRE).
+ * La instancia por omisión (sin nombre) conserva SHM_BASE_KEY y los
+ * SEM_NAME_* originales. Los Makefile y setup.sh repiten la misma
+ * derivación para limpiar y verificar una instancia.
+ *
+ * Una colisión de claves entre dos nombres es improbable pero posible:
+ * el segmento guarda el nombre de su instancia y instance_check lo
+ * compara al adjuntar.
+ */
+
+static char g_name[INSTANCE_NAME_MAX] = "";
+static char g_sem_names[SEM_COUNT][64];
+
+static const char* const g_sem_bases[SEM_COUNT] = {
+    SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+    SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+};
+
+static int valid_name(const char* name) {
+    size_t len = strlen(name);
+    if (len >= INSTANCE_NAME_MAX) return 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)name[i];
+        if (!isalnum(c) && c != '_' && c != '-') return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Determina la instancia del proceso
+ *
+ * "--instance NOMBRE" o "--instance=NOMBRE" en cualquier posición tiene
+ * prioridad sobre IPC_INSTANCE y se quita de argv, así el resto del
+ * parseo de argumentos no cambia.
+ *
+ * @param argc Cantidad de argumentos (se actualiza)
+ * @param argv Argumentos (se compactan)
+ * @return SUCCESS o ERROR si el nombre es inválido
+ */
+int instance_init(int* argc, char* argv[]) {
+    const char* name = getenv("IPC_INSTANCE");
+    int out = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--instance") == 0 && i + 1 < *argc) {
+            name = argv[++i];
+        } else if (strncmp(argv[i], "--instance=", 11) == 0) {
+            name = argv[i] + 11;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argv[out] = NULL;
+    *argc = out;
+
+    if (!name) name = "";
+    if (!valid_name(name)) {
+        fprintf(stderr, RED "[ERROR] Nombre de instancia inválido: '%s' "
+                        "(hasta %d caracteres: letras, dígitos, '_' o '-')\n" RESET,
+                name, INSTANCE_NAME_MAX - 1);
+        return ERROR;
+    }
+    strcpy(g_name, name);
+    for (int i = 0; i < SEM_COUNT; i++) {
+        snprintf(g_sem_names[i], sizeof(g_sem_names[i]), "%s.%s", g_sem_bases[i], g_name);
+    }
+    if (g_name[0]) setenv("IPC_INSTANCE", g_name, 1);
+    else unsetenv("IPC_INSTANCE");
+    return SUCCESS;
+}
+
+const char* instance_name(void) {
+    return g_name;
+}
+
+key_t instance_shm_key(void) {
+    if (!g_name[0]) return SHM_BASE_KEY;
+    uint32_t h = 2166136261u;
+    for (const char* p = g_name; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 16777619u;
+    }
+    return (key_t)((h & 0x7fffffffu) | 0x10000u);
+}
+
+const char* instance_sem(const char* base) {
+    if (!g_name[0]) return base;
+    for (int i = 0; i < SEM_COUNT; i++) {
+        if (strcmp(base, g_sem_bases[i]) == 0) return g_sem_names[i];
+    }
+    return base;
+}
+
+/**
+ * @brief Nombre de un semáforo numerado (etapa intermedia o grupo)
+ *
+ * Retorna uno de cuatro búferes estáticos que se reutilizan en rotación:
+ * alcanza para pasar los dos semáforos de una etapa en la misma llamada.
+ */
+const char* instance_sem_n(const char* base, int n) {
+    static char names[4][64];
+    static int next = 0;
+    char* out = names[next];
+    next = (next + 1) % 4;
+    if (g_name[0]) snprintf(out, sizeof(names[0]), "%s%d.%s", base, n, g_name);
+    else snprintf(out, sizeof(names[0]), "%s%d", base, n);
+    return out;
+}
+
+/**
+ * @brief Verifica que el segmento adjuntado pertenezca a la instancia
+ *
+ * @return SUCCESS o ERROR (colisión de claves entre dos nombres)
+ */
+int instance_check(const SharedMemory* shm) {
+    if (strncmp(shm->instance, g_name, INSTANCE_NAME_MAX) == 0) return SUCCESS;
+    fprintf(stderr, RED "[ERROR] El segmento con clave 0x%08x pertenece a la instancia '%.*s', no a '%s'\n" RESET,
+            (unsigned)instance_shm_key(), INSTANCE_NAME_MAX, shm->instance, g_name);
+    return ERROR;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include "lanes.h"
+#include "worker_stats.h"
+#include "constants.h"
+
+/**
+ * Módulo de Carriles (emisor)
+ *
+ * Con la cola compartida cada carácter pasa por ENCRYPT_QUEUE y
+ * DECRYPT_QUEUE, dos semáforos que todos los emisores y receptores
+ * comparten. En modo carriles el emisor escribe en slots propios y
+ * publica con un único almacenamiento (tail); no toma ningún semáforo
+ * salvo el post de DECRYPT_ITEMS que despierta a un receptor.
+ */
+
+/**
+ * @brief Reserva un carril libre para el emisor
+ *
+ * El estado del anillo (head/tail) se conserva: si el carril tuvo otro
+ * dueño antes, el nuevo continúa donde aquel terminó.
+ *
+ * @return Carril reservado, o NULL si todos tienen dueño
+ */
+Lane* claim_lane(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
+    Lane* lane = NULL;
+    sem_wait(sem_global);
+    for (int i = 0; i < shm->lane_count && i < MAX_LANES; i++) {
+        if (shm->lanes[i].owner == 0) {
+            shm->lanes[i].owner = pid;
+            lane = &shm->lanes[i];
+            break;
+        }
+    }
+    sem_post(sem_global);
+    return lane;
+}
+
+void release_lane(Lane* lane, sem_t* sem_global) {
+    if (!lane) return;
+    sem_wait(sem_global);
+    lane->owner = 0;
+    sem_post(sem_global);
+}
+
+/**
+ * @brief Espera a que el próximo slot del carril quede libre
+ *
+ * El slot del ítem tail es el mismo que usó el ítem tail - capacity; queda
+ * libre cuando su receptor limpia is_valid. Protocolo con el receptor
+ * (lane_release_slot): éste limpia is_valid, incrementa freed y despierta
+ * si producer_waiting; aquí se publica producer_waiting antes de volver a
+ * mirar is_valid, y FUTEX_WAIT no duerme si freed cambió desde la lectura.
+ *
+ * @param shm Memoria compartida (para shutdown_flag)
+ * @param lane Carril propio
+ * @param stop Bandera de terminación por señal
+ * @param slot_index Slot libre (salida)
+ * @return SUCCESS, o ERROR si hay que terminar
+ */
+int lane_acquire_slot(SharedMemory* shm, Lane* lane, volatile sig_atomic_t* stop, int* slot_index) {
+    uint32_t n = __atomic_load_n(&lane->tail, __ATOMIC_RELAXED);
+    int idx = lane->first_slot + (int)(n % (uint32_t)lane->capacity);
+    CharacterSlot* slot = (CharacterSlot*)((char*)shm + shm->buffer_offset) + idx;
+
+    while (__atomic_load_n(&slot->is_valid, __ATOMIC_ACQUIRE)) {
+        if (*stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return ERROR;
+        uint32_t seq = __atomic_load_n(&lane->freed, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&lane->producer_waiting, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&slot->is_valid, __ATOMIC_SEQ_CST)) {
+            stats_futex_wait(SEM_IDX_ENCRYPT_SPACES, &lane->freed, seq);
+        }
+        __atomic_store_n(&lane->producer_waiting, 0, __ATOMIC_RELAXED);
+    }
+    *slot_index = idx;
+    return SUCCESS;
+}
+
+/**
+ * @brief Publica el ítem recién escrito (store_character) en el slot de tail
+ */
+void lane_publish(Lane* lane) {
+    __atomic_store_n(&lane->tail, __atomic_load_n(&lane->tail, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
@@ -2,9 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <signal.h>
 #include <errno.h>
-#include <time.h>
 #include <semaphore.h>
 #include <fcntl.h>
 #include <sys/ipc.h>
@@ -12,36 +10,60 @@
 
 #include "constants.h"
 #include "structures.h"
-#include "shared_memory_access.h"
-#include "queue_operations.h"
-#include "encoder.h"
-#include "process_manager.h"
+#include "emisor.h"
 #include "display.h"
+#include "timebase.h"
+#include "instance.h"
 
-volatile sig_atomic_t should_terminate = 0;
-SharedMemory* g_shm = NULL;
-sem_t* g_sem_global = NULL;
-sem_t* g_sem_encrypt_queue = NULL;
-sem_t* g_sem_decrypt_queue = NULL;
-sem_t* g_sem_encrypt_spaces = NULL;
-sem_t* g_sem_decrypt_items = NULL;
-
-void signal_handler(int sig) {
-    if (sig == SIGINT || sig == SIGTERM || sig == SIGUSR1) {
-        should_terminate = 1;
+/**
+ * @brief Conecta el emisor a la memoria compartida existente
+ * 
+ * Busca y se conecta al segmento de memoria compartida usando la clave
+ * proporcionada. Realiza validaciones básicas para asegurar que la
+ * memoria está correctamente inicializada. Vive en main.c porque
+ * 09lanzador enlaza el resto del emisor junto al inicializador, que
+ * tiene la suya.
+ * 
+ * @param key Clave IPC del segmento de memoria compartida
+ * @return Puntero a la estructura SharedMemory, NULL si hay error
+ */
+static SharedMemory* attach_shared_memory(key_t key) {
+    int shmid = shmget(key, 0, 0);
+    if (shmid == -1) {
+        fprintf(stderr, RED "[ERROR] No se encontró memoria compartida con key 0x%04X: %s\n" RESET, 
+                key, strerror(errno));
+        return NULL;
+    }
+    
+    SharedMemory* shm = (SharedMemory*)shmat(shmid, NULL, 0);
+    if (shm == (void*)-1) {
+        fprintf(stderr, RED "[ERROR] shmat falló: %s\n" RESET, strerror(errno));
+        return NULL;
     }
+    
+    if (shm->buffer_size <= 0 || shm->file_capacity <= 0) {
+        fprintf(stderr, RED "[ERROR] Memoria compartida corrupta\n" RESET);
+        shmdt(shm);
+        return NULL;
+    }
+    
+    return shm;
 }
 
-void setup_signal_handlers() {
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = signal_handler;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
+/**
+ * @brief Desconecta el emisor de la memoria compartida
+ * 
+ * @param shm Puntero a la estructura SharedMemory
+ * @return SUCCESS si la operación fue exitosa, ERROR en caso contrario
+ */
+static int detach_shared_memory(SharedMemory* shm) {
+    if (shm == NULL) return SUCCESS;
     
-    sigaction(SIGINT, &sa, NULL);
-    sigaction(SIGTERM, &sa, NULL);
-    sigaction(SIGUSR1, &sa, NULL);
+    if (shmdt(shm) == -1) {
+        fprintf(stderr, RED "[ERROR] shmdt falló: %s\n" RESET, strerror(errno));
+        return ERROR;
+    }
+    return SUCCESS;
 }
 
 static void print_usage(const char* argv0) {
@@ -56,6 +78,8 @@ static void print_usage(const char* argv0) {
     fprintf(stderr, "Notas:\n");
     fprintf(stderr, "  - <KEY> es 2 hex (ej: AA, ff)\n");
     fprintf(stderr, "  - <MS> es delay en milisegundos (0..%d)\n", MAX_DELAY_MS);
+    fprintf(stderr, "  - IPC_QUIET=1 omite el detalle por carácter\n");
+    fprintf(stderr, "  - --instance NOMBRE (o IPC_INSTANCE) elige la instancia\n");
 }
 
 int validate_arguments(int argc, char* argv[]) {
@@ -102,6 +126,7 @@ unsigned char parse_encryption_key(const char* key_str) {
 }
 
 int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
     if (validate_arguments(argc, argv) == ERROR) return EXIT_FAILURE;
     
     // -------------------------------
@@ -198,37 +223,61 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    setup_signal_handlers();
     print_emisor_banner();
     
     printf(CYAN "[EMISOR] Conectando a memoria compartida...\n" RESET);
-    SharedMemory* shm = attach_shared_memory(SHM_BASE_KEY);
+    SharedMemory* shm = attach_shared_memory(instance_shm_key());
     if (!shm) {
         fprintf(stderr, RED "[ERROR] No se pudo conectar a SHM\n" RESET);
         return EXIT_FAILURE;
     }
-    g_shm = shm;
+    if (instance_check(shm) != SUCCESS) {
+        detach_shared_memory(shm);
+        return EXIT_FAILURE;
+    }
+    timebase_attach(&shm->timebase);
     
     unsigned char encryption_key = has_custom_key ? custom_key : shm->encryption_key;
     
     printf(GREEN "✓ Conectado a memoria compartida\n" RESET);
     printf("  • Buffer size: %d slots\n", shm->buffer_size);
-    printf("  • Archivo: %s (%d caracteres)\n", shm->input_filename, shm->total_chars_in_file);
-    printf("  • Clave: 0x%02X\n", encryption_key);
+    if (shm->job_count > 1) {
+        printf("  • Trabajos: %d (%d caracteres en total)\n", shm->job_count, shm->total_chars_in_file);
+    } else {
+        printf("  • Archivo: %s (%d caracteres)\n", shm->input_filename, shm->total_chars_in_file);
+    }
+    if (has_custom_key || shm->job_count <= 1) {
+        printf("  • Clave: 0x%02X\n", encryption_key);
+    } else {
+        printf("  • Clave: la de cada trabajo\n");
+    }
     printf("  • Modo: %s\n", mode == MODE_AUTO ? "AUTOMÁTICO" : "MANUAL");
     if (mode == MODE_AUTO) printf("  • Delay: %d ms\n", delay_ms);
     
     printf(CYAN "\n[EMISOR] Abriendo semáforos POSIX...\n" RESET);
     
-    g_sem_global = sem_open(SEM_NAME_GLOBAL_MUTEX, 0);
-    g_sem_encrypt_queue = sem_open(SEM_NAME_ENCRYPT_QUEUE, 0);
-    g_sem_decrypt_queue = sem_open(SEM_NAME_DECRYPT_QUEUE, 0);
-    g_sem_encrypt_spaces = sem_open(SEM_NAME_ENCRYPT_SPACES, 0);
-    g_sem_decrypt_items = sem_open(SEM_NAME_DECRYPT_ITEMS, 0);
+    EmisorSems sems;
+    sems.global = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    sems.encrypt_queue = sem_open(instance_sem(SEM_NAME_ENCRYPT_QUEUE), 0);
+    sems.encrypt_spaces = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    // Con etapas intermedias se publica en la cola de la etapa 0
+    if (shm->stage_count > 0) {
+        sems.decrypt_queue = sem_open(instance_sem_n(SEM_NAME_STAGE_QUEUE, 0), 0);
+        sems.decrypt_items = sem_open(instance_sem_n(SEM_NAME_STAGE_ITEMS, 0), 0);
+    } else {
+        sems.decrypt_queue = sem_open(instance_sem(SEM_NAME_DECRYPT_QUEUE), 0);
+        sems.decrypt_items = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+    }
+    // Con difusión cada publicación se anuncia a todos los grupos
+    int groups_ok = 1;
+    for (int g = 0; g < shm->group_count; g++) {
+        sems.group_items[g] = sem_open(instance_sem_n(SEM_NAME_GROUP_ITEMS, g), 0);
+        if (sems.group_items[g] == SEM_FAILED) groups_ok = 0;
+    }
     
-    if (g_sem_global == SEM_FAILED || g_sem_encrypt_queue == SEM_FAILED ||
-        g_sem_decrypt_queue == SEM_FAILED || g_sem_encrypt_spaces == SEM_FAILED ||
-        g_sem_decrypt_items == SEM_FAILED) {
+    if (sems.global == SEM_FAILED || sems.encrypt_queue == SEM_FAILED ||
+        sems.decrypt_queue == SEM_FAILED || sems.encrypt_spaces == SEM_FAILED ||
+        sems.decrypt_items == SEM_FAILED || !groups_ok) {
         fprintf(stderr, RED "[ERROR] No se pudieron abrir semáforos\n" RESET);
         detach_shared_memory(shm);
         return EXIT_FAILURE;
@@ -236,94 +285,20 @@ int main(int argc, char* argv[]) {
     
     printf(GREEN "✓ Semáforos abiertos\n" RESET);
     
-    pid_t my_pid = getpid();
-    register_emisor(shm, my_pid, g_sem_global);
-    
-    printf(BOLD GREEN "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
-    printf(BOLD GREEN "║              EMISOR PID %6d INICIADO                 ║\n" RESET, my_pid);
-    printf(BOLD GREEN "╚══════════════════════════════════════════════════════════╝\n" RESET);
-    printf("\n");
-    
-    int chars_sent = 0;
-    time_t start_time = time(NULL);
-    
-    while (!should_terminate && !shm->shutdown_flag) {
-        if (sem_wait(g_sem_encrypt_spaces) != 0) {
-            if (errno == EINTR) {
-                if (should_terminate || shm->shutdown_flag) break;
-                continue;
-            }
-            break;
-        }
-
-        sem_wait(g_sem_encrypt_queue);
-        int slot_index = dequeue_encrypt_slot(shm);
-        sem_post(g_sem_encrypt_queue);
-
-        if (slot_index < 0) {
-            sem_post(g_sem_encrypt_spaces);
-            continue;
-        }
-
-        int txt_index = get_next_text_index(shm, g_sem_global);
-        if (txt_index >= shm->total_chars_in_file) {
-            sem_wait(g_sem_encrypt_queue);
-            enqueue_encrypt_slot(shm, slot_index);
-            sem_post(g_sem_encrypt_queue);
-            sem_post(g_sem_encrypt_spaces);
-            printf(YELLOW "\n[EMISOR %d] Fin del archivo alcanzado\n" RESET, getpid());
-            break;
-        }
-
-        char original_char = read_char_at_position(shm, txt_index);
-        unsigned char encrypted = encrypt_character(original_char, encryption_key);
-        store_character(shm, slot_index, encrypted, txt_index, my_pid);
-
-        sem_wait(g_sem_decrypt_queue);
-        enqueue_decrypt_slot(shm, slot_index, txt_index);
-        sem_post(g_sem_decrypt_queue);
-        sem_post(g_sem_decrypt_items);
-
-        print_emission_status(shm, slot_index, original_char, encrypted, txt_index);
-        chars_sent++;
-
-        // --- NUEVO: aplicar slowdown sólo en modo AUTO y sólo si delay_ms > 0 ---
-        if (mode == MODE_AUTO && delay_ms > 0) {
-            usleep((useconds_t)delay_ms * 1000);
-        }
-
-        if (mode == MODE_MANUAL) {
-            printf(CYAN "\nPresione ENTER..." RESET);
-            char buffer[10];
-            errno = 0;
-            if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
-                if (errno == EINTR || should_terminate || shm->shutdown_flag) break;
-            }
-        }
-    }
-    
-    time_t end_time = time(NULL);
-    
-    // NUEVO: Guardar estadísticas antes de desregistrar
-    save_emisor_stats(shm, my_pid, chars_sent, start_time, end_time, g_sem_global);
-    
-    printf(BOLD YELLOW "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
-    printf(BOLD YELLOW "║             EMISOR PID %6d FINALIZANDO               ║\n" RESET, my_pid);
-    printf(BOLD YELLOW "╚══════════════════════════════════════════════════════════╝\n" RESET);
-    printf("  • Caracteres enviados: %d\n", chars_sent);
-    printf("  • Tiempo: %d segundos\n", (int)(end_time - start_time));
-    
-    unregister_emisor(shm, my_pid, g_sem_global);
+    EmisorOptions opt = { mode, has_custom_key, custom_key, delay_ms };
+    int rc = emisor_run(shm, &sems, &opt);
     
-    sem_close(g_sem_global);
-    sem_close(g_sem_encrypt_queue);
-    sem_close(g_sem_decrypt_queue);
-    sem_close(g_sem_encrypt_spaces);
-    sem_close(g_sem_decrypt_items);
+    sem_close(sems.global);
+    sem_close(sems.encrypt_queue);
+    sem_close(sems.decrypt_queue);
+    sem_close(sems.encrypt_spaces);
+    sem_close(sems.decrypt_items);
+    for (int g = 0; g < shm->group_count; g++) sem_close(sems.group_items[g]);
     
     detach_shared_memory(shm);
+    if (rc != SUCCESS) return EXIT_FAILURE;
     
-    printf(GREEN "\n[EMISOR %d] Proceso terminado\n" RESET, my_pid);
+    printf(GREEN "\n[EMISOR %d] Proceso terminado\n" RESET, getpid());
     
     return EXIT_SUCCESS;
 }
@@ -1,8 +1,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <limits.h>
 #include <semaphore.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "process_manager.h"
+#include "worker_stats.h"
+#include "shared_memory_access.h"
 #include "constants.h"
 
 /**
@@ -13,32 +18,267 @@
  * índices de texto, y recolección de estadísticas de ejecución.
  */
 
+/**
+ * @brief Avisa al finalizador que un trabajador se desregistró
+ *
+ * Incrementa la palabra futex compartida y despierta a quien espere en
+ * ella (el finalizador cuando pidfd_open no está disponible). Sin
+ * FUTEX_PRIVATE_FLAG: la palabra vive en memoria compartida entre procesos.
+ */
+static void notify_worker_exit(SharedMemory* shm) {
+    __atomic_add_fetch(&shm->workers_exit_seq, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shm->workers_exit_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Comprueba, sin semáforos, si ya se asignaron todos los índices
+ *
+ * Dentro de un lote current_txt_index sólo crece y se publica con
+ * release, así que un resultado 1 es definitivo hasta que el demonio
+ * publique otro lote (ver wait_next_batch). Un 0 puede quedar viejo:
+ * get_next_text_index sigue siendo la comprobación autoritativa.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @return 1 si no quedan caracteres por asignar, 0 en caso contrario
+ */
+int input_exhausted(SharedMemory* shm) {
+    return __atomic_load_n(&shm->current_txt_index, __ATOMIC_ACQUIRE)
+        >= __atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Modo demonio: espera con la entrada agotada hasta el próximo lote
+ *
+ * batch_seq se lee antes de mirar la entrada: el demonio publica el nuevo
+ * total antes de cambiar batch_seq, así que si el total todavía no se ve,
+ * FUTEX_WAIT encuentra batch_seq sin cambios y duerme hasta su FUTEX_WAKE
+ * (o retorna en seguida si ya cambió). El finalizador también cambia
+ * batch_seq para despertar a los que esperan.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param stop Bandera de terminación del proceso
+ * @return SUCCESS si hay índices por tomar, ERROR si hay que terminar
+ */
+int wait_next_batch(SharedMemory* shm, volatile sig_atomic_t* stop) {
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&shm->batch_seq, __ATOMIC_ACQUIRE);
+        if (*stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return ERROR;
+        if (!input_exhausted(shm)) return SUCCESS;
+        syscall(SYS_futex, &shm->batch_seq, FUTEX_WAIT, seq, NULL, NULL, 0);
+    }
+}
+
+/**
+ * @brief Límite de los índices que se pueden tomar ahora
+ *
+ * Con salida ordenada un índice sólo se toma si cabe en la ventana de
+ * reordenamiento (sink_committed + sink_window): así los receptores nunca
+ * esperan lugar y la cabeza de la ventana siempre puede avanzar.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @return Primer índice que todavía no se puede tomar
+ */
+static int claim_limit(SharedMemory* shm) {
+    int total = __atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE);
+    if (!shm->sink_window) return total;
+    long long window_end = (long long)__atomic_load_n(&shm->sink_committed, __ATOMIC_ACQUIRE) + shm->sink_window;
+    return window_end < total ? (int)window_end : total;
+}
+
+/**
+ * @brief Salida ordenada: espera lugar en la ventana de reordenamiento
+ *
+ * Mismo esquema que wait_stream_data sobre sink_committed: el receptor
+ * dueño del destino la avanza después de cada escritura y hace FUTEX_WAKE
+ * sólo si sink_waiters > 0.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param stop Bandera de terminación del proceso
+ * @return SUCCESS si se puede volver a tomar índices, ERROR si hay que terminar
+ */
+int wait_sink_window(SharedMemory* shm, volatile sig_atomic_t* stop) {
+    int result = ERROR;
+    __atomic_add_fetch(&shm->sink_waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        int committed = __atomic_load_n(&shm->sink_committed, __ATOMIC_SEQ_CST);
+        if (*stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) break;
+        if (input_exhausted(shm) ||
+            __atomic_load_n(&shm->current_txt_index, __ATOMIC_ACQUIRE) < (long long)committed + shm->sink_window) {
+            result = SUCCESS;
+            break;
+        }
+        syscall(SYS_futex, &shm->sink_committed, FUTEX_WAIT, committed, NULL, NULL, 0);
+    }
+    __atomic_sub_fetch(&shm->sink_waiters, 1, __ATOMIC_RELAXED);
+    return result;
+}
+
+/**
+ * @brief Modo streaming: espera con la entrada agotada a que llegue más
+ *
+ * Mismo esquema que wait_next_batch sobre stream_seq, que el alimentador
+ * incrementa después de publicar bytes nuevos o el fin de la fuente. El
+ * alimentador sólo hace FUTEX_WAKE si stream_waiters > 0: el contador se
+ * incrementa antes de leer stream_seq (ambos seq_cst), así que un emisor
+ * que va a dormir nunca se pierde el despertar.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param stop Bandera de terminación del proceso
+ * @return SUCCESS si hay índices por tomar, ERROR si la fuente terminó o hay que salir
+ */
+int wait_stream_data(SharedMemory* shm, volatile sig_atomic_t* stop) {
+    int result = ERROR;
+    __atomic_add_fetch(&shm->stream_waiters, 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&shm->stream_seq, __ATOMIC_SEQ_CST);
+        if (*stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) break;
+        if (!input_exhausted(shm)) {
+            result = SUCCESS;
+            break;
+        }
+        if (__atomic_load_n(&shm->stream_eof, __ATOMIC_ACQUIRE)) {
+            // El total final se publica antes que stream_eof: volver a mirarlo
+            if (!input_exhausted(shm)) result = SUCCESS;
+            break;
+        }
+        syscall(SYS_futex, &shm->stream_seq, FUTEX_WAIT, seq, NULL, NULL, 0);
+    }
+    __atomic_sub_fetch(&shm->stream_waiters, 1, __ATOMIC_RELAXED);
+    return result;
+}
+
+/**
+ * @brief Modo streaming: avisa al alimentador que se liberó espacio del anillo
+ *
+ * El alimentador no escribe el índice j mientras j >= current_txt_index +
+ * file_capacity (el emisor lee el byte antes de tomar su índice). Si está
+ * esperando espacio, anota en stream_wake_at el current_txt_index que le
+ * alcanza y duerme en current_txt_index; lo despierta el emisor que lo
+ * alcanza.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param index Índice recién tomado
+ */
+static void stream_claimed(SharedMemory* shm, int index) {
+    if (!shm->stream) return;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&shm->stream_feeder_waiting, __ATOMIC_RELAXED) ||
+        index + 1 < __atomic_load_n(&shm->stream_wake_at, __ATOMIC_RELAXED)) {
+        return;
+    }
+    // Sólo el emisor que baja la bandera hace la llamada al sistema
+    int waiting = 1;
+    if (__atomic_compare_exchange_n(&shm->stream_feeder_waiting, &waiting, 0, 0,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        syscall(SYS_futex, &shm->current_txt_index, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+/**
+ * @brief Cuenta un carácter publicado y, si era el último, marca el fin de flujo
+ *
+ * Se llama después de encolar el carácter y de publicar su item. Quien
+ * completa total_chars_in_file activa end_of_stream y deposita un único
+ * marcador en DECRYPT_ITEMS; como va detrás de todos los items, el receptor
+ * que lo obtiene encuentra la cola vacía, sale y lo reenvía al siguiente
+ * (mismo esquema en cadena que relay_shutdown). Así sirve para cualquier
+ * cantidad de receptores, incluso los que se conecten después. En modo
+ * demonio no hay fin de flujo: los receptores esperan el próximo lote.
+ * Con etapas intermedias el marcador va a la etapa 0 y cada etapa lo
+ * pasa a la siguiente cuando termina de reenviar. Con difusión cada grupo
+ * recibe su propio marcador. En streaming el total sólo es definitivo con
+ * stream_eof; el alimentador hace la misma comprobación al publicarlo y
+ * el CAS sobre end_of_stream deja un único marcador aunque ambos lleguen
+ * a la vez.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param items Semáforos de items (DECRYPT_ITEMS o el de cada grupo)
+ * @param n Cantidad de semáforos
+ * @return 1 si este emisor publicó el fin de flujo
+ */
+int publish_enqueued(SharedMemory* shm, sem_t* const* items, int n) {
+    // Con etapas intermedias el contador y el fin de flujo son los de la etapa 0
+    int staged = shm->stage_count > 0;
+    uint32_t* enqueued = staged ? &shm->stages[0].enqueued : &shm->chars_enqueued;
+    int* end_of_stream = staged ? &shm->stages[0].end_of_stream : &shm->end_of_stream;
+    uint32_t done = __atomic_add_fetch(enqueued, 1, __ATOMIC_SEQ_CST);
+    if (shm->daemon_pid) return 0;
+    if (shm->stream && !__atomic_load_n(&shm->stream_eof, __ATOMIC_SEQ_CST)) return 0;
+    if (done != (uint32_t)__atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE)) return 0;
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(end_of_stream, &expected, 1, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) sem_post(items[i]);
+    return 1;
+}
+
 /**
  * @brief Obtiene el siguiente índice de texto a procesar
  * 
  * De manera atómica, obtiene y actualiza el índice actual del texto
  * que debe ser procesado. Esto asegura que cada carácter sea
- * procesado exactamente una vez.
+ * procesado exactamente una vez. El carácter se lee antes de avanzar
+ * current_txt_index: en streaming, avanzarlo libera su byte del anillo.
  * 
  * @param shm Puntero a la memoria compartida
  * @param sem_global Semáforo para sincronización global
- * @return Siguiente índice a procesar, o -1 si ya no hay caracteres
+ * @param ch Carácter original en el índice asignado
+ * @return Siguiente índice a procesar, o -1 si ya no hay caracteres (o no
+ *         caben en la ventana de salida ordenada)
  */
-int get_next_text_index(SharedMemory* shm, sem_t* sem_global) {
+int get_next_text_index(SharedMemory* shm, sem_t* sem_global, char* ch) {
     if (shm == NULL || sem_global == NULL) return -1;
     
     int index;
-    sem_wait(sem_global);
+    stats_sem_wait(SEM_IDX_GLOBAL_MUTEX, sem_global);
     index = shm->current_txt_index;
-    if (index < shm->total_chars_in_file) {
-        shm->current_txt_index++;
+    if (index < claim_limit(shm)) {
+        // Publicar el índice en curso antes de avanzar: el monitor nunca ve un hueco
+        worker_stats_set_inflight(index);
+        *ch = read_char_at_position(shm, index);
+        __atomic_store_n(&shm->current_txt_index, index + 1, __ATOMIC_RELEASE);
         shm->total_chars_processed++;
+    } else {
+        index = -1;
     }
     sem_post(sem_global);
     
+    if (index >= 0) stream_claimed(shm, index);
     return index;
 }
 
+/**
+ * @brief Obtiene el siguiente índice de texto sin el mutex global (modo carriles)
+ *
+ * CAS sobre current_txt_index: nunca lo lleva más allá del total, así
+ * que los lectores (monitor, input_exhausted) ven el mismo valor que con
+ * get_next_text_index. El carácter se lee antes del CAS por la misma
+ * razón que allí; si el CAS falla se vuelve a leer el del nuevo índice.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param ch Carácter original en el índice asignado
+ * @return Índice asignado, o -1 si ya no hay caracteres (o no caben en la
+ *         ventana de salida ordenada)
+ */
+int claim_next_text_index(SharedMemory* shm, char* ch) {
+    int index = __atomic_load_n(&shm->current_txt_index, __ATOMIC_ACQUIRE);
+    while (index < claim_limit(shm)) {
+        // Publicar el índice antes de avanzar (mismo criterio que get_next_text_index)
+        worker_stats_set_inflight(index);
+        *ch = read_char_at_position(shm, index);
+        if (__atomic_compare_exchange_n(&shm->current_txt_index, &index, index + 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_add_fetch(&shm->total_chars_processed, 1, __ATOMIC_RELAXED);
+            stream_claimed(shm, index);
+            return index;
+        }
+    }
+    worker_stats_set_inflight(-1);
+    return -1;
+}
+
 /**
  * @brief Registra un nuevo proceso emisor en el sistema
  * 
@@ -57,7 +297,7 @@ int register_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     sem_wait(sem_global);
     
     int registered = 0;
-    for (int i = 0; i < 100; i++) {
+    for (int i = 0; i < MAX_WORKERS; i++) {
         if (shm->emisor_pids[i] == 0) {
             shm->emisor_pids[i] = pid;
             registered = 1;
@@ -94,7 +334,7 @@ int unregister_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     sem_wait(sem_global);
     
     int found = 0;
-    for (int i = 0; i < 100; i++) {
+    for (int i = 0; i < MAX_WORKERS; i++) {
         if (shm->emisor_pids[i] == pid) {
             shm->emisor_pids[i] = 0;
             found = 1;
@@ -104,6 +344,7 @@ int unregister_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     
     if (found) {
         shm->active_emisores--;
+        notify_worker_exit(shm);
         printf(YELLOW "[EMISOR %d] Desregistrado (%d activos restantes)\n" RESET,
                pid, shm->active_emisores);
     }
@@ -113,34 +354,32 @@ int unregister_emisor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
 }
 
 /**
- * @brief Guarda las estadísticas de un emisor que finaliza
+ * @brief Reserva el bloque de estadísticas de un emisor
  * 
- * Almacena información estadística sobre la ejecución del emisor,
- * incluyendo cantidad de caracteres procesados y tiempos de
- * ejecución. Estas estadísticas son utilizadas por el finalizador
- * para mostrar el resumen del sistema.
+ * Asigna al emisor un bloque WorkerStats propio en la memoria compartida.
+ * Los bloques nunca se reutilizan: el finalizador puede así reportar
+ * también a los emisores que ya terminaron. A partir de aquí el emisor
+ * actualiza sus contadores sin tomar el semáforo global.
  * 
  * @param shm Puntero a la memoria compartida
  * @param pid PID del emisor
- * @param chars_sent Número de caracteres procesados
- * @param start_time Tiempo de inicio del emisor
- * @param end_time Tiempo de finalización del emisor
  * @param sem_global Semáforo para sincronización global
+ * @return Bloque reservado, o NULL si ya no quedan bloques libres
  */
-void save_emisor_stats(SharedMemory* shm, pid_t pid, int chars_sent, 
-                       time_t start_time, time_t end_time, sem_t* sem_global) {
-    if (shm == NULL || sem_global == NULL) return;
+WorkerStats* claim_emisor_stats(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
+    if (shm == NULL || sem_global == NULL) return NULL;
     
+    WorkerStats* ws = NULL;
     sem_wait(sem_global);
     
-    if (shm->emisor_stats_count < 100) {
-        int idx = shm->emisor_stats_count;
-        shm->emisor_stats[idx].pid = pid;
-        shm->emisor_stats[idx].chars_processed = chars_sent;
-        shm->emisor_stats[idx].start_time = start_time;
-        shm->emisor_stats[idx].end_time = end_time;
+    if (shm->emisor_stats_count < MAX_WORKERS) {
+        ws = &shm->emisor_stats[shm->emisor_stats_count];
+        memset(ws, 0, sizeof(*ws));
+        ws->pid = pid;
+        ws->in_use = 1;
         shm->emisor_stats_count++;
     }
     
     sem_post(sem_global);
-}
\ No newline at end of file
+    return ws;
+}
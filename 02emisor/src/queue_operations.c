@@ -25,16 +25,16 @@ static inline SlotRef* get_encrypt_array(SharedMemory* shm) {
 }
 
 /**
- * @brief Obtiene el array de la cola de desencriptación
+ * @brief Obtiene la cola donde publican los emisores
  * 
- * Calcula la dirección correcta del array de la cola de desencriptación
- * usando el offset almacenado en la memoria compartida.
+ * La de desencriptación, o la de la etapa 0 si hay etapas intermedias
+ * (los receptores reciben el slot cuando sale de la última).
  * 
  * @param shm Puntero a la estructura SharedMemory
- * @return Puntero al array de SlotRef para la cola de desencriptación
+ * @return Cola de publicación
  */
-static inline SlotRef* get_decrypt_array(SharedMemory* shm) {
-    return (SlotRef*)((char*)shm + shm->decrypt_queue.array_offset);
+static inline Queue* get_publish_queue(SharedMemory* shm) {
+    return shm->stage_count > 0 ? &shm->stages[0].queue : &shm->decrypt_queue;
 }
 
 /**
@@ -55,34 +55,38 @@ int dequeue_encrypt_slot(SharedMemory* shm) {
     SlotRef* array = get_encrypt_array(shm);
     int slot_index = array[queue->head].slot_index;
     
+    seq_write_begin(&queue->seq);
     queue->head = (queue->head + 1) % queue->capacity;
     queue->size--;
+    seq_write_end(&queue->seq);
     
     return slot_index;
 }
 
 /**
- * @brief Devuelve un slot a la cola de encriptación
+ * @brief Devuelve a la cola de encriptación un slot que no se usó
  * 
- * Reinserta un slot en la cola de encriptación después de que
- * su contenido ha sido procesado y ya no se necesita.
+ * El emisor tomó el slot pero no había más índices de texto: lo
+ * reinserta para otro emisor (o para el próximo lote del demonio).
  * 
  * @param shm Puntero a la estructura SharedMemory
  * @param slot_index Índice del slot a devolver
  * @return SUCCESS si la operación fue exitosa, ERROR en caso contrario
  */
-int enqueue_encrypt_slot(SharedMemory* shm, int slot_index) {
+int requeue_encrypt_slot(SharedMemory* shm, int slot_index) {
     if (shm == NULL) return ERROR;
     
     Queue* queue = &shm->encrypt_queue;
     if (queue->size >= queue->capacity) return ERROR;
     
     SlotRef* array = get_encrypt_array(shm);
+    seq_write_begin(&queue->seq);
     array[queue->tail].slot_index = slot_index;
     array[queue->tail].text_index = -1;
     
     queue->tail = (queue->tail + 1) % queue->capacity;
     queue->size++;
+    seq_write_end(&queue->seq);
     
     return SUCCESS;
 }
@@ -91,7 +95,8 @@ int enqueue_encrypt_slot(SharedMemory* shm, int slot_index) {
  * @brief Encola un slot con datos en la cola de desencriptación
  * 
  * Añade un slot que contiene un carácter encriptado a la cola
- * de desencriptación para que sea procesado por los receptores.
+ * de desencriptación para que sea procesado por los receptores
+ * (a la de la etapa 0 si hay etapas intermedias).
  * 
  * @param shm Puntero a la estructura SharedMemory
  * @param slot_index Índice del slot con datos
@@ -101,15 +106,17 @@ int enqueue_encrypt_slot(SharedMemory* shm, int slot_index) {
 int enqueue_decrypt_slot(SharedMemory* shm, int slot_index, int text_index) {
     if (shm == NULL) return ERROR;
     
-    Queue* queue = &shm->decrypt_queue;
+    Queue* queue = get_publish_queue(shm);
     if (queue->size >= queue->capacity) return ERROR;
     
-    SlotRef* array = get_decrypt_array(shm);
+    SlotRef* array = (SlotRef*)((char*)shm + queue->array_offset);
+    seq_write_begin(&queue->seq);
     array[queue->tail].slot_index = slot_index;
     array[queue->tail].text_index = text_index;
     
     queue->tail = (queue->tail + 1) % queue->capacity;
     queue->size++;
+    seq_write_end(&queue->seq);
     
     return SUCCESS;
 }
\ No newline at end of file
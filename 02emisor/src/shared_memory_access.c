@@ -1,78 +1,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/ipc.h>
-#include <sys/shm.h>
-#include <errno.h>
 #include <unistd.h>
 #include "shared_memory_access.h"
 #include "constants.h"
+#include "worker_stats.h"
 
 /**
  * Módulo de Acceso a Memoria Compartida para el Emisor
  * 
  * Este módulo proporciona las funciones necesarias para que el emisor
- * interactúe con la memoria compartida, incluyendo la conexión inicial,
- * lectura de datos y almacenamiento de caracteres procesados.
+ * interactúe con la memoria compartida: lectura de datos y almacenamiento
+ * de caracteres procesados. La conexión al segmento está en main.c.
  */
 
-/**
- * @brief Conecta el emisor a la memoria compartida existente
- * 
- * Busca y se conecta al segmento de memoria compartida usando la clave
- * proporcionada. Realiza validaciones básicas para asegurar que la
- * memoria está correctamente inicializada.
- * 
- * @param key Clave IPC del segmento de memoria compartida
- * @return Puntero a la estructura SharedMemory, NULL si hay error
- */
-SharedMemory* attach_shared_memory(key_t key) {
-    int shmid = shmget(key, 0, 0);
-    if (shmid == -1) {
-        fprintf(stderr, RED "[ERROR] No se encontró memoria compartida con key 0x%04X: %s\n" RESET, 
-                key, strerror(errno));
-        return NULL;
-    }
-    
-    SharedMemory* shm = (SharedMemory*)shmat(shmid, NULL, 0);
-    if (shm == (void*)-1) {
-        fprintf(stderr, RED "[ERROR] shmat falló: %s\n" RESET, strerror(errno));
-        return NULL;
-    }
-    
-    if (shm->buffer_size <= 0 || shm->file_data_size <= 0) {
-        fprintf(stderr, RED "[ERROR] Memoria compartida corrupta\n" RESET);
-        shmdt(shm);
-        return NULL;
-    }
-    
-    return shm;
-}
-
-/**
- * @brief Desconecta el emisor de la memoria compartida
- * 
- * Libera la conexión del emisor con el segmento de memoria compartida.
- * Esta función debe llamarse antes de que el emisor termine.
- * 
- * @param shm Puntero a la estructura SharedMemory
- * @return SUCCESS si la operación fue exitosa, ERROR en caso contrario
- */
-int detach_shared_memory(SharedMemory* shm) {
-    if (shm == NULL) return SUCCESS;
-    
-    if (shmdt(shm) == -1) {
-        fprintf(stderr, RED "[ERROR] shmdt falló: %s\n" RESET, strerror(errno));
-        return ERROR;
-    }
-    return SUCCESS;
-}
-
 /**
  * @brief Lee un carácter del archivo original en memoria compartida
  * 
  * Accede a la región de datos del archivo en la memoria compartida
- * y retorna el carácter en la posición especificada.
+ * y retorna el carácter en la posición especificada. En streaming la
+ * región es un anillo de file_capacity bytes.
  * 
  * @param shm Puntero a la estructura SharedMemory
  * @param position Posición del carácter a leer
@@ -80,18 +27,41 @@ int detach_shared_memory(SharedMemory* shm) {
  */
 char read_char_at_position(SharedMemory* shm, int position) {
     if (shm == NULL) return '\0';
-    if (position < 0 || position >= shm->file_data_size) return '\0';
+    if (position < 0 || position >= __atomic_load_n(&shm->file_data_size, __ATOMIC_ACQUIRE)) return '\0';
     
     unsigned char* file_data = (unsigned char*)((char*)shm + shm->file_data_offset);
+    if (shm->stream) position %= shm->file_capacity;
     return (char)file_data[position];
 }
 
+/**
+ * @brief Clave del trabajo al que pertenece un índice de texto
+ * 
+ * Los índices que toma un emisor casi siempre caen en el mismo trabajo
+ * que el anterior: se recuerda el último y sólo se busca (job_find) al
+ * cruzar a otro tramo.
+ * 
+ * @param shm Puntero a la estructura SharedMemory
+ * @param text_index Índice global del carácter
+ * @return Clave del trabajo (la del primero si el índice está fuera)
+ */
+unsigned char job_key_at(SharedMemory* shm, int text_index) {
+    static int last = -1;
+    const Job* jobs = (const Job*)((const char*)shm + shm->jobs_offset);
+    if (last < 0 || last >= shm->job_count ||
+        text_index < jobs[last].start || text_index >= jobs[last].start + jobs[last].length) {
+        last = job_find(jobs, shm->job_count, text_index);
+        if (last < 0) return shm->encryption_key;
+    }
+    return jobs[last].key;
+}
+
 /**
  * @brief Almacena un carácter encriptado en el buffer circular
  * 
  * Guarda un carácter procesado en el slot especificado del buffer,
- * junto con metadatos como el timestamp, índice original y PID del
- * emisor que lo procesó.
+ * junto con metadatos como el instante de emisión (ns), índice original
+ * y PID del emisor que lo procesó.
  * 
  * @param shm Puntero a la estructura SharedMemory
  * @param slot_index Índice del slot donde guardar el carácter
@@ -108,8 +78,8 @@ void store_character(SharedMemory* shm, int slot_index, unsigned char encrypted_
     
     slot->ascii_value = encrypted_char;
     slot->slot_index = slot_index + 1;
-    slot->timestamp = time(NULL);
     slot->is_valid = 1;
     slot->text_index = text_index;
     slot->emisor_pid = emisor_pid;
+    slot->emit_ns = worker_stats_now_ns();  // Origen de la latencia extremo a extremo
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef GROUPS_H
+#define GROUPS_H
+
+#include <semaphore.h>
+#include "structures.h"
+#include "queue_operations.h"
+
+/*
+ * Difusión del receptor (shm->group_count > 0, ver ReceptorGroup):
+ *  - group_take_option: quita "--group G" de argv; -1 si no se pidió
+ *    (error = 1 si G no es un número).
+ *  - group_join: valida el grupo contra el segmento y cuenta al receptor.
+ *  - group_claim: con un token del semáforo del grupo, reclama la próxima
+ *    publicación del anillo. slot_index -1 si es el fin de flujo del grupo.
+ *  - group_release: marca la publicación como terminada por el grupo y
+ *    devuelve a los emisores, en orden, los slots que ya terminaron todos.
+ */
+int      group_take_option(int* argc, char* argv[], int* error);
+int      group_join(SharedMemory* shm, int group);
+SlotInfo group_claim(SharedMemory* shm, int group, uint32_t* seq);
+void     group_release(SharedMemory* shm, int group, uint32_t seq, sem_t* sem_decrypt_queue,
+                       sem_t* sem_encrypt_queue, sem_t* sem_encrypt_spaces);
+
+#endif // GROUPS_H
@@ -0,0 +1,23 @@
+#ifndef INTEGRITY_H
+#define INTEGRITY_H
+
+#include "structures.h"
+
+/*
+ * CRC32C incremental de lo que escribe el receptor (ver structures.h):
+ *  - integrity_bind: prepara la tabla de desplazamientos y adopta los
+ *    resúmenes de la SHM (ERROR si no hay memoria para la tabla; el
+ *    receptor sigue funcionando sin registrar). Se vuelve a llamar en
+ *    cada lote nuevo del modo demonio. Con difusión usa los resúmenes del
+ *    grupo group (sin difusión se ignora).
+ *  - integrity_record: suma un byte escrito en text_index a su bloque
+ *    (acumulado localmente mientras siga en el mismo bloque).
+ *  - integrity_flush: vuelca lo acumulado a la SHM. Se llama al terminar y
+ *    antes de contar un carácter del lote en modo demonio, porque el
+ *    demonio verifica los resúmenes en cuanto el lote está completo.
+ */
+int  integrity_bind(SharedMemory* shm, int group);
+void integrity_record(int text_index, unsigned char ch);
+void integrity_flush(void);
+
+#endif // INTEGRITY_H
@@ -0,0 +1,31 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stddef.h>
+#include "structures.h"
+
+/*
+ * Trabajos del receptor (ver Job en structures.h):
+ *  - jobs_bind: adopta la tabla de la SHM (ERROR si no hay memoria para
+ *    los descriptores).
+ *  - jobs_locate: trabajo de un text_index (recuerda el último).
+ *  - jobs_get: entrada de la tabla.
+ *  - jobs_output_fd: descriptor de la salida del trabajo; la abre al
+ *    primer uso y mantiene a lo sumo JOBS_MAX_OPEN abiertas.
+ *  - jobs_record_written: suma un byte escrito al trabajo.
+ *  - jobs_stream_finish: en streaming, ajusta la salida al total definitivo
+ *    (se llama en el fin de flujo).
+ *  - jobs_close_all: cierra las salidas abiertas (en modo demonio, antes
+ *    de volver a llamar a jobs_bind con la tabla del lote nuevo).
+ */
+#define JOBS_MAX_OPEN 64
+
+int        jobs_bind(SharedMemory* shm);
+int        jobs_locate(int text_index);
+const Job* jobs_get(int job);
+int        jobs_output_fd(int job, char* out_path, size_t out_path_sz);
+void       jobs_record_written(int job);
+int        jobs_stream_finish(SharedMemory* shm);
+void       jobs_close_all(void);
+
+#endif // JOBS_H
@@ -0,0 +1,18 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include "structures.h"
+#include "queue_operations.h"
+
+/*
+ * Modo carriles del receptor (shm->lane_count > 0, ver structures.h):
+ *  - lane_claim: con un token de DECRYPT_ITEMS en la mano, reclama un ítem
+ *    empezando por el carril home y robando de los demás. slot_index -1
+ *    sólo si end_of_stream ya estaba activo (el token es el marcador).
+ *  - lane_release_slot: devuelve el slot al emisor del carril y lo
+ *    despierta si espera.
+ */
+SlotInfo lane_claim(SharedMemory* shm, int home, int* lane_idx);
+void     lane_release_slot(SharedMemory* shm, int lane_idx, int slot_index);
+
+#endif // LANES_H
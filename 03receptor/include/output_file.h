@@ -5,13 +5,17 @@
 
 // Abre/crea el archivo de salida en ./out/<basename>.dec.txt
 // - Si RECEPTOR_OUT_DIR está definido, usa ese directorio.
-// - Pre-dimensiona el archivo a file_size (ftruncate) para escritura aleatoria.
+// - Pre-dimensiona el archivo a file_size (ftruncate) para escritura aleatoria;
+//   file_size < 0 (tamaño desconocido) lo deja como está.
 // - Devuelve el fd o -1 en error. out_path se llena con la ruta final usada.
 int open_output_file(const char* shm_input_filename,
                      int file_size,
                      char* out_path,
                      size_t out_path_sz);
 
+// Difusión: el grupo G > 0 escribe <basename>.g<G>.txt (el grupo 0, el nombre de siempre).
+void output_file_set_group(int group);
+
 // Escribe un byte en la posición 'index' (seguro entre procesos).
 int write_decoded_char(int fd, int index, unsigned char ch);
 
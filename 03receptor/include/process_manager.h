@@ -8,8 +8,22 @@
 int register_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global);
 int unregister_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global);
 
-// NUEVO: Guardar estadísticas al finalizar
-void save_receptor_stats(SharedMemory* shm, pid_t pid, int chars_received,
-                        time_t start_time, time_t end_time, sem_t* sem_global);
+// Reserva el bloque de estadísticas propio del receptor
+WorkerStats* claim_receptor_stats(SharedMemory* shm, pid_t pid, sem_t* sem_global);
+
+// Tras despertar de un semáforo de conteo: 1 si hay que terminar (reenvía el token).
+// Inline: el emisor tiene la misma y 09lanzador enlaza a los dos.
+static inline int relay_shutdown(SharedMemory* shm, sem_t* sem) {
+    if (!__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return 0;
+    __atomic_add_fetch(&shm->shutdown_relays, 1, __ATOMIC_RELAXED);
+    sem_post(sem);
+    return 1;
+}
+
+// Token de DECRYPT_ITEMS sin item en la cola: 1 si es el fin de flujo (lo reenvía)
+int relay_end_of_stream(SharedMemory* shm, sem_t* sem_decrypt_items);
+
+// Modo demonio: cuenta un carácter escrito; el último del lote avisa al demonio
+void batch_record_written(SharedMemory* shm, uint32_t batch);
 
 #endif
\ No newline at end of file
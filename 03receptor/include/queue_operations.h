@@ -3,8 +3,8 @@
 // NOTA: Las funciones de modificación de colas deben llamarse
 //       con el semáforo mutex correspondiente ya tomado
 
-#ifndef QUEUE_OPERATIONS_H
-#define QUEUE_OPERATIONS_H
+#ifndef RECEPTOR_QUEUE_OPERATIONS_H
+#define RECEPTOR_QUEUE_OPERATIONS_H
 
 #include "structures.h"
 
@@ -41,4 +41,4 @@ SlotInfo dequeue_decrypt_slot_ordered(SharedMemory* shm);
  */
 int enqueue_encrypt_slot(SharedMemory* shm, int slot_index);
 
-#endif // QUEUE_OPERATIONS_H
\ No newline at end of file
+#endif // RECEPTOR_QUEUE_OPERATIONS_H
\ No newline at end of file
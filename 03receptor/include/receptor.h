@@ -0,0 +1,36 @@
+#ifndef RECEPTOR_H
+#define RECEPTOR_H
+
+#include <semaphore.h>
+#include "structures.h"
+
+/* Semáforos de la instancia, ya abiertos por quien llama */
+typedef struct {
+    sem_t* global;
+    sem_t* encrypt_queue;
+    sem_t* decrypt_queue;
+    sem_t* encrypt_spaces;
+    sem_t* decrypt_items;      // Con difusión, el GROUP_ITEMS del grupo propio
+} ReceptorSems;
+
+typedef struct {
+    int           mode;             // MODE_AUTO o MODE_MANUAL
+    int           has_custom_key;   // 0 = la clave de cada trabajo
+    unsigned char custom_key;
+    int           delay_ms;         // Retardo por carácter en modo AUTO
+    int           group;            // Grupo de la difusión (0 sin difusión)
+    const char*   sink_dest;        // --sink: destino de la salida ordenada (NULL = ninguno)
+} ReceptorOptions;
+
+/*
+ * Cuerpo del receptor, separado de main para que 09lanzador lo corra en
+ * un hijo de fork sin exec:
+ *  - receptor_run: instala SIGINT/SIGTERM/SIGUSR1, se registra, prepara la
+ *    salida, recibe hasta el fin de flujo o la finalización, vuelca los
+ *    resúmenes de integridad y se desregistra. Quien llama adjunta el
+ *    segmento (con timebase_attach hecho), se une al grupo con group_join
+ *    si hay difusión y abre y cierra los semáforos. SUCCESS o ERROR.
+ */
+int receptor_run(SharedMemory* shm, const ReceptorSems* sems, const ReceptorOptions* opt);
+
+#endif // RECEPTOR_H
@@ -1,6 +1,6 @@
 // shared_memory_access.h
-// Funciones para adjuntar/desadjuntar memoria compartida System V
-// y acceder a los slots del buffer circular
+// Acceso a los slots del buffer circular en la memoria compartida System V
+// (adjuntar/desadjuntar está en main.c)
 
 #ifndef SHARED_MEMORY_ACCESS_H
 #define SHARED_MEMORY_ACCESS_H
@@ -9,22 +9,6 @@
 #include <sys/ipc.h>
 #include "structures.h"
 
-/**
- * attach_shared_memory - Conecta el proceso a la memoria compartida existente
- * @key: Clave System V (SHM_BASE_KEY)
- * 
- * Retorna: Puntero a SharedMemory o NULL si falla
- */
-SharedMemory* attach_shared_memory(key_t key);
-
-/**
- * detach_shared_memory - Desconecta el proceso de la memoria compartida
- * @shm: Puntero a la memoria compartida
- * 
- * Retorna: SUCCESS o ERROR
- */
-int detach_shared_memory(SharedMemory* shm);
-
 /**
  * get_buffer_pointer - Obtiene puntero al array de CharacterSlot
  * @shm: Puntero a la memoria compartida
@@ -0,0 +1,28 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <signal.h>
+#include "structures.h"
+
+/*
+ * Salida ordenada (inicializador --sink): cada receptor deja su byte en la
+ * ventana de reordenamiento de la SHM y un único receptor, el dueño del
+ * destino, lo envía en orden de text_index a la salida estándar, un FIFO,
+ * un archivo o un socket Unix:
+ *  - sink_take_option: quita "--sink DESTINO" de argv (NULL si no está);
+ *    con "-" reserva la salida estándar y los mensajes pasan a la de error,
+ *    así que se llama antes de imprimir nada.
+ *  - sink_open: abre el destino ("-" = la salida estándar reservada;
+ *    "unix:RUTA" = socket; otra ruta = FIFO o archivo, truncado).
+ *  - sink_put: deja un byte en la ventana (todos los receptores).
+ *  - sink_start: toma el destino (sink_pid) y lanza el hilo volcador.
+ *  - sink_finish: espera a que el volcador envíe todo (o lo corta si hay
+ *    que terminar), cierra el destino y lo libera.
+ */
+const char* sink_take_option(int* argc, char* argv[], int* error);
+int  sink_open(const char* dest);
+void sink_put(SharedMemory* shm, int text_index, unsigned char ch);
+int  sink_start(SharedMemory* shm, int fd, volatile sig_atomic_t* stop);
+void sink_finish(SharedMemory* shm);
+
+#endif // SINK_H
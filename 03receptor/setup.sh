@@ -12,12 +12,41 @@ CYAN='\033[0;36m'
 RESET='\033[0m'
 BOLD='\033[1m'
 
+# Instancia: "./setup.sh --instance NOMBRE" o IPC_INSTANCE. Los programas
+# y los make lanzados desde el menú la heredan por el entorno.
+if [ "$1" = "--instance" ] && [ -n "$2" ]; then
+    export IPC_INSTANCE="$2"
+fi
+INSTANCE="${IPC_INSTANCE:-}"
+
+# Clave System V y semáforos de la instancia (misma derivación que src/instance.c)
+shm_key() {
+    if [ -z "$INSTANCE" ]; then
+        echo 0x00001234
+        return
+    fi
+    local h=2166136261 c
+    for c in $(printf '%s' "$INSTANCE" | od -An -tu1); do
+        h=$(( ((h ^ c) * 16777619) & 0xffffffff ))
+    done
+    printf '0x%08x' $(( (h & 0x7fffffff) | 0x10000 ))
+}
+
+sem_files() {
+    local s suffix=""
+    [ -n "$INSTANCE" ] && suffix=".$INSTANCE"
+    for s in global_mutex encrypt_queue decrypt_queue encrypt_spaces decrypt_items; do
+        echo "/dev/shm/sem.sem_${s}${suffix}"
+    done
+}
+
 show_banner() {
     clear
     echo -e "${BOLD}${CYAN}╔════════════════════════════════════════════════════════════╗${RESET}"
     echo -e "${BOLD}${CYAN}║                SETUP - RECEPTOR DEL SISTEMA IPC            ║${RESET}"
     echo -e "${BOLD}${CYAN}║         Sistema de Comunicación entre Procesos             ║${RESET}"
     echo -e "${BOLD}${CYAN}╚════════════════════════════════════════════════════════════╝${RESET}"
+    [ -n "$INSTANCE" ] && echo -e "${CYAN}Instancia: ${INSTANCE}${RESET}"
     echo ""
 }
 
@@ -219,11 +248,11 @@ check_system() {
     echo ""
     
     echo -e "${YELLOW}→ Memoria compartida:${RESET}"
-    ipcs -m | grep -E "0x00001234|key" || echo "  No encontrada - ejecute el inicializador"
+    ipcs -m | grep -E "$(shm_key)|key" || echo "  No encontrada - ejecute el inicializador"
     
     echo ""
     echo -e "${YELLOW}→ Semáforos POSIX:${RESET}"
-    ls -l /dev/shm/sem.* 2>/dev/null || echo "  No encontrados - ejecute el inicializador"
+    ls -l $(sem_files) 2>/dev/null || echo "  No encontrados - ejecute el inicializador"
     
     echo ""
     echo -e "${YELLOW}→ Receptores activos:${RESET}"
@@ -301,7 +330,7 @@ quick_test() {
     fi
     
     echo -e "${CYAN}→ Verificando memoria compartida...${RESET}"
-    if ipcs -m | grep 0x1234 > /dev/null; then
+    if ipcs -m | grep -q "$(shm_key)"; then
         echo -e "${GREEN}✓ Memoria compartida OK${RESET}"
     else
         echo -e "${RED}✗ Ejecute el inicializador primero${RESET}"
@@ -309,7 +338,7 @@ quick_test() {
     fi
     
     echo -e "${CYAN}→ Verificando semáforos...${RESET}"
-    if ls /dev/shm/sem.* 2>/dev/null > /dev/null; then
+    if ls $(sem_files) > /dev/null 2>&1; then
         echo -e "${GREEN}✓ Semáforos OK${RESET}"
     else
         echo -e "${RED}✗ Ejecute el inicializador primero${RESET}"
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "groups.h"
+#include "worker_stats.h"
+#include "constants.h"
+
+/**
+ * Módulo de Difusión (receptor)
+ *
+ * Con --groups N la cola de desencriptación es un anillo numerado que
+ * leen N grupos: cada grupo avanza su propio cursor (next) y dentro del
+ * grupo los receptores se reparten las publicaciones con un fetch_add,
+ * sin rotar la cola ni buscar el menor text_index (el orden del archivo
+ * lo da la escritura posicional).
+ *
+ * Una publicación se termina una vez por grupo. Cada receptor marca el
+ * bit de su grupo en bcast_done; el que completa la máscara toma
+ * DECRYPT_QUEUE y devuelve los slots del frente del anillo mientras estén
+ * completos. Así el slot vuelve a los emisores recién cuando el grupo más
+ * lento lo pasó, y las publicaciones vivas siempre son un tramo contiguo
+ * de a lo sumo buffer_size: un emisor nunca pisa una posición pendiente.
+ */
+
+static uint32_t* done_marks(SharedMemory* shm) {
+    return (uint32_t*)((char*)shm + shm->bcast_done_offset);
+}
+
+/**
+ * @brief Quita "--group G" (o "--group=G") de argv
+ *
+ * @param argc Cantidad de argumentos (se actualiza)
+ * @param argv Argumentos (se compactan)
+ * @param error 1 si G falta o no es un número
+ * @return Grupo pedido, o -1 si no se pidió
+ */
+int group_take_option(int* argc, char* argv[], int* error) {
+    const char* val = NULL;
+    int out = 1;
+    *error = 0;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--group") == 0 && i + 1 < *argc) {
+            val = argv[++i];
+        } else if (strncmp(argv[i], "--group=", 8) == 0) {
+            val = argv[i] + 8;
+        } else if (strcmp(argv[i], "--group") == 0) {
+            *error = 1;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argv[out] = NULL;
+    *argc = out;
+    if (!val) {
+        if (*error) fprintf(stderr, RED "[ERROR] --group requiere un número de grupo\n" RESET);
+        return -1;
+    }
+    char* end = NULL;
+    long g = strtol(val, &end, 10);
+    if (!val[0] || *end != '\0' || g < 0 || g >= MAX_GROUPS) {
+        fprintf(stderr, RED "[ERROR] Grupo inválido: '%s' (0..%d)\n" RESET, val, MAX_GROUPS - 1);
+        *error = 1;
+        return -1;
+    }
+    return (int)g;
+}
+
+/**
+ * @brief Une al receptor a un grupo de la difusión
+ *
+ * @param shm Memoria compartida
+ * @param group Grupo (0..group_count - 1)
+ * @return SUCCESS o ERROR si el segmento no tiene ese grupo
+ */
+int group_join(SharedMemory* shm, int group) {
+    if (shm->group_count == 0) {
+        fprintf(stderr, RED "[ERROR] --group requiere un segmento creado con 'inicializador --groups N'\n" RESET);
+        return ERROR;
+    }
+    if (group >= shm->group_count) {
+        fprintf(stderr, RED "[ERROR] El segmento tiene %d grupos (0..%d)\n" RESET,
+                shm->group_count, shm->group_count - 1);
+        return ERROR;
+    }
+    __atomic_add_fetch(&shm->groups[group].receptors, 1, __ATOMIC_RELAXED);
+    return SUCCESS;
+}
+
+/**
+ * @brief Reclama la próxima publicación del grupo
+ *
+ * Los emisores encolan bajo DECRYPT_QUEUE y recién después depositan el
+ * token: con k tokens consumidos por el grupo, las publicaciones 0..k-1
+ * ya están escritas en el anillo, así que el número reclamado siempre es
+ * legible. La posición no se reutiliza hasta que este grupo la termine.
+ *
+ * @param shm Memoria compartida
+ * @param group Grupo del receptor
+ * @param seq Número de publicación reclamado (salida)
+ * @return Slot y text_index, o slot_index -1 si es el fin de flujo
+ */
+SlotInfo group_claim(SharedMemory* shm, int group, uint32_t* seq) {
+    SlotInfo info = { .slot_index = -1, .text_index = -1 };
+    uint32_t n = __atomic_fetch_add(&shm->groups[group].next, 1, __ATOMIC_ACQ_REL);
+    if (n >= (uint32_t)__atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE)) return info;
+
+    const SlotRef* ring = (const SlotRef*)((char*)shm + shm->decrypt_queue.array_offset);
+    SlotRef ref = ring[n % (uint32_t)shm->decrypt_queue.capacity];
+    info.slot_index = ref.slot_index;
+    info.text_index = ref.text_index;
+    *seq = n;
+    return info;
+}
+
+/**
+ * @brief Termina una publicación para el grupo y libera el frente del anillo
+ *
+ * Orden de semáforos: DECRYPT_QUEUE y dentro ENCRYPT_QUEUE. Los emisores
+ * nunca toman uno mientras tienen el otro, así que no hay ciclo.
+ *
+ * @param shm Memoria compartida
+ * @param group Grupo del receptor
+ * @param seq Publicación terminada (la de group_claim)
+ * @param sem_decrypt_queue Mutex de la cola de desencriptación (anillo)
+ * @param sem_encrypt_queue Mutex de la cola de slots libres
+ * @param sem_encrypt_spaces Semáforo de slots libres de los emisores
+ */
+void group_release(SharedMemory* shm, int group, uint32_t seq, sem_t* sem_decrypt_queue,
+                   sem_t* sem_encrypt_queue, sem_t* sem_encrypt_spaces) {
+    Queue* q = &shm->decrypt_queue;
+    uint32_t cap = (uint32_t)q->capacity;
+    uint32_t all = (1u << shm->group_count) - 1;
+    uint32_t* done = done_marks(shm);
+
+    __atomic_add_fetch(&shm->groups[group].written, 1, __ATOMIC_RELAXED);
+    if (__atomic_or_fetch(&done[seq % cap], 1u << group, __ATOMIC_ACQ_REL) != all) return;
+
+    // Sólo avanza el frente: si esta publicación no es la más vieja, la
+    // libera quien complete la que falta (y de paso ésta)
+    stats_sem_wait(SEM_IDX_DECRYPT_QUEUE, sem_decrypt_queue);
+    SlotRef* ring = (SlotRef*)((char*)shm + q->array_offset);
+    CharacterSlot* buffer = (CharacterSlot*)((char*)shm + shm->buffer_offset);
+    uint32_t r = shm->bcast_reclaimed;
+    int freed = 0;
+    while (q->size > 0 && __atomic_load_n(&done[r % cap], __ATOMIC_ACQUIRE) == all) {
+        int slot_index = ring[q->head].slot_index;   // q->head == r % cap
+        done[r % cap] = 0;
+        buffer[slot_index].is_valid = 0;
+        buffer[slot_index].ascii_value = 0;
+
+        seq_write_begin(&q->seq);
+        q->head = (q->head + 1) % q->capacity;
+        q->size--;
+        seq_write_end(&q->seq);
+        r++;
+
+        if (freed++ == 0) stats_sem_wait(SEM_IDX_ENCRYPT_QUEUE, sem_encrypt_queue);
+        enqueue_encrypt_slot(shm, slot_index);
+    }
+    __atomic_store_n(&shm->bcast_reclaimed, r, __ATOMIC_RELEASE);
+    if (freed > 0) sem_post(sem_encrypt_queue);
+    sem_post(sem_decrypt_queue);
+    for (int i = 0; i < freed; i++) sem_post(sem_encrypt_spaces);
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
+#include "jobs.h"
+#include "output_file.h"
+#include "constants.h"
+
+/**
+ * Módulo de Trabajos (receptor)
+ *
+ * Con varios trabajos cada carácter va al archivo de salida de su trabajo,
+ * en la posición text_index - start. Los descriptores se abren al primer
+ * carácter de cada trabajo: un receptor sólo abre las salidas que toca.
+ * Como los índices avanzan casi en orden, al superar JOBS_MAX_OPEN se
+ * cierra la salida abierta hace más tiempo (si vuelve a hacer falta se
+ * reabre sin truncar). En streaming la longitud crece mientras se escribe:
+ * la salida no se pre-dimensiona y se ajusta al total en el fin de flujo.
+ */
+
+static Job* g_jobs = NULL;
+static int  g_count = 0;
+static int* g_fds = NULL;             // g_fds[job] = descriptor o -1
+static int  g_open[JOBS_MAX_OPEN];    // Trabajos con salida abierta (anillo)
+static int  g_open_count = 0;
+static int  g_open_next = 0;          // Próxima posición del anillo a reemplazar
+static int  g_last = -1;
+static int  g_stream = 0;
+
+int jobs_bind(SharedMemory* shm) {
+    g_jobs = (Job*)((char*)shm + shm->jobs_offset);
+    g_count = shm->job_count;
+    g_last = -1;
+    g_stream = shm->stream;
+    g_fds = malloc((size_t)(g_count > 0 ? g_count : 1) * sizeof(int));
+    if (!g_fds) return ERROR;
+    for (int i = 0; i < g_count; i++) g_fds[i] = -1;
+    return SUCCESS;
+}
+
+int jobs_locate(int text_index) {
+    if (g_last >= 0 && text_index >= g_jobs[g_last].start &&
+        text_index < g_jobs[g_last].start + g_jobs[g_last].length) {
+        return g_last;
+    }
+    int job = job_find(g_jobs, g_count, text_index);
+    if (job >= 0) g_last = job;
+    return job;
+}
+
+const Job* jobs_get(int job) {
+    return &g_jobs[job];
+}
+
+int jobs_output_fd(int job, char* out_path, size_t out_path_sz) {
+    if (g_fds[job] >= 0) return g_fds[job];
+
+    char path[PATH_MAX];
+    if (!out_path) {
+        out_path = path;
+        out_path_sz = sizeof(path);
+    }
+    int fd = open_output_file(g_jobs[job].input_filename, g_stream ? -1 : g_jobs[job].length,
+                              out_path, out_path_sz);
+    if (fd == -1) return -1;
+
+    if (g_open_count == JOBS_MAX_OPEN) {
+        int victim = g_open[g_open_next];
+        close_output_file(g_fds[victim]);
+        g_fds[victim] = -1;
+    } else {
+        g_open_count++;
+    }
+    g_open[g_open_next] = job;
+    g_open_next = (g_open_next + 1) % JOBS_MAX_OPEN;
+    g_fds[job] = fd;
+    return fd;
+}
+
+void jobs_record_written(int job) {
+    __atomic_fetch_add(&g_jobs[job].chars_written, 1, __ATOMIC_RELAXED);
+}
+
+int jobs_stream_finish(SharedMemory* shm) {
+    if (!g_stream || g_count < 1 || g_fds[0] < 0) return SUCCESS;
+    // También recorta lo que quedara de una corrida anterior más larga
+    if (ftruncate(g_fds[0], (off_t)__atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE)) == -1) {
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+void jobs_close_all(void) {
+    for (int i = 0; i < g_open_count; i++) {
+        int job = g_open[i];
+        close_output_file(g_fds[job]);
+        g_fds[job] = -1;
+    }
+    g_open_count = 0;
+    g_open_next = 0;
+    free(g_fds);
+    g_fds = NULL;
+}
@@ -0,0 +1,84 @@
+#include <sched.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "lanes.h"
+
+/**
+ * Módulo de Carriles (receptor)
+ *
+ * Cada carril tiene un único productor, así que reclamar un ítem es un
+ * CAS sobre head: no hay cola compartida ni búsqueda del menor
+ * text_index. El orden del archivo lo garantiza la escritura posicional
+ * (pwrite en text_index), no el orden de extracción.
+ *
+ * Cada receptor empieza por su carril propio (home) para repartir la
+ * carga y sólo roba de los demás cuando el suyo está vacío.
+ */
+
+static SlotInfo lane_scan(SharedMemory* shm, int home, int* lane_idx) {
+    SlotInfo info = { .slot_index = -1, .text_index = -1 };
+    int n = shm->lane_count;
+    CharacterSlot* buffer = (CharacterSlot*)((char*)shm + shm->buffer_offset);
+
+    for (int k = 0; k < n; k++) {
+        int li = (home + k) % n;
+        Lane* lane = &shm->lanes[li];
+        uint32_t h = __atomic_load_n(&lane->head, __ATOMIC_RELAXED);
+        while ((int32_t)(__atomic_load_n(&lane->tail, __ATOMIC_ACQUIRE) - h) > 0) {
+            if (__atomic_compare_exchange_n(&lane->head, &h, h + 1, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                // El slot es nuestro hasta lane_release_slot: el emisor no lo reescribe
+                info.slot_index = lane->first_slot + (int)(h % (uint32_t)lane->capacity);
+                info.text_index = buffer[info.slot_index].text_index;
+                *lane_idx = li;
+                return info;
+            }
+        }
+    }
+    return info;
+}
+
+/**
+ * @brief Reclama un ítem de algún carril
+ *
+ * Quien tiene un token de DECRYPT_ITEMS tiene garantizado un ítem
+ * publicado sin reclamar, pero si otro receptor tomó "el suyo" puede
+ * que el ítem que le corresponde a éste todavía no sea visible: en ese
+ * caso se cede el CPU y se vuelve a recorrer (ventana de nanosegundos).
+ * Si end_of_stream se leyó activo ANTES de recorrer, todos los ítems ya
+ * eran visibles: no encontrar ninguno significa que el token es el
+ * marcador de fin de flujo.
+ *
+ * @param shm Memoria compartida
+ * @param home Carril por el que empezar
+ * @param lane_idx Carril del ítem reclamado (salida)
+ * @return Slot y text_index, o slot_index -1 si es el fin de flujo
+ */
+SlotInfo lane_claim(SharedMemory* shm, int home, int* lane_idx) {
+    for (;;) {
+        int eos = __atomic_load_n(&shm->end_of_stream, __ATOMIC_ACQUIRE);
+        SlotInfo info = lane_scan(shm, home, lane_idx);
+        if (info.slot_index >= 0 || eos) return info;
+        sched_yield();
+    }
+}
+
+/**
+ * @brief Libera el slot para el emisor del carril
+ *
+ * Orden secuencialmente consistente frente a lane_acquire_slot del
+ * emisor: limpiar is_valid, incrementar freed y recién entonces mirar
+ * producer_waiting. O el emisor ve el slot libre, o éste lo ve esperando.
+ */
+void lane_release_slot(SharedMemory* shm, int lane_idx, int slot_index) {
+    Lane* lane = &shm->lanes[lane_idx];
+    CharacterSlot* slot = (CharacterSlot*)((char*)shm + shm->buffer_offset) + slot_index;
+    slot->ascii_value = 0;
+    __atomic_store_n(&slot->is_valid, 0, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&lane->freed, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&lane->producer_waiting, __ATOMIC_SEQ_CST)) {
+        syscall(SYS_futex, &lane->freed, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
@@ -26,49 +26,89 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#include <signal.h>
-#include <time.h>
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 #include <semaphore.h>
 #include <fcntl.h>
-#include <limits.h>
 
 #include "constants.h"
 #include "structures.h"
-#include "shared_memory_access.h"
-#include "queue_operations.h"
-#include "decoder.h"
-#include "process_manager.h"
-#include "output_file.h"
+#include "receptor.h"
+#include "sink.h"
+#include "timebase.h"
+#include "groups.h"
+#include "instance.h"
 
 // =============================================================================
-// VARIABLES GLOBALES (para limpieza ordenada al recibir señales)
+// MEMORIA COMPARTIDA
 // =============================================================================
 
-static volatile sig_atomic_t should_terminate = 0;
-
-// Handles a memoria compartida y semáforos POSIX
-static SharedMemory* g_shm = NULL;
-static sem_t* g_sem_global        = NULL;
-static sem_t* g_sem_encrypt_queue = NULL;
-static sem_t* g_sem_decrypt_queue = NULL;
-static sem_t* g_sem_encrypt_spaces= NULL;
-static sem_t* g_sem_decrypt_items = NULL;
+/**
+ * Conecta el proceso a la memoria compartida creada por el inicializador
+ */
+/**
+ * @brief Conecta el proceso a la memoria compartida existente
+ * 
+ * Localiza y se conecta al segmento de memoria compartida usando la clave
+ * proporcionada. Realiza verificaciones básicas de integridad para
+ * asegurar que la memoria está correctamente inicializada. Vive en main.c
+ * porque 09lanzador enlaza el resto del receptor junto al inicializador,
+ * que tiene la suya.
+ * 
+ * @param key Clave IPC que identifica el segmento de memoria
+ * @return Puntero a la memoria compartida o NULL en caso de error
+ */
+static SharedMemory* attach_shared_memory(key_t key) {
+    // Obtener ID del segmento existente
+    int shmid = shmget(key, 0, 0);
+    if (shmid == -1) {
+        fprintf(stderr, RED "[ERROR] No se encontró memoria compartida con key 0x%04X: %s\n" RESET,
+                key, strerror(errno));
+        return NULL;
+    }
+    
+    // Adjuntar el segmento a nuestro espacio de direcciones
+    SharedMemory* shm = (SharedMemory*)shmat(shmid, NULL, 0);
+    if (shm == (void*)-1) {
+        fprintf(stderr, RED "[ERROR] shmat falló: %s\n" RESET, strerror(errno));
+        return NULL;
+    }
+    
+    // Verificación básica de integridad
+    if (shm->buffer_size <= 0 || shm->file_capacity <= 0) {
+        fprintf(stderr, RED "[ERROR] Memoria compartida corrupta o no inicializada\n" RESET);
+        shmdt(shm);
+        return NULL;
+    }
+    
+    return shm;
+}
 
-// =============================================================================
 /**
- * @brief Manejador de señales para finalización elegante
+ * Desconecta el proceso de la memoria compartida
+ * NOTA: Esto NO destruye el segmento, solo desadjunta el proceso
+ */
+/**
+ * @brief Desconecta el proceso de la memoria compartida
  * 
- * Este manejador es llamado cuando el proceso recibe SIGINT (Ctrl+C),
- * SIGTERM o SIGUSR1. Establece una bandera atómica que indica al bucle
- * principal que debe terminar de manera ordenada.
+ * Desvincula el proceso del segmento de memoria compartida.
+ * Esto no destruye el segmento, solo elimina el mapeo en el
+ * espacio de direcciones del proceso actual.
  * 
- * @param sig Número de señal recibida (no usado)
+ * @param shm Puntero a la memoria compartida a desconectar
+ * @return SUCCESS en caso de éxito, ERROR en caso contrario
  */
-static void on_signal(int sig) {
-    (void)sig;
-    should_terminate = 1;  // Bandera atómica para salir del bucle principal
+static int detach_shared_memory(SharedMemory* shm) {
+    if (!shm) return SUCCESS;
+    
+    if (shmdt(shm) == -1) {
+        fprintf(stderr, RED "[ERROR] shmdt: %s\n" RESET, strerror(errno));
+        return ERROR;
+    }
+    
+    return SUCCESS;
 }
 
 // =============================================================================
@@ -115,26 +155,6 @@ static unsigned char parse_key_opt(const char* s, int* has_custom) {
     return 0;
 }
 
-/**
- * @brief Formatea un timestamp UNIX para display
- * 
- * Convierte un timestamp UNIX en una cadena de hora legible
- * en formato HH:MM:SS usando la zona horaria local.
- * 
- * @param t Timestamp UNIX a formatear
- * @param buf Buffer donde escribir el resultado
- * @param n Tamaño del buffer (debe ser >= 20)
- */
-static void pretty_time(time_t t, char* buf, size_t n) {
-    if (!buf || n < 20) return;
-    struct tm* tm = localtime(&t);
-    if (!tm) {
-        snprintf(buf, n, "--:--:--");
-        return;
-    }
-    strftime(buf, n, "%H:%M:%S", tm);
-}
-
 /**
  * @brief Parsea un entero no negativo (delay en ms)
  * 
@@ -170,60 +190,6 @@ static void print_banner(void) {
     printf("\n");
 }
 
-/**
- * @brief Muestra información detallada del carácter recibido
- * 
- * Imprime un cuadro informativo que muestra:
- * - PID del receptor
- * - Índice del carácter en el texto original
- * - Slot de memoria usado
- * - Valor encriptado y desencriptado del carácter
- * - Timestamp de inserción y PID del emisor
- * - Estado actual de las colas
- * 
- * @param shm Puntero a la memoria compartida
- */
-static void print_reception_box(SharedMemory* shm,
-                                int slot_index,
-                                int text_index,
-                                unsigned char encrypted,
-                                char plain,
-                                time_t inserted_at,
-                                pid_t emisor_pid)
-{
-    // Formatear timestamp y representación del carácter
-    char ts[32];
-    pretty_time(inserted_at, ts, sizeof ts);
-    
-    char disp[8];
-    safe_char_repr(plain, disp, sizeof disp);
-    
-    // Estado actual de las colas
-    int enc_free = shm->encrypt_queue.size;
-    int dec_items = shm->decrypt_queue.size;
-    
-    const char* color = BLUE;
-    
-    printf("%s╔════════════════════════════════════════════════════╗\n", color);
-    printf(  "║               CARÁCTER RECIBIDO                    ║\n");
-    printf(  "╠════════════════════════════════════════════════════╣\n");
-    printf(  "║%s PID Receptor: %-6d                               %s║\n", 
-             RESET, getpid(), color);
-    printf(  "║%s Índice texto: %-6d / %-6d                      %s║\n", 
-             RESET, text_index, shm->total_chars_in_file, color);
-    printf(  "║%s Slot memoria: %-3d                                  %s║\n", 
-             RESET, slot_index + 1, color);
-    printf(  "║%s Encriptado:  0x%02X                                  %s║\n", 
-             RESET, encrypted, color);
-    printf(  "║%s Desencript.: '%-4s' (0x%02X)                         %s║\n", 
-             RESET, disp, (unsigned char)plain, color);
-    printf(  "║%s Insertado:   %-8s  Emisor PID: %-6d          %s║\n", 
-             RESET, ts, (int)emisor_pid, color);
-    printf(  "║%s Colas: [Libres: %3d] [Con datos: %3d]              %s║\n", 
-             RESET, enc_free, dec_items, color);
-    printf(  "╚════════════════════════════════════════════════════╝\n" RESET);
-}
-
 // =============================================================================
 // AYUDA/USO
 // =============================================================================
@@ -240,6 +206,13 @@ static void print_usage(const char* argv0) {
     fprintf(stderr, "Notas:\n");
     fprintf(stderr, "  - <KEY> es 2 hex (ej: AA, ff)\n");
     fprintf(stderr, "  - <MS> es delay en milisegundos (0..%d)\n", MAX_DELAY_MS);
+    fprintf(stderr, "  - IPC_QUIET=1 omite el detalle por carácter\n");
+    fprintf(stderr, "  - --instance NOMBRE (o IPC_INSTANCE) elige la instancia\n");
+    fprintf(stderr, "  - RECEPTOR_OUT_DIR define el directorio de salida (por omisión ./out)\n");
+    fprintf(stderr, "  - --sink DESTINO (inicializador --sink) envía la salida en orden a\n");
+    fprintf(stderr, "    '-' (salida estándar), un FIFO, un archivo o unix:SOCKET\n");
+    fprintf(stderr, "  - --group G (inicializador --groups N) se une al grupo G de la difusión;\n");
+    fprintf(stderr, "    el grupo G > 0 escribe out/<archivo>.g<G>.txt\n");
 }
 
 // =============================================================================
@@ -247,7 +220,15 @@ static void print_usage(const char* argv0) {
 // =============================================================================
 
 int main(int argc, char* argv[]) {
+    // Antes del banner: con "--sink -" la salida estándar lleva sólo datos
+    int sink_error = 0;
+    const char* sink_dest = sink_take_option(&argc, argv, &sink_error);
+    if (sink_error) return EXIT_FAILURE;
+    int group_error = 0;
+    int group_opt = group_take_option(&argc, argv, &group_error);
+    if (group_error) return EXIT_FAILURE;
     print_banner();
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
     
     // =========================================================================
     // PARSEO DE ARGUMENTOS (lógica alineada con Emisor)
@@ -342,40 +323,53 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    // =========================================================================
-    // CONFIGURACIÓN DE SEÑALES
-    // =========================================================================
-    
-    struct sigaction sa;
-    memset(&sa, 0, sizeof sa);
-    sa.sa_handler = on_signal;
-    sigemptyset(&sa.sa_mask);
-    sigaction(SIGINT,  &sa, NULL);
-    sigaction(SIGTERM, &sa, NULL);
-    sigaction(SIGUSR1, &sa, NULL);
-    
     // =========================================================================
     // CONEXIÓN A MEMORIA COMPARTIDA
     // =========================================================================
     
     printf(CYAN "ℹ [RECEPTOR] Conectando a memoria compartida...\n" RESET);
-    SharedMemory* shm = attach_shared_memory(SHM_BASE_KEY);
+    SharedMemory* shm = attach_shared_memory(instance_shm_key());
     if (!shm) {
         fprintf(stderr, RED "[ERROR] No se pudo conectar a SHM. ¿Ejecutaste el inicializador?\n" RESET);
         return EXIT_FAILURE;
     }
-    g_shm = shm;
+    if (instance_check(shm) != SUCCESS) {
+        detach_shared_memory(shm);
+        return EXIT_FAILURE;
+    }
+    if (sink_dest && !shm->sink_window) {
+        fprintf(stderr, RED "[ERROR] --sink requiere un segmento creado con 'inicializador --sink'\n" RESET);
+        detach_shared_memory(shm);
+        return EXIT_FAILURE;
+    }
+    // Con difusión todo receptor pertenece a un grupo (el 0 si no lo pide)
+    int groups = shm->group_count;
+    int my_group = group_opt < 0 ? 0 : group_opt;
+    if ((group_opt >= 0 || groups > 0) && group_join(shm, my_group) != SUCCESS) {
+        detach_shared_memory(shm);
+        return EXIT_FAILURE;
+    }
+    timebase_attach(&shm->timebase);
     
     unsigned char effective_key = has_custom_key ? key : shm->encryption_key;
     
     printf(GREEN "✓ Conectado a SHM\n" RESET);
     printf("  • Buffer size: %d slots\n", shm->buffer_size);
-    printf("  • Archivo fuente: %s (%d bytes)\n", shm->input_filename, shm->total_chars_in_file);
-    printf("  • Clave de desencriptación: 0x%02X\n", effective_key);
+    if (shm->job_count > 1) {
+        printf("  • Trabajos: %d (%d bytes en total)\n", shm->job_count, shm->total_chars_in_file);
+    } else {
+        printf("  • Archivo fuente: %s (%d bytes)\n", shm->input_filename, shm->total_chars_in_file);
+    }
+    if (has_custom_key || shm->job_count <= 1) {
+        printf("  • Clave de desencriptación: 0x%02X\n", effective_key);
+    } else {
+        printf("  • Clave de desencriptación: la de cada trabajo\n");
+    }
     printf("  • Modo: %s\n", mode == MODE_AUTO ? "AUTOMÁTICO" : "MANUAL");
     if (mode == MODE_AUTO) {
         printf("  • Delay: %d ms\n", delay_ms);
     }
+    if (groups > 0) printf("  • Difusión: grupo %d de %d\n", my_group, groups);
     
     // =========================================================================
     // APERTURA DE SEMÁFOROS POSIX
@@ -383,24 +377,27 @@ int main(int argc, char* argv[]) {
     
     printf(CYAN "ℹ [RECEPTOR] Abriendo semáforos POSIX...\n" RESET);
     
-    g_sem_global         = sem_open(SEM_NAME_GLOBAL_MUTEX, 0);
-    g_sem_encrypt_queue  = sem_open(SEM_NAME_ENCRYPT_QUEUE, 0);
-    g_sem_decrypt_queue  = sem_open(SEM_NAME_DECRYPT_QUEUE, 0);
-    g_sem_encrypt_spaces = sem_open(SEM_NAME_ENCRYPT_SPACES, 0);
-    g_sem_decrypt_items  = sem_open(SEM_NAME_DECRYPT_ITEMS, 0);
-    
-    if (g_sem_global == SEM_FAILED || g_sem_encrypt_queue == SEM_FAILED ||
-        g_sem_decrypt_queue == SEM_FAILED || g_sem_encrypt_spaces == SEM_FAILED ||
-        g_sem_decrypt_items == SEM_FAILED) {
+    ReceptorSems sems;
+    sems.global         = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    sems.encrypt_queue  = sem_open(instance_sem(SEM_NAME_ENCRYPT_QUEUE), 0);
+    sems.decrypt_queue  = sem_open(instance_sem(SEM_NAME_DECRYPT_QUEUE), 0);
+    sems.encrypt_spaces = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    // Con difusión los items llegan por el semáforo del grupo
+    sems.decrypt_items  = sem_open(groups > 0 ? instance_sem_n(SEM_NAME_GROUP_ITEMS, my_group)
+                                              : instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+    
+    if (sems.global == SEM_FAILED || sems.encrypt_queue == SEM_FAILED ||
+        sems.decrypt_queue == SEM_FAILED || sems.encrypt_spaces == SEM_FAILED ||
+        sems.decrypt_items == SEM_FAILED) {
         fprintf(stderr, RED "[ERROR] No se pudieron abrir todos los semáforos: %s\n" RESET, 
                 strerror(errno));
         
         // Cleanup parcial
-        if (g_sem_global         && g_sem_global         != SEM_FAILED) sem_close(g_sem_global);
-        if (g_sem_encrypt_queue  && g_sem_encrypt_queue  != SEM_FAILED) sem_close(g_sem_encrypt_queue);
-        if (g_sem_decrypt_queue  && g_sem_decrypt_queue  != SEM_FAILED) sem_close(g_sem_decrypt_queue);
-        if (g_sem_encrypt_spaces && g_sem_encrypt_spaces != SEM_FAILED) sem_close(g_sem_encrypt_spaces);
-        if (g_sem_decrypt_items  && g_sem_decrypt_items  != SEM_FAILED) sem_close(g_sem_decrypt_items);
+        if (sems.global         != SEM_FAILED) sem_close(sems.global);
+        if (sems.encrypt_queue  != SEM_FAILED) sem_close(sems.encrypt_queue);
+        if (sems.decrypt_queue  != SEM_FAILED) sem_close(sems.decrypt_queue);
+        if (sems.encrypt_spaces != SEM_FAILED) sem_close(sems.encrypt_spaces);
+        if (sems.decrypt_items  != SEM_FAILED) sem_close(sems.decrypt_items);
         detach_shared_memory(shm);
         return EXIT_FAILURE;
     }
@@ -408,245 +405,26 @@ int main(int argc, char* argv[]) {
     printf(GREEN "✓ Semáforos abiertos\n" RESET);
     
     // =========================================================================
-    // REGISTRO DEL RECEPTOR
+    // RECEPCIÓN (receptor.c)
     // =========================================================================
     
-    pid_t my_pid = getpid();
-    if (register_receptor(shm, my_pid, g_sem_global) != SUCCESS) {
-        fprintf(stderr, RED "[ERROR] No se pudo registrar el receptor\n" RESET);
-        
-        // Cleanup
-        sem_close(g_sem_global);
-        sem_close(g_sem_encrypt_queue);
-        sem_close(g_sem_decrypt_queue);
-        sem_close(g_sem_encrypt_spaces);
-        sem_close(g_sem_decrypt_items);
-        detach_shared_memory(shm);
-        return EXIT_FAILURE;
-    }
-    
-    // =========================================================================
-    // APERTURA DE ARCHIVO DE SALIDA
-    // =========================================================================
-    
-    char out_path[PATH_MAX];
-    int out_fd = open_output_file(shm->input_filename, shm->total_chars_in_file,
-                                  out_path, sizeof out_path);
-    if (out_fd == -1) {
-        fprintf(stderr, RED "[ERROR] No se pudo preparar archivo de salida: %s\n" RESET, 
-                strerror(errno));
-        unregister_receptor(shm, my_pid, g_sem_global);
-        sem_close(g_sem_global);
-        sem_close(g_sem_encrypt_queue);
-        sem_close(g_sem_decrypt_queue);
-        sem_close(g_sem_encrypt_spaces);
-        sem_close(g_sem_decrypt_items);
-        detach_shared_memory(shm);
-        return EXIT_FAILURE;
-    }
-    
-    printf(GREEN "✓ Archivo de salida: %s\n" RESET, out_path);
-    
-    printf(BOLD GREEN "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
-    printf(BOLD GREEN "║             RECEPTOR PID %6d INICIADO                  ║\n" RESET, my_pid);
-    printf(BOLD GREEN "╚══════════════════════════════════════════════════════════╝\n" RESET);
-    printf("\n");
-    
-    // =========================================================================
-    // BUCLE PRINCIPAL DE RECEPCIÓN
-    // =========================================================================
-    
-    int chars_recv = 0;
-    time_t t0 = time(NULL);
-    
-    while (!should_terminate && !shm->shutdown_flag) {
-        
-        // =====================================================================
-        // VERIFICACIÓN DE FINALIZACIÓN #1 (antes de bloquear)
-        // =====================================================================
-        
-        int should_exit = 0;
-        
-        sem_wait(g_sem_global);
-        if (shm->total_chars_processed >= shm->total_chars_in_file) {
-            // El archivo completo ya fue procesado por los emisores
-            sem_wait(g_sem_decrypt_queue);
-            int queue_empty = (shm->decrypt_queue.size == 0);
-            sem_post(g_sem_decrypt_queue);
-            
-            if (queue_empty) {
-                // No hay datos pendientes por leer
-                should_exit = 1;
-            }
-        }
-        sem_post(g_sem_global);
-        
-        if (should_exit) {
-            printf(YELLOW "\n[RECEPTOR %d] Todos los caracteres procesados y cola vacía\n" RESET, 
-                   getpid());
-            printf(CYAN "  • Total procesado globalmente: %d/%d\n" RESET, 
-                   shm->total_chars_processed, shm->total_chars_in_file);
-            printf(CYAN "  • Recibidos por este receptor: %d\n" RESET, chars_recv);
-            break;
-        }
-        
-        // =====================================================================
-        // PASO 1: Esperar a que haya un item disponible (bloqueante, sin busy wait)
-        // =====================================================================
-        
-        if (sem_wait(g_sem_decrypt_items) != 0) {
-            if (errno == EINTR) {
-                // Interrumpido por señal
-                if (should_terminate || shm->shutdown_flag) break;
-                continue;  // Reintentar
-            }
-            fprintf(stderr, RED "[ERROR] sem_wait(decrypt_items): %s\n" RESET, strerror(errno));
-            break;
-        }
-        
-        // =====================================================================
-        // PASO 2: Extraer elemento de la cola (sección crítica)
-        // =====================================================================
-        
-        sem_wait(g_sem_decrypt_queue);
-        SlotInfo info = dequeue_decrypt_slot_ordered(shm);
-        sem_post(g_sem_decrypt_queue);
-        
-        if (info.slot_index < 0) {
-            // Inconsistencia: el semáforo indicó item pero la cola estaba vacía
-            continue;
-        }
-        
-        // =====================================================================
-        // PASO 3: Leer el slot
-        // =====================================================================
-        
-        CharacterSlot slot;
-        if (get_slot_info(shm, info.slot_index, &slot) != SUCCESS || !slot.is_valid) {
-            // Slot inválido: liberarlo y continuar
-            sem_wait(g_sem_encrypt_queue);
-            enqueue_encrypt_slot(shm, info.slot_index);
-            sem_post(g_sem_encrypt_queue);
-            sem_post(g_sem_encrypt_spaces);
-            continue;
-        }
-        
-        // =====================================================================
-        // PASO 4: Desencriptar el carácter
-        // =====================================================================
-        
-        unsigned char enc = slot.ascii_value;
-        char plain = (char)xor_apply(enc, effective_key);
-        
-        // =====================================================================
-        // PASO 5: Escribir el byte desencriptado al archivo de salida
-        // =====================================================================
-        
-        if (write_decoded_char(out_fd, info.text_index, (unsigned char)plain) != 0) {
-            fprintf(stderr, RED "[ERROR] Escritura de salida falló en índice %d: %s\n" RESET,
-                    info.text_index, strerror(errno));
-        }
-        
-        // =====================================================================
-        // PASO 6: Marcar el slot como libre
-        // =====================================================================
-        
-        CharacterSlot* buf = get_buffer_pointer(shm);
-        if (buf) {
-            buf[info.slot_index].is_valid = 0;
-            buf[info.slot_index].ascii_value = 0;
-        }
-        
-        // =====================================================================
-        // PASO 7: Devolver el slot a la cola de encriptación
-        // =====================================================================
-        
-        sem_wait(g_sem_encrypt_queue);
-        enqueue_encrypt_slot(shm, info.slot_index);
-        sem_post(g_sem_encrypt_queue);
-        sem_post(g_sem_encrypt_spaces);  // Avisar al emisor que hay espacio
-        
-        // =====================================================================
-        // PASO 8: Mostrar información del carácter recibido
-        // =====================================================================
-        
-        print_reception_box(shm, info.slot_index, info.text_index, enc, plain,
-                            slot.timestamp, slot.emisor_pid);
-        chars_recv++;
-
-        // --- NUEVO: aplicar slowdown sólo en modo AUTO y sólo si delay_ms > 0 ---
-        if (mode == MODE_AUTO && delay_ms > 0) {
-            usleep((useconds_t)delay_ms * 1000);
-        }
-        
-        // =====================================================================
-        // VERIFICACIÓN DE FINALIZACIÓN #2 (después de procesar)
-        // =====================================================================
-        
-        sem_wait(g_sem_global);
-        int all_processed = (shm->total_chars_processed >= shm->total_chars_in_file);
-        sem_post(g_sem_global);
-        
-        if (all_processed) {
-            sem_wait(g_sem_decrypt_queue);
-            int queue_empty = (shm->decrypt_queue.size == 0);
-            sem_post(g_sem_decrypt_queue);
-            
-            if (queue_empty) {
-                printf(YELLOW "\n[RECEPTOR %d] Archivo completo procesado\n" RESET, getpid());
-                break;
-            }
-        }
-        
-        // =====================================================================
-        // PASO 9: Control de modo (auto/manual)
-        // =====================================================================
-        
-        if (mode == MODE_MANUAL) {
-            printf(CYAN "\nPresione ENTER para continuar (o Ctrl+C para salir)..." RESET);
-            char tmp[8];
-            errno = 0;
-            if (!fgets(tmp, sizeof tmp, stdin)) {
-                if (errno == EINTR || should_terminate) break;
-            }
-        }
-    }
-    
-    // =========================================================================
-    // RESUMEN Y ESTADÍSTICAS
-    // =========================================================================
-    
-    time_t t1 = time(NULL);
-    int elapsed = (int)(t1 - t0);
-
-    // NUEVO: Guardar estadísticas antes de desregistrar
-    save_receptor_stats(shm, my_pid, chars_recv, t0, t1, g_sem_global);
-    
-    printf(BOLD YELLOW "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
-    printf(BOLD YELLOW "║             RECEPTOR PID %6d FINALIZANDO               ║\n" RESET, my_pid);
-    printf(BOLD YELLOW "╚══════════════════════════════════════════════════════════╝\n" RESET);
-    printf("  • Caracteres recibidos: %d\n", chars_recv);
-    printf("  • Tiempo de ejecución: %d s\n", elapsed);
-    if (elapsed > 0) {
-        printf("  • Velocidad promedio: %.2f chars/s\n", (float)chars_recv / elapsed);
-    }
+    ReceptorOptions opt = { mode, has_custom_key, key, delay_ms, my_group, sink_dest };
+    int rc = receptor_run(shm, &sems, &opt);
     
     // =========================================================================
     // LIMPIEZA Y CIERRE
     // =========================================================================
     
-    close_output_file(out_fd);
-    unregister_receptor(shm, my_pid, g_sem_global);
-    
-    sem_close(g_sem_global);
-    sem_close(g_sem_encrypt_queue);
-    sem_close(g_sem_decrypt_queue);
-    sem_close(g_sem_encrypt_spaces);
-    sem_close(g_sem_decrypt_items);
+    sem_close(sems.global);
+    sem_close(sems.encrypt_queue);
+    sem_close(sems.decrypt_queue);
+    sem_close(sems.encrypt_spaces);
+    sem_close(sems.decrypt_items);
     
     detach_shared_memory(shm);
+    if (rc != SUCCESS) return EXIT_FAILURE;
     
-    printf(GREEN "\n[RECEPTOR %d] Proceso terminado correctamente\n" RESET, my_pid);
+    printf(GREEN "\n[RECEPTOR %d] Proceso terminado correctamente\n" RESET, getpid());
     
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
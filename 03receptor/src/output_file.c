@@ -22,6 +22,12 @@
  *   para reservar el tamaño total (inserciones por offset válidas).
  */
 
+static int g_group = 0;   // Grupo de la difusión (0 = salida de siempre)
+
+void output_file_set_group(int group) {
+    g_group = group;
+}
+
 /**
  * @brief Obtiene el nombre base (basename) de una ruta
  * 
@@ -71,9 +77,10 @@ static int build_output_path(const char* shm_input_filename, char* out_path, siz
     char base[NAME_MAX];
     if (path_basename(shm_input_filename, base, sizeof base) != 0) return -1;
 
-    // Armamos "<basename>.txt"
+    // Armamos "<basename>.txt" (o "<basename>.g<G>.txt" para el grupo G de la difusión)
     char fname[NAME_MAX];
-    int w = snprintf(fname, sizeof fname, "%s.txt", base);
+    int w = g_group > 0 ? snprintf(fname, sizeof fname, "%s.g%d.txt", base, g_group)
+                        : snprintf(fname, sizeof fname, "%s.txt", base);
     if (w <= 0 || (size_t)w >= sizeof fname) return -1;
 
     // Directorio
@@ -89,7 +96,7 @@ int open_output_file(const char* shm_input_filename,
                      char* out_path,
                      size_t out_path_sz)
 {
-    if (!shm_input_filename || file_size < 0 || !out_path || out_path_sz == 0) {
+    if (!shm_input_filename || !out_path || out_path_sz == 0) {
         errno = EINVAL;
         return -1;
     }
@@ -105,6 +112,9 @@ int open_output_file(const char* shm_input_filename,
         return -1;
     }
 
+    // Tamaño desconocido (entrada en streaming): sin pre-dimensionar
+    if (file_size < 0) return fd;
+
     // --- Modificación de metadata para soportar inyecciones posicionales ---
     // Pre-dimensionar: garantiza que los offsets [0..file_size-1] existan.
     if (ftruncate(fd, (off_t)file_size) == -1) {
@@ -9,9 +9,62 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "process_manager.h"
 #include "constants.h"
 
+/**
+ * @brief Avisa al finalizador que un trabajador se desregistró
+ *
+ * Incrementa la palabra futex compartida y despierta a quien espere en
+ * ella (el finalizador cuando pidfd_open no está disponible). Sin
+ * FUTEX_PRIVATE_FLAG: la palabra vive en memoria compartida entre procesos.
+ */
+static void notify_worker_exit(SharedMemory* shm) {
+    __atomic_add_fetch(&shm->workers_exit_seq, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shm->workers_exit_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Reconoce el marcador de fin de flujo (poison pill)
+ *
+ * El emisor que publica el último carácter activa end_of_stream y deposita
+ * un token extra en DECRYPT_ITEMS, detrás de todos los items. Un receptor
+ * que obtiene un token y encuentra la cola vacía tiene ese marcador: lo
+ * reenvía para el siguiente receptor (bloqueado o que llegue después) y
+ * termina. Los receptores no consultan contadores globales por carácter.
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param sem_decrypt_items Semáforo del que se obtuvo el token
+ * @return 1 si hay que terminar (marcador reenviado), 0 si no es el fin
+ */
+int relay_end_of_stream(SharedMemory* shm, sem_t* sem_decrypt_items) {
+    if (!__atomic_load_n(&shm->end_of_stream, __ATOMIC_ACQUIRE)) return 0;
+    __atomic_add_fetch(&shm->eos_relays, 1, __ATOMIC_RELAXED);
+    sem_post(sem_decrypt_items);
+    return 1;
+}
+
+/**
+ * @brief Modo demonio: cuenta un carácter escrito del lote en curso
+ *
+ * Sin fin de flujo, el demonio sabe que el lote terminó por batch_written:
+ * el receptor que escribe el último carácter publica el número de lote en
+ * batch_done y lo despierta (FUTEX_WAKE).
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param batch Lote al que pertenece el carácter (batch_current)
+ */
+void batch_record_written(SharedMemory* shm, uint32_t batch) {
+    uint32_t done = __atomic_add_fetch(&shm->batch_written, 1, __ATOMIC_ACQ_REL);
+    if (done != (uint32_t)__atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE)) return;
+    __atomic_store_n(&shm->batch_done, batch, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shm->batch_done, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
 /**
  * @brief Registra un nuevo proceso receptor
  * 
@@ -28,7 +81,7 @@ int register_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     sem_wait(sem_global);
 
     int ok = 0;
-    for (int i = 0; i < 100; i++) {
+    for (int i = 0; i < MAX_WORKERS; i++) {
         if (shm->receptor_pids[i] == 0) {
             shm->receptor_pids[i] = pid;
             ok = 1;
@@ -61,7 +114,7 @@ int unregister_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     sem_wait(sem_global);
 
     int found = 0;
-    for (int i = 0; i < 100; i++) {
+    for (int i = 0; i < MAX_WORKERS; i++) {
         if (shm->receptor_pids[i] == pid) {
             shm->receptor_pids[i] = 0;
             found = 1;
@@ -70,6 +123,7 @@ int unregister_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
     }
     if (found) {
         shm->active_receptores--;
+        notify_worker_exit(shm);
         printf(YELLOW "[RECEPTOR %d] Desregistrado (%d activos restantes)\n" RESET,
                pid, shm->active_receptores);
     }
@@ -79,33 +133,33 @@ int unregister_receptor(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
 }
 
 /**
- * @brief Guarda las estadísticas de un receptor al finalizar
+ * @brief Reserva el bloque de estadísticas de un receptor
  * 
- * Almacena en la memoria compartida las estadísticas de ejecución
- * de un proceso receptor, incluyendo caracteres procesados y tiempos
- * de inicio y fin.
+ * Asigna al receptor un bloque WorkerStats propio (y el ReceptorLatency
+ * del mismo índice) en la memoria compartida. Los bloques no se reutilizan, de modo que el finalizador
+ * también reporta a los receptores ya terminados. Después de esta
+ * llamada el receptor actualiza sus contadores sin tomar el semáforo global.
  * 
  * @param shm Puntero a la memoria compartida
  * @param pid PID del proceso receptor
- * @param chars_received Número de caracteres procesados por el receptor
- * @param start_time Tiempo de inicio del proceso
- * @param end_time Tiempo de finalización del proceso
  * @param sem_global Semáforo global para sincronización
+ * @return Bloque reservado, o NULL si ya no quedan bloques libres
  */
-void save_receptor_stats(SharedMemory* shm, pid_t pid, int chars_received,
-                        time_t start_time, time_t end_time, sem_t* sem_global) {
-    if (!shm || !sem_global) return;
+WorkerStats* claim_receptor_stats(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
+    if (!shm || !sem_global) return NULL;
     
+    WorkerStats* ws = NULL;
     sem_wait(sem_global);
     
-    if (shm->receptor_stats_count < 100) {
-        int idx = shm->receptor_stats_count;
-        shm->receptor_stats[idx].pid = pid;
-        shm->receptor_stats[idx].chars_processed = chars_received;
-        shm->receptor_stats[idx].start_time = start_time;
-        shm->receptor_stats[idx].end_time = end_time;
+    if (shm->receptor_stats_count < MAX_WORKERS) {
+        ws = &shm->receptor_stats[shm->receptor_stats_count];
+        memset(ws, 0, sizeof(*ws));
+        memset(&shm->receptor_latency[shm->receptor_stats_count], 0, sizeof(ReceptorLatency));
+        ws->pid = pid;
+        ws->in_use = 1;
         shm->receptor_stats_count++;
     }
     
     sem_post(sem_global);
-}
\ No newline at end of file
+    return ws;
+}
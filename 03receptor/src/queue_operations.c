@@ -93,6 +93,8 @@ SlotInfo dequeue_decrypt_slot_ordered(SharedMemory* shm) {
     
     if (best_pos == -1) return info;  // No se encontró (no debería pasar)
     
+    seq_write_begin(&q->seq);
+    
     // Rotar la cola hasta que el mejor elemento quede en head
     // Esto preserva el orden relativo de los demás elementos
     while (q->head != best_pos) {
@@ -108,6 +110,7 @@ SlotInfo dequeue_decrypt_slot_ordered(SharedMemory* shm) {
     info.text_index = arr[q->head].text_index;
     q->head = (q->head + 1) % q->capacity;
     q->size--;
+    seq_write_end(&q->seq);
     
     return info;
 }
@@ -138,12 +141,14 @@ int enqueue_encrypt_slot(SharedMemory* shm, int slot_index) {
     SlotRef* arr = enc_array(shm);
     
     // Agregar el slot libre al final de la cola
+    seq_write_begin(&q->seq);
     arr[q->tail].slot_index = slot_index;
     arr[q->tail].text_index = -1;  // No aplica para slots libres
     
     // Avanzar tail circularmente
     q->tail = (q->tail + 1) % q->capacity;
     q->size++;
+    seq_write_end(&q->seq);
     
     return SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,435 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "constants.h"
+#include "receptor.h"
+#include "shared_memory_access.h"
+#include "queue_operations.h"
+#include "sink.h"
+#include "decoder.h"
+#include "process_manager.h"
+#include "output_file.h"
+#include "worker_stats.h"
+#include "timebase.h"
+#include "integrity.h"
+#include "lanes.h"
+#include "groups.h"
+#include "jobs.h"
+
+/**
+ * Bucle del Receptor
+ *
+ * Todo lo que hace un receptor una vez adjunto al segmento: registrarse,
+ * preparar la salida, tomar items de la cola (o del carril o del grupo),
+ * desencriptarlos, escribirlos y devolver el slot a los emisores. main
+ * (el binario receptor) y 09lanzador (en un hijo de fork) lo llaman con
+ * el segmento y los semáforos ya abiertos.
+ */
+
+static volatile sig_atomic_t should_terminate = 0;
+
+/**
+ * @brief Manejador de señales para finalización elegante
+ * 
+ * Este manejador es llamado cuando el proceso recibe SIGINT (Ctrl+C),
+ * SIGTERM o SIGUSR1. Establece una bandera atómica que indica al bucle
+ * principal que debe terminar de manera ordenada.
+ * 
+ * @param sig Número de señal recibida (no usado)
+ */
+static void on_signal(int sig) {
+    (void)sig;
+    should_terminate = 1;  // Bandera atómica para salir del bucle principal
+}
+
+// =============================================================================
+// DISPLAY
+// =============================================================================
+
+/**
+ * @brief Formatea un timestamp del run para display
+ * 
+ * Convierte un timestamp de la base de tiempo compartida en una cadena
+ * de hora legible en formato HH:MM:SS (zona horaria local cacheada).
+ * 
+ * @param run_ns Timestamp en ns desde la época del run (0 = desconocido)
+ * @param buf Buffer donde escribir el resultado
+ * @param n Tamaño del buffer (debe ser >= 20)
+ */
+static void pretty_time(uint64_t run_ns, char* buf, size_t n) {
+    if (!buf || n < 20) return;
+    if (run_ns == 0) {
+        snprintf(buf, n, "--:--:--");
+        return;
+    }
+    timebase_format_hms(run_ns, buf, n);
+}
+
+/* IPC_QUIET=1 omite el recuadro por carácter (corridas de benchmark) */
+static int quiet_mode(void) {
+    const char* q = getenv("IPC_QUIET");
+    return q && *q && strcmp(q, "0") != 0;
+}
+
+/**
+ * @brief Muestra información detallada del carácter recibido
+ * 
+ * Imprime un cuadro informativo que muestra:
+ * - PID del receptor
+ * - Índice del carácter en el texto original
+ * - Slot de memoria usado
+ * - Valor encriptado y desencriptado del carácter
+ * - Timestamp de inserción y PID del emisor
+ * - Estado actual de las colas
+ * 
+ * @param shm Puntero a la memoria compartida
+ */
+static void print_reception_box(SharedMemory* shm,
+                                int slot_index,
+                                int text_index,
+                                unsigned char encrypted,
+                                char plain,
+                                uint64_t inserted_at,
+                                pid_t emisor_pid)
+{
+    // Formatear timestamp y representación del carácter
+    char ts[32];
+    pretty_time(inserted_at, ts, sizeof ts);
+    
+    char disp[8];
+    safe_char_repr(plain, disp, sizeof disp);
+    
+    // Estado actual de las colas
+    int enc_free = shm->encrypt_queue.size;
+    int dec_items = shm->decrypt_queue.size;
+    
+    const char* color = BLUE;
+    
+    printf("%s╔════════════════════════════════════════════════════╗\n", color);
+    printf(  "║               CARÁCTER RECIBIDO                    ║\n");
+    printf(  "╠════════════════════════════════════════════════════╣\n");
+    printf(  "║%s PID Receptor: %-6d                               %s║\n", 
+             RESET, getpid(), color);
+    printf(  "║%s Índice texto: %-6d / %-6d                      %s║\n", 
+             RESET, text_index, shm->total_chars_in_file, color);
+    printf(  "║%s Slot memoria: %-3d                                  %s║\n", 
+             RESET, slot_index + 1, color);
+    printf(  "║%s Encriptado:  0x%02X                                  %s║\n", 
+             RESET, encrypted, color);
+    printf(  "║%s Desencript.: '%-4s' (0x%02X)                         %s║\n", 
+             RESET, disp, (unsigned char)plain, color);
+    printf(  "║%s Insertado:   %-8s  Emisor PID: %-6d          %s║\n", 
+             RESET, ts, (int)emisor_pid, color);
+    printf(  "║%s Colas: [Libres: %3d] [Con datos: %3d]              %s║\n", 
+             RESET, enc_free, dec_items, color);
+    printf(  "╚════════════════════════════════════════════════════╝\n" RESET);
+}
+
+// =============================================================================
+// BUCLE DEL RECEPTOR
+// =============================================================================
+
+int receptor_run(SharedMemory* shm, const ReceptorSems* sems, const ReceptorOptions* opt) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+    
+    int groups = shm->group_count;
+    int my_group = opt->group;
+    output_file_set_group(groups > 0 ? my_group : 0);
+    unsigned char effective_key = opt->has_custom_key ? opt->custom_key : shm->encryption_key;
+    
+    pid_t my_pid = getpid();
+    if (register_receptor(shm, my_pid, sems->global) != SUCCESS) {
+        fprintf(stderr, RED "[ERROR] No se pudo registrar el receptor\n" RESET);
+        return ERROR;
+    }
+    WorkerStats* my_stats = claim_receptor_stats(shm, my_pid, sems->global);
+    worker_stats_bind(my_stats);
+    worker_stats_bind_latency(my_stats ? &shm->receptor_latency[my_stats - shm->receptor_stats] : NULL);
+    
+    // =========================================================================
+    // APERTURA DE ARCHIVO DE SALIDA
+    // =========================================================================
+    
+    // Con un solo trabajo la salida se abre ya; con varios, al recibir el
+    // primer carácter de cada uno (ver jobs.c)
+    // En modo demonio la salida se abre con el primer carácter del lote
+    // Con salida ordenada no hay archivos: sólo el dueño abre el destino
+    char out_path[PATH_MAX];
+    int out_fd = -1;
+    int daemon_mode = shm->daemon_pid != 0;
+    int sink_mode = shm->sink_window > 0;
+    uint32_t my_batch = batch_current(shm);
+    if (jobs_bind(shm) == SUCCESS) {
+        if (opt->sink_dest) {
+            out_fd = sink_open(opt->sink_dest);
+        } else {
+            out_fd = (shm->job_count > 1 || daemon_mode || sink_mode) ? 0 : jobs_output_fd(0, out_path, sizeof out_path);
+        }
+    }
+    if (opt->sink_dest && out_fd != -1 && sink_start(shm, out_fd, &should_terminate) != SUCCESS) {
+        close(out_fd);
+        out_fd = -1;
+    }
+    if (out_fd == -1) {
+        fprintf(stderr, RED "[ERROR] No se pudo preparar archivo de salida: %s\n" RESET, 
+                strerror(errno));
+        jobs_close_all();
+        unregister_receptor(shm, my_pid, sems->global);
+        return ERROR;
+    }
+    
+    if (daemon_mode) {
+        printf(GREEN "✓ Modo demonio: salidas por lote (lote actual: %u)\n" RESET, my_batch);
+    } else if (opt->sink_dest) {
+        printf(GREEN "✓ Salida ordenada hacia %s (ventana de %d bytes)\n" RESET,
+               strcmp(opt->sink_dest, "-") == 0 ? "la salida estándar" : opt->sink_dest, shm->sink_window);
+    } else if (sink_mode) {
+        printf(GREEN "✓ Salida ordenada: los caracteres van a la ventana del segmento\n" RESET);
+    } else if (shm->stream) {
+        printf(GREEN "✓ Archivo de salida: %s (entrada en streaming)\n" RESET, out_path);
+    } else if (shm->job_count > 1) {
+        printf(GREEN "✓ Salidas: %d archivos, uno por trabajo\n" RESET, shm->job_count);
+    } else {
+        printf(GREEN "✓ Archivo de salida: %s\n" RESET, out_path);
+    }
+    if (integrity_bind(shm, my_group) != SUCCESS) {
+        fprintf(stderr, YELLOW "[ADVERTENCIA] Sin memoria para el CRC32C incremental; "
+                               "el finalizador verá los bloques como faltantes\n" RESET);
+    }
+    
+    printf(BOLD GREEN "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD GREEN "║             RECEPTOR PID %6d INICIADO                  ║\n" RESET, my_pid);
+    printf(BOLD GREEN "╚══════════════════════════════════════════════════════════╝\n" RESET);
+    printf("\n");
+    
+    // =========================================================================
+    // BUCLE PRINCIPAL DE RECEPCIÓN
+    // =========================================================================
+    
+    int chars_recv = 0;
+    int quiet = quiet_mode();
+    int lanes = shm->lane_count;
+    int home_lane = 0;
+    if (lanes > 0) {
+        home_lane = (my_stats ? (int)(my_stats - shm->receptor_stats) : (int)my_pid) % lanes;
+        printf(CYAN "  • Modo carriles: %d carriles, propio %d (roba de los demás)\n" RESET, lanes, home_lane);
+    }
+    time_t t0 = time(NULL);
+    
+    while (!should_terminate && !shm->shutdown_flag) {
+        
+        // =====================================================================
+        // PASO 1: Esperar a que haya un item disponible (bloqueante, sin busy wait)
+        // =====================================================================
+        
+        if (stats_sem_wait(SEM_IDX_DECRYPT_ITEMS, sems->decrypt_items) != 0) {
+            if (errno == EINTR) {
+                // Interrumpido por señal
+                if (should_terminate || shm->shutdown_flag) break;
+                continue;  // Reintentar
+            }
+            fprintf(stderr, RED "[ERROR] sem_wait(decrypt_items): %s\n" RESET, strerror(errno));
+            break;
+        }
+        if (relay_shutdown(shm, sems->decrypt_items)) break;  // Token de finalización, no un item
+        uint64_t service_t0 = worker_stats_now_ns();
+        
+        // =====================================================================
+        // PASO 2: Extraer elemento de la cola (sección crítica)
+        // =====================================================================
+        
+        SlotInfo info;
+        int lane_idx = -1;
+        uint32_t seq = 0;
+        if (lanes) {
+            // Modo carriles: CAS sobre el head de un carril, sin semáforo de cola
+            info = lane_claim(shm, home_lane, &lane_idx);
+            worker_stats_set_inflight(info.text_index);
+        } else if (groups) {
+            // Difusión: fetch_add sobre el cursor del grupo, sin semáforo de cola
+            info = group_claim(shm, my_group, &seq);
+            worker_stats_set_inflight(info.text_index);
+        } else {
+            stats_sem_wait(SEM_IDX_DECRYPT_QUEUE, sems->decrypt_queue);
+            info = dequeue_decrypt_slot_ordered(shm);
+            worker_stats_set_inflight(info.text_index);
+            sem_post(sems->decrypt_queue);
+        }
+        uint64_t dequeue_ns = worker_stats_now_ns();
+        
+        if (info.slot_index < 0) {
+            // Cola vacía con un token en la mano: es el marcador de fin de flujo
+            if (relay_end_of_stream(shm, sems->decrypt_items)) {
+                worker_stats_set_inflight(-1);
+                if (jobs_stream_finish(shm) != SUCCESS) {
+                    fprintf(stderr, YELLOW "[ADVERTENCIA] No se pudo ajustar la salida al fin del flujo: %s\n" RESET,
+                            strerror(errno));
+                }
+                printf(YELLOW "\n[RECEPTOR %d] Fin de flujo: todos los caracteres recibidos\n" RESET,
+                       getpid());
+                printf(CYAN "  • Recibidos por este receptor: %d\n" RESET, chars_recv);
+                break;
+            }
+            // Inconsistencia: el semáforo indicó item pero la cola estaba vacía
+            continue;
+        }
+        
+        // =====================================================================
+        // PASO 3: Leer el slot
+        // =====================================================================
+        
+        CharacterSlot slot;
+        if (get_slot_info(shm, info.slot_index, &slot) != SUCCESS || !slot.is_valid) {
+            // Slot inválido: liberarlo y continuar
+            if (lanes) {
+                lane_release_slot(shm, lane_idx, info.slot_index);
+            } else if (groups) {
+                group_release(shm, my_group, seq, sems->decrypt_queue, sems->encrypt_queue, sems->encrypt_spaces);
+            } else {
+                stats_sem_wait(SEM_IDX_ENCRYPT_QUEUE, sems->encrypt_queue);
+                enqueue_encrypt_slot(shm, info.slot_index);
+                sem_post(sems->encrypt_queue);
+                sem_post(sems->encrypt_spaces);
+            }
+            worker_stats_set_inflight(-1);
+            continue;
+        }
+        
+        // Modo demonio: el primer carácter de un lote nuevo cambia la tabla de
+        // trabajos y los resúmenes; los anteriores ya están todos escritos
+        uint32_t batch = daemon_mode ? batch_current(shm) : my_batch;
+        if (batch != my_batch) {
+            jobs_close_all();
+            if (jobs_bind(shm) != SUCCESS || integrity_bind(shm, my_group) != SUCCESS) {
+                fprintf(stderr, RED "[ERROR] Sin memoria para el lote %u\n" RESET, batch);
+            }
+            my_batch = batch;
+            if (!quiet) printf(CYAN "\n[RECEPTOR %d] Lote %u: %d trabajo(s)\n" RESET, getpid(), batch, shm->job_count);
+        }
+        
+        // =====================================================================
+        // PASO 4: Desencriptar el carácter
+        // =====================================================================
+        
+        int job = jobs_locate(info.text_index);
+        unsigned char enc = slot.ascii_value;
+        unsigned char job_key = (opt->has_custom_key || job < 0) ? effective_key : jobs_get(job)->key;
+        char plain = (char)xor_apply(enc, job_key);
+        
+        // =====================================================================
+        // PASO 5: Escribir el byte desencriptado al archivo de salida
+        // =====================================================================
+        
+        int job_fd = (job < 0) ? -1 : sink_mode ? 0 : jobs_output_fd(job, NULL, 0);
+        if (job_fd != -1 && sink_mode) {
+            sink_put(shm, info.text_index, (unsigned char)plain);
+            integrity_record(info.text_index, (unsigned char)plain);
+            jobs_record_written(job);
+        } else if (job_fd == -1 ||
+            write_decoded_char(job_fd, info.text_index - jobs_get(job)->start, (unsigned char)plain) != 0) {
+            fprintf(stderr, RED "[ERROR] Escritura de salida falló en índice %d: %s\n" RESET,
+                    info.text_index, job < 0 ? "fuera de todo trabajo" : strerror(errno));
+        } else {
+            integrity_record(info.text_index, (unsigned char)plain);
+            if (my_group == 0) jobs_record_written(job);  // Con difusión cada grupo cuenta en ReceptorGroup
+        }
+        // Aun si la escritura falló: el lote termina y el demonio lo verifica,
+        // así que lo acumulado tiene que estar en la SHM antes de contarlo
+        if (daemon_mode) {
+            integrity_flush();
+            batch_record_written(shm, batch);
+        }
+        worker_stats_record_latency(slot.emit_ns, dequeue_ns, worker_stats_now_ns());
+        worker_stats_set_inflight(-1);
+        
+        // =====================================================================
+        // PASO 6-7: Marcar el slot como libre y devolverlo
+        // =====================================================================
+        
+        if (lanes) {
+            // Al emisor dueño del carril (futex), no a la cola de encriptación
+            lane_release_slot(shm, lane_idx, info.slot_index);
+        } else if (groups) {
+            // Vuelve a los emisores cuando lo terminaron todos los grupos
+            group_release(shm, my_group, seq, sems->decrypt_queue, sems->encrypt_queue, sems->encrypt_spaces);
+        } else {
+            CharacterSlot* buf = get_buffer_pointer(shm);
+            if (buf) {
+                buf[info.slot_index].is_valid = 0;
+                buf[info.slot_index].ascii_value = 0;
+            }
+            stats_sem_wait(SEM_IDX_ENCRYPT_QUEUE, sems->encrypt_queue);
+            enqueue_encrypt_slot(shm, info.slot_index);
+            sem_post(sems->encrypt_queue);
+            sem_post(sems->encrypt_spaces);  // Avisar al emisor que hay espacio
+        }
+        worker_stats_record_item(worker_stats_now_ns() - service_t0);
+        
+        // =====================================================================
+        // PASO 8: Mostrar información del carácter recibido
+        // =====================================================================
+        
+        if (!quiet) {
+            print_reception_box(shm, info.slot_index, info.text_index, enc, plain,
+                                slot.emit_ns, slot.emisor_pid);
+        }
+        chars_recv++;
+
+        // --- NUEVO: aplicar slowdown sólo en modo AUTO y sólo si opt->delay_ms > 0 ---
+        if (opt->mode == MODE_AUTO && opt->delay_ms > 0) {
+            usleep((useconds_t)opt->delay_ms * 1000);
+        }
+        
+        // =====================================================================
+        // PASO 9: Control de modo (auto/manual)
+        // =====================================================================
+        
+        if (opt->mode == MODE_MANUAL) {
+            printf(CYAN "\nPresione ENTER para continuar (o Ctrl+C para salir)..." RESET);
+            char tmp[8];
+            errno = 0;
+            if (!fgets(tmp, sizeof tmp, stdin)) {
+                if (errno == EINTR || should_terminate) break;
+            }
+        }
+    }
+    
+    // =========================================================================
+    // RESUMEN Y ESTADÍSTICAS
+    // =========================================================================
+    
+    time_t t1 = time(NULL);
+    int elapsed = (int)(t1 - t0);
+    integrity_flush();   // Antes de desregistrarse: el finalizador lee los resúmenes después
+    worker_stats_finish();
+    
+    printf(BOLD YELLOW "\n╔══════════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD YELLOW "║             RECEPTOR PID %6d FINALIZANDO               ║\n" RESET, my_pid);
+    printf(BOLD YELLOW "╚══════════════════════════════════════════════════════════╝\n" RESET);
+    printf("  • Caracteres recibidos: %d\n", chars_recv);
+    printf("  • Tiempo de ejecución: %d s\n", elapsed);
+    if (elapsed > 0) {
+        printf("  • Velocidad promedio: %.2f chars/s\n", (float)chars_recv / elapsed);
+    }
+    
+    // =========================================================================
+    // LIMPIEZA Y CIERRE
+    // =========================================================================
+    
+    sink_finish(shm);
+    jobs_close_all();
+    unregister_receptor(shm, my_pid, sems->global);
+    return SUCCESS;
+}
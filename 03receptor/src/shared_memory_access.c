@@ -3,9 +3,9 @@
  * 
  * Este módulo proporciona las funciones necesarias para que el receptor
  * acceda a la memoria compartida System V creada por el inicializador.
- * Incluye funciones para conectarse y desconectarse de la memoria compartida,
- * así como para acceder a las estructuras de datos dentro de ella de manera
- * segura usando offsets en lugar de punteros directos.
+ * Incluye funciones para acceder a las estructuras de datos dentro de ella
+ * de manera segura usando offsets en lugar de punteros directos. La
+ * conexión y desconexión del segmento están en main.c.
  * 
  * La memoria compartida contiene un buffer circular de slots de caracteres
  * y las colas de sincronización entre emisores y receptores.
@@ -19,70 +19,6 @@
 #include "constants.h"
 #include "shared_memory_access.h"
 
-/**
- * Conecta el proceso a la memoria compartida creada por el inicializador
- */
-/**
- * @brief Conecta el proceso a la memoria compartida existente
- * 
- * Localiza y se conecta al segmento de memoria compartida usando la clave
- * proporcionada. Realiza verificaciones básicas de integridad para
- * asegurar que la memoria está correctamente inicializada.
- * 
- * @param key Clave IPC que identifica el segmento de memoria
- * @return Puntero a la memoria compartida o NULL en caso de error
- */
-SharedMemory* attach_shared_memory(key_t key) {
-    // Obtener ID del segmento existente
-    int shmid = shmget(key, 0, 0);
-    if (shmid == -1) {
-        fprintf(stderr, RED "[ERROR] No se encontró memoria compartida con key 0x%04X: %s\n" RESET,
-                key, strerror(errno));
-        return NULL;
-    }
-    
-    // Adjuntar el segmento a nuestro espacio de direcciones
-    SharedMemory* shm = (SharedMemory*)shmat(shmid, NULL, 0);
-    if (shm == (void*)-1) {
-        fprintf(stderr, RED "[ERROR] shmat falló: %s\n" RESET, strerror(errno));
-        return NULL;
-    }
-    
-    // Verificación básica de integridad
-    if (shm->buffer_size <= 0 || shm->file_data_size <= 0) {
-        fprintf(stderr, RED "[ERROR] Memoria compartida corrupta o no inicializada\n" RESET);
-        shmdt(shm);
-        return NULL;
-    }
-    
-    return shm;
-}
-
-/**
- * Desconecta el proceso de la memoria compartida
- * NOTA: Esto NO destruye el segmento, solo desadjunta el proceso
- */
-/**
- * @brief Desconecta el proceso de la memoria compartida
- * 
- * Desvincula el proceso del segmento de memoria compartida.
- * Esto no destruye el segmento, solo elimina el mapeo en el
- * espacio de direcciones del proceso actual.
- * 
- * @param shm Puntero a la memoria compartida a desconectar
- * @return SUCCESS en caso de éxito, ERROR en caso contrario
- */
-int detach_shared_memory(SharedMemory* shm) {
-    if (!shm) return SUCCESS;
-    
-    if (shmdt(shm) == -1) {
-        fprintf(stderr, RED "[ERROR] shmdt: %s\n" RESET, strerror(errno));
-        return ERROR;
-    }
-    
-    return SUCCESS;
-}
-
 /**
  * Obtiene puntero al buffer de CharacterSlot usando el offset almacenado en SHM
  */
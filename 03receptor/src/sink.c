@@ -0,0 +1,340 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <linux/futex.h>
+#include "sink.h"
+#include "constants.h"
+
+/**
+ * Módulo de Salida Ordenada (receptor)
+ *
+ * La ventana tiene sink_window bytes de datos y otros tantos de banderas
+ * "listo"; el índice i ocupa la posición i % sink_window. Los emisores
+ * sólo toman índices menores que sink_committed + sink_window (ver
+ * claim_limit en el emisor), así que un receptor siempre encuentra libre
+ * la posición de su byte y nunca espera.
+ *
+ * El hilo volcador del dueño del destino recorre las banderas desde
+ * sink_committed, envía el tramo contiguo con un único writev (dos
+ * segmentos si da la vuelta a la ventana), limpia las banderas y avanza
+ * sink_committed. Como los bytes llegan casi en orden, enviar apenas está
+ * lista la cabeza sería un writev de pocos bytes por despertar: el
+ * volcador anota en sink_wake_at el índice que completa SINK_BATCH bytes
+ * (o la cabeza, si no hay nada listo) y duerme en sink_seq hasta que el
+ * receptor que deja ese byte lo despierta o pasan SINK_LINGER_MS. El
+ * tiempo de espera también cubre el fin de la entrada y las señales de
+ * terminación.
+ *
+ * No se usa splice/vmsplice: la fuente es memoria compartida que se
+ * reutiliza en cuanto avanza sink_committed, y vmsplice la dejaría
+ * referenciada por la tubería después de la escritura.
+ */
+
+#define SINK_POLL_MS   100
+#define SINK_LINGER_MS 5
+#define SINK_BATCH     (64 * 1024)
+
+static int           g_fd = -1;
+static int           g_running = 0;
+static int           g_broken = 0;
+static pthread_t     g_thread;
+static int           g_stdout_fd = -1;    // Salida estándar original con "--sink -"
+static volatile sig_atomic_t* g_stop = NULL;
+
+static unsigned char* window_data(SharedMemory* shm) {
+    return (unsigned char*)shm + shm->sink_offset;
+}
+
+static unsigned char* window_ready(SharedMemory* shm) {
+    return window_data(shm) + shm->sink_window;
+}
+
+static int stop_requested(SharedMemory* shm) {
+    return *g_stop || __atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE);
+}
+
+/* Todo lo que se va a publicar ya se envió */
+static int input_done(SharedMemory* shm, int head) {
+    if (shm->stream && !__atomic_load_n(&shm->stream_eof, __ATOMIC_ACQUIRE)) return 0;
+    return head >= __atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE);
+}
+
+/* La salida estándar queda para los datos; los mensajes van a la de error */
+static int take_stdout(void) {
+    fflush(stdout);
+    g_stdout_fd = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 0);
+    if (g_stdout_fd == -1 || dup2(STDERR_FILENO, STDOUT_FILENO) == -1) {
+        fprintf(stderr, RED "[ERROR] No se pudo reservar la salida estándar: %s\n" RESET, strerror(errno));
+        return ERROR;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return SUCCESS;
+}
+
+/**
+ * @brief Quita "--sink DESTINO" (o "--sink=DESTINO") de argv
+ *
+ * Con "-" la salida estándar se reserva aquí, antes del primer mensaje.
+ *
+ * @param argc Cantidad de argumentos (se actualiza)
+ * @param argv Argumentos (se compactan)
+ * @param error 1 si falta el destino
+ * @return Destino, o NULL si no se pidió
+ */
+const char* sink_take_option(int* argc, char* argv[], int* error) {
+    const char* dest = NULL;
+    int out = 1;
+    *error = 0;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--sink") == 0) {
+            if (i + 1 >= *argc) {
+                fprintf(stderr, RED "[ERROR] --sink requiere un destino (-, FIFO, archivo o unix:SOCKET)\n" RESET);
+                *error = 1;
+                return NULL;
+            }
+            dest = argv[++i];
+        } else if (strncmp(argv[i], "--sink=", 7) == 0) {
+            dest = argv[i] + 7;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argv[out] = NULL;
+    *argc = out;
+    if (dest && strcmp(dest, "-") == 0 && take_stdout() != SUCCESS) {
+        *error = 1;
+        return NULL;
+    }
+    return dest;
+}
+
+/**
+ * @brief Abre el destino de la salida ordenada
+ *
+ * Abrir un FIFO bloquea hasta que aparece su lector. SIGPIPE se ignora:
+ * un lector que se va se detecta como EPIPE en el volcador.
+ *
+ * @param dest "-", "unix:RUTA" o ruta de un FIFO o archivo
+ * @return Descriptor o -1
+ */
+int sink_open(const char* dest) {
+    signal(SIGPIPE, SIG_IGN);
+    int fd = -1;
+    if (strcmp(dest, "-") == 0) {
+        fd = g_stdout_fd;
+        g_stdout_fd = -1;
+    } else if (strncmp(dest, "unix:", 5) == 0) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(dest + 5) >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+        } else {
+            strcpy(addr.sun_path, dest + 5);
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd != -1 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) {
+                int saved = errno;
+                close(fd);
+                fd = -1;
+                errno = saved;
+            }
+        }
+    } else {
+        fd = open(dest, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    }
+    if (fd == -1) {
+        fprintf(stderr, RED "[ERROR] No se pudo abrir el destino '%s': %s\n" RESET, dest, strerror(errno));
+    }
+    return fd;
+}
+
+void sink_put(SharedMemory* shm, int text_index, unsigned char ch) {
+    int pos = text_index % shm->sink_window;
+    window_data(shm)[pos] = ch;
+    __atomic_store_n(&window_ready(shm)[pos], 1, __ATOMIC_SEQ_CST);
+    // Sólo el byte anotado despierta al volcador: el resto lo encuentra listo al recorrer
+    if (__atomic_load_n(&shm->sink_flusher_waiting, __ATOMIC_SEQ_CST) &&
+        text_index == __atomic_load_n(&shm->sink_wake_at, __ATOMIC_SEQ_CST)) {
+        __atomic_add_fetch(&shm->sink_seq, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &shm->sink_seq, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+/**
+ * @brief Escribe todo el vector en el destino
+ *
+ * Un lector lento llena la tubería: se espera con poll para seguir viendo
+ * las señales de terminación.
+ *
+ * @return SUCCESS, o ERROR si el destino falló o hay que terminar
+ */
+static int write_all(SharedMemory* shm, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        struct pollfd pfd = { .fd = g_fd, .events = POLLOUT, .revents = 0 };
+        int ready = poll(&pfd, 1, SINK_POLL_MS);
+        if (ready == 0 || (ready == -1 && errno == EINTR)) {
+            if (stop_requested(shm)) return ERROR;
+            continue;
+        }
+        ssize_t w = writev(g_fd, iov, iovcnt);
+        if (w < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            fprintf(stderr, RED "[ERROR] Destino de la salida ordenada: %s; se descarta el resto\n" RESET,
+                    strerror(errno));
+            return ERROR;
+        }
+        __atomic_add_fetch(&shm->sink_writes, 1, __ATOMIC_RELAXED);
+        size_t done = (size_t)w;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return SUCCESS;
+}
+
+/* Envía [head, head + n), libera sus posiciones y avanza sink_committed */
+static void flush_range(SharedMemory* shm, int head, int n) {
+    int window = shm->sink_window;
+    int pos = head % window;
+    int first = MIN(n, window - pos);
+    unsigned char* data = window_data(shm);
+    unsigned char* ready = window_ready(shm);
+
+    struct iovec iov[2] = {
+        { .iov_base = data + pos, .iov_len = (size_t)first },
+        { .iov_base = data,       .iov_len = (size_t)(n - first) },
+    };
+    if (!g_broken && write_all(shm, iov, n > first ? 2 : 1) != SUCCESS) g_broken = 1;
+    if (g_broken) __atomic_add_fetch(&shm->sink_dropped, (uint32_t)n, __ATOMIC_RELAXED);
+
+    memset(ready + pos, 0, (size_t)first);
+    if (n > first) memset(ready, 0, (size_t)(n - first));
+    __atomic_store_n(&shm->sink_committed, head + n, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&shm->sink_waiters, __ATOMIC_SEQ_CST)) {
+        syscall(SYS_futex, &shm->sink_committed, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/* Bytes listos y contiguos desde head */
+static int ready_prefix(const unsigned char* ready, int window, int head) {
+    int pos = head % window;
+    int n = 0;
+    while (n < window && __atomic_load_n(&ready[pos], __ATOMIC_ACQUIRE)) {
+        n++;
+        if (++pos == window) pos = 0;
+    }
+    return n;
+}
+
+static void* flusher_main(void* arg) {
+    SharedMemory* shm = arg;
+    int window = shm->sink_window;
+    int batch = MAX(1, MIN(window / 4, SINK_BATCH));
+    unsigned char* ready = window_ready(shm);
+    int lingered = 0;
+
+    for (;;) {
+        int head = __atomic_load_n(&shm->sink_committed, __ATOMIC_RELAXED);
+        int n = ready_prefix(ready, window, head);
+        int total = __atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE);
+        // Tramo completo, fin de la entrada a la vista o ya se esperó una vez
+        if (n >= batch || (n > 0 && (lingered || head + n >= total))) {
+            flush_range(shm, head, n);
+            lingered = 0;
+            continue;
+        }
+        if (n == 0 && (input_done(shm, head) || stop_requested(shm))) break;
+
+        int wake_at = n > 0 ? MIN(head + batch, total) - 1 : head;
+        struct timespec timeout = { 0, (n > 0 ? SINK_LINGER_MS : SINK_POLL_MS) * 1000000L };
+        uint32_t seq = __atomic_load_n(&shm->sink_seq, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&shm->sink_wake_at, wake_at, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&shm->sink_flusher_waiting, 1, __ATOMIC_SEQ_CST);
+        // Un receptor que dejó el byte antes de ver la bandera no va a despertar
+        if (!__atomic_load_n(&ready[wake_at % window], __ATOMIC_SEQ_CST)) {
+            syscall(SYS_futex, &shm->sink_seq, FUTEX_WAIT, seq, &timeout, NULL, 0);
+        }
+        __atomic_store_n(&shm->sink_flusher_waiting, 0, __ATOMIC_RELAXED);
+        lingered = n > 0;
+        if (stop_requested(shm)) lingered = 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Toma el destino y lanza el hilo volcador
+ *
+ * Un único receptor puede ser dueño; si el anterior murió sin liberarlo
+ * (kill(pid, 0) ya no lo encuentra) se lo reemplaza y se sigue desde
+ * sink_committed. El hilo bloquea las señales del proceso: las recibe el
+ * hilo principal, que es el que espera en los semáforos.
+ *
+ * @param shm Segmento con salida ordenada
+ * @param fd Destino (de sink_open)
+ * @param stop Bandera de terminación del proceso
+ * @return SUCCESS o ERROR
+ */
+int sink_start(SharedMemory* shm, int fd, volatile sig_atomic_t* stop) {
+    pid_t me = getpid();
+    pid_t owner = 0;
+    while (!__atomic_compare_exchange_n(&shm->sink_pid, &owner, me, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        if (kill(owner, 0) == 0 || errno != ESRCH) {
+            fprintf(stderr, RED "[ERROR] El receptor %d ya es dueño del destino de la salida ordenada\n" RESET,
+                    (int)owner);
+            return ERROR;
+        }
+    }
+
+    g_fd = fd;
+    g_stop = stop;
+    g_broken = 0;
+
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    int rc = pthread_create(&g_thread, NULL, flusher_main, shm);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (rc != 0) {
+        fprintf(stderr, RED "[ERROR] No se pudo lanzar el volcador: %s\n" RESET, strerror(rc));
+        __atomic_store_n(&shm->sink_pid, 0, __ATOMIC_RELEASE);
+        return ERROR;
+    }
+    g_running = 1;
+    return SUCCESS;
+}
+
+void sink_finish(SharedMemory* shm) {
+    if (!g_running) return;
+    pthread_join(g_thread, NULL);
+    g_running = 0;
+    close(g_fd);
+    g_fd = -1;
+
+    int committed = __atomic_load_n(&shm->sink_committed, __ATOMIC_ACQUIRE);
+    uint32_t dropped = __atomic_load_n(&shm->sink_dropped, __ATOMIC_RELAXED);
+    printf(CYAN "  • Salida ordenada: %d bytes enviados en %llu escrituras%s\n" RESET,
+           committed - (int)dropped, (unsigned long long)__atomic_load_n(&shm->sink_writes, __ATOMIC_RELAXED),
+           input_done(shm, committed) ? "" : " (incompleta)");
+    if (dropped) printf(YELLOW "  • %u bytes descartados: el destino se cerró\n" RESET, dropped);
+
+    pid_t me = getpid();
+    __atomic_compare_exchange_n(&shm->sink_pid, &me, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
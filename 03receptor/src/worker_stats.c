@@ -0,0 +1,220 @@
+#include <errno.h>
+#include <time.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "worker_stats.h"
+#include "timebase.h"
+
+/**
+ * Módulo de Estadísticas por Proceso
+ *
+ * Cada emisor o receptor escribe únicamente en su propio bloque
+ * WorkerStats dentro de la memoria compartida, por lo que no necesita
+ * semáforos: los contadores se actualizan con cargas/almacenamientos
+ * atómicos relajados (un solo escritor) y el finalizador puede leerlos
+ * en cualquier momento sin observar valores a medio escribir. Cada
+ * actualización se envuelve en el seqlock del bloque para que el monitor
+ * obtenga copias coherentes.
+ *
+ * Archivo idéntico en 02emisor y 03receptor: 09lanzador enlaza a los dos
+ * y usa una sola copia.
+ */
+
+static WorkerStats*     g_ws  = NULL;
+static ReceptorLatency* g_lat = NULL;
+
+/**
+ * @brief Suma un valor a un contador de un único escritor
+ *
+ * Evita la instrucción atómica con prefijo lock: basta con que la
+ * escritura sea atómica para los lectores concurrentes.
+ */
+static inline void counter_add(uint64_t* c, uint64_t v) {
+    __atomic_store_n(c, __atomic_load_n(c, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Calcula el bucket del histograma logarítmico para un valor
+ *
+ * @param v Valor en nanosegundos
+ * @return Índice en [0, HIST_BUCKETS)
+ */
+static int hist_bucket(uint64_t v) {
+    if (v < HIST_SUB_BUCKETS) return (int)v;
+    int msb = 63 - __builtin_clzll(v);
+    if (msb > HIST_MAX_MSB) return HIST_BUCKETS - 1;
+    int shift = msb - HIST_SUB_BITS;
+    int sub = (int)((v >> shift) & (HIST_SUB_BUCKETS - 1));
+    return (shift + 1) * HIST_SUB_BUCKETS + sub;
+}
+
+static void hist_record(LatencyHistogram* h, uint64_t v) {
+    counter_add(&h->buckets[hist_bucket(v)], 1);
+    counter_add(&h->count, 1);
+    counter_add(&h->sum_ns, v);
+    if (v > __atomic_load_n(&h->max_ns, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&h->max_ns, v, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Asocia el bloque de estadísticas del proceso
+ *
+ * Inicializa tiempos de inicio. Si ws es NULL (no hubo bloque libre),
+ * el resto de funciones se convierten en no-ops.
+ *
+ * @param ws Bloque WorkerStats reservado para este proceso
+ */
+void worker_stats_bind(WorkerStats* ws) {
+    g_ws = ws;
+    if (!g_ws) return;
+    g_ws->blocked_on = -1;
+    g_ws->inflight_text_index = -1;
+    __atomic_store_n(&g_ws->start_ns, worker_stats_now_ns(), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Lee el reloj del run en nanosegundos
+ *
+ * @return Nanosegundos desde la época del run (ver timebase.c)
+ */
+uint64_t worker_stats_now_ns(void) {
+    return timebase_now_ns();
+}
+
+/* Marca el bloqueo en curso para el monitor y devuelve si se contabiliza */
+static int block_begin(int sem_idx, uint64_t* t0) {
+    *t0 = worker_stats_now_ns();
+    int tracked = g_ws && sem_idx >= 0 && sem_idx < SEM_COUNT;
+    if (tracked) {
+        // Visible para el monitor mientras dure el bloqueo (detección de estancamientos)
+        seq_write_begin(&g_ws->seq);
+        g_ws->blocked_since_ns = *t0;
+        g_ws->blocked_on = sem_idx;
+        seq_write_end(&g_ws->seq);
+    }
+    return tracked;
+}
+
+static void block_end(int sem_idx, uint64_t t0) {
+    seq_write_begin(&g_ws->seq);
+    counter_add(&g_ws->sem_waits[sem_idx], 1);
+    counter_add(&g_ws->sem_blocked_ns[sem_idx], worker_stats_now_ns() - t0);
+    g_ws->blocked_on = -1;
+    seq_write_end(&g_ws->seq);
+}
+
+/**
+ * @brief sem_wait instrumentado
+ *
+ * Intenta primero sem_trywait: si el semáforo está disponible no se
+ * considera espera. Si no lo está, cuenta una espera bloqueante y
+ * acumula el tiempo que el proceso pasó dormido en sem_wait.
+ * Conserva la semántica de retorno/errno de sem_wait (EINTR incluido).
+ *
+ * @param sem_idx Índice SEM_IDX_* del semáforo
+ * @param sem Semáforo POSIX
+ * @return 0 en éxito, -1 con errno en error
+ */
+int stats_sem_wait(int sem_idx, sem_t* sem) {
+    if (sem_trywait(sem) == 0) return 0;
+    if (errno != EAGAIN) return -1;
+
+    uint64_t t0;
+    int tracked = block_begin(sem_idx, &t0);
+    int rc = sem_wait(sem);
+    if (tracked) block_end(sem_idx, t0);
+    return rc;
+}
+
+/**
+ * @brief FUTEX_WAIT instrumentado (modo carriles)
+ *
+ * Duerme mientras *word == expected y cuenta la espera bajo sem_idx, de
+ * modo que las estadísticas por semáforo siguen siendo comparables con
+ * el modo de colas compartidas.
+ *
+ * @param sem_idx Índice SEM_IDX_* bajo el que se contabiliza la espera
+ * @param word Palabra futex en memoria compartida
+ * @param expected Valor leído antes de decidir dormir
+ */
+void stats_futex_wait(int sem_idx, uint32_t* word, uint32_t expected) {
+    uint64_t t0;
+    int tracked = block_begin(sem_idx, &t0);
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, NULL, NULL, 0);
+    if (tracked) block_end(sem_idx, t0);
+}
+
+/**
+ * @brief Registra un carácter procesado y su tiempo de servicio
+ *
+ * Cada iteración del bucle del emisor o del receptor trata un carácter,
+ * por lo que cada registro cuenta como un lote de tamaño 1.
+ *
+ * @param service_ns Tiempo de servicio del carácter en nanosegundos
+ */
+void worker_stats_record_item(uint64_t service_ns) {
+    if (!g_ws) return;
+    seq_write_begin(&g_ws->seq);
+    // Un solo escritor: el primer registro fija el instante del primer carácter
+    if (g_ws->chars == 0) __atomic_store_n(&g_ws->first_ns, worker_stats_now_ns(), __ATOMIC_RELAXED);
+    counter_add(&g_ws->chars, 1);
+    counter_add(&g_ws->batches, 1);
+    hist_record(&g_ws->service, service_ns);
+    seq_write_end(&g_ws->seq);
+}
+
+/**
+ * @brief Asocia el bloque de latencias extremo a extremo del receptor
+ *
+ * @param lat Bloque ReceptorLatency del mismo índice que el WorkerStats
+ *            (NULL desactiva el registro)
+ */
+void worker_stats_bind_latency(ReceptorLatency* lat) {
+    g_lat = lat;
+}
+
+/**
+ * @brief Registra las latencias de un carácter ya escrito
+ *
+ * Separa el tiempo que el carácter esperó en el buffer (cola) del
+ * tiempo que el receptor tardó en escribirlo (procesamiento).
+ *
+ * @param emit_ns    Instante de emisión guardado en el slot
+ * @param dequeue_ns Instante de extracción de la cola de desencriptación
+ * @param write_ns   Instante en que terminó la escritura en el archivo
+ */
+void worker_stats_record_latency(uint64_t emit_ns, uint64_t dequeue_ns, uint64_t write_ns) {
+    if (!g_lat || emit_ns == 0) return;
+    if (dequeue_ns < emit_ns) dequeue_ns = emit_ns;
+    if (write_ns < dequeue_ns) write_ns = dequeue_ns;
+    if (g_ws) seq_write_begin(&g_ws->seq);
+    hist_record(&g_lat->e2e,        write_ns - emit_ns);
+    hist_record(&g_lat->queue,      dequeue_ns - emit_ns);
+    hist_record(&g_lat->processing, write_ns - dequeue_ns);
+    if (g_ws) seq_write_end(&g_ws->seq);
+}
+
+/**
+ * @brief Publica el índice de texto que el proceso tiene en sus manos
+ *
+ * El monitor lo usa para calcular el prefijo del archivo de salida ya
+ * confirmado. Un solo almacenamiento con liberación: no requiere semáforos.
+ *
+ * @param text_index Índice en curso, o -1 al soltarlo
+ */
+void worker_stats_set_inflight(int text_index) {
+    if (!g_ws) return;
+    __atomic_store_n(&g_ws->inflight_text_index, text_index, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Marca el fin de la ejecución del proceso
+ */
+void worker_stats_finish(void) {
+    if (!g_ws) return;
+    __atomic_store_n(&g_ws->inflight_text_index, -1, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_ws->end_ns, worker_stats_now_ns(), __ATOMIC_RELAXED);
+}
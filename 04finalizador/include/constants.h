@@ -25,6 +25,11 @@
 #define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
 #define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
 #define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+// Etapas intermedias: base + número de etapa (ver instance_sem_n)
+#define SEM_NAME_STAGE_QUEUE    "/sem_stage_queue"
+#define SEM_NAME_STAGE_ITEMS    "/sem_stage_items"
+// Difusión: base + número de grupo de receptores
+#define SEM_NAME_GROUP_ITEMS    "/sem_group_items"
 
 // Permisos para objetos IPC y archivos
 #define IPC_PERMS 0666
@@ -38,6 +43,11 @@
 #define MIN_DELAY_MS     10
 #define MAX_DELAY_MS     5000
 
+// Espera de finalización (drenado)
+#define DRAIN_RESCAN_MS         250   // Relectura de PIDs registrados tarde (pidfd)
+#define DRAIN_FALLBACK_POLL_MS  100   // Timeout del futex para detectar caídos (sin pidfd)
+#define DRAIN_MUTEX_TIMEOUT_MS  500   // Un caído pudo morir con el mutex global tomado
+
 // Macros útiles
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
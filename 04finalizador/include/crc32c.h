@@ -0,0 +1,26 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * CRC32C (Castagnoli, polinomio reflejado 0x82F63B78) compartido por
+ * inicializador, receptor, etapa y finalizador:
+ *  - crc32c: CRC estándar; encadenable (crc32c(crc32c(0, a), b) = CRC de a||b).
+ *    Usa la instrucción crc32 de SSE4.2 si el CPU la tiene.
+ *  - crc32c_byte_raw / crc32c_multiply / crc32c_x8n: CRC "crudo" (sin valor
+ *    inicial ni XOR final), que es lineal: el CRC crudo de un bloque es el
+ *    XOR de las contribuciones de cada byte en su posición, en cualquier orden.
+ *  - crc32c_from_raw: CRC crudo de len bytes -> CRC32C estándar.
+ *  - crc32c_merkle_root: raíz de un árbol binario de CRCs (destruye el arreglo).
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t len);
+uint32_t crc32c_byte_raw(unsigned char b);
+uint32_t crc32c_multiply(uint32_t a, uint32_t b);
+uint32_t crc32c_x8n(uint64_t nbytes);
+uint32_t crc32c_from_raw(uint32_t raw, uint64_t len);
+uint32_t crc32c_merkle_root(uint32_t* level, size_t n);
+int      crc32c_hw_available(void);
+
+#endif // CRC32C_H
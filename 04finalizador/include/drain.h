@@ -0,0 +1,33 @@
+#ifndef DRAIN_H
+#define DRAIN_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "structures.h"
+
+/**
+ * Espera de finalización de emisores/receptores/etapas (drenado)
+ *
+ * wait_for_workers()    - Bloquea hasta que termina el último trabajador:
+ *                         pidfd_open + poll por cada PID registrado, o
+ *                         futex sobre workers_exit_seq si no hay pidfd.
+ *                         Detecta y desregistra a los que murieron sin hacerlo.
+ * print_drain_report()  - Imprime tiempos de la finalización y procesos caídos
+ */
+
+typedef struct {
+    uint64_t wake_ns;                       // shutdown_flag -> señales y tokens enviados
+    uint64_t drain_ns;                      // shutdown_flag -> último trabajador terminado
+    uint64_t cleanup_ns;                    // sem_unlink + shmctl(IPC_RMID)
+    int      relays;                        // Tokens de finalización reenviados por trabajadores
+    int      exited;                        // Terminaron desregistrándose
+    int      crashed;                       // Terminaron sin desregistrarse
+    pid_t    crashed_pids[3 * MAX_WORKERS];
+    int      crashed_role[3 * MAX_WORKERS]; // 0 = emisor, 1 = receptor, 2 = etapa
+    int      used_pidfd;                    // 1 = pidfd + poll, 0 = futex
+} DrainReport;
+
+int  wait_for_workers(SharedMemory* shm, uint64_t since_ns, uint32_t exit_seq0, DrainReport* rep);
+void print_drain_report(const DrainReport* rep);
+
+#endif // DRAIN_H
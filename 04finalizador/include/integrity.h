@@ -0,0 +1,24 @@
+#ifndef INTEGRITY_H
+#define INTEGRITY_H
+
+#include "structures.h"
+
+/**
+ * Verificación de integridad al finalizar
+ *
+ * print_integrity_report() - Compara, bloque a bloque, el CRC32C esperado
+ *                            (inicializador) con el acumulado por los
+ *                            receptores, reconstruye la raíz Merkle y lista
+ *                            los bloques corruptos o incompletos.
+ *                            Retorna la cantidad de bloques con problemas.
+ * print_stage_report()     - Caracteres que pasaron por cada etapa intermedia
+ *                            y la misma verificación para las etapas checksum.
+ * print_group_report()     - Con difusión, caracteres escritos por cada grupo
+ *                            de receptores y la verificación de los grupos
+ *                            1..N-1 (el 0 es el del informe principal).
+ */
+int print_integrity_report(const SharedMemory* shm);
+int print_stage_report(const SharedMemory* shm);
+int print_group_report(const SharedMemory* shm);
+
+#endif // INTEGRITY_H
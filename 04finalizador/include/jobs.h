@@ -0,0 +1,15 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include "structures.h"
+
+/**
+ * Reporte de trabajos al finalizar
+ *
+ * print_jobs_report() - Con más de un trabajo, cuenta los completos
+ *                       (chars_written == length) y lista los que
+ *                       quedaron a medias. Retorna los incompletos.
+ */
+int print_jobs_report(const SharedMemory* shm);
+
+#endif // JOBS_H
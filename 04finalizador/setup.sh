@@ -10,12 +10,20 @@ CYAN='\033[0;36m'
 RESET='\033[0m'
 BOLD='\033[1m'
 
+# Instancia: "./setup.sh --instance NOMBRE" o IPC_INSTANCE. Los programas
+# y los make lanzados desde el menú la heredan por el entorno.
+if [ "$1" = "--instance" ] && [ -n "$2" ]; then
+    export IPC_INSTANCE="$2"
+fi
+INSTANCE="${IPC_INSTANCE:-}"
+
 show_banner() {
     clear
     echo -e "${BOLD}${CYAN}╔════════════════════════════════════════════════════════════╗${RESET}"
     echo -e "${BOLD}${CYAN}║                SETUP - FINALIZADOR                         ║${RESET}"
     echo -e "${BOLD}${CYAN}║         Sistema de Comunicación entre Procesos             ║${RESET}"
     echo -e "${BOLD}${CYAN}╚════════════════════════════════════════════════════════════╝${RESET}"
+    [ -n "$INSTANCE" ] && echo -e "${CYAN}Instancia: ${INSTANCE}${RESET}"
     echo ""
 }
 
@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "drain.h"
+#include "constants.h"
+#include "timebase.h"
+#include "instance.h"
+
+/**
+ * Espera de finalización (drenado)
+ *
+ * En vez de consultar active_emisores/active_receptores cada segundo, el
+ * finalizador abre un pidfd por cada PID registrado y duerme en poll():
+ * el kernel lo despierta en el instante en que termina cada proceso, haya
+ * pasado o no por unregister_*. Un PID que termina y sigue en la tabla
+ * murió sin desregistrarse; el finalizador lo quita y corrige el contador.
+ *
+ * Si el kernel no ofrece pidfd_open (< 5.3), se espera sobre la palabra
+ * futex workers_exit_seq, que cada trabajador incrementa al desregistrarse;
+ * el timeout del futex permite detectar caídos con kill(pid, 0).
+ */
+
+typedef struct {
+    pid_t pid;
+    int   fd;
+    int   role;     // 0 = emisor, 1 = receptor, 2 = etapa
+} Tracked;
+
+#define DRAIN_ROLES 3
+
+static int pidfd_open_compat(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+static int futex_wait(uint32_t* addr, uint32_t expected, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static pid_t* role_pids(SharedMemory* shm, int role) {
+    return role == 0 ? shm->emisor_pids : role == 1 ? shm->receptor_pids : shm->stage_pids;
+}
+
+static const char* role_name(int role) {
+    return role == 0 ? "emisor" : role == 1 ? "receptor" : "etapa";
+}
+
+static int active_workers(const SharedMemory* shm) {
+    return __atomic_load_n(&shm->active_emisores, __ATOMIC_ACQUIRE)
+         + __atomic_load_n(&shm->active_receptores, __ATOMIC_ACQUIRE)
+         + __atomic_load_n(&shm->active_etapas, __ATOMIC_ACQUIRE);
+}
+
+static int pid_registered(SharedMemory* shm, int role, pid_t pid) {
+    const pid_t* pids = role_pids(shm, role);
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (__atomic_load_n(&pids[i], __ATOMIC_ACQUIRE) == pid) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Quita de la tabla a un trabajador que terminó sin desregistrarse.
+ * Si murió con el mutex global tomado, sem_timedwait vence y se corrige
+ * igual: ya nadie más va a modificar la tabla.
+ */
+static void reap_crashed(SharedMemory* shm, sem_t* mutex, int role, pid_t pid, DrainReport* rep) {
+    int locked = 0;
+    if (mutex) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)DRAIN_MUTEX_TIMEOUT_MS * 1000000L;
+        ts.tv_sec  += ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        while (!(locked = (sem_timedwait(mutex, &ts) == 0)) && errno == EINTR) {}
+    }
+
+    pid_t* pids = role_pids(shm, role);
+    int found = 0;
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (pids[i] == pid) {
+            pids[i] = 0;
+            found = 1;
+            break;
+        }
+    }
+    if (found) {
+        if (role == 0)      shm->active_emisores--;
+        else if (role == 1) shm->active_receptores--;
+        else                shm->active_etapas--;
+    }
+    if (locked) sem_post(mutex);
+    if (!found) return;
+
+    if (rep->crashed < DRAIN_ROLES * MAX_WORKERS) {
+        rep->crashed_pids[rep->crashed] = pid;
+        rep->crashed_role[rep->crashed] = role;
+    }
+    rep->crashed++;
+    printf("\n" RED "  ! %s %d terminó sin desregistrarse%s\n" RESET,
+           role == 0 ? "Emisor" : role == 1 ? "Receptor" : "Proceso etapa", (int)pid,
+           mutex && !locked ? " (mutex global abandonado)" : "");
+}
+
+/*
+ * Abre un pidfd por cada PID registrado que todavía no se sigue.
+ * Devuelve 0 si pidfd_open no está disponible (pasar al modo futex).
+ */
+static int track_registered(SharedMemory* shm, sem_t* mutex, Tracked* tr, int* n, DrainReport* rep) {
+    for (int role = 0; role < DRAIN_ROLES; role++) {
+        const pid_t* pids = role_pids(shm, role);
+        for (int i = 0; i < MAX_WORKERS; i++) {
+            pid_t pid = __atomic_load_n(&pids[i], __ATOMIC_ACQUIRE);
+            if (pid <= 0) continue;
+
+            int known = 0;
+            for (int k = 0; k < *n && !known; k++) known = (tr[k].pid == pid && tr[k].role == role);
+            if (known) continue;
+
+            int fd = pidfd_open_compat(pid);
+            if (fd >= 0) {
+                tr[*n].pid = pid;
+                tr[*n].fd = fd;
+                tr[*n].role = role;
+                (*n)++;
+            } else if (errno == ESRCH) {
+                reap_crashed(shm, mutex, role, pid, rep);
+            } else {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static void print_progress(const SharedMemory* shm) {
+    if (shm->stage_count > 0) {
+        printf("\033[1;34m→ Esperando finalización (%d emisores, %d receptores, %d etapas activos)\033[0m\r",
+               shm->active_emisores, shm->active_receptores, shm->active_etapas);
+    } else {
+        printf("\033[1;34m→ Esperando finalización (%d emisores, %d receptores activos)\033[0m\r",
+               shm->active_emisores, shm->active_receptores);
+    }
+    fflush(stdout);
+}
+
+static void wait_pidfd(SharedMemory* shm, sem_t* mutex, DrainReport* rep, int* ok) {
+    Tracked tr[DRAIN_ROLES * MAX_WORKERS];
+    struct pollfd pfds[DRAIN_ROLES * MAX_WORKERS];
+    int n = 0;
+
+    for (;;) {
+        if (!track_registered(shm, mutex, tr, &n, rep)) {
+            *ok = 0;
+            break;
+        }
+        if (n == 0 && active_workers(shm) <= 0) break;
+
+        for (int k = 0; k < n; k++) {
+            pfds[k].fd = tr[k].fd;
+            pfds[k].events = POLLIN;
+            pfds[k].revents = 0;
+        }
+        // El timeout sólo sirve para ver PIDs registrados tarde: cada salida despierta al instante
+        int rc = poll(pfds, (nfds_t)n, DRAIN_RESCAN_MS);
+        if (rc < 0 && errno != EINTR) {
+            *ok = 0;
+            break;
+        }
+        if (rc <= 0) continue;
+
+        for (int k = n - 1; k >= 0; k--) {
+            if (!(pfds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            if (pid_registered(shm, tr[k].role, tr[k].pid)) {
+                reap_crashed(shm, mutex, tr[k].role, tr[k].pid, rep);
+            }
+            close(tr[k].fd);
+            tr[k] = tr[--n];
+        }
+        print_progress(shm);
+    }
+
+    for (int k = 0; k < n; k++) close(tr[k].fd);
+}
+
+static void wait_futex(SharedMemory* shm, sem_t* mutex, DrainReport* rep) {
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&shm->workers_exit_seq, __ATOMIC_ACQUIRE);
+        if (active_workers(shm) <= 0) break;
+
+        futex_wait(&shm->workers_exit_seq, seq, DRAIN_FALLBACK_POLL_MS);
+        if (__atomic_load_n(&shm->workers_exit_seq, __ATOMIC_ACQUIRE) != seq) print_progress(shm);
+
+        for (int role = 0; role < DRAIN_ROLES; role++) {
+            const pid_t* pids = role_pids(shm, role);
+            for (int i = 0; i < MAX_WORKERS; i++) {
+                pid_t pid = __atomic_load_n(&pids[i], __ATOMIC_ACQUIRE);
+                if (pid > 0 && kill(pid, 0) == -1 && errno == ESRCH) {
+                    reap_crashed(shm, mutex, role, pid, rep);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Espera a que terminen todos los emisores, receptores y etapas
+ *
+ * @param shm Memoria compartida (ya con shutdown_flag activo)
+ * @param since_ns Instante en que se pidió la finalización (timebase)
+ * @param exit_seq0 workers_exit_seq leído antes de activar shutdown_flag
+ * @param rep Reporte de drenado a llenar
+ * @return SUCCESS
+ */
+int wait_for_workers(SharedMemory* shm, uint64_t since_ns, uint32_t exit_seq0, DrainReport* rep) {
+    memset(rep, 0, sizeof(*rep));
+    sem_t* mutex = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    if (mutex == SEM_FAILED) mutex = NULL;
+
+    print_progress(shm);
+    int pidfd_ok = 1;
+    wait_pidfd(shm, mutex, rep, &pidfd_ok);
+    rep->used_pidfd = pidfd_ok;
+    if (!pidfd_ok) {
+        printf("\n" YELLOW "  • pidfd_open no disponible, esperando sobre futex\n" RESET);
+        wait_futex(shm, mutex, rep);
+    }
+
+    uint64_t now = timebase_now_ns();
+    rep->drain_ns = now > since_ns ? now - since_ns : 0;
+    // Incluye a los que se desregistraron antes de que se abrieran sus pidfd
+    rep->exited = (int)(__atomic_load_n(&shm->workers_exit_seq, __ATOMIC_ACQUIRE) - exit_seq0);
+    if (mutex) sem_close(mutex);
+    return SUCCESS;
+}
+
+void print_drain_report(const DrainReport* rep) {
+    printf("\033[1;36mFinalización:\033[0m\n");
+    printf("  Aviso (SIGUSR1 + tokens):           %.3f ms (%d reenvíos en cadena)\n",
+           (double)rep->wake_ns / 1e6, rep->relays);
+    printf("  Drenado hasta el último proceso:    %.3f ms (%s)\n",
+           (double)rep->drain_ns / 1e6, rep->used_pidfd ? "pidfd + poll" : "futex");
+    printf("  Limpieza (sem_unlink + IPC_RMID):   %.3f ms\n", (double)rep->cleanup_ns / 1e6);
+    printf("  Procesos terminados normalmente: %d\n", rep->exited);
+    if (rep->crashed == 0) {
+        printf("  Procesos caídos sin desregistrarse: 0\n\n");
+        return;
+    }
+    printf(RED "  Procesos caídos sin desregistrarse: %d\n" RESET, rep->crashed);
+    int shown = rep->crashed < DRAIN_ROLES * MAX_WORKERS ? rep->crashed : DRAIN_ROLES * MAX_WORKERS;
+    for (int i = 0; i < shown; i++) {
+        printf("    - %s %d\n", role_name(rep->crashed_role[i]), (int)rep->crashed_pids[i]);
+    }
+    printf("\n");
+}
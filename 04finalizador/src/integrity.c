@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "integrity.h"
+#include "crc32c.h"
+#include "constants.h"
+
+/**
+ * Módulo de Integridad (finalizador)
+ *
+ * No relee el archivo de salida: usa los CRC crudos que los receptores
+ * acumularon en la SHM (ver 03receptor/src/integrity.c). Un bloque está
+ * íntegro si se escribieron exactamente sus bytes y el CRC coincide.
+ * Se llama con los trabajadores ya terminados, así que los contadores
+ * no cambian durante la lectura. Las etapas checksum acumulan sus
+ * propios resúmenes de la misma forma (ver 08etapa/src/checksum.c), y
+ * con difusión cada grupo de receptores tiene los suyos (el grupo 0 usa
+ * los principales).
+ */
+
+#define INTEGRITY_MAX_LISTED 16
+
+static const char* chunk_problem(const ChunkDigest* d, uint32_t len, uint32_t crc) {
+    if (d->written_bytes < len) return "incompleto";
+    if (d->written_bytes > len) return "escrito de más";
+    if (crc != d->expected_crc) return "corrupto";
+    return NULL;
+}
+
+/*
+ * Verifica n bloques de resúmenes contra sus CRC esperados y la raíz
+ * Merkle expected_root; imprime los bloques con problemas, el conteo y la
+ * raíz. Retorna la cantidad de bloques con problemas.
+ */
+static int check_digests(const SharedMemory* shm, const ChunkDigest* digests, int n,
+                         uint32_t expected_root, const char* source) {
+    uint32_t* leaves = malloc((size_t)n * sizeof(uint32_t));
+    if (!leaves) {
+        printf(YELLOW "  • Sin memoria para la verificación\n\n" RESET);
+        return 0;
+    }
+
+    int corrupt = 0, incomplete = 0, listed = 0;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    for (int c = 0; c < n; c++) {
+        const ChunkDigest* d = &digests[c];
+        uint64_t start = (uint64_t)c * INTEGRITY_CHUNK_SIZE;
+        uint32_t len = (uint32_t)MIN((uint64_t)INTEGRITY_CHUNK_SIZE, (uint64_t)shm->file_data_size - start);
+        // En streaming los receptores cuentan el último bloque completo (relleno con ceros)
+        leaves[c] = crc32c_from_raw(d->written_crc, shm->stream ? INTEGRITY_CHUNK_SIZE : len);
+
+        const char* problem = chunk_problem(d, len, leaves[c]);
+        if (!problem) continue;
+        if (d->written_bytes < len) incomplete++;
+        else corrupt++;
+        if (listed++ < INTEGRITY_MAX_LISTED) {
+            printf(RED "  ✗ Bloque %d [%llu, %llu): %s (%u/%u bytes, CRC %08x, esperado %08x)\n" RESET,
+                   c, (unsigned long long)start, (unsigned long long)(start + len), problem,
+                   d->written_bytes, len, leaves[c], d->expected_crc);
+        }
+    }
+    if (listed > INTEGRITY_MAX_LISTED) printf("    ... %d bloques más\n", listed - INTEGRITY_MAX_LISTED);
+
+    uint32_t root = crc32c_merkle_root(leaves, (size_t)n);
+    free(leaves);
+
+    printf("  Bloques: %d  íntegros: %d  corruptos: %d  incompletos: %d\n",
+           n, n - corrupt - incomplete, corrupt, incomplete);
+    if (root == expected_root) {
+        printf(GREEN "  ✓ Raíz Merkle %08x coincide con %s\n\n" RESET, root, source);
+    } else {
+        printf(RED "  ✗ Raíz Merkle %08x (esperada %08x)\n\n" RESET, root, expected_root);
+    }
+    return corrupt + incomplete;
+}
+
+int print_integrity_report(const SharedMemory* shm) {
+    int n = shm->integrity_chunks;
+    const ChunkDigest* digests = (const ChunkDigest*)((const char*)shm + shm->integrity_offset);
+
+    printf("\033[1;36mIntegridad (CRC32C por bloques de %d KiB):\033[0m\n", INTEGRITY_CHUNK_SIZE / 1024);
+    if (n <= 0) {
+        printf("  Sin datos de entrada\n\n");
+        return 0;
+    }
+    return check_digests(shm, digests, n, shm->integrity_root,
+                         shm->stage_count > 0 ? "la entrada transformada por las etapas" : "la entrada");
+}
+
+int print_stage_report(const SharedMemory* shm) {
+    if (shm->stage_count <= 0) return 0;
+    int problems = 0;
+    printf("\033[1;36mEtapas intermedias:\033[0m\n");
+    for (int k = 0; k < shm->stage_count; k++) {
+        const Stage* st = &shm->stages[k];
+        printf("  Etapa %d: %-8s %u de %d caracteres, %d proceso(s)", k, stage_op_name(st->op),
+               __atomic_load_n(&st->passed, __ATOMIC_ACQUIRE), shm->total_chars_in_file, st->workers);
+        if (st->op == STAGE_OP_XOR || st->op == STAGE_OP_FILTER) printf(" [param %02X]", st->param);
+        printf("\n");
+    }
+    printf("\n");
+    for (int k = 0; k < shm->stage_count; k++) {
+        const Stage* st = &shm->stages[k];
+        if (!st->digest_offset || shm->integrity_chunks <= 0) continue;
+        printf("\033[1;36mIntegridad en la etapa %d (checksum):\033[0m\n", k);
+        problems += check_digests(shm, (const ChunkDigest*)((const char*)shm + st->digest_offset),
+                                  shm->integrity_chunks, st->digest_root, "lo esperado en la etapa");
+    }
+    return problems;
+}
+
+int print_group_report(const SharedMemory* shm) {
+    if (shm->group_count <= 0) return 0;
+    int problems = 0;
+    printf("\033[1;36mDifusión:\033[0m\n");
+    for (int g = 0; g < shm->group_count; g++) {
+        const ReceptorGroup* grp = &shm->groups[g];
+        printf("  Grupo %d: %u de %d caracteres, %d receptor(es)\n", g,
+               __atomic_load_n(&grp->written, __ATOMIC_ACQUIRE), shm->total_chars_in_file, grp->receptors);
+    }
+    printf("\n");
+    for (int g = 1; g < shm->group_count; g++) {
+        if (shm->integrity_chunks <= 0) break;
+        printf("\033[1;36mIntegridad del grupo %d:\033[0m\n", g);
+        problems += check_digests(shm, (const ChunkDigest*)((const char*)shm + shm->groups[g].digest_offset),
+                                  shm->integrity_chunks, shm->integrity_root, "la entrada");
+    }
+    return problems;
+}
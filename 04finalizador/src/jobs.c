@@ -0,0 +1,38 @@
+#include <stdio.h>
+#include "jobs.h"
+#include "constants.h"
+
+/**
+ * Módulo de Trabajos (finalizador)
+ *
+ * Los receptores suman cada byte escrito al chars_written de su trabajo;
+ * con los trabajadores ya terminados basta compararlo con length. La
+ * integridad byte a byte la cubre print_integrity_report.
+ */
+
+#define JOBS_MAX_LISTED 16
+
+int print_jobs_report(const SharedMemory* shm) {
+    int n = shm->job_count;
+    if (n <= 1) return 0;
+    const Job* jobs = (const Job*)((const char*)shm + shm->jobs_offset);
+
+    printf("\033[1;36mTrabajos (%d):\033[0m\n", n);
+    int incomplete = 0;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    for (int j = 0; j < n; j++) {
+        uint32_t written = jobs[j].chars_written;
+        if (written == (uint32_t)jobs[j].length) continue;
+        if (incomplete++ < JOBS_MAX_LISTED) {
+            printf(RED "  ✗ %s: %u/%d bytes\n" RESET, jobs[j].input_filename, written, jobs[j].length);
+        }
+    }
+    if (incomplete > JOBS_MAX_LISTED) printf("    ... %d trabajos más\n", incomplete - JOBS_MAX_LISTED);
+
+    if (incomplete == 0) {
+        printf(GREEN "  ✓ %d/%d trabajos completos\n\n" RESET, n, n);
+    } else {
+        printf("  Completos: %d  incompletos: %d\n\n", n - incomplete, incomplete);
+    }
+    return incomplete;
+}
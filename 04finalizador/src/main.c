@@ -5,41 +5,102 @@
 #include <string.h>
 #include <semaphore.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
 
 #include "constants.h"
 #include "structures.h"
 #include "signal_handler.h"
 #include "shared_memory_access.h"
+#include "timebase.h"
+#include "drain.h"
+#include "integrity.h"
+#include "jobs.h"
+#include "instance.h"
 
 /**
  * Finalizador del Sistema IPC
  *
  * - Espera 'q' (bloqueante, sin busy-wait) o señal externa
- * - Marca shutdown_flag y notifica a emisores/receptores (SIGUSR1)
- * - Despierta potenciales bloqueados en semáforos POSIX
- * - Espera a que todos terminen
- * - Imprime estadísticas (con señales bloqueadas para que no se corte)
+ * - Marca shutdown_flag y notifica a emisores/receptores/etapas (SIGUSR1)
+ * - Despierta bloqueados en semáforos POSIX con un token reenviado en cadena
+ * - Espera a que todos terminen (pidfd + poll, sin sondeo periódico)
+ * - Elimina SHM y semáforos (shmctl / sem_unlink, sin shell)
+ * - Imprime estadísticas, tiempos de la finalización e integridad (CRC32C)
+ *   (con señales bloqueadas para que no se corte)
  */
 
-static void wake_blocked_processes_posix(int buffer_size) {
-    sem_t *es = sem_open(SEM_NAME_ENCRYPT_SPACES, 0);
-    sem_t *di = sem_open(SEM_NAME_DECRYPT_ITEMS, 0);
+/*
+ * Despierta a los bloqueados en ENCRYPT_SPACES / DECRYPT_ITEMS con un único
+ * token por semáforo. Cada trabajador que despierta con shutdown_flag activo
+ * lo reenvía antes de salir (relay_shutdown), de modo que el costo total es
+ * O(trabajadores) sem_post en vez de buffer_size por semáforo.
+ */
+static void wake_blocked_processes_posix(SharedMemory* shm) {
+    sem_t *es = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    sem_t *di = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
 
     if (es != SEM_FAILED) {
-        for (int i = 0; i < buffer_size; i++) sem_post(es);
+        sem_post(es);
         sem_close(es);
-        printf("  ! Despertados emisores (ENCRYPT_SPACES)\n");
+        printf("  ! Token de finalización en ENCRYPT_SPACES (emisores)\n");
     }
     if (di != SEM_FAILED) {
-        for (int i = 0; i < buffer_size; i++) sem_post(di);
+        sem_post(di);
         sem_close(di);
-        printf("  ! Despertados receptores (DECRYPT_ITEMS)\n");
+        printf("  ! Token de finalización en DECRYPT_ITEMS (receptores)\n");
+    }
+    // Modo carriles: los emisores esperan su próximo slot en la palabra futex del carril
+    int lanes = shm->lane_count < MAX_LANES ? shm->lane_count : MAX_LANES;
+    for (int i = 0; i < lanes; i++) {
+        __atomic_add_fetch(&shm->lanes[i].freed, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &shm->lanes[i].freed, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+    if (lanes > 0) printf("  ! Despertados los emisores de %d carriles\n", lanes);
+    // Etapas intermedias: un token por cola, reenviado en cadena igual que los anteriores
+    int stages = shm->stage_count < MAX_STAGES ? shm->stage_count : MAX_STAGES;
+    for (int k = 0; k < stages; k++) {
+        sem_t* it = sem_open(instance_sem_n(SEM_NAME_STAGE_ITEMS, k), 0);
+        if (it == SEM_FAILED) continue;
+        sem_post(it);
+        sem_close(it);
+    }
+    if (stages > 0) printf("  ! Token de finalización en las colas de %d etapas\n", stages);
+    // Difusión: cada grupo de receptores espera en su propio semáforo de items
+    int groups = shm->group_count < MAX_GROUPS ? shm->group_count : MAX_GROUPS;
+    for (int g = 0; g < groups; g++) {
+        sem_t* it = sem_open(instance_sem_n(SEM_NAME_GROUP_ITEMS, g), 0);
+        if (it == SEM_FAILED) continue;
+        sem_post(it);
+        sem_close(it);
+    }
+    if (groups > 0) printf("  ! Token de finalización en los semáforos de %d grupos\n", groups);
+    // Modo demonio: emisores que esperan el próximo lote con la entrada agotada
+    if (shm->daemon_pid) {
+        __atomic_add_fetch(&shm->batch_seq, 2, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &shm->batch_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        printf("  ! Despertados los emisores que esperaban otro lote\n");
+    }
+    // Streaming: emisores que esperan más datos de la fuente
+    if (shm->stream) {
+        __atomic_add_fetch(&shm->stream_seq, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &shm->stream_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        printf("  ! Despertados los emisores que esperaban datos del flujo\n");
+    }
+    // Salida ordenada: emisores que esperan lugar en la ventana de reordenamiento
+    if (shm->sink_window) {
+        syscall(SYS_futex, &shm->sink_committed, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        printf("  ! Despertados los emisores que esperaban la ventana de salida\n");
     }
     fflush(stdout);
 }
 
 static void notify_processes(SharedMemory* shm, int* sent_emisores, int* sent_receptores) {
-    int se = 0, sr = 0;
+    int se = 0, sr = 0, st = 0;
     for (int i = 0; i < 100; i++) {
         if (shm->emisor_pids[i] > 0) {
             if (kill(shm->emisor_pids[i], SIGUSR1) == 0) se++;
@@ -50,54 +111,95 @@ static void notify_processes(SharedMemory* shm, int* sent_emisores, int* sent_re
             if (kill(shm->receptor_pids[i], SIGUSR1) == 0) sr++;
         }
     }
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (shm->stage_pids[i] > 0 && kill(shm->stage_pids[i], SIGUSR1) == 0) st++;
+    }
     *sent_emisores  = se;
     *sent_receptores = sr;
-    printf("  • Señales SIGUSR1 enviadas: emisores=%d, receptores=%d\n", se, sr);
+    printf("  • Señales SIGUSR1 enviadas: emisores=%d, receptores=%d", se, sr);
+    if (shm->stage_count > 0) printf(", etapas=%d", st);
+    printf("\n");
+    // El demonio deja de aceptar lotes y borra su socket de control
+    if (shm->daemon_pid > 0 && kill(shm->daemon_pid, SIGTERM) == 0) {
+        printf("  • SIGTERM enviada al inicializador en modo demonio (PID %d)\n", (int)shm->daemon_pid);
+    }
+    // El alimentador deja de leer la fuente y publica el total leído
+    if (shm->stream_feeder_pid > 0 && !shm->stream_eof && kill(shm->stream_feeder_pid, SIGTERM) == 0) {
+        printf("  • SIGTERM enviada al inicializador que alimenta el flujo (PID %d)\n",
+               (int)shm->stream_feeder_pid);
+    }
     fflush(stdout);
 }
 
-// Limpieza FINAL de IPC: despierta bloqueados, elimina semáforos POSIX y SHM System V.
+/* Borra los semáforos legacy (prefijo sem.sem.ipc_*) sin lanzar un shell */
+static int remove_legacy_semaphores(void) {
+    DIR* dir = opendir("/dev/shm");
+    if (!dir) return 0;
+    int removed = 0;
+    struct dirent* de;
+    while ((de = readdir(dir)) != NULL) {
+        if (strncmp(de->d_name, "sem.sem.ipc_", 12) != 0) continue;
+        if (unlinkat(dirfd(dir), de->d_name, 0) == 0) removed++;
+    }
+    closedir(dir);
+    return removed;
+}
+
+// Limpieza FINAL de IPC: elimina semáforos POSIX y SHM System V con llamadas directas.
 // Llamar a esta función *después* de esperar a que terminen emisores/receptores.
-static void final_cleanup_ipc(SharedMemory* shm) {
+// El segmento sigue adjunto (IPC_RMID lo destruye al desadjuntar el último proceso),
+// así que las estadísticas pueden leerse después.
+static void final_cleanup_ipc(int stage_count, int group_count) {
+    static const char* sem_names[] = {
+        SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+        SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+    };
+
     printf(BOLD RED "╔══════════════════════════════════════════════════════╗\n" RESET);
     printf(BOLD RED "║                    LIMPIEZA DE IPC                   ║\n" RESET);
     printf(BOLD RED "╚══════════════════════════════════════════════════════╝\n" RESET);
 
-    // 1) Despertar posibles procesos bloqueados (usa tu helper local)
-    if (shm && shm->buffer_size > 0) {
-        wake_blocked_processes_posix(shm->buffer_size);
-        printf(YELLOW "  ! Despertados posibles bloqueados (ENCRYPT_SPACES / DECRYPT_ITEMS)\n" RESET);
-    }
-
-    // 2) Eliminar semáforos POSIX nombrados directamente (equivalente a borrar /dev/shm/sem.*)
+    // 1) Eliminar semáforos POSIX nombrados (equivalente a borrar /dev/shm/sem.*)
     printf("  → Eliminando semáforos POSIX nombrados...\n");
     int any_err = 0;
-    if (sem_unlink(SEM_NAME_GLOBAL_MUTEX)   == -1) any_err = 1;
-    if (sem_unlink(SEM_NAME_ENCRYPT_QUEUE)  == -1) any_err = 1;
-    if (sem_unlink(SEM_NAME_DECRYPT_QUEUE)  == -1) any_err = 1;
-    if (sem_unlink(SEM_NAME_ENCRYPT_SPACES) == -1) any_err = 1;
-    if (sem_unlink(SEM_NAME_DECRYPT_ITEMS)  == -1) any_err = 1;
+    for (size_t i = 0; i < sizeof(sem_names) / sizeof(sem_names[0]); i++) {
+        if (sem_unlink(instance_sem(sem_names[i])) == -1) any_err = 1;
+    }
+    for (int k = 0; k < stage_count && k < MAX_STAGES; k++) {
+        if (sem_unlink(instance_sem_n(SEM_NAME_STAGE_QUEUE, k)) == -1) any_err = 1;
+        if (sem_unlink(instance_sem_n(SEM_NAME_STAGE_ITEMS, k)) == -1) any_err = 1;
+    }
+    for (int g = 0; g < group_count && g < MAX_GROUPS; g++) {
+        if (sem_unlink(instance_sem_n(SEM_NAME_GROUP_ITEMS, g)) == -1) any_err = 1;
+    }
 
     if (!any_err) printf(GREEN "  ✓ Semáforos POSIX eliminados\n" RESET);
     else          printf(YELLOW "  • Uno o más semáforos ya no existían o no pudieron eliminarse (continuando)\n" RESET);
 
-    // 3) Eliminar SHM System V por clave (0x1234), como en tu make clean-ipc
-    printf("  → Eliminando memoria compartida System V (key 0x%04X)...\n", SHM_BASE_KEY);
-    int rc = system("ipcrm -M 0x1234 2>/dev/null || true");
-    (void)rc; // evitar warning por valor no usado
-    printf(GREEN "  ✓ Solicitud de eliminación de SHM enviada (ipcrm)\n" RESET);
+    // 2) Marcar la SHM System V para eliminación (clave de la instancia)
+    printf("  → Eliminando memoria compartida System V (key 0x%08X)...\n", (unsigned)instance_shm_key());
+    int shm_id = shmget(instance_shm_key(), 0, 0);
+    if (shm_id != -1 && shmctl(shm_id, IPC_RMID, NULL) == 0) {
+        printf(GREEN "  ✓ Segmento marcado para eliminación (IPC_RMID)\n" RESET);
+    } else {
+        printf(YELLOW "  • No se pudo eliminar el segmento: %s (continuando)\n" RESET, strerror(errno));
+    }
 
-    // 4) Limpieza legacy opcional (prefijo sem.sem.ipc_*)
-    printf("  → Limpieza legacy en /dev/shm (sem.sem.ipc_*)...\n");
-    rc = system("rm -f /dev/shm/sem.sem.ipc_* 2>/dev/null || true");
-    (void)rc;
+    // 3) Limpieza legacy opcional (prefijo sem.sem.ipc_*)
+    int legacy = remove_legacy_semaphores();
+    if (legacy > 0) printf("  → Semáforos legacy eliminados: %d\n", legacy);
 
     printf(GREEN "✓ IPC limpiado (SHM y semáforos POSIX)\n" RESET);
 }
 
-int main(void) {
+int main(int argc, char* argv[]) {
     /* Salida sin búfer para que no se “corte” el output */
     setvbuf(stdout, NULL, _IONBF, 0);
+    if (instance_init(&argc, argv) != SUCCESS) return 1;
+    if (argc > 1) {
+        fprintf(stderr, "Uso: %s [--instance NOMBRE]\n", argv[0]);
+        return 1;
+    }
 
     printf("\033[1;36m╔════════════════════════════════════════════════════════════╗\033[0m\n");
     printf("\033[1;36m║                     FINALIZADOR                            ║\033[0m\n");
@@ -115,27 +217,41 @@ int main(void) {
         cleanup_keyboard();
         return 1;
     }
+    if (instance_check(shm) != SUCCESS) {
+        detach_shared_memory(shm);
+        cleanup_keyboard();
+        return 1;
+    }
+    timebase_attach(&shm->timebase);
 
     /* Espera bloqueante hasta 'q' o señal (sin busy-wait) */
     (void)wait_for_quit_or_signal();
 
-    /* Activar flag de finalización */
-    shm->shutdown_flag = 1;
+    /* Activar flag de finalización (desde aquí se mide el drenado) */
+    uint64_t shutdown_ns = timebase_now_ns();
+    uint32_t exit_seq0 = __atomic_load_n(&shm->workers_exit_seq, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&shm->shutdown_flag, 1, __ATOMIC_RELEASE);
     printf("\033[1;33m→ Solicitando finalización de procesos...\033[0m\n");
 
     /* Notificar procesos y despertar bloqueados por semáforos POSIX */
     int se = 0, sr = 0;
     notify_processes(shm, &se, &sr);
-    wake_blocked_processes_posix(shm->buffer_size);
+    wake_blocked_processes_posix(shm);
+    uint64_t wake_ns = timebase_now_ns() - shutdown_ns;
 
-    /* Esperar a que todos terminen */
-    while (shm->active_emisores > 0 || shm->active_receptores > 0) {
-        printf("\033[1;34m→ Esperando finalización (%d emisores, %d receptores activos)\033[0m\r",
-               shm->active_emisores, shm->active_receptores);
-        fflush(stdout);
-        sleep(1);
-    }
-    printf("\n\033[1;32m✓ Todos los procesos han finalizado\033[0m\n\n");
+    /* Esperar a que todos terminen: retorna en cuanto sale el último */
+    DrainReport drain;
+    wait_for_workers(shm, shutdown_ns, exit_seq0, &drain);
+    drain.wake_ns = wake_ns;
+    drain.relays  = (int)__atomic_load_n(&shm->shutdown_relays, __ATOMIC_ACQUIRE);
+    printf("\n\033[1;32m✓ Todos los procesos han finalizado en %.3f ms\033[0m\n\n",
+           (double)drain.drain_ns / 1e6);
+
+    /* Sin trabajadores vivos: eliminar IPC ya (el segmento sigue adjunto para las estadísticas) */
+    uint64_t cleanup_t0 = timebase_now_ns();
+    final_cleanup_ipc(shm->stage_count, shm->group_count);
+    drain.cleanup_ns = timebase_now_ns() - cleanup_t0;
+    printf("\n");
 
     /* Bloquear señales mientras imprimimos estadísticas para que no se corte */
     sigset_t set, oldset;
@@ -144,13 +260,33 @@ int main(void) {
     sigaddset(&set, SIGTERM);
     sigprocmask(SIG_BLOCK, &set, &oldset);
     print_statistics(shm);
+    print_drain_report(&drain);
+    if (shm->daemon_pid) {
+        printf("\033[1;36mModo demonio:\033[0m %u lote(s) completos; integridad y trabajos del último publicado\n\n",
+               __atomic_load_n(&shm->batch_done, __ATOMIC_ACQUIRE));
+    }
+    if (shm->stream) {
+        printf("\033[1;36mStreaming:\033[0m %d bytes leídos de la fuente%s\n\n",
+               __atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE),
+               __atomic_load_n(&shm->stream_eof, __ATOMIC_ACQUIRE) ? "" : " (la fuente no terminó)");
+    }
+    if (shm->sink_window) {
+        uint32_t dropped = __atomic_load_n(&shm->sink_dropped, __ATOMIC_RELAXED);
+        printf("\033[1;36mSalida ordenada:\033[0m %d bytes enviados en %llu escrituras (%u descartados)\n\n",
+               __atomic_load_n(&shm->sink_committed, __ATOMIC_ACQUIRE) - (int)dropped,
+               (unsigned long long)__atomic_load_n(&shm->sink_writes, __ATOMIC_RELAXED), dropped);
+    }
+    print_integrity_report(shm);
+    print_stage_report(shm);
+    print_group_report(shm);
+    print_jobs_report(shm);
     sleep(5);
     sigprocmask(SIG_SETMASK, &oldset, NULL);
 
     /* Limpiar y salir */
     printf("\n\033[1;33m→ Limpiando recursos...\033[0m\n");
     cleanup_keyboard();
-    final_cleanup_ipc(shm);
+    detach_shared_memory(shm);
     printf("\033[1;32m✓ Finalización completada\033[0m\n");
     fflush(stdout);
     return 0;
@@ -1,15 +1,19 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <sys/shm.h>
 #include <time.h>
 #include "shared_memory_access.h"
-#include "constants.h"   // SHM_BASE_KEY y colores
+#include "constants.h"   // Colores
+#include "timebase.h"
+#include "instance.h"
 
 /**
  * Funciones para manejo de memoria compartida y estadísticas del sistema
  */
 
 SharedMemory* attach_shared_memory(void) {
-    int shm_id = shmget(SHM_BASE_KEY, sizeof(SharedMemory), 0666);
+    int shm_id = shmget(instance_shm_key(), sizeof(SharedMemory), 0666);
     if (shm_id == -1) {
         perror("shmget failed");
         return NULL;
@@ -29,11 +33,221 @@ void detach_shared_memory(SharedMemory* shm) {
     }
 }
 
-static void fmt_time(char* out, size_t n, time_t t) {
+/* Hora local de un timestamp del run (0 = todavía sin valor) */
+static void fmt_time(char* out, size_t n, uint64_t run_ns) {
     if (!out || n == 0) return;
-    struct tm tmp;
-    localtime_r(&t, &tmp);
-    strftime(out, n, "%H:%M:%S", &tmp);
+    if (run_ns == 0) {
+        snprintf(out, n, "--:--:--");
+        return;
+    }
+    timebase_format_hms(run_ns, out, n);
+}
+
+/* Valor más alto representado por un bucket del histograma logarítmico */
+static uint64_t hist_bucket_upper(int idx) {
+    if (idx < HIST_SUB_BUCKETS) return (uint64_t)idx;
+    int shift = idx / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(idx % HIST_SUB_BUCKETS);
+    return ((HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static void hist_merge(LatencyHistogram* dst, const LatencyHistogram* src) {
+    dst->count  += src->count;
+    dst->sum_ns += src->sum_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    for (int i = 0; i < HIST_BUCKETS; i++) dst->buckets[i] += src->buckets[i];
+}
+
+/* Percentil q (0..1) en ns; se acota por el máximo observado */
+static uint64_t hist_percentile(const LatencyHistogram* h, double q) {
+    uint64_t total = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) total += h->buckets[i];
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t v = hist_bucket_upper(i);
+            return (h->max_ns > 0 && v > h->max_ns) ? h->max_ns : v;
+        }
+    }
+    return h->max_ns;
+}
+
+/* Duración de un bloque en segundos (si sigue activo, hasta ahora) */
+static double worker_elapsed_s(const WorkerStats* ws, uint64_t now_ns) {
+    uint64_t end = ws->end_ns ? ws->end_ns : now_ns;
+    if (ws->start_ns == 0 || end <= ws->start_ns) return 0.0;
+    return (double)(end - ws->start_ns) / 1e9;
+}
+
+static void print_worker_table(const char* title, const char* color,
+                               const WorkerStats* blocks, int n, uint64_t now_ns) {
+    printf("%s%s:\033[0m\n", color, title);
+    printf("  %-8s %-10s %-12s %-9s %-11s %-9s %-9s %-9s %-9s %-9s\n",
+           "PID", "Chars", "Chars/s", "Esperas", "Bloq.(ms)",
+           "p50(us)", "p99(us)", "p999(us)", "Inicio", "Fin");
+    printf("  %-8s %-10s %-12s %-9s %-11s %-9s %-9s %-9s %-9s %-9s\n",
+           "--------", "----------", "------------", "---------", "-----------",
+           "---------", "---------", "---------", "---------", "---------");
+
+    LatencyHistogram* merged = calloc(1, sizeof(LatencyHistogram));
+    uint64_t total_chars = 0, total_waits = 0, total_blocked = 0;
+    uint64_t first_start = 0, last_end = 0;
+
+    for (int i = 0; i < n; i++) {
+        const WorkerStats* ws = &blocks[i];
+        if (!ws->in_use) continue;
+
+        uint64_t waits = 0, blocked = 0;
+        for (int s = 0; s < SEM_COUNT; s++) {
+            waits   += ws->sem_waits[s];
+            blocked += ws->sem_blocked_ns[s];
+        }
+        double secs = worker_elapsed_s(ws, now_ns);
+        double rate = secs > 0.0 ? (double)ws->chars / secs : 0.0;
+
+        char a[20] = {0}, b[20] = {0};
+        fmt_time(a, sizeof(a), ws->start_ns);
+        fmt_time(b, sizeof(b), ws->end_ns);
+        printf("  %-8d %-10llu %-12.1f %-9llu %-11.2f %-9.2f %-9.2f %-9.2f %-9s %-9s\n",
+               ws->pid, (unsigned long long)ws->chars, rate,
+               (unsigned long long)waits, (double)blocked / 1e6,
+               hist_percentile(&ws->service, 0.50) / 1e3,
+               hist_percentile(&ws->service, 0.99) / 1e3,
+               hist_percentile(&ws->service, 0.999) / 1e3,
+               a, b);
+
+        total_chars   += ws->chars;
+        total_waits   += waits;
+        total_blocked += blocked;
+        uint64_t end = ws->end_ns ? ws->end_ns : now_ns;
+        if (ws->start_ns && (first_start == 0 || ws->start_ns < first_start)) first_start = ws->start_ns;
+        if (end > last_end) last_end = end;
+        if (merged) hist_merge(merged, &ws->service);
+    }
+
+    double span = (first_start && last_end > first_start)
+                ? (double)(last_end - first_start) / 1e9 : 0.0;
+    printf("  %-8s %-10llu %-12.1f %-9llu %-11.2f",
+           "TOTAL", (unsigned long long)total_chars,
+           span > 0.0 ? (double)total_chars / span : 0.0,
+           (unsigned long long)total_waits, (double)total_blocked / 1e6);
+    if (merged) {
+        printf(" %-9.2f %-9.2f %-9.2f", hist_percentile(merged, 0.50) / 1e3,
+               hist_percentile(merged, 0.99) / 1e3, hist_percentile(merged, 0.999) / 1e3);
+        if (merged->count > 0) {
+            printf(" (media %.2f us, máx %.2f us)",
+                   (double)merged->sum_ns / (double)merged->count / 1e3,
+                   (double)merged->max_ns / 1e3);
+        }
+    }
+    printf("\n\n");
+    free(merged);
+}
+
+static void print_semaphore_contention(const SharedMemory* shm, int emisores_n, int receptores_n) {
+    static const char* names[SEM_COUNT] = {
+        SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+        SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+    };
+
+    printf("\033[1;36mContención por Semáforo:\033[0m\n");
+    printf("  %-22s %-12s %-14s %-12s %-14s\n",
+           "Semáforo", "Esperas(E)", "Bloq.(ms)(E)", "Esperas(R)", "Bloq.(ms)(R)");
+    for (int s = 0; s < SEM_COUNT; s++) {
+        uint64_t we = 0, be = 0, wr = 0, br = 0;
+        for (int i = 0; i < emisores_n; i++) {
+            we += shm->emisor_stats[i].sem_waits[s];
+            be += shm->emisor_stats[i].sem_blocked_ns[s];
+        }
+        for (int i = 0; i < receptores_n; i++) {
+            wr += shm->receptor_stats[i].sem_waits[s];
+            br += shm->receptor_stats[i].sem_blocked_ns[s];
+        }
+        printf("  %-22s %-12llu %-14.2f %-12llu %-14.2f\n", names[s],
+               (unsigned long long)we, (double)be / 1e6,
+               (unsigned long long)wr, (double)br / 1e6);
+    }
+    printf("\n");
+}
+
+/*
+ * Latencias extremo a extremo por receptor (us), separando la espera en el
+ * buffer (emisión -> extracción) del procesamiento (extracción -> escritura).
+ * Con la ley de Little (L = λ·W) estima cuántos slots ocupa en promedio el
+ * tráfico observado, como referencia para dimensionar buffer_size.
+ */
+static void print_latency_breakdown(const SharedMemory* shm, int receptores_n,
+                                    int buf_sz, uint64_t now_ns) {
+    printf("\033[1;36mLatencia Extremo a Extremo (us):\033[0m\n");
+    printf("  %-8s %-10s %-9s %-9s %-9s %-9s %-9s %-9s %-9s\n",
+           "PID", "Muestras", "e2e p50", "e2e p99", "e2e p999",
+           "cola p50", "cola p99", "proc p50", "proc p99");
+
+    LatencyHistogram* tot = calloc(3, sizeof(LatencyHistogram));
+    uint64_t first_start = 0, last_end = 0;
+
+    for (int i = 0; i < receptores_n; i++) {
+        const WorkerStats* ws = &shm->receptor_stats[i];
+        const ReceptorLatency* lat = &shm->receptor_latency[i];
+        if (!ws->in_use) continue;
+
+        printf("  %-8d %-10llu %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f\n",
+               ws->pid, (unsigned long long)lat->e2e.count,
+               hist_percentile(&lat->e2e, 0.50) / 1e3,
+               hist_percentile(&lat->e2e, 0.99) / 1e3,
+               hist_percentile(&lat->e2e, 0.999) / 1e3,
+               hist_percentile(&lat->queue, 0.50) / 1e3,
+               hist_percentile(&lat->queue, 0.99) / 1e3,
+               hist_percentile(&lat->processing, 0.50) / 1e3,
+               hist_percentile(&lat->processing, 0.99) / 1e3);
+
+        uint64_t end = ws->end_ns ? ws->end_ns : now_ns;
+        if (ws->start_ns && (first_start == 0 || ws->start_ns < first_start)) first_start = ws->start_ns;
+        if (end > last_end) last_end = end;
+        if (tot) {
+            hist_merge(&tot[0], &lat->e2e);
+            hist_merge(&tot[1], &lat->queue);
+            hist_merge(&tot[2], &lat->processing);
+        }
+    }
+
+    if (!tot) { printf("\n"); return; }
+
+    printf("  %-8s %-10llu %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f %-9.2f\n",
+           "TOTAL", (unsigned long long)tot[0].count,
+           hist_percentile(&tot[0], 0.50) / 1e3, hist_percentile(&tot[0], 0.99) / 1e3,
+           hist_percentile(&tot[0], 0.999) / 1e3,
+           hist_percentile(&tot[1], 0.50) / 1e3, hist_percentile(&tot[1], 0.99) / 1e3,
+           hist_percentile(&tot[2], 0.50) / 1e3, hist_percentile(&tot[2], 0.99) / 1e3);
+
+    double span = (first_start && last_end > first_start)
+                ? (double)(last_end - first_start) / 1e9 : 0.0;
+    if (tot[0].count > 0 && span > 0.0) {
+        double lambda     = (double)tot[0].count / span;
+        double queue_mean = (double)tot[1].sum_ns / (double)tot[1].count / 1e9;
+        double proc_mean  = (double)tot[2].sum_ns / (double)tot[2].count / 1e9;
+        double queue_p99  = (double)hist_percentile(&tot[1], 0.99) / 1e9;
+
+        printf("  Tiempo medio en cola: %.2f us | procesamiento: %.2f us\n",
+               queue_mean * 1e6, proc_mean * 1e6);
+        printf("  Ocupación media (Little, λ=%.1f chars/s): %.1f slots en cola, %.1f en proceso\n",
+               lambda, lambda * queue_mean, lambda * proc_mean);
+        printf("  buffer_size sugerido (λ·p99 cola + proceso): %.0f slots (actual: %d)\n",
+               lambda * (queue_p99 + proc_mean) + 1.0, buf_sz);
+        if (queue_mean > 10.0 * proc_mean && lambda * queue_mean >= 0.9 * (double)buf_sz) {
+            printf("\033[33m  ! El buffer pasa lleno: los receptores son el cuello de botella,"
+                   " más slots no aumentan el throughput\033[0m\n");
+        }
+    }
+    printf("\n");
+    free(tot);
 }
 
 void print_statistics(SharedMemory* shm) {
@@ -53,10 +267,10 @@ void print_statistics(SharedMemory* shm) {
 
     /* Límites explícitos en líneas separadas para evitar -Wmisleading-indentation */
     if (emisores_n < 0)  emisores_n = 0;
-    if (emisores_n > 100) emisores_n = 100;
+    if (emisores_n > MAX_WORKERS) emisores_n = MAX_WORKERS;
 
     if (receptores_n < 0)  receptores_n = 0;
-    if (receptores_n > 100) receptores_n = 100;
+    if (receptores_n > MAX_WORKERS) receptores_n = MAX_WORKERS;
 
     printf("\033[1;36m╔════════════════════════════════════════════════════════════╗\033[0m\n");
     printf("\033[1;36m║                ESTADÍSTICAS DEL SISTEMA                    ║\033[0m\n");
@@ -85,8 +299,8 @@ void print_statistics(SharedMemory* shm) {
     /* Uso (estimado) */
     size_t buffer_bytes = (size_t)buf_sz * sizeof(CharacterSlot);
     size_t queue_bytes  = 2ULL * (size_t)buf_sz * sizeof(SlotRef);
-    size_t stats_bytes  = (sizeof(ProcessStats) * 200);
-    size_t total_bytes  = sizeof(SharedMemory) + buffer_bytes + queue_bytes + stats_bytes;
+    size_t stats_bytes  = sizeof(WorkerStats) * 2 * MAX_WORKERS + sizeof(shm->receptor_latency);
+    size_t total_bytes  = sizeof(SharedMemory) + buffer_bytes + queue_bytes; /* stats ya incluidas */
 
     printf("\n\033[1;36mUso de Memoria:\033[0m\n");
     printf("  Buffer de caracteres: %zu bytes\n", buffer_bytes);
@@ -96,31 +310,11 @@ void print_statistics(SharedMemory* shm) {
            total_bytes, (float)total_bytes / (1024.0f * 1024.0f));
     fflush(stdout);
 
-    /* Emisores */
-    printf("\033[1;32mEstadísticas de Emisores:\033[0m\n");
-    printf("  %-10s %-15s %-20s %-20s\n", "PID", "Chars Proc.", "Tiempo Inicio", "Tiempo Fin");
-    printf("  %-10s %-15s %-20s %-20s\n", "----------", "---------------", "--------------------", "--------------------");
-    for (int i = 0; i < emisores_n; i++) {
-        ProcessStats st = shm->emisor_stats[i];
-        char a[20]={0}, b[20]={0};
-        fmt_time(a, sizeof(a), st.start_time);
-        fmt_time(b, sizeof(b), st.end_time);
-        printf("  %-10d %-15d %-20s %-20s\n", st.pid, st.chars_processed, a, b);
-    }
-    printf("\n");
-    fflush(stdout);
-
-    /* Receptores (encabezado SIEMPRE) */
-    printf("\033[1;35mEstadísticas de Receptores:\033[0m\n");
-    printf("  %-10s %-15s %-20s %-20s\n", "PID", "Chars Proc.", "Tiempo Inicio", "Tiempo Fin");
-    printf("  %-10s %-15s %-20s %-20s\n", "----------", "---------------", "--------------------", "--------------------");
-    for (int i = 0; i < receptores_n; i++) {
-        ProcessStats st = shm->receptor_stats[i];
-        char a[20]={0}, b[20]={0};
-        fmt_time(a, sizeof(a), st.start_time);
-        fmt_time(b, sizeof(b), st.end_time);
-        printf("  %-10d %-15d %-20s %-20s\n", st.pid, st.chars_processed, a, b);
-    }
-    printf("\n");
+    /* Estadísticas por proceso y agregadas (tiempos de servicio en us) */
+    uint64_t now_ns = timebase_now_ns();
+    print_worker_table("Estadísticas de Emisores", "\033[1;32m", shm->emisor_stats, emisores_n, now_ns);
+    print_worker_table("Estadísticas de Receptores", "\033[1;35m", shm->receptor_stats, receptores_n, now_ns);
+    print_semaphore_contention(shm, emisores_n, receptores_n);
+    print_latency_breakdown(shm, receptores_n, buf_sz, now_ns);
     fflush(stdout);
 }
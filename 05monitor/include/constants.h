@@ -0,0 +1,49 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+// Clave de memoria compartida (System V SHM)
+#define SHM_BASE_KEY 0x1234
+
+// Colores para output
+#define RED     "\x1b[31m"
+#define GREEN   "\x1b[32m"
+#define YELLOW  "\x1b[33m"
+#define BLUE    "\x1b[34m"
+#define MAGENTA "\x1b[35m"
+#define CYAN    "\x1b[36m"
+#define WHITE   "\x1b[37m"
+#define RESET   "\x1b[0m"
+#define BOLD    "\x1b[1m"
+
+// Semáforos POSIX nombrados (persisten en /dev/shm/sem.*)
+#define SEM_NAME_GLOBAL_MUTEX   "/sem_global_mutex"
+#define SEM_NAME_ENCRYPT_QUEUE  "/sem_encrypt_queue"
+#define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
+#define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
+#define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+
+// Estados de retorno
+#define SUCCESS  0
+#define ERROR   -1
+
+// Capturas sin bloqueo (seqlock)
+#define SNAPSHOT_MAX_RETRIES 64       // Reintentos antes de aceptar una copia incoherente
+#define SNAPSHOT_QUEUE_SAMPLE 256     // Elementos de cada cola (desencriptación, etapas) leídos desde head
+
+// Exportador de métricas (formato de texto Prometheus)
+#define DEFAULT_EXPORT_INTERVAL_MS 1000
+#define MIN_EXPORT_INTERVAL_MS     50
+#define MAX_EXPORT_INTERVAL_MS     60000
+#define STALL_THRESHOLD_MS         1000   // Bloqueado/sin progreso más que esto = estancado
+#define EXPORT_BUFFER_SIZE         (1 << 20)
+#define CLIENT_TIMEOUT_MS          100    // Tiempo máximo atendiendo a un cliente del socket
+
+// Vista en vivo (monitor top)
+#define DEFAULT_TOP_HZ             20
+#define MIN_TOP_HZ                 10
+#define MAX_TOP_HZ                 50
+#define TOP_HISTORY                120    // Muestras en cada sparkline
+#define TOP_EWMA_TAU_MS            1000   // Constante de tiempo de las tasas suavizadas
+#define TOP_SCREEN_BUFFER_SIZE     (256 * 1024)
+
+#endif // CONSTANTS_H
@@ -0,0 +1,26 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <stddef.h>
+#include "structures.h"
+#include "snapshot.h"
+
+/*
+ * Exportador de métricas en formato de texto Prometheus:
+ *  - file_path: se reescribe atómicamente (tmp + rename) en cada intervalo.
+ *  - socket_path: socket Unix; cada conexión recibe la última captura
+ *    (con cabecera HTTP si el cliente envía "GET", p. ej. curl --unix-socket).
+ *  - Sin file_path ni socket_path, la captura se imprime en stdout.
+ */
+typedef struct {
+    const char* file_path;
+    const char* socket_path;
+    int         interval_ms;
+    int         once;           // Exportar una sola captura y salir
+} ExporterConfig;
+
+size_t render_prometheus(const Snapshot* cur, const Snapshot* prev,
+                         uint64_t scrape_ns, char* buf, size_t cap);
+int    run_exporter(const SharedMemory* shm, const ExporterConfig* cfg);
+
+#endif // EXPORTER_H
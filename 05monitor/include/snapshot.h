@@ -0,0 +1,101 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include "structures.h"
+
+/*
+ * Copia coherente del estado del pipeline tomada sin semáforos:
+ * colas y bloques WorkerStats se copian bajo su seqlock; los contadores
+ * globales (int alineados) se leen de forma individual.
+ */
+typedef struct {
+    uint64_t taken_ns;              // Instante de la captura (base de tiempo del run)
+
+    int buffer_size;
+    int total_chars_in_file;
+    int job_count;
+    int current_txt_index;
+    int total_chars_processed;
+    int total_emisores;
+    int active_emisores;
+    int total_receptores;
+    int active_receptores;
+    int shutdown_flag;
+    int      daemon;                // 1 si el inicializador corre en modo demonio
+    uint32_t batch;                 // Lote de entrada en curso (batch_current)
+    uint32_t batches_done;          // Último lote completo
+    int      stream;                // 1 si la entrada llega en streaming
+    int      stream_eof;            // La fuente terminó
+    int      ring_capacity;         // Bytes del anillo de entrada (streaming)
+    int      ring_pending;          // Bytes en el anillo sin tomar por emisores
+    int      sink_window;           // Ventana de la salida ordenada (0 = sin --sink)
+    int      sink_committed;        // Bytes ya enviados al destino
+    int      sink_pending;          // Índices tomados aún no enviados (ocupación de la ventana)
+    uint64_t sink_writes;           // Llamadas a writev del volcador
+    int      stage_count;           // Etapas intermedias (0 = sin --stages)
+    int      active_etapas;
+    int      total_etapas;
+    int      stage_op[MAX_STAGES];
+    uint32_t stage_passed[MAX_STAGES];
+    Queue    stage_queues[MAX_STAGES];
+    int      stage_min_text;        // Menor text_index en las colas de etapas (-1 = vacías)
+    int      group_count;           // Grupos de receptores (0 = sin --groups)
+    uint32_t group_lag[MAX_GROUPS];     // Publicaciones que el grupo aún no reclamó
+    uint32_t group_written[MAX_GROUPS]; // Caracteres que escribió el grupo
+
+    Queue encrypt_queue;
+    Queue decrypt_queue;
+    SlotRef* decrypt_items;         // Primeros elementos de la cola de desencriptación (desde head)
+    int      decrypt_items_n;       // Elementos copiados en decrypt_items
+    int      decrypt_items_cap;     // Capacidad reservada (0 = sólo la cabecera de la cola)
+    int      sem_values[SEM_COUNT]; // -1 si el semáforo no está disponible
+
+    int             emisores_n;
+    int             receptores_n;
+    WorkerStats     emisores[MAX_WORKERS];
+    WorkerStats     receptores[MAX_WORKERS];
+    ReceptorLatency latency[MAX_WORKERS];
+
+    uint64_t retries;               // Reintentos de seqlock en esta captura
+    uint64_t torn;                  // Copias aceptadas sin lograr coherencia
+} Snapshot;
+
+/* Desorden de la cola de desencriptación respecto al orden del texto */
+typedef struct {
+    int min_text;       // Menor text_index en cola (-1 si está vacía)
+    int max_text;       // Mayor text_index en cola
+    int spread;         // max_text - min_text
+    int search_depth;   // Posición del mínimo desde head (trabajo del dequeue ordenado)
+} ReorderInfo;
+
+/*
+ * Acceso de sólo lectura al segmento y captura:
+ *  - monitor_attach: adjunta la SHM con SHM_RDONLY (nunca escribe en ella).
+ *  - monitor_detach: desadjunta la SHM.
+ *  - monitor_segment_alive: 0 si el segmento fue eliminado (IPC_RMID).
+ *  - monitor_open_semaphores / monitor_close_semaphores: handles para sem_getvalue.
+ *  - snapshot_alloc / snapshot_free: Snapshot con espacio para copiar los
+ *    primeros elementos de la cola (sólo la vista en vivo los usa).
+ *  - snapshot_take: llena un Snapshot sin tomar ningún semáforo.
+ *  - snapshot_reorder: desorden de los primeros elementos de la cola de
+ *    desencriptación.
+ *  - snapshot_committed_prefix: caracteres iniciales ya escritos (aproximado;
+ *    no ve el carácter que un proceso etapa tiene entre dos colas).
+ *  - snapshot_worker_up: 1 si el trabajador sigue vivo y sin terminar.
+ *  - sem_index_name: nombre POSIX de un índice SEM_IDX_*.
+ */
+const SharedMemory* monitor_attach(void);
+void                monitor_detach(const SharedMemory* shm);
+int                 monitor_segment_alive(void);
+void                monitor_open_semaphores(void);
+void                monitor_close_semaphores(void);
+Snapshot*           snapshot_alloc(int buffer_size);
+void                snapshot_free(Snapshot* snap);
+void                snapshot_take(const SharedMemory* shm, Snapshot* snap);
+ReorderInfo         snapshot_reorder(const Snapshot* snap);
+int                 snapshot_committed_prefix(const Snapshot* snap);
+int                 snapshot_worker_up(const WorkerStats* ws);
+const char*         sem_index_name(int idx);
+
+#endif // SNAPSHOT_H
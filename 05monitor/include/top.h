@@ -0,0 +1,20 @@
+#ifndef TOP_H
+#define TOP_H
+
+#include "structures.h"
+
+/*
+ * Vista interactiva estilo top del pipeline:
+ *  - hz: frecuencia de refresco (MIN_TOP_HZ..MAX_TOP_HZ).
+ *  - Ocupación de colas y throughput con historial (sparklines),
+ *    tabla por trabajador con tasa suavizada (EWMA), desorden de la cola
+ *    de desencriptación y prefijo de salida ya confirmado.
+ *  - 'q' o Ctrl-C para salir.
+ */
+typedef struct {
+    int hz;
+} TopConfig;
+
+int run_top(const SharedMemory* shm, const TopConfig* cfg);
+
+#endif // TOP_H
@@ -0,0 +1,521 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include "exporter.h"
+#include "constants.h"
+#include "timebase.h"
+
+/**
+ * Módulo Exportador de Métricas
+ *
+ * Cada intervalo toma una captura sin bloqueos (snapshot.c), la
+ * renderiza como texto Prometheus y la publica en un archivo y/o en un
+ * socket Unix. Las tasas (chars/s) se calculan contra la captura
+ * anterior, de modo que el exportador no agrega ningún contador a los
+ * trabajadores: todo se deriva de lo que ya escriben en sus bloques.
+ */
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+// =============================================================================
+// RENDERIZADO
+// =============================================================================
+
+typedef struct {
+    char*  buf;
+    size_t cap;
+    size_t len;
+} OutBuf;
+
+static void out_printf(OutBuf* o, const char* fmt, ...) {
+    if (o->len >= o->cap) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(o->buf + o->len, o->cap - o->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    o->len += (size_t)n;
+    if (o->len >= o->cap) o->len = o->cap - 1;  // Truncado: se conserva lo escrito
+}
+
+static void out_header(OutBuf* o, const char* name, const char* type, const char* help) {
+    out_printf(o, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/* Valor más alto representado por un bucket del histograma logarítmico */
+static uint64_t hist_bucket_upper(int idx) {
+    if (idx < HIST_SUB_BUCKETS) return (uint64_t)idx;
+    int shift = idx / HIST_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(idx % HIST_SUB_BUCKETS);
+    return ((HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static void hist_merge(LatencyHistogram* dst, const LatencyHistogram* src) {
+    dst->count  += src->count;
+    dst->sum_ns += src->sum_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    for (int i = 0; i < HIST_BUCKETS; i++) dst->buckets[i] += src->buckets[i];
+}
+
+/* Percentil q (0..1) en ns; se acota por el máximo observado */
+static uint64_t hist_percentile(const LatencyHistogram* h, double q) {
+    uint64_t total = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) total += h->buckets[i];
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t v = hist_bucket_upper(i);
+            return (h->max_ns > 0 && v > h->max_ns) ? h->max_ns : v;
+        }
+    }
+    return h->max_ns;
+}
+
+static void out_summary(OutBuf* o, const char* name, const char* labels, const LatencyHistogram* h) {
+    static const double qs[] = { 0.5, 0.99, 0.999 };
+    for (size_t i = 0; i < sizeof(qs) / sizeof(qs[0]); i++) {
+        out_printf(o, "%s{%s%squantile=\"%g\"} %.9f\n", name, labels, labels[0] ? "," : "",
+                   qs[i], (double)hist_percentile(h, qs[i]) / 1e9);
+    }
+    out_printf(o, "%s_sum{%s} %.9f\n", name, labels, (double)h->sum_ns / 1e9);
+    out_printf(o, "%s_count{%s} %llu\n", name, labels, (unsigned long long)h->count);
+}
+
+static int worker_is_stalled(const WorkerStats* ws, uint64_t now_ns) {
+    if (!snapshot_worker_up(ws) || ws->blocked_on < 0) return 0;
+    return now_ns > ws->blocked_since_ns
+        && now_ns - ws->blocked_since_ns >= (uint64_t)STALL_THRESHOLD_MS * 1000000ULL;
+}
+
+/* Familias de métricas por trabajador (cada una se emite como un solo grupo) */
+enum {
+    WM_UP, WM_CHARS, WM_RATE, WM_STALLED, WM_BLOCKED, WM_SEM_WAITS, WM_SEM_BLOCKED, WM_COUNT
+};
+
+static const char* g_wm_meta[WM_COUNT][3] = {
+    { "ipc_worker_up", "gauge", "1 si el proceso sigue vivo y registrado" },
+    { "ipc_worker_chars_total", "counter", "Caracteres procesados por el proceso" },
+    { "ipc_worker_chars_per_second", "gauge", "Tasa desde la captura anterior" },
+    { "ipc_worker_stalled", "gauge", "1 si lleva bloqueado más del umbral de estancamiento" },
+    { "ipc_worker_blocked_seconds", "gauge", "Duración del bloqueo en curso" },
+    { "ipc_worker_sem_waits_total", "counter", "Esperas bloqueantes por semáforo" },
+    { "ipc_worker_sem_blocked_seconds_total", "counter", "Tiempo bloqueado por semáforo" },
+};
+
+static void render_worker_sample(OutBuf* o, int metric, const char* lbl, const WorkerStats* ws,
+                                 const WorkerStats* before, double dt_s, uint64_t now_ns) {
+    const char* name = g_wm_meta[metric][0];
+    switch (metric) {
+    case WM_UP:
+        out_printf(o, "%s{%s} %d\n", name, lbl, snapshot_worker_up(ws));
+        break;
+    case WM_CHARS:
+        out_printf(o, "%s{%s} %llu\n", name, lbl, (unsigned long long)ws->chars);
+        break;
+    case WM_RATE: {
+        double rate = 0.0;
+        if (before && dt_s > 0.0 && ws->chars >= before->chars) {
+            rate = (double)(ws->chars - before->chars) / dt_s;
+        }
+        out_printf(o, "%s{%s} %.3f\n", name, lbl, rate);
+        break;
+    }
+    case WM_STALLED:
+        out_printf(o, "%s{%s} %d\n", name, lbl, worker_is_stalled(ws, now_ns));
+        break;
+    case WM_BLOCKED:
+        if (snapshot_worker_up(ws) && ws->blocked_on >= 0 && now_ns > ws->blocked_since_ns) {
+            out_printf(o, "%s{%s,sem=\"%s\"} %.6f\n", name, lbl, sem_index_name(ws->blocked_on),
+                       (double)(now_ns - ws->blocked_since_ns) / 1e9);
+        }
+        break;
+    case WM_SEM_WAITS:
+    case WM_SEM_BLOCKED:
+        for (int s = 0; s < SEM_COUNT; s++) {
+            if (ws->sem_waits[s] == 0) continue;
+            if (metric == WM_SEM_WAITS) {
+                out_printf(o, "%s{%s,sem=\"%s\"} %llu\n", name, lbl, sem_index_name(s),
+                           (unsigned long long)ws->sem_waits[s]);
+            } else {
+                out_printf(o, "%s{%s,sem=\"%s\"} %.6f\n", name, lbl, sem_index_name(s),
+                           (double)ws->sem_blocked_ns[s] / 1e9);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void render_workers(OutBuf* o, const Snapshot* cur, const Snapshot* prev, double dt_s) {
+    for (int metric = 0; metric < WM_COUNT; metric++) {
+        out_header(o, g_wm_meta[metric][0], g_wm_meta[metric][1], g_wm_meta[metric][2]);
+        for (int role = 0; role < 2; role++) {
+            const WorkerStats* blocks = role == 0 ? cur->emisores : cur->receptores;
+            int n = role == 0 ? cur->emisores_n : cur->receptores_n;
+            const WorkerStats* pblocks = prev ? (role == 0 ? prev->emisores : prev->receptores) : NULL;
+            int pn = prev ? (role == 0 ? prev->emisores_n : prev->receptores_n) : 0;
+
+            for (int i = 0; i < n; i++) {
+                const WorkerStats* ws = &blocks[i];
+                if (!ws->in_use) continue;
+                const WorkerStats* before = (pblocks && i < pn && pblocks[i].pid == ws->pid)
+                                          ? &pblocks[i] : NULL;
+                char lbl[64];
+                snprintf(lbl, sizeof(lbl), "role=\"%s\",pid=\"%d\"",
+                         role == 0 ? "emisor" : "receptor", (int)ws->pid);
+                render_worker_sample(o, metric, lbl, ws, before, dt_s, cur->taken_ns);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Renderiza una captura en formato de texto Prometheus
+ *
+ * @param cur Captura actual
+ * @param prev Captura anterior (para tasas), puede ser NULL
+ * @param scrape_ns Duración de la captura en ns (se exporta como métrica)
+ * @param buf Buffer de salida
+ * @param cap Capacidad del buffer
+ * @return Bytes escritos (sin el terminador)
+ */
+size_t render_prometheus(const Snapshot* cur, const Snapshot* prev,
+                         uint64_t scrape_ns, char* buf, size_t cap) {
+    OutBuf o = { buf, cap, 0 };
+    if (!buf || cap == 0) return 0;
+    buf[0] = '\0';
+
+    double dt_s = (prev && cur->taken_ns > prev->taken_ns)
+                ? (double)(cur->taken_ns - prev->taken_ns) / 1e9 : 0.0;
+
+    out_header(&o, "ipc_up", "gauge", "1 si el segmento de memoria compartida existe");
+    out_printf(&o, "ipc_up 1\n");
+    out_header(&o, "ipc_shutdown_flag", "gauge", "Bandera de finalización en la SHM");
+    out_printf(&o, "ipc_shutdown_flag %d\n", cur->shutdown_flag);
+    out_header(&o, "ipc_buffer_slots", "gauge", "Slots del buffer circular (buffer_size)");
+    out_printf(&o, "ipc_buffer_slots %d\n", cur->buffer_size);
+    out_header(&o, "ipc_chars_in_file", "gauge", "Caracteres del archivo de entrada");
+    out_printf(&o, "ipc_chars_in_file %d\n", cur->total_chars_in_file);
+    out_header(&o, "ipc_jobs", "gauge", "Trabajos (archivos de entrada) en el segmento");
+    out_printf(&o, "ipc_jobs %d\n", cur->job_count);
+    if (cur->daemon) {
+        out_header(&o, "ipc_batch", "gauge", "Lote de entrada en curso (modo demonio)");
+        out_printf(&o, "ipc_batch %u\n", cur->batch);
+        out_header(&o, "ipc_batches_done_total", "counter", "Lotes completos (modo demonio)");
+        out_printf(&o, "ipc_batches_done_total %u\n", cur->batches_done);
+    }
+    if (cur->stream) {
+        out_header(&o, "ipc_stream_ring_bytes", "gauge", "Bytes del anillo de entrada sin tomar (streaming)");
+        out_printf(&o, "ipc_stream_ring_bytes %d\n", cur->ring_pending);
+        out_header(&o, "ipc_stream_ring_capacity_bytes", "gauge", "Capacidad del anillo de entrada (streaming)");
+        out_printf(&o, "ipc_stream_ring_capacity_bytes %d\n", cur->ring_capacity);
+        out_header(&o, "ipc_stream_eof", "gauge", "1 si la fuente en streaming terminó");
+        out_printf(&o, "ipc_stream_eof %d\n", cur->stream_eof);
+    }
+    if (cur->sink_window) {
+        out_header(&o, "ipc_sink_committed_bytes_total", "counter", "Bytes enviados en orden al destino (--sink)");
+        out_printf(&o, "ipc_sink_committed_bytes_total %d\n", cur->sink_committed);
+        out_header(&o, "ipc_sink_window_bytes", "gauge", "Índices tomados aún no enviados al destino");
+        out_printf(&o, "ipc_sink_window_bytes %d\n", cur->sink_pending);
+        out_header(&o, "ipc_sink_window_capacity_bytes", "gauge", "Tamaño de la ventana de reordenamiento");
+        out_printf(&o, "ipc_sink_window_capacity_bytes %d\n", cur->sink_window);
+        out_header(&o, "ipc_sink_writes_total", "counter", "Llamadas a writev del volcador de salida");
+        out_printf(&o, "ipc_sink_writes_total %llu\n", (unsigned long long)cur->sink_writes);
+    }
+    out_header(&o, "ipc_chars_claimed_total", "counter", "Índices de texto tomados por emisores");
+    out_printf(&o, "ipc_chars_claimed_total %d\n", cur->total_chars_processed);
+
+    uint64_t written = 0;
+    for (int i = 0; i < cur->receptores_n; i++) written += cur->receptores[i].chars;
+    out_header(&o, "ipc_chars_written_total", "counter", "Caracteres escritos por receptores");
+    out_printf(&o, "ipc_chars_written_total %llu\n", (unsigned long long)written);
+
+    out_header(&o, "ipc_queue_depth", "gauge", "Elementos en cada cola");
+    out_printf(&o, "ipc_queue_depth{queue=\"encrypt\"} %d\n", cur->encrypt_queue.size);
+    out_printf(&o, "ipc_queue_depth{queue=\"decrypt\"} %d\n", cur->decrypt_queue.size);
+    out_header(&o, "ipc_queue_capacity", "gauge", "Capacidad de cada cola");
+    out_printf(&o, "ipc_queue_capacity{queue=\"encrypt\"} %d\n", cur->encrypt_queue.capacity);
+    out_printf(&o, "ipc_queue_capacity{queue=\"decrypt\"} %d\n", cur->decrypt_queue.capacity);
+
+    if (cur->stage_count > 0) {
+        out_header(&o, "ipc_stage_queue_depth", "gauge", "Elementos en la cola de cada etapa intermedia");
+        for (int k = 0; k < cur->stage_count; k++) {
+            out_printf(&o, "ipc_stage_queue_depth{stage=\"%d\",op=\"%s\"} %d\n", k,
+                       stage_op_name(cur->stage_op[k]), cur->stage_queues[k].size);
+        }
+        out_header(&o, "ipc_stage_passed_total", "counter", "Caracteres que salieron de cada etapa intermedia");
+        for (int k = 0; k < cur->stage_count; k++) {
+            out_printf(&o, "ipc_stage_passed_total{stage=\"%d\",op=\"%s\"} %u\n", k,
+                       stage_op_name(cur->stage_op[k]), cur->stage_passed[k]);
+        }
+    }
+
+    if (cur->group_count > 0) {
+        out_header(&o, "ipc_group_lag", "gauge", "Publicaciones que cada grupo de receptores aún no reclamó");
+        for (int g = 0; g < cur->group_count; g++) {
+            out_printf(&o, "ipc_group_lag{group=\"%d\"} %u\n", g, cur->group_lag[g]);
+        }
+        out_header(&o, "ipc_group_written_total", "counter", "Caracteres escritos por cada grupo de receptores");
+        for (int g = 0; g < cur->group_count; g++) {
+            out_printf(&o, "ipc_group_written_total{group=\"%d\"} %u\n", g, cur->group_written[g]);
+        }
+    }
+
+    out_header(&o, "ipc_semaphore_value", "gauge", "Valor actual de cada semáforo POSIX");
+    for (int s = 0; s < SEM_COUNT; s++) {
+        out_printf(&o, "ipc_semaphore_value{sem=\"%s\"} %d\n", sem_index_name(s), cur->sem_values[s]);
+    }
+
+    out_header(&o, "ipc_active_workers", "gauge", "Procesos registrados y activos");
+    out_printf(&o, "ipc_active_workers{role=\"emisor\"} %d\n", cur->active_emisores);
+    out_printf(&o, "ipc_active_workers{role=\"receptor\"} %d\n", cur->active_receptores);
+    if (cur->stage_count > 0) out_printf(&o, "ipc_active_workers{role=\"etapa\"} %d\n", cur->active_etapas);
+    out_header(&o, "ipc_registered_workers_total", "counter", "Procesos registrados desde el inicio");
+    out_printf(&o, "ipc_registered_workers_total{role=\"emisor\"} %d\n", cur->total_emisores);
+    out_printf(&o, "ipc_registered_workers_total{role=\"receptor\"} %d\n", cur->total_receptores);
+    if (cur->stage_count > 0) {
+        out_printf(&o, "ipc_registered_workers_total{role=\"etapa\"} %d\n", cur->total_etapas);
+    }
+
+    render_workers(&o, cur, prev, dt_s);
+
+    LatencyHistogram* h = calloc(5, sizeof(LatencyHistogram));
+    if (h) {
+        for (int i = 0; i < cur->emisores_n; i++) hist_merge(&h[0], &cur->emisores[i].service);
+        for (int i = 0; i < cur->receptores_n; i++) {
+            hist_merge(&h[1], &cur->receptores[i].service);
+            hist_merge(&h[2], &cur->latency[i].e2e);
+            hist_merge(&h[3], &cur->latency[i].queue);
+            hist_merge(&h[4], &cur->latency[i].processing);
+        }
+        out_header(&o, "ipc_service_seconds", "summary", "Tiempo de servicio por carácter");
+        out_summary(&o, "ipc_service_seconds", "role=\"emisor\"", &h[0]);
+        out_summary(&o, "ipc_service_seconds", "role=\"receptor\"", &h[1]);
+        out_header(&o, "ipc_latency_seconds", "summary", "Latencia emisión->escritura por etapa");
+        out_summary(&o, "ipc_latency_seconds", "stage=\"e2e\"", &h[2]);
+        out_summary(&o, "ipc_latency_seconds", "stage=\"queue\"", &h[3]);
+        out_summary(&o, "ipc_latency_seconds", "stage=\"processing\"", &h[4]);
+        free(h);
+    }
+
+    out_header(&o, "ipc_snapshot_retries", "gauge", "Reintentos de seqlock en la última captura");
+    out_printf(&o, "ipc_snapshot_retries %llu\n", (unsigned long long)cur->retries);
+    out_header(&o, "ipc_snapshot_torn", "gauge", "Bloques copiados sin coherencia en la última captura");
+    out_printf(&o, "ipc_snapshot_torn %llu\n", (unsigned long long)cur->torn);
+    out_header(&o, "ipc_scrape_duration_seconds", "gauge", "Duración de la captura");
+    out_printf(&o, "ipc_scrape_duration_seconds %.9f\n", (double)scrape_ns / 1e9);
+
+    return o.len;
+}
+
+// =============================================================================
+// PUBLICACIÓN
+// =============================================================================
+
+/* Reemplazo atómico: los lectores nunca ven un archivo a medio escribir */
+static int publish_file(const char* path, const char* text, size_t len) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    FILE* f = fopen(tmp, "w");
+    if (!f) {
+        fprintf(stderr, RED "[ERROR] No se pudo escribir %s: %s\n" RESET, tmp, strerror(errno));
+        return ERROR;
+    }
+    size_t w = fwrite(text, 1, len, f);
+    if (fclose(f) != 0 || w != len || rename(tmp, path) != 0) {
+        fprintf(stderr, RED "[ERROR] No se pudo publicar %s: %s\n" RESET, path, strerror(errno));
+        unlink(tmp);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+static int open_listen_socket(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, RED "[ERROR] Ruta de socket demasiado larga: %s\n" RESET, path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        fprintf(stderr, RED "[ERROR] socket(): %s\n" RESET, strerror(errno));
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, 16) == -1) {
+        fprintf(stderr, RED "[ERROR] bind/listen en %s: %s\n" RESET, path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+static void write_all(int fd, const char* p, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w <= 0) {
+            if (w < 0 && errno == EINTR) continue;
+            return;     // Cliente lento o desconectado: se abandona
+        }
+        p += w;
+        len -= (size_t)w;
+    }
+}
+
+/**
+ * @brief Atiende a un cliente del socket con la última captura
+ *
+ * Si el cliente envía una petición HTTP (curl --unix-socket) se antepone
+ * una cabecera HTTP/1.0; si no envía nada se responde el texto plano.
+ */
+static void serve_client(int cfd, const char* text, size_t len) {
+    struct timeval tv = { 0, CLIENT_TIMEOUT_MS * 1000 };
+    setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    char req[512];
+    ssize_t r = 0;
+    struct pollfd pfd = { cfd, POLLIN, 0 };
+    if (poll(&pfd, 1, CLIENT_TIMEOUT_MS) > 0) r = read(cfd, req, sizeof(req) - 1);
+
+    if (r >= 4 && strncmp(req, "GET ", 4) == 0) {
+        char hdr[160];
+        int n = snprintf(hdr, sizeof(hdr),
+                         "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: %zu\r\n\r\n", len);
+        write_all(cfd, hdr, (size_t)n);
+    }
+    write_all(cfd, text, len);
+    close(cfd);
+}
+
+static void drain_clients(int lfd, const char* text, size_t len) {
+    for (;;) {
+        int cfd = accept(lfd, NULL, NULL);
+        if (cfd == -1) return;
+        serve_client(cfd, text, len);
+    }
+}
+
+/**
+ * @brief Bucle principal del exportador
+ *
+ * Captura, renderiza y publica cada interval_ms hasta recibir SIGINT/
+ * SIGTERM o hasta que el segmento sea eliminado (se publica una última
+ * captura con ipc_up 0).
+ *
+ * @param shm SHM adjunta en sólo lectura
+ * @param cfg Configuración del exportador
+ * @return SUCCESS o ERROR
+ */
+int run_exporter(const SharedMemory* shm, const ExporterConfig* cfg) {
+    if (!shm || !cfg) return ERROR;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;      // Sin SA_RESTART: poll() despierta con EINTR
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Sin el contenido de la cola: desorden y prefijo confirmado son de la vista en vivo
+    Snapshot* snaps[2] = { snapshot_alloc(0), snapshot_alloc(0) };
+    char* text = malloc(EXPORT_BUFFER_SIZE);
+    if (!snaps[0] || !snaps[1] || !text) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para capturas\n" RESET);
+        snapshot_free(snaps[0]);
+        snapshot_free(snaps[1]);
+        free(text);
+        return ERROR;
+    }
+
+    int lfd = -1;
+    if (cfg->socket_path && (lfd = open_listen_socket(cfg->socket_path)) == -1) {
+        snapshot_free(snaps[0]);
+        snapshot_free(snaps[1]);
+        free(text);
+        return ERROR;
+    }
+
+    monitor_open_semaphores();
+
+    Snapshot* cur = snaps[0];
+    Snapshot* prev = NULL;
+    size_t len = 0;
+    int alive = 1;
+
+    while (!g_stop && alive) {
+        uint64_t t0 = timebase_now_ns();
+        snapshot_take(shm, cur);
+        len = render_prometheus(cur, prev, timebase_now_ns() - t0, text, EXPORT_BUFFER_SIZE);
+
+        if (cfg->file_path) publish_file(cfg->file_path, text, len);
+        if (!cfg->file_path && !cfg->socket_path) {
+            fwrite(text, 1, len, stdout);
+            fflush(stdout);
+        }
+        if (cfg->once) break;
+
+        prev = cur;
+        cur = (cur == snaps[0]) ? snaps[1] : snaps[0];
+
+        // Esperar al siguiente intervalo atendiendo clientes del socket
+        uint64_t deadline = t0 + (uint64_t)cfg->interval_ms * 1000000ULL;
+        for (;;) {
+            uint64_t now = timebase_now_ns();
+            if (g_stop || now >= deadline) break;
+            int timeout = (int)((deadline - now + 999999ULL) / 1000000ULL);
+            struct pollfd pfd = { lfd, POLLIN, 0 };
+            int rc = poll(lfd >= 0 ? &pfd : NULL, lfd >= 0 ? 1 : 0, timeout);
+            if (rc > 0) drain_clients(lfd, text, len);
+        }
+
+        alive = monitor_segment_alive();
+    }
+
+    if (!alive) {
+        // El segmento fue eliminado: la última publicación lo indica
+        static const char down[] = "# HELP ipc_up 1 si el segmento de memoria compartida existe\n"
+                                   "# TYPE ipc_up gauge\nipc_up 0\n";
+        if (cfg->file_path) publish_file(cfg->file_path, down, sizeof(down) - 1);
+        printf(YELLOW "[MONITOR] El segmento fue eliminado; exportador terminado\n" RESET);
+    }
+
+    if (lfd >= 0) {
+        close(lfd);
+        unlink(cfg->socket_path);
+    }
+    monitor_close_semaphores();
+    snapshot_free(snaps[0]);
+    snapshot_free(snaps[1]);
+    free(text);
+    return SUCCESS;
+}
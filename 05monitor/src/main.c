@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+#include "structures.h"
+#include "snapshot.h"
+#include "exporter.h"
+#include "top.h"
+#include "instance.h"
+
+/**
+ * Monitor del Sistema de Comunicación entre Procesos
+ *
+ * Se adjunta a la memoria compartida en modo sólo lectura y observa el
+ * pipeline mientras corre, sin tomar semáforos ni escribir en la SHM.
+ *
+ * Modos:
+ *  - export: publica métricas en formato de texto Prometheus.
+ *  - top: vista en vivo de colas, trabajadores y progreso.
+ */
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s export [--file RUTA] [--socket RUTA] [--interval MS] [--once]\n", argv0);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --file RUTA      Reescribe RUTA atómicamente en cada intervalo\n");
+    fprintf(stderr, "  --socket RUTA    Sirve la última captura en un socket Unix\n");
+    fprintf(stderr, "                   (curl --unix-socket RUTA http://localhost/metrics)\n");
+    fprintf(stderr, "  --interval MS    Intervalo entre capturas (%d..%d, por omisión %d)\n",
+            MIN_EXPORT_INTERVAL_MS, MAX_EXPORT_INTERVAL_MS, DEFAULT_EXPORT_INTERVAL_MS);
+    fprintf(stderr, "  --once           Una sola captura y salir\n");
+    fprintf(stderr, "  Sin --file ni --socket las capturas se imprimen en stdout.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  %s top [--hz N]\n", argv0);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --hz N           Refrescos por segundo (%d..%d, por omisión %d); 'q' para salir\n",
+            MIN_TOP_HZ, MAX_TOP_HZ, DEFAULT_TOP_HZ);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --instance NOMBRE (o IPC_INSTANCE) elige la instancia a observar\n");
+}
+
+/**
+ * @brief Parsea un entero dentro de un rango
+ *
+ * @return 1 si es válido, 0 si no
+ */
+static int parse_int_range(const char* s, int lo, int hi, int* out) {
+    char* end = NULL;
+    long v = strtol(s, &end, 10);
+    if (!s[0] || *end != '\0' || v < lo || v > hi) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+static int cmd_export(int argc, char* argv[]) {
+    ExporterConfig cfg = { NULL, NULL, DEFAULT_EXPORT_INTERVAL_MS, 0 };
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            cfg.file_path = argv[++i];
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            cfg.socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            if (!parse_int_range(argv[++i], MIN_EXPORT_INTERVAL_MS, MAX_EXPORT_INTERVAL_MS,
+                                 &cfg.interval_ms)) {
+                fprintf(stderr, RED "[ERROR] Intervalo inválido: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--once") == 0) {
+            cfg.once = 1;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const SharedMemory* shm = monitor_attach();
+    if (!shm) return EXIT_FAILURE;
+
+    if (cfg.file_path || cfg.socket_path) {
+        printf(CYAN "[MONITOR] Exportando métricas cada %d ms", cfg.interval_ms);
+        if (cfg.file_path)   printf(" -> archivo %s", cfg.file_path);
+        if (cfg.socket_path) printf(" -> socket %s", cfg.socket_path);
+        printf("\n" RESET);
+    }
+
+    int rc = run_exporter(shm, &cfg);
+    monitor_detach(shm);
+    return rc == SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int cmd_top(int argc, char* argv[]) {
+    TopConfig cfg = { DEFAULT_TOP_HZ };
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) {
+            if (!parse_int_range(argv[++i], MIN_TOP_HZ, MAX_TOP_HZ, &cfg.hz)) {
+                fprintf(stderr, RED "[ERROR] Frecuencia inválida: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const SharedMemory* shm = monitor_attach();
+    if (!shm) return EXIT_FAILURE;
+
+    int rc = run_top(shm, &cfg);
+    monitor_detach(shm);
+    return rc == SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (strcmp(argv[1], "export") == 0) return cmd_export(argc, argv);
+    if (strcmp(argv[1], "top") == 0) return cmd_top(argc, argv);
+
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+}
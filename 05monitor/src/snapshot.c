@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include "snapshot.h"
+#include "constants.h"
+#include "timebase.h"
+#include "instance.h"
+
+/**
+ * Módulo de Captura sin Bloqueos
+ *
+ * El monitor nunca toma /sem_global_mutex ni los semáforos de las colas:
+ * adjunta el segmento en modo sólo lectura y copia cada estructura con
+ * el protocolo de seqlock definido en structures.h. Si un escritor está
+ * a mitad de una modificación (seq impar) o la modifica durante la copia
+ * (seq cambió), la copia se repite. Los trabajadores nunca esperan al
+ * monitor, así que el camino caliente no se ve afectado.
+ */
+
+static int    g_shm_id = -1;
+static sem_t* g_sems[SEM_COUNT];
+
+static const char* g_sem_names[SEM_COUNT] = {
+    SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+    SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+};
+
+/**
+ * @brief Copia una región protegida por un seqlock
+ *
+ * @param seq Contador de secuencia del escritor
+ * @param dst Destino de la copia
+ * @param src Región compartida
+ * @param n Bytes a copiar
+ * @param snap Captura donde se contabilizan reintentos y copias incoherentes
+ */
+static void seq_copy(const uint32_t* seq, void* dst, const void* src, size_t n, Snapshot* snap) {
+    for (int attempt = 0; attempt < SNAPSHOT_MAX_RETRIES; attempt++) {
+        uint32_t s1 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1u) == 0) {
+            memcpy(dst, src, n);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s1) return;
+        }
+        snap->retries++;
+    }
+    // Escritor muerto a mitad de una escritura o contención extrema: mejor esfuerzo
+    memcpy(dst, src, n);
+    snap->torn++;
+}
+
+static int read_int(const int* p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Copia la cola de desencriptación y su contenido bajo un mismo seqlock
+ *
+ * El contenido se copia desde head en orden lógico, de modo que
+ * decrypt_items[0] es el próximo elemento que vería un dequeue FIFO.
+ * Sólo se copian los primeros decrypt_items_cap elementos: los emisores
+ * encolan casi en orden y los receptores sacan el menor índice, así que
+ * el mínimo está cerca de head, y la ventana del seqlock no crece con
+ * el tamaño del buffer.
+ */
+static void copy_decrypt_queue(const SharedMemory* shm, Snapshot* snap) {
+    const Queue* q = &shm->decrypt_queue;
+    const SlotRef* arr = (const SlotRef*)((const char*)shm + q->array_offset);
+
+    for (int attempt = 0; attempt <= SNAPSHOT_MAX_RETRIES; attempt++) {
+        uint32_t s1 = __atomic_load_n(&q->seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1u) == 0 || attempt == SNAPSHOT_MAX_RETRIES) {
+            memcpy(&snap->decrypt_queue, q, sizeof(Queue));
+            int cap = snap->decrypt_queue.capacity;
+            int n = snap->decrypt_queue.size;
+            if (n > snap->decrypt_items_cap) n = snap->decrypt_items_cap;
+            if (cap <= 0 || n < 0) n = 0;
+            for (int i = 0, pos = snap->decrypt_queue.head; i < n; i++, pos = (pos + 1) % cap) {
+                snap->decrypt_items[i] = arr[pos];
+            }
+            snap->decrypt_items_n = n;
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&q->seq, __ATOMIC_RELAXED) == s1 && (s1 & 1u) == 0) return;
+            if (attempt == SNAPSHOT_MAX_RETRIES) {
+                snap->torn++;
+                return;
+            }
+        }
+        snap->retries++;
+    }
+}
+
+/**
+ * @brief Copia la cola de una etapa y el menor text_index de su principio
+ *
+ * Igual que copy_decrypt_queue: la cabecera y los elementos se leen bajo
+ * el seqlock de la cola y sólo los primeros SNAPSHOT_QUEUE_SAMPLE desde
+ * head, donde esperan los índices más antiguos.
+ *
+ * @return Menor text_index visto, -1 si la cola está vacía
+ */
+static int copy_stage_queue(const SharedMemory* shm, const Queue* q, Queue* dst, Snapshot* snap) {
+    const SlotRef* arr = (const SlotRef*)((const char*)shm + q->array_offset);
+    int min_text = -1;
+
+    for (int attempt = 0; attempt <= SNAPSHOT_MAX_RETRIES; attempt++) {
+        uint32_t s1 = __atomic_load_n(&q->seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1u) == 0 || attempt == SNAPSHOT_MAX_RETRIES) {
+            memcpy(dst, q, sizeof(Queue));
+            int cap = dst->capacity;
+            int n = dst->size;
+            if (n > SNAPSHOT_QUEUE_SAMPLE) n = SNAPSHOT_QUEUE_SAMPLE;
+            if (cap <= 0 || n < 0) n = 0;
+            min_text = -1;
+            for (int i = 0, pos = dst->head; i < n; i++, pos = (pos + 1) % cap) {
+                int t = arr[pos].text_index;
+                if (t >= 0 && (min_text < 0 || t < min_text)) min_text = t;
+            }
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&q->seq, __ATOMIC_RELAXED) == s1 && (s1 & 1u) == 0) return min_text;
+            if (attempt == SNAPSHOT_MAX_RETRIES) {
+                snap->torn++;
+                return min_text;
+            }
+        }
+        snap->retries++;
+    }
+    return min_text;
+}
+
+/**
+ * @brief Adjunta la memoria compartida en modo sólo lectura
+ *
+ * @return Puntero constante a la SHM, NULL si no existe
+ */
+const SharedMemory* monitor_attach(void) {
+    g_shm_id = shmget(instance_shm_key(), 0, 0);
+    if (g_shm_id == -1) {
+        fprintf(stderr, RED "[ERROR] No se encontró memoria compartida con key 0x%08X: %s\n" RESET,
+                (unsigned)instance_shm_key(), strerror(errno));
+        return NULL;
+    }
+
+    const SharedMemory* shm = (const SharedMemory*)shmat(g_shm_id, NULL, SHM_RDONLY);
+    if (shm == (const void*)-1) {
+        fprintf(stderr, RED "[ERROR] shmat(SHM_RDONLY) falló: %s\n" RESET, strerror(errno));
+        return NULL;
+    }
+    if (shm->buffer_size <= 0) {
+        fprintf(stderr, RED "[ERROR] Memoria compartida no inicializada\n" RESET);
+        shmdt(shm);
+        return NULL;
+    }
+    if (instance_check(shm) != SUCCESS) {
+        shmdt(shm);
+        return NULL;
+    }
+
+    timebase_attach(&shm->timebase);
+    return shm;
+}
+
+void monitor_detach(const SharedMemory* shm) {
+    if (shm) shmdt(shm);
+}
+
+/**
+ * @brief Indica si el segmento sigue vivo
+ *
+ * El finalizador marca el segmento con IPC_RMID; seguimos adjuntos pero
+ * el kernel lo reporta como SHM_DEST (o ya no existe el id).
+ *
+ * @return 1 si sigue vivo, 0 si fue eliminado
+ */
+int monitor_segment_alive(void) {
+    struct shmid_ds ds;
+    if (g_shm_id == -1 || shmctl(g_shm_id, IPC_STAT, &ds) == -1) return 0;
+    return (ds.shm_perm.mode & SHM_DEST) == 0;
+}
+
+/**
+ * @brief Abre (sin crear) los semáforos nombrados para leer sus valores
+ *
+ * Los que no existan quedan en NULL y se reportan como -1.
+ */
+void monitor_open_semaphores(void) {
+    for (int i = 0; i < SEM_COUNT; i++) {
+        g_sems[i] = sem_open(instance_sem(g_sem_names[i]), 0);
+        if (g_sems[i] == SEM_FAILED) g_sems[i] = NULL;
+    }
+}
+
+void monitor_close_semaphores(void) {
+    for (int i = 0; i < SEM_COUNT; i++) {
+        if (g_sems[i]) sem_close(g_sems[i]);
+        g_sems[i] = NULL;
+    }
+}
+
+const char* sem_index_name(int idx) {
+    return (idx >= 0 && idx < SEM_COUNT) ? g_sem_names[idx] : "-";
+}
+
+/**
+ * @brief Reserva un Snapshot capaz de copiar el principio de la cola de desencriptación
+ *
+ * @param buffer_size Capacidad de la cola (0 = no copiar su contenido); la
+ *                    copia se limita a SNAPSHOT_QUEUE_SAMPLE elementos
+ * @return Snapshot en cero, NULL si no hay memoria
+ */
+Snapshot* snapshot_alloc(int buffer_size) {
+    Snapshot* snap = calloc(1, sizeof(Snapshot));
+    if (!snap) return NULL;
+    int items = buffer_size < SNAPSHOT_QUEUE_SAMPLE ? buffer_size : SNAPSHOT_QUEUE_SAMPLE;
+    if (items > 0) {
+        snap->decrypt_items = calloc((size_t)items, sizeof(SlotRef));
+        if (!snap->decrypt_items) {
+            free(snap);
+            return NULL;
+        }
+        snap->decrypt_items_cap = items;
+    }
+    return snap;
+}
+
+void snapshot_free(Snapshot* snap) {
+    if (!snap) return;
+    free(snap->decrypt_items);
+    free(snap);
+}
+
+/**
+ * @brief Captura el estado del pipeline sin tomar semáforos
+ *
+ * @param shm SHM adjunta en sólo lectura
+ * @param snap Captura de salida (se sobrescribe por completo)
+ */
+void snapshot_take(const SharedMemory* shm, Snapshot* snap) {
+    if (!shm || !snap) return;
+
+    snap->retries = 0;
+    snap->torn    = 0;
+    snap->taken_ns = timebase_now_ns();
+
+    snap->buffer_size           = read_int(&shm->buffer_size);
+    snap->total_chars_in_file   = read_int(&shm->total_chars_in_file);
+    snap->job_count             = read_int(&shm->job_count);
+    // Primero el índice global: todo índice menor ya está publicado en algún bloque o cola
+    snap->current_txt_index     = __atomic_load_n(&shm->current_txt_index, __ATOMIC_ACQUIRE);
+    snap->total_chars_processed = read_int(&shm->total_chars_processed);
+    snap->total_emisores        = read_int(&shm->total_emisores);
+    snap->active_emisores       = read_int(&shm->active_emisores);
+    snap->total_receptores      = read_int(&shm->total_receptores);
+    snap->active_receptores     = read_int(&shm->active_receptores);
+    snap->shutdown_flag         = read_int(&shm->shutdown_flag);
+    snap->daemon                = read_int(&shm->daemon_pid) != 0;
+    snap->batch                 = batch_current(shm);
+    snap->batches_done          = __atomic_load_n(&shm->batch_done, __ATOMIC_ACQUIRE);
+    snap->stream                = read_int(&shm->stream);
+    snap->stream_eof            = read_int(&shm->stream_eof);
+    snap->ring_capacity         = read_int(&shm->file_capacity);
+    // total se leyó antes que el índice: puede quedar por debajo
+    snap->ring_pending          = snap->total_chars_in_file > snap->current_txt_index
+                                ? snap->total_chars_in_file - snap->current_txt_index : 0;
+    snap->sink_window           = read_int(&shm->sink_window);
+    snap->sink_committed        = read_int(&shm->sink_committed);
+    snap->sink_writes           = __atomic_load_n(&shm->sink_writes, __ATOMIC_RELAXED);
+    snap->sink_pending          = snap->current_txt_index > snap->sink_committed
+                                ? snap->current_txt_index - snap->sink_committed : 0;
+
+    seq_copy(&shm->encrypt_queue.seq, &snap->encrypt_queue, &shm->encrypt_queue, sizeof(Queue), snap);
+
+    // Etapas intermedias: estado de cada cola y el menor índice que espera en ellas
+    int ns = read_int(&shm->stage_count);
+    snap->stage_count   = ns < 0 ? 0 : (ns > MAX_STAGES ? MAX_STAGES : ns);
+    snap->active_etapas = read_int(&shm->active_etapas);
+    snap->total_etapas  = read_int(&shm->total_etapas);
+    snap->stage_min_text = -1;
+    for (int k = 0; k < snap->stage_count; k++) {
+        const Stage* stg = &shm->stages[k];
+        snap->stage_op[k] = stg->op;
+        snap->stage_passed[k] = __atomic_load_n(&stg->passed, __ATOMIC_RELAXED);
+        int t = copy_stage_queue(shm, &stg->queue, &snap->stage_queues[k], snap);
+        if (t >= 0 && (snap->stage_min_text < 0 || t < snap->stage_min_text)) snap->stage_min_text = t;
+    }
+
+    for (int i = 0; i < SEM_COUNT; i++) {
+        int v = -1;
+        if (g_sems[i] && sem_getvalue(g_sems[i], &v) != 0) v = -1;
+        snap->sem_values[i] = v;
+    }
+
+    int ne = read_int(&shm->emisor_stats_count);
+    int nr = read_int(&shm->receptor_stats_count);
+    snap->emisores_n   = ne < 0 ? 0 : (ne > MAX_WORKERS ? MAX_WORKERS : ne);
+    snap->receptores_n = nr < 0 ? 0 : (nr > MAX_WORKERS ? MAX_WORKERS : nr);
+
+    for (int i = 0; i < snap->emisores_n; i++) {
+        const WorkerStats* ws = &shm->emisor_stats[i];
+        seq_copy(&ws->seq, &snap->emisores[i], ws, sizeof(WorkerStats), snap);
+    }
+    for (int i = 0; i < snap->receptores_n; i++) {
+        const WorkerStats* ws = &shm->receptor_stats[i];
+        // El bloque de latencias se actualiza bajo el seqlock del WorkerStats del receptor
+        seq_copy(&ws->seq, &snap->receptores[i], ws, sizeof(WorkerStats), snap);
+        seq_copy(&ws->seq, &snap->latency[i], &shm->receptor_latency[i], sizeof(ReceptorLatency), snap);
+    }
+
+    // La cola al final: un índice que un trabajador ya soltó debe aparecer aquí
+    if (snap->decrypt_items) {
+        copy_decrypt_queue(shm, snap);
+    } else {
+        seq_copy(&shm->decrypt_queue.seq, &snap->decrypt_queue, &shm->decrypt_queue, sizeof(Queue), snap);
+        snap->decrypt_items_n = 0;
+    }
+
+    // Difusión: publicadas = recuperadas + en el anillo; cada grupo va por su cursor
+    int ng = read_int(&shm->group_count);
+    snap->group_count = ng < 0 ? 0 : (ng > MAX_GROUPS ? MAX_GROUPS : ng);
+    if (snap->group_count > 0) {
+        uint32_t published = __atomic_load_n(&shm->bcast_reclaimed, __ATOMIC_ACQUIRE)
+                           + (uint32_t)snap->decrypt_queue.size;
+        for (int g = 0; g < snap->group_count; g++) {
+            uint32_t next = __atomic_load_n(&shm->groups[g].next, __ATOMIC_RELAXED);
+            snap->group_lag[g] = next < published ? published - next : 0;
+            snap->group_written[g] = __atomic_load_n(&shm->groups[g].written, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Mide el desorden de la cola de desencriptación
+ *
+ * Los emisores encolan en orden de llegada y los receptores extraen el
+ * menor text_index, así que spread indica cuánto se adelantaron algunos
+ * emisores y search_depth cuánto recorre cada dequeue ordenado. Se mide
+ * sobre los elementos copiados (ver SNAPSHOT_QUEUE_SAMPLE).
+ */
+ReorderInfo snapshot_reorder(const Snapshot* snap) {
+    ReorderInfo r = { -1, -1, 0, 0 };
+    if (!snap || snap->decrypt_items_n <= 0) return r;
+
+    r.min_text = INT_MAX;
+    for (int i = 0; i < snap->decrypt_items_n; i++) {
+        int t = snap->decrypt_items[i].text_index;
+        if (t < r.min_text) {
+            r.min_text = t;
+            r.search_depth = i;
+        }
+        if (t > r.max_text) r.max_text = t;
+    }
+    r.spread = r.max_text - r.min_text;
+    return r;
+}
+
+/**
+ * @brief Prefijo del archivo de salida ya escrito
+ *
+ * Es el menor índice que todavía no se escribió: el mínimo entre el
+ * próximo índice a emitir, los índices en manos de emisores/receptores
+ * vivos y los que esperan en la cola de desencriptación o en la de alguna
+ * etapa intermedia. Las lecturas no
+ * son atómicas entre sí, por lo que el valor es aproximado (puede
+ * adelantarse por un instante si un índice cambia de manos durante la captura).
+ *
+ * @return Cantidad de caracteres iniciales ya confirmados
+ */
+int snapshot_committed_prefix(const Snapshot* snap) {
+    if (!snap) return 0;
+    int prefix = snap->current_txt_index;
+    if (prefix > snap->total_chars_in_file) prefix = snap->total_chars_in_file;
+
+    for (int role = 0; role < 2; role++) {
+        const WorkerStats* blocks = role == 0 ? snap->emisores : snap->receptores;
+        int n = role == 0 ? snap->emisores_n : snap->receptores_n;
+        for (int i = 0; i < n; i++) {
+            int t = blocks[i].inflight_text_index;
+            if (blocks[i].in_use && blocks[i].end_ns == 0 && t >= 0 && t < prefix) prefix = t;
+        }
+    }
+    for (int i = 0; i < snap->decrypt_items_n; i++) {
+        int t = snap->decrypt_items[i].text_index;
+        if (t >= 0 && t < prefix) prefix = t;
+    }
+    if (snap->stage_min_text >= 0 && snap->stage_min_text < prefix) prefix = snap->stage_min_text;
+    return prefix;
+}
+
+/**
+ * @brief Indica si un trabajador sigue vivo
+ *
+ * Un trabajador terminado tiene end_ns; uno que murió sin desregistrarse
+ * no, pero kill(pid, 0) ya no lo encuentra.
+ *
+ * @return 1 si está registrado, sin terminar y el proceso existe
+ */
+int snapshot_worker_up(const WorkerStats* ws) {
+    if (!ws->in_use || ws->end_ns != 0) return 0;
+    return kill(ws->pid, 0) == 0 || errno == EPERM;
+}
@@ -0,0 +1,457 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include "top.h"
+#include "snapshot.h"
+#include "constants.h"
+#include "timebase.h"
+
+/**
+ * Módulo de Vista en Vivo (monitor top)
+ *
+ * Redibuja el estado del pipeline varias veces por segundo a partir de
+ * capturas sin bloqueos (snapshot.c). Igual que el exportador, no agrega
+ * trabajo a emisores ni receptores: las tasas se derivan de la diferencia
+ * entre capturas consecutivas y se suavizan con una media exponencial,
+ * y el historial de ocupación/throughput se guarda sólo en el monitor.
+ *
+ * Cada cuadro se arma completo en memoria y se escribe con un solo
+ * write() para evitar parpadeo; el terminal se deja en modo no canónico
+ * para leer 'q' sin esperar Enter.
+ */
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+// =============================================================================
+// PANTALLA
+// =============================================================================
+
+typedef struct {
+    char*  buf;
+    size_t cap;
+    size_t len;
+} Screen;
+
+static void scr_printf(Screen* s, const char* fmt, ...) {
+    if (s->len >= s->cap) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s->buf + s->len, s->cap - s->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    s->len += (size_t)n;
+    if (s->len >= s->cap) s->len = s->cap - 1;
+}
+
+/* Termina la línea borrando lo que quedaba del cuadro anterior */
+static void scr_eol(Screen* s) {
+    scr_printf(s, "\x1b[K\n");
+}
+
+typedef struct {
+    double v[TOP_HISTORY];
+    int    n;       // Muestras válidas
+    int    pos;     // Próxima posición a escribir
+} Series;
+
+static void series_push(Series* s, double v) {
+    s->v[s->pos] = v;
+    s->pos = (s->pos + 1) % TOP_HISTORY;
+    if (s->n < TOP_HISTORY) s->n++;
+}
+
+static double series_max(const Series* s) {
+    double m = 0.0;
+    for (int i = 0; i < s->n; i++) if (s->v[i] > m) m = s->v[i];
+    return m;
+}
+
+/**
+ * @brief Dibuja las últimas 'width' muestras como sparkline
+ *
+ * @param scale Valor que corresponde a la barra llena (<= 0 usa el máximo del historial)
+ */
+static void scr_spark(Screen* s, const Series* series, double scale, int width) {
+    static const char* bars[] = { "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+    if (scale <= 0.0) scale = series_max(series);
+
+    int shown = series->n < width ? series->n : width;
+    for (int i = shown; i < width; i++) scr_printf(s, " ");
+    for (int i = shown; i > 0; i--) {
+        double v = series->v[(series->pos - i + TOP_HISTORY) % TOP_HISTORY];
+        int level = scale > 0.0 ? (int)(v / scale * 7.0 + 0.5) : 0;
+        if (level < 0) level = 0;
+        if (level > 7) level = 7;
+        scr_printf(s, "%s", bars[level]);
+    }
+}
+
+static void scr_bar(Screen* s, int value, int capacity, int width) {
+    int fill = capacity > 0 ? (int)((long)value * width / capacity) : 0;
+    if (value > 0 && fill == 0) fill = 1;
+    if (fill > width) fill = width;
+    scr_printf(s, "[");
+    for (int i = 0; i < width; i++) scr_printf(s, i < fill ? "#" : ".");
+    scr_printf(s, "]");
+}
+
+/* Nombre corto del semáforo para la columna de estado */
+static const char* sem_short_name(int idx) {
+    const char* name = sem_index_name(idx);
+    return strncmp(name, "/sem_", 5) == 0 ? name + 5 : name;
+}
+
+static void term_size(int* rows, int* cols) {
+    struct winsize wz;
+    *rows = 40;
+    *cols = 100;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &wz) == 0 && wz.ws_row > 0 && wz.ws_col > 0) {
+        *rows = wz.ws_row;
+        *cols = wz.ws_col;
+    }
+}
+
+// =============================================================================
+// ESTADO ENTRE CUADROS
+// =============================================================================
+
+typedef struct {
+    pid_t    pid;
+    uint64_t chars;
+    double   rate;      // chars/s suavizado
+    int      seen;
+} WorkerRate;
+
+typedef struct {
+    Series     enc_occ;
+    Series     dec_occ;
+    Series     throughput;
+    Series     spread;
+    double     total_rate;
+    uint64_t   last_written;
+    int        have_last;
+    WorkerRate rates[2][MAX_WORKERS];
+} TopState;
+
+/**
+ * @brief Media exponencial con constante de tiempo TOP_EWMA_TAU_MS
+ *
+ * alpha = dt / (tau + dt) evita depender de libm y se comporta bien
+ * con cualquier frecuencia de refresco.
+ */
+static double ewma(double prev, double sample, double dt_s, int first) {
+    if (first) return sample;
+    double tau = TOP_EWMA_TAU_MS / 1000.0;
+    double alpha = dt_s / (tau + dt_s);
+    return prev + alpha * (sample - prev);
+}
+
+static void update_rates(TopState* st, const Snapshot* cur, double dt_s) {
+    uint64_t written = 0;
+    for (int role = 0; role < 2; role++) {
+        const WorkerStats* blocks = role == 0 ? cur->emisores : cur->receptores;
+        int n = role == 0 ? cur->emisores_n : cur->receptores_n;
+        for (int i = 0; i < n; i++) {
+            WorkerRate* r = &st->rates[role][i];
+            const WorkerStats* ws = &blocks[i];
+            if (role == 1) written += ws->chars;
+            if (!ws->in_use) continue;
+
+            if (!r->seen || r->pid != ws->pid || ws->chars < r->chars || dt_s <= 0.0) {
+                r->pid = ws->pid;
+                r->chars = ws->chars;
+                r->rate = 0.0;
+                r->seen = 1;
+                continue;
+            }
+            double sample = (double)(ws->chars - r->chars) / dt_s;
+            r->rate = ewma(r->rate, sample, dt_s, 0);
+            r->chars = ws->chars;
+        }
+    }
+
+    double sample = (st->have_last && dt_s > 0.0 && written >= st->last_written)
+                  ? (double)(written - st->last_written) / dt_s : 0.0;
+    st->total_rate = ewma(st->total_rate, sample, dt_s, !st->have_last);
+    st->last_written = written;
+    st->have_last = 1;
+
+    series_push(&st->enc_occ, cur->encrypt_queue.size);
+    series_push(&st->dec_occ, cur->decrypt_queue.size);
+    series_push(&st->throughput, st->total_rate);
+    series_push(&st->spread, snapshot_reorder(cur).spread);
+}
+
+// =============================================================================
+// RENDERIZADO
+// =============================================================================
+
+static void render_worker_row(Screen* s, const char* role, const WorkerStats* ws,
+                              const WorkerRate* r, uint64_t now_ns) {
+    char state[48];
+    const char* color = "";
+    int up = snapshot_worker_up(ws);
+
+    if (!up && ws->end_ns != 0) {
+        snprintf(state, sizeof(state), "terminado");
+    } else if (!up) {
+        snprintf(state, sizeof(state), "muerto");
+        color = RED;
+    } else if (ws->blocked_on >= 0 && now_ns > ws->blocked_since_ns) {
+        uint64_t blocked = now_ns - ws->blocked_since_ns;
+        snprintf(state, sizeof(state), "espera %s %.1fs", sem_short_name(ws->blocked_on),
+                 (double)blocked / 1e9);
+        if (blocked >= (uint64_t)STALL_THRESHOLD_MS * 1000000ULL) color = YELLOW;
+    } else {
+        snprintf(state, sizeof(state), "activo");
+        color = GREEN;
+    }
+
+    char inflight[16] = "-";
+    if (up && ws->inflight_text_index >= 0) {
+        snprintf(inflight, sizeof(inflight), "%d", ws->inflight_text_index);
+    }
+
+    scr_printf(s, " %-8s %8d  %s%-24s" RESET " %10llu %10.0f %10s", role, (int)ws->pid, color, state,
+               (unsigned long long)ws->chars, up ? r->rate : 0.0, inflight);
+    scr_eol(s);
+}
+
+static void render_frame(Screen* s, const TopState* st, const Snapshot* cur,
+                         const TimeBase* tb, int hz) {
+    int rows, cols;
+    term_size(&rows, &cols);
+    int spark_w = cols - 46;
+    if (spark_w > TOP_HISTORY) spark_w = TOP_HISTORY;
+    if (spark_w < 8) spark_w = 8;
+
+    s->len = 0;
+    scr_printf(s, "\x1b[H");
+
+    double elapsed = (double)cur->taken_ns / 1e9;
+    scr_printf(s, BOLD CYAN "ipc top" RESET "  %d Hz  base %s  t=%.1fs  emisores %d/%d  receptores %d/%d%s",
+               hz, timebase_source_name(tb), elapsed, cur->active_emisores, cur->total_emisores,
+               cur->active_receptores, cur->total_receptores,
+               cur->shutdown_flag ? "  " YELLOW "[finalizando]" RESET : "");
+    if (cur->daemon) {
+        scr_printf(s, "  lote %u%s", cur->batch, cur->batches_done == cur->batch ? " (completo)" : "");
+    }
+    if (cur->stream) {
+        scr_printf(s, "  anillo %d/%d KiB%s", cur->ring_pending / 1024, cur->ring_capacity / 1024,
+                   cur->stream_eof ? " (fin del flujo)" : "");
+    }
+    if (cur->sink_window) {
+        scr_printf(s, "  ventana %d/%d KiB", cur->sink_pending / 1024, cur->sink_window / 1024);
+    }
+    if (cur->stage_count > 0) {
+        scr_printf(s, "  etapas %d/%d", cur->active_etapas, cur->total_etapas);
+    }
+    scr_eol(s);
+
+    int total = cur->total_chars_in_file;
+    int prefix = snapshot_committed_prefix(cur);
+    uint64_t written = 0;
+    for (int i = 0; i < cur->receptores_n; i++) written += cur->receptores[i].chars;
+    scr_printf(s, "Texto: tomados %d  escritos %llu  prefijo confirmado ~%d/%d (%.1f%%)",
+               cur->current_txt_index, (unsigned long long)written, prefix, total,
+               total > 0 ? 100.0 * prefix / total : 0.0);
+    scr_eol(s);
+    scr_eol(s);
+
+    const Queue* qs[2] = { &cur->encrypt_queue, &cur->decrypt_queue };
+    const Series* occ[2] = { &st->enc_occ, &st->dec_occ };
+    const char* qnames[2] = { "cifrado", "descifrado" };
+    for (int q = 0; q < 2; q++) {
+        scr_printf(s, " %-10s ", qnames[q]);
+        scr_bar(s, qs[q]->size, qs[q]->capacity, 20);
+        scr_printf(s, " %6d/%-6d ", qs[q]->size, qs[q]->capacity);
+        scr_spark(s, occ[q], qs[q]->capacity, spark_w);
+        scr_eol(s);
+    }
+    for (int k = 0; k < cur->stage_count; k++) {
+        const Queue* q = &cur->stage_queues[k];
+        char label[24];
+        snprintf(label, sizeof(label), "%d %.8s", k, stage_op_name(cur->stage_op[k]));
+        scr_printf(s, " %-10s ", label);
+        scr_bar(s, q->size, q->capacity, 20);
+        scr_printf(s, " %6d/%-6d  salieron %u", q->size, q->capacity, cur->stage_passed[k]);
+        scr_eol(s);
+    }
+    for (int g = 0; g < cur->group_count; g++) {
+        char label[24];
+        snprintf(label, sizeof(label), "grupo %d", g);
+        scr_printf(s, " %-10s ", label);
+        scr_bar(s, (int)cur->group_lag[g], cur->decrypt_queue.capacity, 20);
+        scr_printf(s, " %6u/%-6d  escritos %u", cur->group_lag[g], cur->decrypt_queue.capacity,
+                   cur->group_written[g]);
+        scr_eol(s);
+    }
+
+    scr_printf(s, " %-10s %10.0f chars/s               ", "throughput", st->total_rate);
+    scr_spark(s, &st->throughput, 0.0, spark_w);
+    scr_eol(s);
+
+    ReorderInfo ro = snapshot_reorder(cur);
+    scr_printf(s, " %-10s spread %-6d prof. %-6d      ", "desorden", ro.spread, ro.search_depth);
+    scr_spark(s, &st->spread, 0.0, spark_w);
+    scr_eol(s);
+    if (ro.min_text >= 0) {
+        scr_printf(s, "            en cola: text_index %d..%d (primeros %d de %d elementos)",
+                   ro.min_text, ro.max_text, cur->decrypt_items_n, cur->decrypt_queue.size);
+    }
+    scr_eol(s);
+
+    scr_printf(s, " semáforos ");
+    for (int i = 0; i < SEM_COUNT; i++) scr_printf(s, " %s=%d", sem_short_name(i), cur->sem_values[i]);
+    scr_eol(s);
+    scr_printf(s, " captura: reintentos %llu  incoherentes %llu",
+               (unsigned long long)cur->retries, (unsigned long long)cur->torn);
+    scr_eol(s);
+    scr_eol(s);
+
+    scr_printf(s, BOLD " %-8s %8s  %-24s %10s %10s %10s" RESET, "ROL", "PID", "ESTADO", "CHARS",
+               "CHARS/S", "EN CURSO");
+    scr_eol(s);
+
+    int used = 13;
+    int room = rows - used - 2;
+    if (room < 4) room = 4;
+    int shown = 0, hidden = 0;
+    for (int role = 0; role < 2; role++) {
+        const WorkerStats* blocks = role == 0 ? cur->emisores : cur->receptores;
+        int n = role == 0 ? cur->emisores_n : cur->receptores_n;
+        for (int i = 0; i < n; i++) {
+            if (!blocks[i].in_use) continue;
+            if (shown >= room) {
+                hidden++;
+                continue;
+            }
+            render_worker_row(s, role == 0 ? "emisor" : "receptor", &blocks[i],
+                              &st->rates[role][i], cur->taken_ns);
+            shown++;
+        }
+    }
+    if (hidden > 0) {
+        scr_printf(s, " ... %d trabajadores más", hidden);
+        scr_eol(s);
+    }
+    scr_printf(s, "\x1b[J");
+}
+
+static void write_all(int fd, const char* p, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return;
+        p += w;
+        len -= (size_t)w;
+    }
+}
+
+// =============================================================================
+// BUCLE PRINCIPAL
+// =============================================================================
+
+/**
+ * @brief Ejecuta la vista en vivo hasta 'q', una señal o la eliminación del segmento
+ *
+ * @param shm Segmento adjunto en sólo lectura
+ * @param cfg Frecuencia de refresco
+ * @return SUCCESS o ERROR
+ */
+int run_top(const SharedMemory* shm, const TopConfig* cfg) {
+    Snapshot* snaps[2] = { snapshot_alloc(shm->buffer_size), snapshot_alloc(shm->buffer_size) };
+    TopState* st = calloc(1, sizeof(TopState));
+    Screen scr = { malloc(TOP_SCREEN_BUFFER_SIZE), TOP_SCREEN_BUFFER_SIZE, 0 };
+    if (!snaps[0] || !snaps[1] || !st || !scr.buf) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para la vista en vivo\n" RESET);
+        snapshot_free(snaps[0]);
+        snapshot_free(snaps[1]);
+        free(st);
+        free(scr.buf);
+        return ERROR;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;      // Sin SA_RESTART: poll() despierta con EINTR
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    struct termios saved;
+    int tty = isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0;
+    if (tty) {
+        struct termios raw = saved;
+        raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+    const char* enter = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    write_all(STDOUT_FILENO, enter, strlen(enter));
+
+    monitor_open_semaphores();
+
+    uint64_t period_ns = 1000000000ULL / (uint64_t)cfg->hz;
+    Snapshot* cur = snaps[0];
+    Snapshot* prev = NULL;
+    int segment_gone = 0;
+
+    while (!g_stop) {
+        if (!monitor_segment_alive()) {
+            segment_gone = 1;
+            break;
+        }
+        snapshot_take(shm, cur);
+        double dt_s = (prev && cur->taken_ns > prev->taken_ns)
+                    ? (double)(cur->taken_ns - prev->taken_ns) / 1e9 : 0.0;
+        update_rates(st, cur, dt_s);
+        render_frame(&scr, st, cur, &shm->timebase, cfg->hz);
+        write_all(STDOUT_FILENO, scr.buf, scr.len);
+
+        prev = cur;
+        cur = (cur == snaps[0]) ? snaps[1] : snaps[0];
+
+        // Espera hasta el próximo cuadro atendiendo el teclado
+        uint64_t deadline = timebase_now_ns() + period_ns;
+        for (;;) {
+            uint64_t now = timebase_now_ns();
+            if (g_stop || now >= deadline) break;
+            struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+            int timeout_ms = (int)((deadline - now + 999999ULL) / 1000000ULL);
+            int rc = poll(&pfd, tty ? 1 : 0, timeout_ms);
+            if (rc > 0 && (pfd.revents & POLLIN)) {
+                char c;
+                if (read(STDIN_FILENO, &c, 1) == 1 && (c == 'q' || c == 'Q')) g_stop = 1;
+            }
+        }
+    }
+
+    const char* leave = "\x1b[?25h\x1b[?1049l";
+    write_all(STDOUT_FILENO, leave, strlen(leave));
+    if (tty) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+
+    if (segment_gone && prev) {
+        printf(CYAN "[MONITOR] Segmento eliminado. Última captura: %d/%d caracteres confirmados\n" RESET,
+               snapshot_committed_prefix(prev), prev->total_chars_in_file);
+    }
+
+    monitor_close_semaphores();
+    snapshot_free(snaps[0]);
+    snapshot_free(snaps[1]);
+    free(st);
+    free(scr.buf);
+    return SUCCESS;
+}
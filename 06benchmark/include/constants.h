@@ -0,0 +1,55 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+// Clave de memoria compartida (System V SHM)
+#define SHM_BASE_KEY 0x1234
+
+// Colores para output
+#define RED     "\x1b[31m"
+#define GREEN   "\x1b[32m"
+#define YELLOW  "\x1b[33m"
+#define BLUE    "\x1b[34m"
+#define MAGENTA "\x1b[35m"
+#define CYAN    "\x1b[36m"
+#define WHITE   "\x1b[37m"
+#define RESET   "\x1b[0m"
+#define BOLD    "\x1b[1m"
+
+// Semáforos POSIX nombrados (persisten en /dev/shm/sem.*)
+#define SEM_NAME_GLOBAL_MUTEX   "/sem_global_mutex"
+#define SEM_NAME_ENCRYPT_QUEUE  "/sem_encrypt_queue"
+#define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
+#define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
+#define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+
+// Estados de retorno
+#define SUCCESS  0
+#define ERROR   -1
+
+// Programas del pipeline (relativos a la raíz del repositorio)
+#define PATH_INICIALIZADOR "01inicializador/bin/inicializador"
+#define PATH_EMISOR        "02emisor/bin/emisor"
+#define PATH_RECEPTOR      "03receptor/bin/receptor"
+
+// Parámetros por omisión del driver
+#define DEFAULT_ROOT_DIR     ".."
+#define DEFAULT_OUT_DIR      "/tmp/ipc_bench_out"
+#define DEFAULT_KEY          "AA"
+#define DEFAULT_BUFFER_SIZE  64
+#define DEFAULT_EMISORES     2
+#define DEFAULT_RECEPTORES   2
+#define DEFAULT_TRIALS       3
+#define DEFAULT_TIMEOUT_S    600
+#define DEFAULT_THRESHOLD    5.0      // % de caída de chars/s que cuenta como regresión
+#define MAX_TRIALS           1000
+
+// Ejes por omisión del barrido (bench sweep)
+#define DEFAULT_SWEEP_WORKERS "1..64"
+#define DEFAULT_SWEEP_BUFFERS "1,16,256,4096,65536,1048576"
+#define DEFAULT_SWEEP_TRIALS  1
+
+// Códigos de salida del driver
+#define EXIT_REGRESSION      2        // Peor que la línea base más allá del umbral
+#define EXIT_VERIFY_FAILED   3        // La salida no coincide con la entrada
+
+#endif // CONSTANTS_H
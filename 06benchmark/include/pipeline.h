@@ -0,0 +1,49 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include "structures.h"
+
+/*
+ * Ejecución de una corrida completa del pipeline:
+ *  - run_trial: inicializador + E emisores + R receptores (IPC_QUIET=1),
+ *    espera a que terminen, verifica la salida (verify_files) y elimina los
+ *    objetos IPC.
+ *  - teardown_ipc: sem_unlink de los cinco semáforos y IPC_RMID del segmento.
+ */
+typedef struct {
+    const char* input_path;
+    const char* root_dir;       // Raíz del repositorio (binarios de cada programa)
+    const char* out_dir;        // RECEPTOR_OUT_DIR de los receptores
+    const char* key;            // Clave de encriptación (2 hex)
+    int         buffer_size;
+    int         emisores;
+    int         receptores;
+    int         timeout_s;      // Límite por corrida (los procesos restantes reciben SIGKILL)
+    int         lanes;          // 0 = cola compartida, -1 = un carril por emisor, N = --lanes N
+} TrialConfig;
+
+typedef struct {
+    int      completed;         // Todos los trabajadores terminaron dentro del límite
+    int      verified;          // La salida coincide con la entrada
+    int      failed_workers;    // Terminaron con error o por señal
+    uint64_t chars;             // Caracteres del archivo
+    double   init_s;            // Duración del inicializador
+    double   wall_s;            // Primer fork de trabajador -> último en terminar
+    double   chars_per_s;
+    double   cpu_user_s;        // Suma de los trabajadores (getrusage de hijos)
+    double   cpu_sys_s;
+    long     vol_ctx;           // Cambios de contexto voluntarios (bloqueos)
+    long     invol_ctx;         // Cambios de contexto involuntarios (desalojos)
+    long     peak_rss_kb;       // Máximo entre los trabajadores
+    uint64_t sem_waits[SEM_COUNT];      // Esperas bloqueantes (WorkerStats, todos)
+    uint64_t sem_blocked_ns[SEM_COUNT];
+    uint64_t mismatched_bytes;  // Bytes distintos de la salida (ver verify.h)
+    uint64_t missing_bytes;     // De ellos, los que quedaron en cero o faltan al final
+    double   verify_s;          // Duración de la verificación
+} TrialResult;
+
+int  run_trial(const TrialConfig* cfg, TrialResult* res);
+void teardown_ipc(void);
+
+#endif // PIPELINE_H
@@ -0,0 +1,40 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdio.h>
+#include "pipeline.h"
+
+/*
+ * Reporte de corridas:
+ *  - report_write: una fila por corrida (CSV) o documento JSON con resumen.
+ *  - report_print_summary: mediana/mín/máx legibles en stderr.
+ *  - baseline_save / baseline_compare: línea base en texto "clave=valor";
+ *    la comparación devuelve 1 si chars/s cae más que threshold_pct.
+ */
+typedef enum { FORMAT_CSV, FORMAT_JSON } OutputFormat;
+
+typedef struct {
+    double median;
+    double min;
+    double max;
+    double mean;
+    double stddev;
+} Summary;
+
+typedef struct {
+    Summary chars_per_s;
+    Summary wall_s;
+    Summary cpu_s;          // usuario + sistema
+    Summary ctx_switches;   // voluntarios + involuntarios
+    long    peak_rss_kb;    // Máximo entre corridas
+    int     trials;
+    int     verified;       // Corridas con salida correcta
+} TrialSummary;
+
+void report_summarize(const TrialResult* r, int n, TrialSummary* out);
+void report_write(FILE* f, OutputFormat fmt, const TrialConfig* cfg, const TrialResult* r, int n);
+void report_print_summary(const TrialConfig* cfg, const TrialSummary* s);
+int  baseline_save(const char* path, const TrialConfig* cfg, const TrialSummary* s);
+int  baseline_compare(const char* path, const TrialConfig* cfg, const TrialSummary* s, double threshold_pct);
+
+#endif // REPORT_H
@@ -0,0 +1,30 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdio.h>
+#include "pipeline.h"
+
+/*
+ * Barrido de escalabilidad (emisores × receptores × buffer_size):
+ *  - sweep_parse_axis: "1,2,8" o "1..64" (potencias de 2 entre ambos extremos).
+ *  - run_sweep: una fila CSV por punto (formato largo, listo para pivotar a
+ *    un mapa de calor) con throughput y contención por semáforo. Con resume
+ *    se omiten los puntos ya presentes en el archivo de salida.
+ */
+#define SWEEP_MAX_POINTS 64
+
+typedef struct {
+    TrialConfig base;                   // input, rutas, clave, timeout
+    int         emisores[SWEEP_MAX_POINTS];
+    int         n_emisores;
+    int         receptores[SWEEP_MAX_POINTS];
+    int         n_receptores;
+    int         buffers[SWEEP_MAX_POINTS];
+    int         n_buffers;
+    int         trials;                 // Corridas por punto (se reporta la mediana)
+} SweepConfig;
+
+int sweep_parse_axis(const char* spec, int lo, int hi, int* out, int* count);
+int run_sweep(const SweepConfig* sc, const char* output_path, int resume);
+
+#endif // SWEEP_H
@@ -0,0 +1,49 @@
+#ifndef SYNC_PRIMS_H
+#define SYNC_PRIMS_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/*
+ * Semáforo contador entre procesos con cinco implementaciones
+ * intercambiables (bench_sync):
+ *  - named:   sem_open (lo que usa hoy el pipeline)
+ *  - unnamed: sem_init(pshared=1) dentro de la región compartida
+ *  - condvar: pthread_mutex + pthread_cond con PTHREAD_PROCESS_SHARED
+ *  - futex:   contador atómico + FUTEX_WAIT/FUTEX_WAKE
+ *  - spin:    contador atómico con espera activa pura
+ *
+ * Los SyncSem deben vivir en memoria MAP_SHARED creada antes del fork.
+ */
+typedef enum { PRIM_NAMED, PRIM_UNNAMED, PRIM_CONDVAR, PRIM_FUTEX, PRIM_SPIN, PRIM_COUNT } PrimKind;
+
+typedef struct {
+    _Alignas(64) PrimKind kind;     // Una línea de caché por semáforo
+    union {
+        struct {
+            sem_t* handle;
+            char   name[48];
+        } named;
+        sem_t sem;
+        struct {
+            pthread_mutex_t mutex;
+            pthread_cond_t  cond;
+            unsigned        value;
+        } cv;
+        struct {
+            uint32_t value;         // Palabra futex
+            uint32_t waiters;
+        } fx;
+        uint32_t spin;
+    } u;
+} SyncSem;
+
+const char* prim_name(PrimKind kind);
+int  prim_from_name(const char* name);
+int  sync_sem_init(SyncSem* s, PrimKind kind, unsigned value, int id);
+void sync_sem_wait(SyncSem* s);
+void sync_sem_post(SyncSem* s);
+void sync_sem_destroy(SyncSem* s);
+
+#endif // SYNC_PRIMS_H
@@ -0,0 +1,41 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Verificación de la salida de los receptores contra el archivo de entrada:
+ *  - verify_files: proyecta ambos archivos con mmap y los compara por
+ *    fragmentos en paralelo; reporta rangos distintos y regiones faltantes
+ *    (todavía en cero en la salida).
+ *  - verify_print: informe legible (rangos, totales y throughput).
+ */
+#define VERIFY_MAX_RANGES 32
+
+typedef enum { RANGE_CORRUPT, RANGE_MISSING, RANGE_EXTRA } RangeKind;
+
+typedef struct {
+    uint64_t  start;
+    uint64_t  end;                  // Exclusivo
+    RangeKind kind;                 // MISSING: la salida tiene sólo ceros en el rango
+} MismatchRange;
+
+typedef struct {
+    uint64_t expected_bytes;
+    uint64_t actual_bytes;
+    uint64_t mismatched_bytes;      // Incluye la diferencia de tamaño
+    uint64_t missing_bytes;         // Distintos y en cero en la salida, más la cola faltante
+    uint64_t extra_bytes;           // Salida más larga que la entrada
+    int64_t  first_mismatch;        // -1 si son idénticos
+    uint64_t range_count;           // Rangos contiguos distintos (todos)
+    int      ranges_shown;          // Los primeros por offset, hasta VERIFY_MAX_RANGES
+    MismatchRange ranges[VERIFY_MAX_RANGES];
+    int      threads;
+    double   seconds;
+} VerifyResult;
+
+int  verify_files(const char* expected_path, const char* actual_path, int threads, VerifyResult* vr);
+void verify_print(FILE* f, const VerifyResult* vr);
+
+#endif // VERIFY_H
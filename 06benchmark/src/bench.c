@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+#include "structures.h"
+#include "pipeline.h"
+#include "report.h"
+#include "sweep.h"
+#include "instance.h"
+
+/**
+ * Driver de Benchmark del Pipeline
+ *
+ * Ejecuta el pipeline completo (inicializador, E emisores, R receptores)
+ * tantas veces como se pida, verifica cada salida y publica las métricas
+ * de cada corrida en CSV o JSON. Opcionalmente guarda el resumen como
+ * línea base o lo compara contra una guardada.
+ *
+ * Modos:
+ *  - run: corridas repetidas de una configuración.
+ *  - sweep: barrido emisores × receptores × buffer_size (CSV por punto).
+ */
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s run --input ARCHIVO [opciones]\n", argv0);
+    fprintf(stderr, "  %s sweep --input ARCHIVO [--emisores EJE] [--receptores EJE] [--buffers EJE]\n", argv0);
+    fprintf(stderr, "        [--trials N] [--output ARCHIVO] [--resume] [opciones comunes]\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --input ARCHIVO        Archivo de entrada\n");
+    fprintf(stderr, "  --buffer N             buffer_size (por omisión %d)\n", DEFAULT_BUFFER_SIZE);
+    fprintf(stderr, "  --emisores E           Emisores (1..%d, por omisión %d)\n", MAX_WORKERS, DEFAULT_EMISORES);
+    fprintf(stderr, "  --receptores R         Receptores (1..%d, por omisión %d)\n", MAX_WORKERS, DEFAULT_RECEPTORES);
+    fprintf(stderr, "  --trials N             Corridas repetidas (por omisión %d)\n", DEFAULT_TRIALS);
+    fprintf(stderr, "  --format csv|json      Formato de salida (por omisión csv)\n");
+    fprintf(stderr, "  --output ARCHIVO       Escribir resultados en ARCHIVO (por omisión stdout)\n");
+    fprintf(stderr, "  --save-baseline RUTA   Guardar el resumen como línea base\n");
+    fprintf(stderr, "  --baseline RUTA        Comparar con una línea base (salida %d si hay regresión)\n",
+            EXIT_REGRESSION);
+    fprintf(stderr, "  --threshold PCT        Caída de chars/s tolerada (por omisión %.1f%%)\n", DEFAULT_THRESHOLD);
+    fprintf(stderr, "  --timeout S            Límite por corrida (por omisión %d s)\n", DEFAULT_TIMEOUT_S);
+    fprintf(stderr, "  --root DIR             Raíz del repositorio (por omisión %s)\n", DEFAULT_ROOT_DIR);
+    fprintf(stderr, "  --out-dir DIR          Salida de los receptores (por omisión %s)\n", DEFAULT_OUT_DIR);
+    fprintf(stderr, "  --key HEX              Clave de encriptación (por omisión %s)\n", DEFAULT_KEY);
+    fprintf(stderr, "  --lanes N|auto         Carriles por emisor (auto = uno por emisor; por omisión cola compartida)\n");
+    fprintf(stderr, "  --instance NOMBRE      Instancia IPC propia (o IPC_INSTANCE); permite correr junto a otra\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  Ejes de sweep: lista \"1,2,8\" o rango \"1..64\" (potencias de 2).\n");
+    fprintf(stderr, "  Por omisión: emisores y receptores %s, buffers %s, %d corrida por punto.\n",
+            DEFAULT_SWEEP_WORKERS, DEFAULT_SWEEP_BUFFERS, DEFAULT_SWEEP_TRIALS);
+}
+
+/**
+ * @brief Parsea un entero dentro de un rango
+ *
+ * @return 1 si es válido, 0 si no
+ */
+static int parse_int_range(const char* s, int lo, int hi, int* out) {
+    char* end = NULL;
+    long v = strtol(s, &end, 10);
+    if (!s[0] || *end != '\0' || v < lo || v > hi) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+/**
+ * @brief Opciones compartidas por run y sweep
+ *
+ * @return 1 si la opción se reconoció y su valor es válido, 0 si no es
+ *         una opción común, -1 si el valor es inválido
+ */
+static int parse_common(const char* opt, const char* val, TrialConfig* cfg) {
+    if (strcmp(opt, "--input") == 0)   { cfg->input_path = val; return 1; }
+    if (strcmp(opt, "--root") == 0)    { cfg->root_dir = val; return 1; }
+    if (strcmp(opt, "--out-dir") == 0) { cfg->out_dir = val; return 1; }
+    if (strcmp(opt, "--key") == 0)     { cfg->key = val; return 1; }
+    if (strcmp(opt, "--timeout") == 0) return parse_int_range(val, 1, 86400, &cfg->timeout_s) ? 1 : -1;
+    if (strcmp(opt, "--lanes") == 0) {
+        if (strcmp(val, "auto") == 0) { cfg->lanes = -1; return 1; }
+        return parse_int_range(val, 1, MAX_LANES, &cfg->lanes) ? 1 : -1;
+    }
+    return 0;
+}
+
+static int cmd_run(int argc, char* argv[]) {
+    TrialConfig cfg = { NULL, DEFAULT_ROOT_DIR, DEFAULT_OUT_DIR, DEFAULT_KEY,
+                        DEFAULT_BUFFER_SIZE, DEFAULT_EMISORES, DEFAULT_RECEPTORES, DEFAULT_TIMEOUT_S, 0 };
+    int trials = DEFAULT_TRIALS;
+    OutputFormat fmt = FORMAT_CSV;
+    const char* output = NULL;
+    const char* save_baseline = NULL;
+    const char* baseline = NULL;
+    double threshold = DEFAULT_THRESHOLD;
+
+    for (int i = 2; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int ok = val != NULL;
+        int common = ok ? parse_common(opt, val, &cfg) : 0;
+        if (common != 0)                                 ok = common > 0;
+        else if (strcmp(opt, "--buffer") == 0 && ok)     ok = parse_int_range(val, 1, 1 << 30, &cfg.buffer_size);
+        else if (strcmp(opt, "--emisores") == 0 && ok)   ok = parse_int_range(val, 1, MAX_WORKERS, &cfg.emisores);
+        else if (strcmp(opt, "--receptores") == 0 && ok) ok = parse_int_range(val, 1, MAX_WORKERS, &cfg.receptores);
+        else if (strcmp(opt, "--trials") == 0 && ok)     ok = parse_int_range(val, 1, MAX_TRIALS, &trials);
+        else if (strcmp(opt, "--output") == 0 && ok)     output = val;
+        else if (strcmp(opt, "--save-baseline") == 0 && ok) save_baseline = val;
+        else if (strcmp(opt, "--baseline") == 0 && ok)   baseline = val;
+        else if (strcmp(opt, "--threshold") == 0 && ok) {
+            char* end = NULL;
+            threshold = strtod(val, &end);
+            ok = *end == '\0' && threshold >= 0.0;
+        } else if (strcmp(opt, "--format") == 0 && ok) {
+            if (strcmp(val, "csv") == 0)       fmt = FORMAT_CSV;
+            else if (strcmp(val, "json") == 0) fmt = FORMAT_JSON;
+            else ok = 0;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (!ok) {
+            fprintf(stderr, RED "[ERROR] Valor inválido para %s\n" RESET, opt);
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+    if (!cfg.input_path) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    TrialResult* results = calloc((size_t)trials, sizeof(TrialResult));
+    if (!results) {
+        fprintf(stderr, RED "[ERROR] Sin memoria\n" RESET);
+        return EXIT_FAILURE;
+    }
+
+    int done = 0;
+    for (int t = 0; t < trials; t++) {
+        fprintf(stderr, CYAN "[BENCH] Corrida %d/%d: %s, buffer %d, %dE/%dR..." RESET,
+                t + 1, trials, cfg.input_path, cfg.buffer_size, cfg.emisores, cfg.receptores);
+        if (run_trial(&cfg, &results[done]) != SUCCESS) {
+            fprintf(stderr, RED " falló\n" RESET);
+            break;
+        }
+        const TrialResult* r = &results[done++];
+        fprintf(stderr, " %.0f chars/s en %.3f s %s\n", r->chars_per_s, r->wall_s,
+                r->verified ? GREEN "✓" RESET : RED "✗" RESET);
+    }
+
+    FILE* out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        perror(output);
+        free(results);
+        return EXIT_FAILURE;
+    }
+    report_write(out, fmt, &cfg, results, done);
+    if (out != stdout) fclose(out);
+
+    TrialSummary summary;
+    report_summarize(results, done, &summary);
+    report_print_summary(&cfg, &summary);
+
+    int rc = EXIT_SUCCESS;
+    if (done < trials || summary.verified < done) rc = EXIT_VERIFY_FAILED;
+    if (save_baseline && done > 0 && baseline_save(save_baseline, &cfg, &summary) == SUCCESS) {
+        fprintf(stderr, GREEN "✓ Línea base guardada en %s\n" RESET, save_baseline);
+    }
+    if (baseline && done > 0 && baseline_compare(baseline, &cfg, &summary, threshold) == 1 &&
+        rc == EXIT_SUCCESS) {
+        rc = EXIT_REGRESSION;
+    }
+
+    free(results);
+    return rc;
+}
+
+static int cmd_sweep(int argc, char* argv[]) {
+    SweepConfig sc;
+    memset(&sc, 0, sizeof(sc));
+    sc.base = (TrialConfig){ NULL, DEFAULT_ROOT_DIR, DEFAULT_OUT_DIR, DEFAULT_KEY,
+                             DEFAULT_BUFFER_SIZE, 1, 1, DEFAULT_TIMEOUT_S, 0 };
+    sc.trials = DEFAULT_SWEEP_TRIALS;
+    const char* output = NULL;
+    int resume = 0;
+
+    sweep_parse_axis(DEFAULT_SWEEP_WORKERS, 1, MAX_WORKERS, sc.emisores, &sc.n_emisores);
+    sweep_parse_axis(DEFAULT_SWEEP_WORKERS, 1, MAX_WORKERS, sc.receptores, &sc.n_receptores);
+    sweep_parse_axis(DEFAULT_SWEEP_BUFFERS, 1, 1 << 30, sc.buffers, &sc.n_buffers);
+
+    for (int i = 2; i < argc; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--resume") == 0) { resume = 1; continue; }
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int ok = val != NULL;
+        int common = ok ? parse_common(opt, val, &sc.base) : 0;
+        if (common != 0)                                  ok = common > 0;
+        else if (strcmp(opt, "--emisores") == 0 && ok)
+            ok = sweep_parse_axis(val, 1, MAX_WORKERS, sc.emisores, &sc.n_emisores) == SUCCESS;
+        else if (strcmp(opt, "--receptores") == 0 && ok)
+            ok = sweep_parse_axis(val, 1, MAX_WORKERS, sc.receptores, &sc.n_receptores) == SUCCESS;
+        else if (strcmp(opt, "--buffers") == 0 && ok)
+            ok = sweep_parse_axis(val, 1, 1 << 30, sc.buffers, &sc.n_buffers) == SUCCESS;
+        else if (strcmp(opt, "--trials") == 0 && ok)      ok = parse_int_range(val, 1, MAX_TRIALS, &sc.trials);
+        else if (strcmp(opt, "--output") == 0 && ok)      output = val;
+        else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (!ok) {
+            fprintf(stderr, RED "[ERROR] Valor inválido para %s\n" RESET, opt);
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+    if (!sc.base.input_path) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, BOLD CYAN "Barrido: %d buffers × %d emisores × %d receptores, %d corrida(s) por punto\n" RESET,
+            sc.n_buffers, sc.n_emisores, sc.n_receptores, sc.trials);
+    return run_sweep(&sc, output, resume) == SUCCESS ? EXIT_SUCCESS : EXIT_VERIFY_FAILED;
+}
+
+int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (strcmp(argv[1], "run") == 0) return cmd_run(argc, argv);
+    if (strcmp(argv[1], "sweep") == 0) return cmd_sweep(argc, argv);
+
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+}
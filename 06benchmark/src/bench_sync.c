@@ -0,0 +1,409 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "sync_prims.h"
+#include "constants.h"
+
+/**
+ * Benchmark de Traspaso entre Procesos
+ *
+ * Compara las primitivas de sync_prims.h con dos cargas:
+ *  - pingpong: P pares de procesos se pasan un testigo por dos semáforos;
+ *    reporta la latencia de un traspaso (ida del viaje redondo / 2).
+ *  - buffer:   buffer acotado con P productores y C consumidores sobre tres
+ *    semáforos (espacios, ítems y mutex de índices), el mismo esquema que
+ *    ENCRYPT_SPACES / DECRYPT_ITEMS / mutex de cola del pipeline; reporta
+ *    ítems por segundo.
+ *
+ * Cada medición dura un tiempo fijo (no un número fijo de operaciones),
+ * así la espera activa sin núcleos libres no deja el benchmark colgado.
+ * Con pinning cada proceso queda fijo en la CPU (i mod nCPU).
+ *
+ * Uso: ./bench_sync [--prim NOMBRE] [--test pingpong|buffer] [--pc 1x1,2x2]
+ *                   [--pin on|off|both] [--duration MS] [--slots N] [--csv]
+ */
+
+#define SYNC_MAX_PROCS        64
+#define SYNC_DEFAULT_PC       "1x1,2x2,4x4,8x8"
+#define SYNC_DEFAULT_DURATION 1000      // ms por medición
+#define SYNC_DEFAULT_SLOTS    64
+#define SYNC_MAX_SLOTS        65536
+
+typedef enum { TEST_PINGPONG, TEST_BUFFER, TEST_COUNT } TestKind;
+static const char* g_test_names[TEST_COUNT] = { "pingpong", "buffer" };
+
+static volatile uint64_t g_sink;    // Evita que el compilador elimine las lecturas del anillo
+
+typedef struct {
+    _Alignas(64) uint64_t ops;          // Una línea por proceso: sin falso compartido
+} Counter;
+
+/* Región compartida de una medición (mmap MAP_SHARED antes del fork) */
+typedef struct {
+    int      stop;
+    int      ready;
+    int      start;
+    int      slots;
+    SyncSem  ping[SYNC_MAX_PROCS];      // pingpong: ida de cada par
+    SyncSem  pong[SYNC_MAX_PROCS];      // pingpong: vuelta de cada par
+    int      done[SYNC_MAX_PROCS];      // pingpong: el iniciador ya no espera respuesta
+    SyncSem  spaces;                    // buffer: huecos libres
+    SyncSem  items;                     // buffer: elementos disponibles
+    SyncSem  mutex;                     // buffer: protege head/tail
+    int      head;
+    int      tail;
+    Counter  counters[2 * SYNC_MAX_PROCS];
+    uint64_t ring[SYNC_MAX_SLOTS];
+} Arena;
+
+typedef struct {
+    PrimKind kind;
+    TestKind test;
+    int      producers;
+    int      consumers;
+    int      pinned;
+    int      duration_ms;
+    int      slots;
+} SyncConfig;
+
+typedef struct {
+    uint64_t ops;
+    double   seconds;
+    double   ns_per_op;
+    double   ops_per_s;
+    double   ctx_per_op;                // Cambios de contexto (vol + invol) por operación
+} SyncResult;
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int is_stopped(Arena* a) {
+    return __atomic_load_n(&a->stop, __ATOMIC_ACQUIRE);
+}
+
+static void pin_to(int index) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(index % ncpu), &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+/* Barrera de arranque: el padre toma t0 cuando todos están listos */
+static void wait_start(Arena* a) {
+    __atomic_fetch_add(&a->ready, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&a->start, __ATOMIC_ACQUIRE)) sched_yield();
+}
+
+// =============================================================================
+// ROLES
+// =============================================================================
+
+static void pingpong_initiator(Arena* a, int pair) {
+    Counter* c = &a->counters[pair];
+    while (!is_stopped(a)) {
+        sync_sem_post(&a->ping[pair]);
+        sync_sem_wait(&a->pong[pair]);
+        __atomic_store_n(&c->ops, c->ops + 1, __ATOMIC_RELAXED);
+    }
+    // Sin viaje en curso: el último ping sólo libera al respondedor
+    __atomic_store_n(&a->done[pair], 1, __ATOMIC_RELEASE);
+    sync_sem_post(&a->ping[pair]);
+}
+
+static void pingpong_responder(Arena* a, int pair) {
+    for (;;) {
+        sync_sem_wait(&a->ping[pair]);
+        if (__atomic_load_n(&a->done[pair], __ATOMIC_ACQUIRE)) break;
+        sync_sem_post(&a->pong[pair]);
+    }
+}
+
+/* Al detenerse, cada proceso reenvía el token de parada (ver relay_shutdown) */
+static void buffer_producer(Arena* a, int id) {
+    Counter* c = &a->counters[id];
+    uint64_t x = (uint64_t)id << 48;
+    for (;;) {
+        sync_sem_wait(&a->spaces);
+        if (is_stopped(a)) {
+            sync_sem_post(&a->spaces);
+            break;
+        }
+        sync_sem_wait(&a->mutex);
+        a->ring[a->tail] = x++;
+        a->tail = (a->tail + 1) % a->slots;
+        sync_sem_post(&a->mutex);
+        sync_sem_post(&a->items);
+        __atomic_store_n(&c->ops, c->ops + 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void buffer_consumer(Arena* a, int id) {
+    Counter* c = &a->counters[SYNC_MAX_PROCS + id];
+    uint64_t sink = 0;
+    for (;;) {
+        sync_sem_wait(&a->items);
+        if (is_stopped(a)) {
+            sync_sem_post(&a->items);
+            break;
+        }
+        sync_sem_wait(&a->mutex);
+        sink += a->ring[a->head];
+        a->head = (a->head + 1) % a->slots;
+        sync_sem_post(&a->mutex);
+        sync_sem_post(&a->spaces);
+        __atomic_store_n(&c->ops, c->ops + 1, __ATOMIC_RELAXED);
+    }
+    g_sink = sink;
+}
+
+// =============================================================================
+// MEDICIÓN
+// =============================================================================
+
+static int arena_init(Arena* a, const SyncConfig* cfg) {
+    int id = 0;
+    a->slots = cfg->slots;
+    if (cfg->test == TEST_PINGPONG) {
+        for (int p = 0; p < cfg->producers; p++) {
+            if (sync_sem_init(&a->ping[p], cfg->kind, 0, id++) != SUCCESS) return ERROR;
+            if (sync_sem_init(&a->pong[p], cfg->kind, 0, id++) != SUCCESS) return ERROR;
+        }
+        return SUCCESS;
+    }
+    if (sync_sem_init(&a->spaces, cfg->kind, (unsigned)cfg->slots, id++) != SUCCESS) return ERROR;
+    if (sync_sem_init(&a->items, cfg->kind, 0, id++) != SUCCESS) return ERROR;
+    return sync_sem_init(&a->mutex, cfg->kind, 1, id++);
+}
+
+static void arena_destroy(Arena* a, const SyncConfig* cfg) {
+    if (cfg->test == TEST_PINGPONG) {
+        for (int p = 0; p < cfg->producers; p++) {
+            sync_sem_destroy(&a->ping[p]);
+            sync_sem_destroy(&a->pong[p]);
+        }
+        return;
+    }
+    sync_sem_destroy(&a->spaces);
+    sync_sem_destroy(&a->items);
+    sync_sem_destroy(&a->mutex);
+}
+
+static uint64_t total_ops(Arena* a, const SyncConfig* cfg) {
+    uint64_t sum = 0;
+    if (cfg->test == TEST_PINGPONG) {
+        for (int p = 0; p < cfg->producers; p++) sum += __atomic_load_n(&a->counters[p].ops, __ATOMIC_RELAXED);
+    } else {
+        for (int c = 0; c < cfg->consumers; c++)
+            sum += __atomic_load_n(&a->counters[SYNC_MAX_PROCS + c].ops, __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+/**
+ * @brief Ejecuta una medición completa
+ *
+ * @return SUCCESS, o ERROR si no se pudo crear la región o los procesos
+ */
+static int measure(const SyncConfig* cfg, SyncResult* res) {
+    memset(res, 0, sizeof(*res));
+    Arena* a = mmap(NULL, sizeof(Arena), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (a == MAP_FAILED) {
+        perror("mmap");
+        return ERROR;
+    }
+    if (arena_init(a, cfg) != SUCCESS) {
+        munmap(a, sizeof(Arena));
+        return ERROR;
+    }
+
+    int nprocs = (cfg->test == TEST_PINGPONG) ? 2 * cfg->producers : cfg->producers + cfg->consumers;
+    pid_t pids[2 * SYNC_MAX_PROCS];
+    int n = 0;
+    for (int i = 0; i < nprocs; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            if (cfg->pinned) pin_to(i);
+            wait_start(a);
+            if (cfg->test == TEST_PINGPONG) {
+                if (i % 2 == 0) pingpong_initiator(a, i / 2);
+                else            pingpong_responder(a, i / 2);
+            } else {
+                if (i < cfg->producers) buffer_producer(a, i);
+                else                    buffer_consumer(a, i - cfg->producers);
+            }
+            _exit(0);
+        }
+        pids[n++] = pid;
+    }
+
+    int ok = (n == nprocs);
+    if (ok) {
+        while (__atomic_load_n(&a->ready, __ATOMIC_ACQUIRE) < nprocs) sched_yield();
+    }
+    uint64_t t0 = mono_ns();
+    __atomic_store_n(&a->start, 1, __ATOMIC_RELEASE);
+
+    struct timespec ts = { cfg->duration_ms / 1000, (long)(cfg->duration_ms % 1000) * 1000000L };
+    if (ok) nanosleep(&ts, NULL);
+
+    res->ops = total_ops(a, cfg);
+    uint64_t t1 = mono_ns();
+    __atomic_store_n(&a->stop, 1, __ATOMIC_RELEASE);
+    if (cfg->test == TEST_BUFFER) {
+        sync_sem_post(&a->spaces);      // Tokens de parada; cada proceso los reenvía
+        sync_sem_post(&a->items);
+    }
+    if (!ok) {
+        for (int i = 0; i < n; i++) kill(pids[i], SIGKILL);
+    }
+
+    long ctx = 0;
+    for (int i = 0; i < n; i++) {
+        struct rusage ru;
+        int status;
+        if (wait4(pids[i], &status, 0, &ru) == pids[i]) ctx += ru.ru_nvcsw + ru.ru_nivcsw;
+    }
+
+    res->seconds = (double)(t1 - t0) / 1e9;
+    // pingpong: latencia de un traspaso dentro de un par (dos por viaje redondo);
+    // buffer: tiempo por ítem del conjunto
+    if (res->ops > 0) {
+        double ns = (double)(t1 - t0);
+        res->ns_per_op = (cfg->test == TEST_PINGPONG)
+            ? ns * cfg->producers / (2.0 * (double)res->ops)
+            : ns / (double)res->ops;
+    }
+    res->ops_per_s = res->seconds > 0.0 ? (double)res->ops / res->seconds : 0.0;
+    res->ctx_per_op = res->ops > 0 ? (double)ctx / (double)res->ops : 0.0;
+
+    arena_destroy(a, cfg);
+    munmap(a, sizeof(Arena));
+    return ok ? SUCCESS : ERROR;
+}
+
+// =============================================================================
+// CLI
+// =============================================================================
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso: %s [--prim NOMBRE] [--test pingpong|buffer] [--pc 1x1,2x2] [--pin on|off|both]\n", argv0);
+    fprintf(stderr, "          [--duration MS] [--slots N] [--csv]\n");
+    fprintf(stderr, "  Primitivas: ");
+    for (int i = 0; i < PRIM_COUNT; i++) fprintf(stderr, "%s ", prim_name((PrimKind)i));
+    fprintf(stderr, "\n  --pc: productores x consumidores (pingpong usa P pares, sólo con P = C)\n");
+}
+
+static int parse_pc(const char* spec, int* prod, int* cons, int max) {
+    int n = 0;
+    const char* p = spec;
+    while (*p && n < max) {
+        char* end = NULL;
+        long a = strtol(p, &end, 10);
+        if (*end != 'x') return -1;
+        long b = strtol(end + 1, &end, 10);
+        if (a < 1 || b < 1 || a > SYNC_MAX_PROCS || b > SYNC_MAX_PROCS) return -1;
+        if (*end != ',' && *end != '\0') return -1;
+        prod[n] = (int)a;
+        cons[n] = (int)b;
+        n++;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    int only_prim = -1, only_test = -1, csv = 0;
+    int pin_lo = 0, pin_hi = 1;
+    int duration = SYNC_DEFAULT_DURATION, slots = SYNC_DEFAULT_SLOTS;
+    const char* pc_spec = SYNC_DEFAULT_PC;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--csv") == 0) { csv = 1; continue; }
+        const char* val = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!val) { print_usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(opt, "--prim") == 0) {
+            only_prim = prim_from_name(val);
+            if (only_prim < 0) only_prim = -2;
+        }
+        else if (strcmp(opt, "--test") == 0) {
+            only_test = strcmp(val, "pingpong") == 0 ? TEST_PINGPONG : strcmp(val, "buffer") == 0 ? TEST_BUFFER : -2;
+        } else if (strcmp(opt, "--pc") == 0) pc_spec = val;
+        else if (strcmp(opt, "--duration") == 0) duration = atoi(val);
+        else if (strcmp(opt, "--slots") == 0) slots = atoi(val);
+        else if (strcmp(opt, "--pin") == 0) {
+            if (strcmp(val, "on") == 0)        pin_lo = pin_hi = 1;
+            else if (strcmp(val, "off") == 0)  pin_lo = pin_hi = 0;
+            else if (strcmp(val, "both") != 0) pin_lo = 2;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int prod[16], cons[16];
+    int npc = parse_pc(pc_spec, prod, cons, 16);
+    if (npc <= 0 || only_prim == -2 || only_test == -2 || pin_lo > 1 || duration < 10 ||
+        slots < 1 || slots > SYNC_MAX_SLOTS) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (csv) {
+        printf("primitive,test,producers,consumers,pinned,ops,seconds,ns_per_handoff,ops_per_s,ctx_per_op\n");
+    } else {
+        printf("\nTraspaso entre procesos (%ld CPU, %d ms por medición, buffer de %d)\n",
+               sysconf(_SC_NPROCESSORS_ONLN), duration, slots);
+        printf("\n  %-8s %-9s %5s %6s %14s %14s %12s\n", "Prim.", "Prueba", "PxC", "Pin", "ns/traspaso",
+               "ops/s", "ctx/op");
+    }
+
+    for (int t = 0; t < TEST_COUNT; t++) {
+        if (only_test >= 0 && t != only_test) continue;
+        for (int k = 0; k < PRIM_COUNT; k++) {
+            if (only_prim >= 0 && k != only_prim) continue;
+            for (int c = 0; c < npc; c++) {
+                if (t == TEST_PINGPONG && prod[c] != cons[c]) continue;
+                for (int pin = pin_lo; pin <= pin_hi; pin++) {
+                    SyncConfig cfg = { (PrimKind)k, (TestKind)t, prod[c], cons[c], pin, duration, slots };
+                    SyncResult r;
+                    if (measure(&cfg, &r) != SUCCESS) {
+                        fprintf(stderr, RED "[ERROR] Falló %s/%s %dx%d\n" RESET,
+                                prim_name(cfg.kind), g_test_names[t], prod[c], cons[c]);
+                        continue;
+                    }
+                    if (csv) {
+                        printf("%s,%s,%d,%d,%d,%llu,%.6f,%.1f,%.1f,%.4f\n", prim_name(cfg.kind), g_test_names[t],
+                               prod[c], cons[c], pin, (unsigned long long)r.ops, r.seconds, r.ns_per_op,
+                               r.ops_per_s, r.ctx_per_op);
+                    } else {
+                        char pc[16];
+                        snprintf(pc, sizeof(pc), "%dx%d", prod[c], cons[c]);
+                        printf("  %-8s %-9s %5s %6s %14.1f %14.0f %12.3f\n", prim_name(cfg.kind), g_test_names[t],
+                               pc, pin ? "sí" : "no", r.ns_per_op, r.ops_per_s, r.ctx_per_op);
+                    }
+                    fflush(stdout);
+                }
+            }
+            if (!csv) printf("\n");
+        }
+    }
+    return EXIT_SUCCESS;
+}
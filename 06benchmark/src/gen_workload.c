@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "constants.h"
+
+/**
+ * Generador de Cargas Sintéticas
+ *
+ * Produce archivos de entrada de tamaño y forma conocidos para el
+ * benchmark y para el inicializador (print_file_statistics). El contenido
+ * depende sólo de (semilla, distribución, tamaño): cada bloque de
+ * GEN_BLOCK_SIZE se genera con su propio estado derivado de la semilla y
+ * del número de bloque, así varios hilos generan y escriben (pwrite) en
+ * paralelo y el resultado es idéntico con cualquier cantidad de hilos.
+ *
+ * Distribuciones:
+ *  - text:   palabras ASCII con espacios, puntuación y saltos de línea
+ *  - binary: bytes uniformes
+ *  - runs:   rachas largas (1..64 KiB) de un mismo byte
+ *  - zero:   todo ceros
+ *
+ * Uso: ./gen_workload --size 100M [--dist text] [--seed N] [--threads N] --output ARCHIVO
+ */
+
+#define GEN_BLOCK_SIZE   (4u << 20)            // 4 MiB por bloque
+#define GEN_MAX_SIZE     (1ULL << 40)          // 1 TiB
+#define GEN_MAX_THREADS  64
+#define GEN_DEFAULT_SEED 1
+#define GEN_RUN_MIN      1024
+#define GEN_RUN_MAX      65536
+#define GEN_LINE_WIDTH   72
+
+typedef enum { DIST_TEXT, DIST_BINARY, DIST_RUNS, DIST_ZERO, DIST_COUNT } Distribution;
+static const char* g_dist_names[DIST_COUNT] = { "text", "binary", "runs", "zero" };
+
+typedef struct { uint64_t s[4]; } Rng;
+
+typedef struct {
+    int          fd;
+    Distribution dist;
+    uint64_t     seed;
+    uint64_t     size;
+    uint64_t     blocks;
+    int          index;
+    int          stride;
+    int          failed;
+} Worker;
+
+static const char* g_words[] = {
+    "el", "la", "de", "que", "y", "en", "un", "los", "se", "del", "las", "por", "con", "para",
+    "una", "memoria", "compartida", "proceso", "emisor", "receptor", "cola", "semaforo", "texto",
+    "the", "of", "and", "to", "in", "is", "that", "for", "it", "with", "as", "was", "on",
+    "buffer", "shared", "memory", "queue", "data", "system", "character", "order", "file",
+    "sequence", "encrypt", "decrypt", "slot", "index", "process", "signal", "time", "value",
+    "a", "o", "es", "no", "lo", "su", "al", "mas", "pero", "sus", "le", "ya", "fue", "este",
+};
+#define NWORDS (sizeof(g_words) / sizeof(g_words[0]))
+
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+/* xoshiro256** */
+static inline uint64_t rng_next(Rng* r) {
+    uint64_t result = rotl(r->s[1] * 5, 7) * 9;
+    uint64_t t = r->s[1] << 17;
+    r->s[2] ^= r->s[0];
+    r->s[3] ^= r->s[1];
+    r->s[1] ^= r->s[2];
+    r->s[0] ^= r->s[3];
+    r->s[2] ^= t;
+    r->s[3] = rotl(r->s[3], 45);
+    return result;
+}
+
+/* Estado del bloque: depende sólo de la semilla y del número de bloque */
+static void rng_seed_block(Rng* r, uint64_t seed, uint64_t block) {
+    uint64_t x = seed ^ (block * 0xd1342543de82ef95ULL);
+    for (int i = 0; i < 4; i++) r->s[i] = splitmix64(&x);
+}
+
+static void fill_binary(Rng* r, unsigned char* buf, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v = rng_next(r);
+        memcpy(buf + i, &v, 8);
+    }
+    if (i < n) {
+        uint64_t v = rng_next(r);
+        memcpy(buf + i, &v, n - i);
+    }
+}
+
+static void fill_runs(Rng* r, unsigned char* buf, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        uint64_t v = rng_next(r);
+        size_t len = GEN_RUN_MIN + (size_t)((v >> 8) % (GEN_RUN_MAX - GEN_RUN_MIN + 1));
+        if (len > n - i) len = n - i;
+        memset(buf + i, (int)(v & 0xff), len);
+        i += len;
+    }
+}
+
+/* Palabras rellenadas a 16 bytes: el camino rápido copia un bloque de tamaño fijo */
+static char    g_word_pad[NWORDS][16];
+static uint8_t g_word_len[NWORDS];
+
+static void init_words(void) {
+    for (size_t w = 0; w < NWORDS; w++) {
+        g_word_len[w] = (uint8_t)strlen(g_words[w]);
+        memcpy(g_word_pad[w], g_words[w], g_word_len[w]);
+    }
+}
+
+/*
+ * Palabras del diccionario; cada GEN_LINE_WIDTH columnas aprox. un salto de
+ * línea. Cada valor aleatorio de 64 bits decide cuatro palabras (16 bits
+ * por palabra: índice, puntuación y separador).
+ */
+static void fill_text(Rng* r, unsigned char* buf, size_t n) {
+    size_t i = 0, col = 0;
+    while (i < n) {
+        uint64_t v = rng_next(r);
+        for (int k = 0; k < 4 && i < n; k++, v >>= 16) {
+            unsigned bits = (unsigned)(v & 0xffff);
+            size_t w = (bits & 0x3ff) % NWORDS;
+            size_t len = g_word_len[w];
+            if (i + sizeof(g_word_pad[w]) <= n) {
+                memcpy(buf + i, g_word_pad[w], sizeof(g_word_pad[w]));
+            } else {
+                memcpy(buf + i, g_word_pad[w], len < n - i ? len : n - i);
+            }
+            i += len;
+            col += len;
+            if (i >= n) break;
+
+            unsigned p = (bits >> 10) & 0x3f;       // 0..63
+            if (p < 4)      buf[i++] = ',';
+            else if (p < 7) buf[i++] = '.';
+            if (i >= n) break;
+
+            if (col >= GEN_LINE_WIDTH) {
+                buf[i++] = '\n';
+                col = 0;
+            } else {
+                buf[i++] = ' ';
+                col++;
+            }
+        }
+    }
+}
+
+static int pwrite_all(int fd, const unsigned char* buf, size_t n, off_t off) {
+    while (n > 0) {
+        ssize_t w = pwrite(fd, buf, n, off);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return ERROR;
+        }
+        buf += w;
+        n -= (size_t)w;
+        off += w;
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Hilo generador: bloques index, index + stride, ...
+ */
+static void* generate_blocks(void* arg) {
+    Worker* w = arg;
+    unsigned char* buf = malloc(GEN_BLOCK_SIZE);
+    if (!buf) {
+        w->failed = 1;
+        return NULL;
+    }
+    if (w->dist == DIST_ZERO) memset(buf, 0, GEN_BLOCK_SIZE);
+
+    for (uint64_t b = (uint64_t)w->index; b < w->blocks; b += (uint64_t)w->stride) {
+        uint64_t off = b * GEN_BLOCK_SIZE;
+        size_t n = (w->size - off < GEN_BLOCK_SIZE) ? (size_t)(w->size - off) : GEN_BLOCK_SIZE;
+        Rng r;
+        rng_seed_block(&r, w->seed, b);
+        switch (w->dist) {
+        case DIST_TEXT:   fill_text(&r, buf, n); break;
+        case DIST_BINARY: fill_binary(&r, buf, n); break;
+        case DIST_RUNS:   fill_runs(&r, buf, n); break;
+        default:          break;
+        }
+        if (pwrite_all(w->fd, buf, n, (off_t)off) != SUCCESS) {
+            w->failed = 1;
+            break;
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+/**
+ * @brief Parsea un tamaño con sufijo opcional K, M, G o T (potencias de 1024)
+ *
+ * @return Tamaño en bytes, 0 si es inválido
+ */
+static uint64_t parse_size(const char* s) {
+    char* end = NULL;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (errno || end == s) return 0;
+    uint64_t mult = 1;
+    switch (*end) {
+    case 'k': case 'K': mult = 1ULL << 10; end++; break;
+    case 'm': case 'M': mult = 1ULL << 20; end++; break;
+    case 'g': case 'G': mult = 1ULL << 30; end++; break;
+    case 't': case 'T': mult = 1ULL << 40; end++; break;
+    default: break;
+    }
+    if (*end == 'i') end++;
+    if (*end == 'B' || *end == 'b') end++;
+    if (*end != '\0' || v > GEN_MAX_SIZE / mult) return 0;
+    return (uint64_t)v * mult;
+}
+
+static double mono_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso: %s --size N[K|M|G|T] --output ARCHIVO [--dist text|binary|runs|zero]\n", argv0);
+    fprintf(stderr, "          [--seed N] [--threads N]\n");
+    fprintf(stderr, "  El contenido depende sólo de semilla, distribución y tamaño.\n");
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t size = 0, seed = GEN_DEFAULT_SEED;
+    Distribution dist = DIST_TEXT;
+    const char* output = NULL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* val = (i + 1 < argc) ? argv[++i] : NULL;
+        if (!val) { print_usage(argv[0]); return EXIT_FAILURE; }
+        if (strcmp(opt, "--size") == 0) {
+            if ((size = parse_size(val)) == 0) { print_usage(argv[0]); return EXIT_FAILURE; }
+        } else if (strcmp(opt, "--seed") == 0) {
+            seed = strtoull(val, NULL, 0);
+        } else if (strcmp(opt, "--threads") == 0) {
+            threads = atol(val);
+        } else if (strcmp(opt, "--output") == 0) {
+            output = val;
+        } else if (strcmp(opt, "--dist") == 0) {
+            int d = -1;
+            for (int k = 0; k < DIST_COUNT; k++) if (strcmp(val, g_dist_names[k]) == 0) d = k;
+            if (d < 0) { print_usage(argv[0]); return EXIT_FAILURE; }
+            dist = (Distribution)d;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!output || size == 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > GEN_MAX_THREADS) threads = GEN_MAX_THREADS;
+    init_words();
+
+    int fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror(output);
+        return EXIT_FAILURE;
+    }
+    // Reserva el tamaño final: los hilos escriben fuera de orden
+    if (ftruncate(fd, (off_t)size) != 0) {
+        perror("ftruncate");
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t blocks = (size + GEN_BLOCK_SIZE - 1) / GEN_BLOCK_SIZE;
+    if ((uint64_t)threads > blocks) threads = (long)blocks;
+
+    Worker workers[GEN_MAX_THREADS];
+    pthread_t tids[GEN_MAX_THREADS];
+    int started[GEN_MAX_THREADS];
+    double t0 = mono_s();
+    for (long t = 0; t < threads; t++) {
+        workers[t] = (Worker){ fd, dist, seed, size, blocks, (int)t, (int)threads, 0 };
+        started[t] = (pthread_create(&tids[t], NULL, generate_blocks, &workers[t]) == 0);
+        if (!started[t]) generate_blocks(&workers[t]);     // Sin hilo: lo hace el principal
+    }
+    int failed = 0;
+    for (long t = 0; t < threads; t++) {
+        if (started[t]) pthread_join(tids[t], NULL);
+        failed |= workers[t].failed;
+    }
+    if (!failed && fsync(fd) != 0) failed = 1;
+    double secs = mono_s() - t0;
+    close(fd);
+
+    if (failed) {
+        fprintf(stderr, RED "[ERROR] No se pudo escribir %s: %s\n" RESET, output, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    printf(GREEN "✓ %s: %llu bytes (%s, semilla %llu) en %.3f s — %.1f MiB/s con %ld hilos\n" RESET,
+           output, (unsigned long long)size, g_dist_names[dist], (unsigned long long)seed, secs,
+           secs > 0.0 ? (double)size / (1 << 20) / secs : 0.0, threads);
+    return EXIT_SUCCESS;
+}
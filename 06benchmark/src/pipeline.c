@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "pipeline.h"
+#include "verify.h"
+#include "constants.h"
+#include "instance.h"
+
+/**
+ * Módulo de Corridas del Pipeline
+ *
+ * Reproduce lo que hoy se hace a mano en cuatro terminales: inicializador,
+ * receptores y emisores en modo automático y silencioso (IPC_QUIET=1), con
+ * la salida en un directorio propio. Los recursos de cada trabajador se
+ * obtienen con wait4() y la contención por semáforo se lee de los bloques
+ * WorkerStats que los trabajadores ya escriben en la SHM.
+ *
+ * El driver no necesita al finalizador: emisores y receptores terminan
+ * solos al agotar el archivo (los receptores con el marcador de fin de
+ * flujo). Si aun así alguno sigue bloqueado cuando ya está todo escrito
+ * (p. ej. murió el emisor que debía publicar el marcador), el driver
+ * activa shutdown_flag y deposita el token de finalización (ver
+ * relay_shutdown).
+ */
+
+#define MAX_CHILDREN (2 * MAX_WORKERS)
+
+static double mono_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double tv_s(struct timeval tv) {
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+}
+
+void teardown_ipc(void) {
+    static const char* names[] = {
+        SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+        SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) sem_unlink(instance_sem(names[i]));
+
+    int shm_id = shmget(instance_shm_key(), 0, 0);
+    if (shm_id != -1) shmctl(shm_id, IPC_RMID, NULL);
+}
+
+/**
+ * @brief Lanza un programa del pipeline con stdout/stdin en /dev/null
+ *
+ * @param path Ejecutable
+ * @param argv Argumentos (terminados en NULL)
+ * @param out_dir Directorio de salida de receptores (NULL = no definir)
+ * @param unblock Máscara a restaurar en el hijo (el padre bloquea SIGCHLD)
+ * @return PID del hijo, -1 en error
+ */
+static pid_t spawn(const char* path, char* const argv[], const char* out_dir, const sigset_t* unblock) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    sigprocmask(SIG_SETMASK, unblock, NULL);
+    int devnull = open("/dev/null", O_RDWR);
+    if (devnull != -1) {
+        dup2(devnull, STDIN_FILENO);
+        dup2(devnull, STDOUT_FILENO);
+        if (devnull > STDERR_FILENO) close(devnull);
+    }
+    setenv("IPC_QUIET", "1", 1);
+    if (out_dir) setenv("RECEPTOR_OUT_DIR", out_dir, 1);
+    execv(path, argv);
+    fprintf(stderr, RED "[BENCH] No se pudo ejecutar %s: %s\n" RESET, path, strerror(errno));
+    _exit(127);
+}
+
+static int join_path(char* out, size_t n, const char* a, const char* b) {
+    int w = snprintf(out, n, "%s/%s", a, b);
+    return (w > 0 && (size_t)w < n) ? SUCCESS : ERROR;
+}
+
+/* Salida del receptor: <out_dir>/<basename(input)>.txt (ver output_file.c) */
+static int output_path_for(const TrialConfig* cfg, char* out, size_t n) {
+    const char* base = strrchr(cfg->input_path, '/');
+    base = base ? base + 1 : cfg->input_path;
+    int w = snprintf(out, n, "%s/%s.txt", cfg->out_dir, base);
+    return (w > 0 && (size_t)w < n) ? SUCCESS : ERROR;
+}
+
+static uint64_t receptor_chars(const SharedMemory* shm) {
+    uint64_t total = 0;
+    int n = shm->receptor_stats_count;
+    if (n > MAX_WORKERS) n = MAX_WORKERS;
+    for (int i = 0; i < n; i++) total += __atomic_load_n(&shm->receptor_stats[i].chars, __ATOMIC_RELAXED);
+    return total;
+}
+
+/* Despierta a los que sigan bloqueados una vez escrito todo el archivo */
+static void release_stragglers(SharedMemory* shm) {
+    __atomic_store_n(&shm->shutdown_flag, 1, __ATOMIC_RELEASE);
+    const char* names[] = { instance_sem(SEM_NAME_DECRYPT_ITEMS), instance_sem(SEM_NAME_ENCRYPT_SPACES) };
+    for (int i = 0; i < 2; i++) {
+        sem_t* s = sem_open(names[i], 0);
+        if (s == SEM_FAILED) continue;
+        sem_post(s);
+        sem_close(s);
+    }
+}
+
+static void collect_contention(const SharedMemory* shm, TrialResult* res) {
+    const WorkerStats* roles[2] = { shm->emisor_stats, shm->receptor_stats };
+    int counts[2] = { shm->emisor_stats_count, shm->receptor_stats_count };
+    for (int r = 0; r < 2; r++) {
+        int n = counts[r] > MAX_WORKERS ? MAX_WORKERS : counts[r];
+        for (int i = 0; i < n; i++) {
+            for (int s = 0; s < SEM_COUNT; s++) {
+                res->sem_waits[s]      += roles[r][i].sem_waits[s];
+                res->sem_blocked_ns[s] += roles[r][i].sem_blocked_ns[s];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Espera a los trabajadores acumulando sus recursos
+ *
+ * Duerme en sigtimedwait(SIGCHLD): no hay sondeo periódico.
+ */
+static void wait_workers(SharedMemory* shm, pid_t* pids, int n, double deadline, TrialResult* res) {
+    sigset_t chld;
+    sigemptyset(&chld);
+    sigaddset(&chld, SIGCHLD);
+
+    int remaining = n;
+    int released = 0;
+    while (remaining > 0) {
+        int status;
+        struct rusage ru;
+        pid_t p = wait4(-1, &status, WNOHANG, &ru);
+        if (p > 0) {
+            for (int i = 0; i < n; i++) if (pids[i] == p) pids[i] = 0;
+            remaining--;
+            res->cpu_user_s += tv_s(ru.ru_utime);
+            res->cpu_sys_s  += tv_s(ru.ru_stime);
+            res->vol_ctx    += ru.ru_nvcsw;
+            res->invol_ctx  += ru.ru_nivcsw;
+            if (ru.ru_maxrss > res->peak_rss_kb) res->peak_rss_kb = ru.ru_maxrss;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) res->failed_workers++;
+
+            if (!released && receptor_chars(shm) >= res->chars) {
+                release_stragglers(shm);
+                released = 1;
+            }
+            continue;
+        }
+        if (p < 0 && errno != EINTR) break;
+
+        double left = deadline - mono_s();
+        if (left <= 0.0) {
+            fprintf(stderr, YELLOW "[BENCH] Límite de tiempo alcanzado: %d procesos sin terminar\n" RESET,
+                    remaining);
+            for (int i = 0; i < n; i++) if (pids[i] > 0) kill(pids[i], SIGKILL);
+            deadline = mono_s() + 5.0;
+            continue;
+        }
+        struct timespec ts = { (time_t)left, (long)((left - (double)(time_t)left) * 1e9) };
+        sigtimedwait(&chld, NULL, &ts);
+    }
+    res->completed = (remaining == 0 && res->failed_workers == 0);
+}
+
+/**
+ * @brief Ejecuta una corrida completa y mide sus recursos
+ *
+ * @param cfg Parámetros de la corrida
+ * @param res Resultados (se sobrescriben)
+ * @return SUCCESS si la corrida pudo ejecutarse (ver res->completed / res->verified)
+ */
+int run_trial(const TrialConfig* cfg, TrialResult* res) {
+    memset(res, 0, sizeof(*res));
+
+    char init_bin[4096], emisor_bin[4096], receptor_bin[4096], out_path[4096];
+    if (join_path(init_bin, sizeof(init_bin), cfg->root_dir, PATH_INICIALIZADOR) != SUCCESS ||
+        join_path(emisor_bin, sizeof(emisor_bin), cfg->root_dir, PATH_EMISOR) != SUCCESS ||
+        join_path(receptor_bin, sizeof(receptor_bin), cfg->root_dir, PATH_RECEPTOR) != SUCCESS ||
+        output_path_for(cfg, out_path, sizeof(out_path)) != SUCCESS) {
+        fprintf(stderr, RED "[BENCH] Ruta demasiado larga\n" RESET);
+        return ERROR;
+    }
+
+    // El receptor no trunca su salida: un archivo viejo podría pasar la verificación
+    mkdir(cfg->out_dir, 0777);
+    unlink(out_path);
+    teardown_ipc();
+
+    sigset_t chld, old;
+    sigemptyset(&chld);
+    sigaddset(&chld, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &chld, &old);
+
+    char buf_arg[16];
+    snprintf(buf_arg, sizeof(buf_arg), "%d", cfg->buffer_size);
+    char lanes_arg[16];
+    int lanes = cfg->lanes < 0 ? cfg->emisores : cfg->lanes;
+    if (lanes > cfg->buffer_size) lanes = cfg->buffer_size;
+    if (lanes > MAX_LANES) lanes = MAX_LANES;
+    snprintf(lanes_arg, sizeof(lanes_arg), "%d", lanes);
+    char* init_argv[] = { init_bin, (char*)cfg->input_path, buf_arg, (char*)cfg->key,
+                          lanes > 0 ? "--lanes" : NULL, lanes_arg, NULL };
+
+    double t0 = mono_s();
+    pid_t ip = spawn(init_bin, init_argv, NULL, &old);
+    int status = 0;
+    if (ip < 0 || waitpid(ip, &status, 0) != ip || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, RED "[BENCH] El inicializador falló (%s)\n" RESET, init_bin);
+        sigprocmask(SIG_SETMASK, &old, NULL);
+        teardown_ipc();
+        return ERROR;
+    }
+    res->init_s = mono_s() - t0;
+
+    int shm_id = shmget(instance_shm_key(), 0, 0);
+    SharedMemory* shm = shm_id == -1 ? (void*)-1 : shmat(shm_id, NULL, 0);
+    if (shm == (void*)-1) {
+        fprintf(stderr, RED "[BENCH] No se pudo adjuntar la SHM: %s\n" RESET, strerror(errno));
+        sigprocmask(SIG_SETMASK, &old, NULL);
+        teardown_ipc();
+        return ERROR;
+    }
+    if (instance_check(shm) != SUCCESS) {
+        shmdt(shm);
+        sigprocmask(SIG_SETMASK, &old, NULL);
+        teardown_ipc();
+        return ERROR;
+    }
+    res->chars = (uint64_t)shm->total_chars_in_file;
+
+    pid_t pids[MAX_CHILDREN];
+    int n = 0;
+    char* recv_argv[] = { receptor_bin, "auto", NULL };
+    char* emit_argv[] = { emisor_bin, "auto", NULL };
+
+    double start = mono_s();
+    for (int i = 0; i < cfg->receptores && n < MAX_CHILDREN; i++) {
+        pid_t p = spawn(receptor_bin, recv_argv, cfg->out_dir, &old);
+        if (p > 0) pids[n++] = p;
+    }
+    for (int i = 0; i < cfg->emisores && n < MAX_CHILDREN; i++) {
+        pid_t p = spawn(emisor_bin, emit_argv, NULL, &old);
+        if (p > 0) pids[n++] = p;
+    }
+    wait_workers(shm, pids, n, start + cfg->timeout_s, res);
+    res->wall_s = mono_s() - start;
+    res->chars_per_s = res->wall_s > 0.0 ? (double)res->chars / res->wall_s : 0.0;
+    sigprocmask(SIG_SETMASK, &old, NULL);
+
+    collect_contention(shm, res);
+    shmdt(shm);
+    teardown_ipc();
+
+    VerifyResult vr;
+    if (verify_files(cfg->input_path, out_path, 0, &vr) != SUCCESS) {
+        fprintf(stderr, RED "[BENCH] No se pudo leer la salida %s: %s\n" RESET, out_path, strerror(errno));
+        return SUCCESS;
+    }
+    res->verified = (vr.mismatched_bytes == 0);
+    res->mismatched_bytes = vr.mismatched_bytes;
+    res->missing_bytes = vr.missing_bytes;
+    res->verify_s = vr.seconds;
+    if (!res->verified) {
+        fprintf(stderr, RED "\n[BENCH] La salida %s no coincide con la entrada:\n" RESET, out_path);
+        verify_print(stderr, &vr);
+    }
+    return SUCCESS;
+}
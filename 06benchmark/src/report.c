@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "report.h"
+#include "constants.h"
+
+/**
+ * Módulo de Reporte y Línea Base
+ *
+ * Las filas CSV y los objetos JSON llevan los mismos campos, de modo que
+ * ambos formatos se pueden cargar en una planilla o en pandas sin
+ * transformaciones. La línea base guarda sólo el resumen (medianas), que
+ * es lo que se compara entre versiones.
+ */
+
+static const char* g_sem_short[SEM_COUNT] = {
+    "global_mutex", "encrypt_queue", "decrypt_queue", "encrypt_spaces", "decrypt_items"
+};
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static Summary summarize(double* v, int n) {
+    Summary s = { 0, 0, 0, 0, 0 };
+    if (n <= 0) return s;
+    qsort(v, (size_t)n, sizeof(double), cmp_double);
+    s.min = v[0];
+    s.max = v[n - 1];
+    s.median = (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+    for (int i = 0; i < n; i++) s.mean += v[i];
+    s.mean /= n;
+    for (int i = 0; i < n; i++) s.stddev += (v[i] - s.mean) * (v[i] - s.mean);
+    s.stddev = n > 1 ? sqrt(s.stddev / (n - 1)) : 0.0;
+    return s;
+}
+
+void report_summarize(const TrialResult* r, int n, TrialSummary* out) {
+    memset(out, 0, sizeof(*out));
+    double* v = calloc(n > 0 ? (size_t)n : 1, sizeof(double));
+    if (!v) return;
+
+    out->trials = n;
+    for (int i = 0; i < n; i++) v[i] = r[i].chars_per_s;
+    out->chars_per_s = summarize(v, n);
+    for (int i = 0; i < n; i++) v[i] = r[i].wall_s;
+    out->wall_s = summarize(v, n);
+    for (int i = 0; i < n; i++) v[i] = r[i].cpu_user_s + r[i].cpu_sys_s;
+    out->cpu_s = summarize(v, n);
+    for (int i = 0; i < n; i++) v[i] = (double)(r[i].vol_ctx + r[i].invol_ctx);
+    out->ctx_switches = summarize(v, n);
+    for (int i = 0; i < n; i++) {
+        if (r[i].peak_rss_kb > out->peak_rss_kb) out->peak_rss_kb = r[i].peak_rss_kb;
+        if (r[i].verified) out->verified++;
+    }
+    free(v);
+}
+
+/* Cadena JSON con las comillas y barras escapadas */
+static void json_string(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s < 0x20) fprintf(f, "\\u%04x", (unsigned char)*s);
+        else fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void csv_header(FILE* f) {
+    fprintf(f, "trial,input,bytes,buffer_size,emisores,receptores,init_s,wall_s,chars_per_s,"
+               "cpu_user_s,cpu_sys_s,vol_ctx,invol_ctx,peak_rss_kb,completed,verified,mismatched_bytes,"
+               "missing_bytes,verify_s");
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",waits_%s", g_sem_short[s]);
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",blocked_ms_%s", g_sem_short[s]);
+    fprintf(f, "\n");
+}
+
+static void csv_row(FILE* f, const TrialConfig* cfg, int trial, const TrialResult* r) {
+    fprintf(f, "%d,%s,%llu,%d,%d,%d,%.6f,%.6f,%.1f,%.6f,%.6f,%ld,%ld,%ld,%d,%d,%llu,%llu,%.6f",
+            trial, cfg->input_path, (unsigned long long)r->chars, cfg->buffer_size,
+            cfg->emisores, cfg->receptores, r->init_s, r->wall_s, r->chars_per_s,
+            r->cpu_user_s, r->cpu_sys_s, r->vol_ctx, r->invol_ctx, r->peak_rss_kb,
+            r->completed, r->verified, (unsigned long long)r->mismatched_bytes,
+            (unsigned long long)r->missing_bytes, r->verify_s);
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",%llu", (unsigned long long)r->sem_waits[s]);
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",%.3f", (double)r->sem_blocked_ns[s] / 1e6);
+    fprintf(f, "\n");
+}
+
+static void json_summary(FILE* f, const char* name, const Summary* s, int last) {
+    fprintf(f, "    \"%s\": {\"median\": %.6f, \"min\": %.6f, \"max\": %.6f, \"mean\": %.6f, \"stddev\": %.6f}%s\n",
+            name, s->median, s->min, s->max, s->mean, s->stddev, last ? "" : ",");
+}
+
+static void json_trial(FILE* f, int trial, const TrialResult* r, int last) {
+    fprintf(f, "    {\"trial\": %d, \"bytes\": %llu, \"init_s\": %.6f, \"wall_s\": %.6f, "
+               "\"chars_per_s\": %.1f, \"cpu_user_s\": %.6f, \"cpu_sys_s\": %.6f, "
+               "\"vol_ctx\": %ld, \"invol_ctx\": %ld, \"peak_rss_kb\": %ld, "
+               "\"completed\": %s, \"verified\": %s, \"mismatched_bytes\": %llu, \"missing_bytes\": %llu, "
+               "\"verify_s\": %.6f, \"semaphores\": {",
+            trial, (unsigned long long)r->chars, r->init_s, r->wall_s, r->chars_per_s,
+            r->cpu_user_s, r->cpu_sys_s, r->vol_ctx, r->invol_ctx, r->peak_rss_kb,
+            r->completed ? "true" : "false", r->verified ? "true" : "false",
+            (unsigned long long)r->mismatched_bytes, (unsigned long long)r->missing_bytes, r->verify_s);
+    for (int s = 0; s < SEM_COUNT; s++) {
+        fprintf(f, "\"%s\": {\"waits\": %llu, \"blocked_ms\": %.3f}%s", g_sem_short[s],
+                (unsigned long long)r->sem_waits[s], (double)r->sem_blocked_ns[s] / 1e6,
+                s + 1 < SEM_COUNT ? ", " : "");
+    }
+    fprintf(f, "}}%s\n", last ? "" : ",");
+}
+
+/**
+ * @brief Escribe todas las corridas en el formato pedido
+ */
+void report_write(FILE* f, OutputFormat fmt, const TrialConfig* cfg, const TrialResult* r, int n) {
+    if (fmt == FORMAT_CSV) {
+        csv_header(f);
+        for (int i = 0; i < n; i++) csv_row(f, cfg, i + 1, &r[i]);
+        return;
+    }
+
+    TrialSummary s;
+    report_summarize(r, n, &s);
+    fprintf(f, "{\n  \"config\": {\"input\": ");
+    json_string(f, cfg->input_path);
+    fprintf(f, ", \"buffer_size\": %d, \"emisores\": %d, \"receptores\": %d, \"lanes\": %d, \"trials\": %d},\n",
+            cfg->buffer_size, cfg->emisores, cfg->receptores, cfg->lanes < 0 ? cfg->emisores : cfg->lanes, n);
+    fprintf(f, "  \"trials\": [\n");
+    for (int i = 0; i < n; i++) json_trial(f, i + 1, &r[i], i + 1 == n);
+    fprintf(f, "  ],\n  \"summary\": {\n");
+    json_summary(f, "chars_per_s", &s.chars_per_s, 0);
+    json_summary(f, "wall_s", &s.wall_s, 0);
+    json_summary(f, "cpu_s", &s.cpu_s, 0);
+    json_summary(f, "ctx_switches", &s.ctx_switches, 0);
+    fprintf(f, "    \"peak_rss_kb\": %ld,\n    \"verified\": %d\n  }\n}\n", s.peak_rss_kb, s.verified);
+}
+
+void report_print_summary(const TrialConfig* cfg, const TrialSummary* s) {
+    fprintf(stderr, BOLD CYAN "\nResumen (%d corridas, buffer %d, %d emisores, %d receptores):\n" RESET,
+            s->trials, cfg->buffer_size, cfg->emisores, cfg->receptores);
+    fprintf(stderr, "  %-14s %14s %14s %14s %12s\n", "Métrica", "Mediana", "Mín", "Máx", "Desv.");
+    const struct { const char* name; const Summary* v; } rows[] = {
+        { "chars/s", &s->chars_per_s }, { "wall (s)", &s->wall_s },
+        { "CPU (s)", &s->cpu_s }, { "ctx switches", &s->ctx_switches },
+    };
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        fprintf(stderr, "  %-14s %14.3f %14.3f %14.3f %12.3f\n", rows[i].name,
+                rows[i].v->median, rows[i].v->min, rows[i].v->max, rows[i].v->stddev);
+    }
+    fprintf(stderr, "  %-14s %14ld\n", "RSS máx (KB)", s->peak_rss_kb);
+    fprintf(stderr, "  %-14s %s%d/%d" RESET "\n", "Verificadas",
+            s->verified == s->trials ? GREEN : RED, s->verified, s->trials);
+}
+
+// =============================================================================
+// LÍNEA BASE
+// =============================================================================
+
+int baseline_save(const char* path, const TrialConfig* cfg, const TrialSummary* s) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror("baseline");
+        return ERROR;
+    }
+    fprintf(f, "# Línea base del benchmark (bench run --save-baseline)\n");
+    fprintf(f, "input=%s\nbuffer_size=%d\nemisores=%d\nreceptores=%d\nlanes=%d\ntrials=%d\n",
+            cfg->input_path, cfg->buffer_size, cfg->emisores, cfg->receptores,
+            cfg->lanes < 0 ? cfg->emisores : cfg->lanes, s->trials);
+    fprintf(f, "chars_per_s=%.3f\nwall_s=%.6f\ncpu_s=%.6f\nctx_switches=%.1f\npeak_rss_kb=%ld\n",
+            s->chars_per_s.median, s->wall_s.median, s->cpu_s.median,
+            s->ctx_switches.median, s->peak_rss_kb);
+    fclose(f);
+    return SUCCESS;
+}
+
+/* Valor numérico de "clave=valor" (NAN si falta) */
+static double baseline_value(FILE* f, const char* key) {
+    char line[4096];
+    size_t klen = strlen(key);
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, key, klen) == 0 && line[klen] == '=') return strtod(line + klen + 1, NULL);
+    }
+    return NAN;
+}
+
+static void compare_row(const char* name, double base, double cur, int higher_is_better) {
+    if (isnan(base)) return;
+    double delta = base != 0.0 ? (cur - base) / base * 100.0 : 0.0;
+    int better = higher_is_better ? delta >= 0.0 : delta <= 0.0;
+    fprintf(stderr, "  %-14s %14.3f %14.3f   %s%+7.2f%%" RESET "\n", name, base, cur,
+            fabs(delta) < 1.0 ? "" : (better ? GREEN : RED), delta);
+}
+
+/**
+ * @brief Compara el resumen actual con una línea base guardada
+ *
+ * @return 1 si chars/s cayó más que threshold_pct, 0 si no, ERROR si no se pudo leer
+ */
+int baseline_compare(const char* path, const TrialConfig* cfg, const TrialSummary* s, double threshold_pct) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror("baseline");
+        return ERROR;
+    }
+
+    double base_buf = baseline_value(f, "buffer_size");
+    double base_e = baseline_value(f, "emisores");
+    double base_r = baseline_value(f, "receptores");
+    if ((int)base_buf != cfg->buffer_size || (int)base_e != cfg->emisores || (int)base_r != cfg->receptores) {
+        fprintf(stderr, YELLOW "  ! La línea base usa otra configuración (buffer %.0f, %.0fE/%.0fR)\n" RESET,
+                base_buf, base_e, base_r);
+    }
+
+    fprintf(stderr, BOLD CYAN "\nComparación con %s:\n" RESET, path);
+    fprintf(stderr, "  %-14s %14s %14s   %8s\n", "Métrica", "Base", "Actual", "Delta");
+    double base_rate = baseline_value(f, "chars_per_s");
+    compare_row("chars/s", base_rate, s->chars_per_s.median, 1);
+    compare_row("wall (s)", baseline_value(f, "wall_s"), s->wall_s.median, 0);
+    compare_row("CPU (s)", baseline_value(f, "cpu_s"), s->cpu_s.median, 0);
+    compare_row("ctx switches", baseline_value(f, "ctx_switches"), s->ctx_switches.median, 0);
+    compare_row("RSS máx (KB)", baseline_value(f, "peak_rss_kb"), (double)s->peak_rss_kb, 0);
+    fclose(f);
+
+    if (isnan(base_rate) || base_rate <= 0.0) return 0;
+    double drop = (base_rate - s->chars_per_s.median) / base_rate * 100.0;
+    if (drop > threshold_pct) {
+        fprintf(stderr, RED "  ✗ Regresión: chars/s %.2f%% por debajo de la línea base (umbral %.1f%%)\n" RESET,
+                drop, threshold_pct);
+        return 1;
+    }
+    fprintf(stderr, GREEN "  ✓ Dentro del umbral (%.1f%%)\n" RESET, threshold_pct);
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sweep.h"
+#include "report.h"
+#include "constants.h"
+
+/**
+ * Módulo de Barrido de Escalabilidad
+ *
+ * Recorre la grilla emisores × receptores × buffer_size con el mismo
+ * driver que `bench run` y escribe una fila por punto. Además de chars/s
+ * reporta, por semáforo, la fracción del tiempo de los trabajadores que
+ * pasó bloqueada en él: es la columna que muestra dónde deja de escalar
+ * el pipeline (p. ej. ENCRYPT_SPACES con buffers chicos, o DECRYPT_QUEUE
+ * cuando la búsqueda ordenada domina con buffers grandes).
+ *
+ * Cada fila se escribe y se vacía al terminar su punto, así un barrido
+ * largo interrumpido se retoma con --resume sin repetir lo ya medido.
+ */
+
+static const char* g_sem_short[SEM_COUNT] = {
+    "global_mutex", "encrypt_queue", "decrypt_queue", "encrypt_spaces", "decrypt_items"
+};
+
+/**
+ * @brief Parsea un eje del barrido
+ *
+ * Acepta una lista "1,2,8" o un rango "1..64", que se expande en
+ * potencias de 2 desde el extremo inferior e incluye siempre el superior.
+ *
+ * @return SUCCESS, o ERROR si algún valor está fuera de [lo, hi]
+ */
+int sweep_parse_axis(const char* spec, int lo, int hi, int* out, int* count) {
+    *count = 0;
+    const char* dots = strstr(spec, "..");
+    if (dots) {
+        char* end = NULL;
+        long a = strtol(spec, &end, 10);
+        if (end != dots) return ERROR;
+        long b = strtol(dots + 2, &end, 10);
+        if (*end != '\0' || a < lo || b > hi || a > b) return ERROR;
+        for (long v = a; v < b && *count < SWEEP_MAX_POINTS - 1; v *= 2) out[(*count)++] = (int)v;
+        out[(*count)++] = (int)b;
+        return SUCCESS;
+    }
+
+    const char* p = spec;
+    while (*p && *count < SWEEP_MAX_POINTS) {
+        char* end = NULL;
+        long v = strtol(p, &end, 10);
+        if (end == p || v < lo || v > hi || (*end != ',' && *end != '\0')) return ERROR;
+        out[(*count)++] = (int)v;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return (*count > 0 && *p == '\0') ? SUCCESS : ERROR;
+}
+
+static void sweep_header(FILE* f) {
+    fprintf(f, "emisores,receptores,buffer_size,trials,verified,bytes,chars_per_s,chars_per_s_min,"
+               "chars_per_s_max,wall_s,cpu_s,ctx_switches,peak_rss_kb");
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",waits_per_kchar_%s", g_sem_short[s]);
+    for (int s = 0; s < SEM_COUNT; s++) fprintf(f, ",blocked_pct_%s", g_sem_short[s]);
+    fprintf(f, "\n");
+}
+
+/**
+ * @brief Escribe la fila de un punto
+ *
+ * Contención normalizada para que sea comparable entre puntos:
+ *  - waits_per_kchar: esperas bloqueantes por cada 1000 caracteres.
+ *  - blocked_pct: tiempo bloqueado / (wall × trabajadores) × 100.
+ */
+static void sweep_row(FILE* f, const TrialConfig* cfg, const TrialResult* r, int n) {
+    TrialSummary s;
+    report_summarize(r, n, &s);
+
+    double waits[SEM_COUNT] = { 0 }, blocked[SEM_COUNT] = { 0 };
+    double chars = 0.0, worker_s = 0.0;
+    for (int i = 0; i < n; i++) {
+        chars += (double)r[i].chars;
+        worker_s += r[i].wall_s * (cfg->emisores + cfg->receptores);
+        for (int k = 0; k < SEM_COUNT; k++) {
+            waits[k] += (double)r[i].sem_waits[k];
+            blocked[k] += (double)r[i].sem_blocked_ns[k] / 1e9;
+        }
+    }
+
+    fprintf(f, "%d,%d,%d,%d,%d,%llu,%.1f,%.1f,%.1f,%.6f,%.6f,%.1f,%ld",
+            cfg->emisores, cfg->receptores, cfg->buffer_size, n, s.verified,
+            n > 0 ? (unsigned long long)r[0].chars : 0ULL,
+            s.chars_per_s.median, s.chars_per_s.min, s.chars_per_s.max,
+            s.wall_s.median, s.cpu_s.median, s.ctx_switches.median, s.peak_rss_kb);
+    for (int k = 0; k < SEM_COUNT; k++) fprintf(f, ",%.3f", chars > 0.0 ? waits[k] * 1000.0 / chars : 0.0);
+    for (int k = 0; k < SEM_COUNT; k++) fprintf(f, ",%.2f", worker_s > 0.0 ? blocked[k] * 100.0 / worker_s : 0.0);
+    fprintf(f, "\n");
+    fflush(f);
+}
+
+/* ¿El archivo de un barrido anterior ya contiene este punto? */
+static int point_done(FILE* prev, int e, int r, int b) {
+    if (!prev) return 0;
+    char line[1024];
+    rewind(prev);
+    while (fgets(line, sizeof(line), prev)) {
+        int pe, pr, pb;
+        if (sscanf(line, "%d,%d,%d,", &pe, &pr, &pb) == 3 && pe == e && pr == r && pb == b) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ejecuta el barrido completo
+ *
+ * @param sc Ejes y parámetros comunes
+ * @param output_path Archivo CSV (NULL = stdout, sin resume)
+ * @param resume Omitir los puntos ya presentes en output_path
+ * @return SUCCESS si todos los puntos se ejecutaron y verificaron
+ */
+int run_sweep(const SweepConfig* sc, const char* output_path, int resume) {
+    FILE* prev = (resume && output_path) ? fopen(output_path, "r") : NULL;
+    FILE* out = stdout;
+    if (output_path && !(out = fopen(output_path, prev ? "a" : "w"))) {
+        perror(output_path);
+        if (prev) fclose(prev);
+        return ERROR;
+    }
+    if (!prev) sweep_header(out);
+
+    TrialResult* results = calloc((size_t)sc->trials, sizeof(TrialResult));
+    if (!results) {
+        if (prev) fclose(prev);
+        if (out != stdout) fclose(out);
+        return ERROR;
+    }
+
+    int total = sc->n_emisores * sc->n_receptores * sc->n_buffers;
+    int point = 0, failures = 0;
+    time_t started = time(NULL);
+
+    for (int b = 0; b < sc->n_buffers; b++) {
+        for (int e = 0; e < sc->n_emisores; e++) {
+            for (int r = 0; r < sc->n_receptores; r++) {
+                TrialConfig cfg = sc->base;
+                cfg.buffer_size = sc->buffers[b];
+                cfg.emisores = sc->emisores[e];
+                cfg.receptores = sc->receptores[r];
+                point++;
+                if (point_done(prev, cfg.emisores, cfg.receptores, cfg.buffer_size)) continue;
+
+                int done = 0;
+                for (int t = 0; t < sc->trials; t++) {
+                    if (run_trial(&cfg, &results[done]) != SUCCESS) break;
+                    done++;
+                }
+                if (done < sc->trials) failures++;
+                if (done > 0) sweep_row(out, &cfg, results, done);
+
+                TrialSummary s;
+                report_summarize(results, done, &s);
+                if (s.verified < done) failures++;
+                long elapsed = (long)(time(NULL) - started);
+                fprintf(stderr, CYAN "[SWEEP] %d/%d" RESET " buffer %-8d %2dE/%2dR  %12.0f chars/s  %s  (%ld s)\n",
+                        point, total, cfg.buffer_size, cfg.emisores, cfg.receptores,
+                        s.chars_per_s.median, (done > 0 && s.verified == done) ? GREEN "✓" RESET : RED "✗" RESET,
+                        elapsed);
+            }
+        }
+    }
+
+    free(results);
+    if (prev) fclose(prev);
+    if (out != stdout) fclose(out);
+    return failures == 0 ? SUCCESS : ERROR;
+}
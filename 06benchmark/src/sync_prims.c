@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include "sync_prims.h"
+#include "constants.h"
+
+/**
+ * Módulo de Primitivas de Sincronización
+ *
+ * Todas las variantes exponen la misma semántica de semáforo contador
+ * (wait decrementa o bloquea, post incrementa y despierta a uno), que es
+ * exactamente lo que el pipeline pide a sus cinco puntos de
+ * sincronización. Así bench_sync compara el costo del traspaso sin
+ * cambiar el algoritmo que lo rodea.
+ */
+
+static const char* g_prim_names[PRIM_COUNT] = { "named", "unnamed", "condvar", "futex", "spin" };
+
+const char* prim_name(PrimKind kind) {
+    return ((unsigned)kind < PRIM_COUNT) ? g_prim_names[kind] : "?";
+}
+
+int prim_from_name(const char* name) {
+    for (int i = 0; i < PRIM_COUNT; i++) if (strcmp(name, g_prim_names[i]) == 0) return i;
+    return -1;
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static long futex(uint32_t* addr, int op, uint32_t val) {
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+/**
+ * @brief Inicializa un semáforo del tipo pedido
+ *
+ * @param s Semáforo (en memoria compartida)
+ * @param kind Implementación
+ * @param value Valor inicial
+ * @param id Identificador único dentro de la corrida (nombre del semáforo nombrado)
+ * @return SUCCESS o ERROR
+ */
+int sync_sem_init(SyncSem* s, PrimKind kind, unsigned value, int id) {
+    memset(s, 0, sizeof(*s));
+    s->kind = kind;
+
+    switch (kind) {
+    case PRIM_NAMED:
+        snprintf(s->u.named.name, sizeof(s->u.named.name), "/ipc_bench_sync_%d_%d", (int)getpid(), id);
+        sem_unlink(s->u.named.name);
+        s->u.named.handle = sem_open(s->u.named.name, O_CREAT | O_EXCL, 0600, value);
+        if (s->u.named.handle == SEM_FAILED) {
+            perror("sem_open");
+            return ERROR;
+        }
+        return SUCCESS;
+
+    case PRIM_UNNAMED:
+        if (sem_init(&s->u.sem, 1, value) != 0) {
+            perror("sem_init");
+            return ERROR;
+        }
+        return SUCCESS;
+
+    case PRIM_CONDVAR: {
+        pthread_mutexattr_t ma;
+        pthread_condattr_t ca;
+        pthread_mutexattr_init(&ma);
+        pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_init(&ca);
+        pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED);
+        int rc = pthread_mutex_init(&s->u.cv.mutex, &ma);
+        if (rc == 0) rc = pthread_cond_init(&s->u.cv.cond, &ca);
+        pthread_mutexattr_destroy(&ma);
+        pthread_condattr_destroy(&ca);
+        s->u.cv.value = value;
+        if (rc != 0) {
+            fprintf(stderr, RED "[ERROR] pthread_*_init: %s\n" RESET, strerror(rc));
+            return ERROR;
+        }
+        return SUCCESS;
+    }
+
+    case PRIM_FUTEX:
+        s->u.fx.value = value;
+        return SUCCESS;
+
+    case PRIM_SPIN:
+        s->u.spin = value;
+        return SUCCESS;
+
+    default:
+        return ERROR;
+    }
+}
+
+void sync_sem_wait(SyncSem* s) {
+    switch (s->kind) {
+    case PRIM_NAMED:
+        while (sem_wait(s->u.named.handle) == -1 && errno == EINTR) { }
+        return;
+
+    case PRIM_UNNAMED:
+        while (sem_wait(&s->u.sem) == -1 && errno == EINTR) { }
+        return;
+
+    case PRIM_CONDVAR:
+        pthread_mutex_lock(&s->u.cv.mutex);
+        while (s->u.cv.value == 0) pthread_cond_wait(&s->u.cv.cond, &s->u.cv.mutex);
+        s->u.cv.value--;
+        pthread_mutex_unlock(&s->u.cv.mutex);
+        return;
+
+    case PRIM_FUTEX:
+        // Si post incrementa entre la lectura y FUTEX_WAIT, el kernel ve
+        // value != 0 y retorna EAGAIN: no se pierde el despertar
+        for (;;) {
+            uint32_t v = __atomic_load_n(&s->u.fx.value, __ATOMIC_ACQUIRE);
+            while (v > 0) {
+                if (__atomic_compare_exchange_n(&s->u.fx.value, &v, v - 1, 0,
+                                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+            }
+            __atomic_fetch_add(&s->u.fx.waiters, 1, __ATOMIC_SEQ_CST);
+            futex(&s->u.fx.value, FUTEX_WAIT, 0);
+            __atomic_fetch_sub(&s->u.fx.waiters, 1, __ATOMIC_RELAXED);
+        }
+
+    case PRIM_SPIN:
+        for (;;) {
+            uint32_t v = __atomic_load_n(&s->u.spin, __ATOMIC_ACQUIRE);
+            if (v > 0 && __atomic_compare_exchange_n(&s->u.spin, &v, v - 1, 0,
+                                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+            cpu_relax();
+        }
+
+    default:
+        return;
+    }
+}
+
+void sync_sem_post(SyncSem* s) {
+    switch (s->kind) {
+    case PRIM_NAMED:
+        sem_post(s->u.named.handle);
+        return;
+
+    case PRIM_UNNAMED:
+        sem_post(&s->u.sem);
+        return;
+
+    case PRIM_CONDVAR:
+        pthread_mutex_lock(&s->u.cv.mutex);
+        s->u.cv.value++;
+        pthread_cond_signal(&s->u.cv.cond);
+        pthread_mutex_unlock(&s->u.cv.mutex);
+        return;
+
+    case PRIM_FUTEX:
+        __atomic_fetch_add(&s->u.fx.value, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&s->u.fx.waiters, __ATOMIC_SEQ_CST) > 0) futex(&s->u.fx.value, FUTEX_WAKE, 1);
+        return;
+
+    case PRIM_SPIN:
+        __atomic_fetch_add(&s->u.spin, 1, __ATOMIC_RELEASE);
+        return;
+
+    default:
+        return;
+    }
+}
+
+void sync_sem_destroy(SyncSem* s) {
+    switch (s->kind) {
+    case PRIM_NAMED:
+        sem_close(s->u.named.handle);
+        sem_unlink(s->u.named.name);
+        return;
+    case PRIM_UNNAMED:
+        sem_destroy(&s->u.sem);
+        return;
+    case PRIM_CONDVAR:
+        pthread_cond_destroy(&s->u.cv.cond);
+        pthread_mutex_destroy(&s->u.cv.mutex);
+        return;
+    default:
+        return;
+    }
+}
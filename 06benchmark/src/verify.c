@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "verify.h"
+#include "constants.h"
+
+/**
+ * Módulo de Verificación de Salida
+ *
+ * Proyecta ambos archivos con mmap y reparte fragmentos de VERIFY_CHUNK
+ * entre hilos (contador atómico, sin asignación estática: un fragmento
+ * lento no frena a los demás). Cada fragmento se compara primero con
+ * memcmp (vectorizado en glibc); sólo si difiere se recorre por bloques
+ * de 64 bytes y, dentro de un bloque distinto, byte a byte para armar
+ * los rangos.
+ *
+ * Un rango es "faltante" cuando la salida tiene sólo ceros en él: el
+ * receptor escribe por offset sobre un archivo que no trunca, así que los
+ * caracteres que nunca llegaron quedan como huecos en cero.
+ */
+
+#define VERIFY_CHUNK        (4u << 20)
+#define VERIFY_LANE         64
+#define VERIFY_MAX_THREADS  64
+#define VERIFY_KEEP_RANGES  (2 * VERIFY_MAX_RANGES)
+
+typedef struct {
+    const unsigned char* exp;
+    const unsigned char* act;
+    uint64_t             common;        // Bytes presentes en ambos archivos
+    uint64_t             nchunks;
+    uint64_t             next_chunk;    // Contador atómico de reparto
+    uint8_t*             head_open;     // El fragmento empieza con un byte distinto
+    uint8_t*             tail_open;     // El fragmento termina con un byte distinto
+
+    pthread_mutex_t      lock;          // Protege lo siguiente
+    uint64_t             mismatched;
+    uint64_t             missing;
+    uint64_t             ranges;        // Rangos por fragmento (antes de unir bordes)
+    int64_t              first;
+    MismatchRange        kept[VERIFY_KEEP_RANGES];
+    int                  nkept;
+} VerifyJob;
+
+static double mono_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Proyecta un archivo completo en sólo lectura (size 0 -> NULL sin error) */
+static int map_file(const char* path, const unsigned char** data, uint64_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return ERROR;
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return ERROR;
+    }
+    *size = (uint64_t)st.st_size;
+    *data = NULL;
+    if (st.st_size > 0) {
+        void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return ERROR;
+        }
+        *data = p;
+    }
+    close(fd);
+    return SUCCESS;
+}
+
+/* Igualdad de 64 bytes con palabras de 64 bits (el compilador lo vectoriza) */
+static inline int lane_equal(const unsigned char* a, const unsigned char* b) {
+    uint64_t diff = 0;
+    for (int i = 0; i < VERIFY_LANE; i += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        diff |= x ^ y;
+    }
+    return diff == 0;
+}
+
+/*
+ * Conserva los rangos de menor offset: si la lista está llena, el nuevo
+ * reemplaza al de mayor inicio cuando empieza antes. Llamar con lock.
+ */
+static void keep_range(VerifyJob* job, MismatchRange r) {
+    if (job->nkept < VERIFY_KEEP_RANGES) {
+        job->kept[job->nkept++] = r;
+        return;
+    }
+    int worst = 0;
+    for (int i = 1; i < job->nkept; i++) if (job->kept[i].start > job->kept[worst].start) worst = i;
+    if (r.start < job->kept[worst].start) job->kept[worst] = r;
+}
+
+/**
+ * @brief Compara un fragmento y acumula sus rangos
+ */
+static void compare_chunk(VerifyJob* job, uint64_t c) {
+    uint64_t base = c * VERIFY_CHUNK;
+    size_t len = (size_t)(job->common - base < VERIFY_CHUNK ? job->common - base : VERIFY_CHUNK);
+    const unsigned char* e = job->exp + base;
+    const unsigned char* a = job->act + base;
+    if (memcmp(e, a, len) == 0) return;
+
+    uint64_t mismatched = 0, missing = 0, ranges = 0;
+    int64_t first = -1;
+    MismatchRange local[VERIFY_MAX_RANGES];
+    int nlocal = 0;
+    int open = 0;
+    MismatchRange cur = { 0, 0, RANGE_MISSING };
+
+    for (size_t off = 0; off < len; off += VERIFY_LANE) {
+        size_t n = len - off < VERIFY_LANE ? len - off : VERIFY_LANE;
+        if (n == VERIFY_LANE && lane_equal(e + off, a + off)) {
+            if (open) {
+                cur.end = base + off;
+                if (nlocal < VERIFY_MAX_RANGES) local[nlocal++] = cur;
+                open = 0;
+            }
+            continue;
+        }
+        for (size_t i = off; i < off + n; i++) {
+            if (e[i] == a[i]) {
+                if (open) {
+                    cur.end = base + i;
+                    if (nlocal < VERIFY_MAX_RANGES) local[nlocal++] = cur;
+                    open = 0;
+                }
+                continue;
+            }
+            mismatched++;
+            if (a[i] == 0) missing++;
+            if (!open) {
+                open = 1;
+                ranges++;
+                cur.start = base + i;
+                cur.kind = RANGE_MISSING;
+                if (first < 0) first = (int64_t)(base + i);
+            }
+            if (a[i] != 0) cur.kind = RANGE_CORRUPT;
+        }
+    }
+    if (open) {
+        cur.end = base + len;
+        if (nlocal < VERIFY_MAX_RANGES) local[nlocal++] = cur;
+    }
+    job->head_open[c] = (e[0] != a[0]);
+    job->tail_open[c] = (e[len - 1] != a[len - 1]);
+
+    pthread_mutex_lock(&job->lock);
+    job->mismatched += mismatched;
+    job->missing += missing;
+    job->ranges += ranges;
+    if (first >= 0 && (job->first < 0 || first < job->first)) job->first = first;
+    for (int i = 0; i < nlocal; i++) keep_range(job, local[i]);
+    pthread_mutex_unlock(&job->lock);
+}
+
+static void* verify_worker(void* arg) {
+    VerifyJob* job = arg;
+    for (;;) {
+        uint64_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->nchunks) break;
+        compare_chunk(job, c);
+    }
+    return NULL;
+}
+
+static int cmp_range(const void* x, const void* y) {
+    const MismatchRange* a = x;
+    const MismatchRange* b = y;
+    return (a->start > b->start) - (a->start < b->start);
+}
+
+/**
+ * @brief Ordena los rangos conservados y une los que se tocan en un borde de fragmento
+ */
+static void finalize_ranges(VerifyJob* job, VerifyResult* vr) {
+    qsort(job->kept, (size_t)job->nkept, sizeof(MismatchRange), cmp_range);
+    int n = 0;
+    for (int i = 0; i < job->nkept; i++) {
+        if (n > 0 && vr->ranges[n - 1].end == job->kept[i].start &&
+            vr->ranges[n - 1].kind != RANGE_EXTRA && job->kept[i].kind != RANGE_EXTRA) {
+            vr->ranges[n - 1].end = job->kept[i].end;
+            if (job->kept[i].kind == RANGE_CORRUPT) vr->ranges[n - 1].kind = RANGE_CORRUPT;
+            continue;
+        }
+        if (n == VERIFY_MAX_RANGES) break;
+        vr->ranges[n++] = job->kept[i];
+    }
+    vr->ranges_shown = n;
+
+    // Rangos que cruzan un borde se contaron una vez por fragmento
+    uint64_t count = job->ranges;
+    for (uint64_t c = 0; c + 1 < job->nchunks; c++) {
+        if (job->tail_open[c] && job->head_open[c + 1]) count--;
+    }
+    vr->range_count = count;
+}
+
+/**
+ * @brief Compara la salida de los receptores con la entrada
+ *
+ * @param threads Hilos de comparación (0 = uno por CPU)
+ * @return SUCCESS si ambos archivos pudieron leerse (ver vr->mismatched_bytes)
+ */
+int verify_files(const char* expected_path, const char* actual_path, int threads, VerifyResult* vr) {
+    memset(vr, 0, sizeof(*vr));
+    vr->first_mismatch = -1;
+    double t0 = mono_s();
+
+    const unsigned char *exp = NULL, *act = NULL;
+    if (map_file(expected_path, &exp, &vr->expected_bytes) != SUCCESS) return ERROR;
+    if (map_file(actual_path, &act, &vr->actual_bytes) != SUCCESS) {
+        if (exp) munmap((void*)exp, vr->expected_bytes);
+        return ERROR;
+    }
+
+    VerifyJob job;
+    memset(&job, 0, sizeof(job));
+    job.exp = exp;
+    job.act = act;
+    job.common = vr->expected_bytes < vr->actual_bytes ? vr->expected_bytes : vr->actual_bytes;
+    job.nchunks = (job.common + VERIFY_CHUNK - 1) / VERIFY_CHUNK;
+    job.first = -1;
+    pthread_mutex_init(&job.lock, NULL);
+    job.head_open = calloc(job.nchunks ? job.nchunks : 1, 1);
+    job.tail_open = calloc(job.nchunks ? job.nchunks : 1, 1);
+    if (!job.head_open || !job.tail_open) {
+        free(job.head_open);
+        free(job.tail_open);
+        if (exp) munmap((void*)exp, vr->expected_bytes);
+        if (act) munmap((void*)act, vr->actual_bytes);
+        return ERROR;
+    }
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads > VERIFY_MAX_THREADS) threads = VERIFY_MAX_THREADS;
+    if ((uint64_t)threads > job.nchunks) threads = job.nchunks ? (int)job.nchunks : 1;
+    vr->threads = threads;
+
+    pthread_t tids[VERIFY_MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&tids[started], NULL, verify_worker, &job) == 0) started++;
+    }
+    verify_worker(&job);        // El hilo principal también compara
+    for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+
+    // Cola: salida más corta (faltante) o más larga (sobrante)
+    if (vr->expected_bytes != vr->actual_bytes) {
+        int shorter = vr->actual_bytes < vr->expected_bytes;
+        MismatchRange tail = { job.common, shorter ? vr->expected_bytes : vr->actual_bytes,
+                               shorter ? RANGE_MISSING : RANGE_EXTRA };
+        uint64_t n = tail.end - tail.start;
+        job.mismatched += n;
+        if (shorter) job.missing += n;
+        else         vr->extra_bytes = n;
+        // Un faltante que continúa el último rango no es un rango nuevo
+        int continues = shorter && job.nchunks > 0 && job.tail_open[job.nchunks - 1];
+        if (!continues) job.ranges++;
+        if (job.first < 0) job.first = (int64_t)job.common;
+        keep_range(&job, tail);
+    }
+
+    vr->mismatched_bytes = job.mismatched;
+    vr->missing_bytes = job.missing;
+    vr->first_mismatch = job.first;
+    finalize_ranges(&job, vr);
+
+    pthread_mutex_destroy(&job.lock);
+    free(job.head_open);
+    free(job.tail_open);
+    if (exp) munmap((void*)exp, vr->expected_bytes);
+    if (act) munmap((void*)act, vr->actual_bytes);
+    vr->seconds = mono_s() - t0;
+    return SUCCESS;
+}
+
+void verify_print(FILE* f, const VerifyResult* vr) {
+    static const char* kinds[] = { "distinto", "faltante", "sobrante" };
+    double mib = (double)(vr->expected_bytes > vr->actual_bytes ? vr->expected_bytes : vr->actual_bytes)
+               / (1 << 20);
+
+    if (vr->mismatched_bytes == 0) {
+        fprintf(f, GREEN "✓ Idénticos: %llu bytes" RESET, (unsigned long long)vr->expected_bytes);
+    } else {
+        fprintf(f, RED "✗ %llu bytes distintos en %llu rangos (%llu faltantes, %llu sobrantes)" RESET,
+                (unsigned long long)vr->mismatched_bytes, (unsigned long long)vr->range_count,
+                (unsigned long long)vr->missing_bytes, (unsigned long long)vr->extra_bytes);
+    }
+    fprintf(f, " — %.3f s, %.1f MiB/s, %d hilos\n", vr->seconds,
+            vr->seconds > 0.0 ? mib / vr->seconds : 0.0, vr->threads);
+    if (vr->expected_bytes != vr->actual_bytes) {
+        fprintf(f, YELLOW "  ! Tamaños: esperado %llu, salida %llu" RESET "\n",
+                (unsigned long long)vr->expected_bytes, (unsigned long long)vr->actual_bytes);
+    }
+    for (int i = 0; i < vr->ranges_shown; i++) {
+        const MismatchRange* r = &vr->ranges[i];
+        fprintf(f, "  [%llu, %llu)  %llu bytes  %s\n", (unsigned long long)r->start,
+                (unsigned long long)r->end, (unsigned long long)(r->end - r->start), kinds[r->kind]);
+    }
+    if ((uint64_t)vr->ranges_shown < vr->range_count) {
+        fprintf(f, "  ... %llu rangos más\n", (unsigned long long)(vr->range_count - (uint64_t)vr->ranges_shown));
+    }
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "verify.h"
+#include "constants.h"
+
+/**
+ * Verificador de Salida
+ *
+ * Compara el archivo escrito por los receptores con la entrada original
+ * (ver verify.c): rangos distintos, regiones faltantes y throughput.
+ *
+ * Uso: ./verify_output ENTRADA SALIDA [--threads N]
+ * Salida: 0 idénticos, 1 distintos, 2 error de lectura
+ */
+
+#define VERIFY_EXIT_DIFFERENT 1
+#define VERIFY_EXIT_ERROR     2
+
+int main(int argc, char* argv[]) {
+    int threads = 0;
+    if (argc == 5 && strcmp(argv[3], "--threads") == 0) {
+        threads = atoi(argv[4]);
+    } else if (argc != 3) {
+        fprintf(stderr, "Uso: %s ENTRADA SALIDA [--threads N]\n", argv[0]);
+        return VERIFY_EXIT_ERROR;
+    }
+
+    VerifyResult vr;
+    if (verify_files(argv[1], argv[2], threads, &vr) != SUCCESS) {
+        perror("verify");
+        return VERIFY_EXIT_ERROR;
+    }
+    verify_print(stdout, &vr);
+    return vr.mismatched_bytes == 0 ? EXIT_SUCCESS : VERIFY_EXIT_DIFFERENT;
+}
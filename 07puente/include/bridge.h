@@ -0,0 +1,20 @@
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#include <signal.h>
+
+/*
+ * Extremos del puente:
+ *  - bridge_send: receptor de la instancia local que reenvía los caracteres
+ *    cifrados en lotes de hasta batch caracteres a la dirección addr.
+ *  - bridge_receive: emisor de la instancia local que escucha en addr y
+ *    publica lo que llega en su cola de desencriptación; concede credits
+ *    caracteres de crédito. Con buffer_size > 0 crea antes el segmento de
+ *    la instancia (buffer_size slots) con la entrada que describe el
+ *    origen; con 0 usa el existente, que tiene que tener la misma entrada.
+ * Ambos retornan SUCCESS si la entrada llegó completa al destino.
+ */
+int bridge_send(const char* addr, int batch, volatile sig_atomic_t* stop);
+int bridge_receive(const char* addr, int credits, int buffer_size, volatile sig_atomic_t* stop);
+
+#endif // BRIDGE_H
@@ -0,0 +1,43 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+// Clave de memoria compartida (System V SHM)
+#define SHM_BASE_KEY 0x1234
+
+// Colores para output
+#define RED     "\x1b[31m"
+#define GREEN   "\x1b[32m"
+#define YELLOW  "\x1b[33m"
+#define BLUE    "\x1b[34m"
+#define MAGENTA "\x1b[35m"
+#define CYAN    "\x1b[36m"
+#define WHITE   "\x1b[37m"
+#define RESET   "\x1b[0m"
+#define BOLD    "\x1b[1m"
+
+// Semáforos POSIX nombrados (persisten en /dev/shm/sem.*)
+#define SEM_NAME_GLOBAL_MUTEX   "/sem_global_mutex"
+#define SEM_NAME_ENCRYPT_QUEUE  "/sem_encrypt_queue"
+#define SEM_NAME_DECRYPT_QUEUE  "/sem_decrypt_queue"
+#define SEM_NAME_ENCRYPT_SPACES "/sem_encrypt_spaces"
+#define SEM_NAME_DECRYPT_ITEMS  "/sem_decrypt_items"
+
+// Estados de retorno
+#define SUCCESS  0
+#define ERROR   -1
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+
+// Lote y créditos (en caracteres)
+#define DEFAULT_BATCH      256
+#define MAX_BATCH          65536
+#define DEFAULT_CREDITS    4096
+#define MAX_CREDITS        (1 << 20)
+
+// Conexión
+#define CONNECT_TIMEOUT_MS 10000  // El emisor del puente reintenta hasta que el receptor escuche
+#define POLL_INTERVAL_MS   100    // Espera máxima antes de revisar señales y shutdown_flag
+#define LISTEN_BACKLOG     1
+
+#endif // CONSTANTS_H
@@ -0,0 +1,48 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <signal.h>
+#include <semaphore.h>
+#include <sys/types.h>
+#include "structures.h"
+
+/*
+ * Acceso del puente al pipeline local (una instancia):
+ *  - pipeline_open: adjunta la SHM de la instancia, abre los semáforos y
+ *    registra el proceso como receptor (lado que envía) o como emisor
+ *    (lado que recibe). Rechaza los modos que el puente no cubre.
+ *  - pipeline_take: saca el próximo carácter cifrado de la cola de
+ *    desencriptación (el de menor text_index) y libera su slot.
+ *  - pipeline_inject: escribe un carácter cifrado en un slot libre y lo
+ *    publica en la cola de desencriptación, como un emisor.
+ *  - pipeline_close: desregistra, cierra semáforos y desadjunta.
+ *  - pipeline_label: nombre de la instancia para los mensajes.
+ */
+#define PIPELINE_RECEPTOR 0
+#define PIPELINE_EMISOR   1
+
+// Resultado de pipeline_take
+#define TAKE_ITEM  1     // Carácter en *text_index / *byte
+#define TAKE_EMPTY 0     // Sin items por ahora (sólo sin bloquear)
+#define TAKE_END   -1    // Fin de flujo o finalización (ver end_of_stream)
+
+typedef struct {
+    SharedMemory* shm;
+    sem_t* global;
+    sem_t* encrypt_queue;
+    sem_t* decrypt_queue;
+    sem_t* encrypt_spaces;
+    sem_t* decrypt_items;
+    pid_t  pid;
+    int    role;
+    int    end_of_stream;     // pipeline_take recibió el marcador de fin de flujo
+    volatile sig_atomic_t* stop;
+} Pipeline;
+
+int  pipeline_open(Pipeline* p, int role, volatile sig_atomic_t* stop);
+int  pipeline_take(Pipeline* p, int block, int* text_index, unsigned char* byte);
+int  pipeline_inject(Pipeline* p, int text_index, unsigned char byte);
+void pipeline_close(Pipeline* p);
+const char* pipeline_label(void);
+
+#endif // PIPELINE_H
@@ -0,0 +1,79 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include "structures.h"
+
+/*
+ * Protocolo del puente. Cada trama empieza con tipo y cantidad (uint32 en
+ * orden de red):
+ *   HELLO   envía -> recibe   carga: BridgeHello (forma del segmento de origen)
+ *   JOBS    envía -> recibe   cantidad = trabajos; carga: JOB_WIRE_SIZE bytes por trabajo
+ *   DIGESTS envía -> recibe   cantidad = bloques; carga: CRC32C esperado (uint32) de cada bloque
+ *   CREDIT  recibe -> envía   cantidad = caracteres más que se pueden enviar
+ *   DATA    envía -> recibe   cantidad = n; carga: n índices (uint32) y n bytes cifrados
+ *   END     ambos             cantidad = caracteres enviados / inyectados
+ *   REJECT  recibe -> envía   cantidad = largo del motivo (texto) que sigue
+ * El saludo son HELLO, JOBS y DIGESTS seguidos: con ellos el destino crea
+ * su segmento (recibir --buffer) o comprueba que el suyo tiene la misma
+ * entrada. Control de flujo por créditos: el lado que recibe concede al
+ * principio --credits caracteres y devuelve los de cada lote al
+ * inyectarlo, así que hay hasta credits / batch lotes en vuelo sin
+ * esperar confirmaciones.
+ */
+#define BRIDGE_MAGIC   0x49504342u   // "IPCB"
+#define BRIDGE_VERSION 2
+
+#define FRAME_HELLO   1
+#define FRAME_CREDIT  2
+#define FRAME_DATA    3
+#define FRAME_END     4
+#define FRAME_REJECT  5
+#define FRAME_JOBS    6
+#define FRAME_DIGESTS 7
+
+// Trabajo en la trama JOBS: start, length y key (uint32) y el nombre
+#define JOB_WIRE_SIZE (3 * sizeof(uint32_t) + JOB_NAME_MAX)
+
+typedef struct {
+    uint32_t type;
+    uint32_t count;
+} FrameHeader;
+
+// Forma del segmento de origen
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_chars;
+    uint32_t job_count;
+    uint32_t integrity_root;
+    uint32_t key;
+    uint32_t batch;
+    uint32_t chunk_count;
+} BridgeHello;
+
+// Entrada que describe el origen (lo que llega en el saludo)
+typedef struct {
+    BridgeHello hello;
+    Job*        jobs;         // hello.job_count trabajos
+    uint32_t*   chunk_crcs;   // hello.chunk_count CRC32C esperados
+} BridgeInput;
+
+/*
+ *  - input_send: HELLO, JOBS y DIGESTS del segmento de origen.
+ *  - input_recv: recibe y valida el saludo (versión, tabla de trabajos
+ *    contigua y un CRC por bloque). ERROR con el motivo en why si el saludo
+ *    es inválido, o con why vacío si se cortó la conexión.
+ *  - input_mismatch: compara con un segmento ya inicializado; 1 y el
+ *    primer trabajo o bloque distinto en why si no es la misma entrada.
+ */
+int  input_send(int fd, const SharedMemory* shm, uint32_t batch);
+int  input_recv(int fd, BridgeInput* in, char* why, size_t n);
+int  input_mismatch(const SharedMemory* shm, const BridgeInput* in, char* why, size_t n);
+void input_free(BridgeInput* in);
+
+int frame_send(int fd, uint32_t type, uint32_t count, const void* payload, size_t len);
+int frame_send_data(int fd, const uint32_t* net_indices, const unsigned char* bytes, uint32_t n);
+int frame_recv(int fd, FrameHeader* h);
+
+#endif // PROTOCOL_H
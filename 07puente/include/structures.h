@@ -0,0 +1,423 @@
+#ifndef STRUCTURES_H
+#define STRUCTURES_H
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+
+// Máximo de procesos registrados por rol (emisores / receptores)
+#define MAX_WORKERS 100
+
+// Largo máximo del nombre de instancia, con el terminador (ver instance.h)
+#define INSTANCE_NAME_MAX 32
+
+// Índices de los semáforos para contadores de contención por semáforo
+#define SEM_IDX_GLOBAL_MUTEX   0
+#define SEM_IDX_ENCRYPT_QUEUE  1
+#define SEM_IDX_DECRYPT_QUEUE  2
+#define SEM_IDX_ENCRYPT_SPACES 3
+#define SEM_IDX_DECRYPT_ITEMS  4
+#define SEM_COUNT              5
+
+/*
+ * Histograma logarítmico de tiempos (ns):
+ *  - Valores < HIST_SUB_BUCKETS se guardan exactos.
+ *  - Cada potencia de 2 se divide en HIST_SUB_BUCKETS sub-buckets lineales
+ *    (error relativo máximo 1/HIST_SUB_BUCKETS).
+ *  - Valores >= 2^(HIST_MAX_MSB+1) ns (~36 min) caen en el último bucket.
+ */
+#define HIST_SUB_BITS    3
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_MAX_MSB     40
+#define HIST_BUCKETS     ((HIST_MAX_MSB - HIST_SUB_BITS + 2) * HIST_SUB_BUCKETS)
+
+// Fuentes de la base de tiempo compartida (TimeBase.source)
+#define TIME_SOURCE_MONOTONIC 0
+#define TIME_SOURCE_TSC       1
+
+/*
+ * Integridad por bloques (ver crc32c.h):
+ *  - La entrada se divide en bloques de INTEGRITY_CHUNK_SIZE bytes.
+ *  - expected_crc: CRC32C del bloque de entrada (inicializador).
+ *  - written_crc: XOR de las contribuciones crudas de cada byte escrito
+ *    por los receptores (lineal: el orden de escritura no importa).
+ *  - written_bytes: bytes escritos en el bloque (faltantes si < tamaño).
+ * Los receptores actualizan ambos contadores con operaciones atómicas.
+ */
+#define INTEGRITY_CHUNK_SIZE 65536
+
+typedef struct {
+    uint32_t expected_crc;
+    uint32_t written_crc;
+    uint32_t written_bytes;
+    uint32_t reserved;
+} ChunkDigest;
+
+/*
+ * Trabajos: varios archivos de entrada en un mismo sistema. La entrada de
+ * cada trabajo ocupa el tramo [start, start + length) de file_data y del
+ * espacio de text_index, así que emisores y receptores siguen usando un
+ * único contador y un único pool de slots para todos los trabajos:
+ *  - key: clave XOR del trabajo (emisor y receptor la buscan por índice).
+ *  - input_filename: ruta original; el receptor escribe en
+ *    <RECEPTOR_OUT_DIR>/<basename>.txt en la posición text_index - start.
+ *  - chars_written: bytes escritos por los receptores (atómico).
+ * La tabla vive en jobs_offset: job_count entradas ordenadas por start.
+ */
+#define MAX_JOBS     65536
+#define JOB_NAME_MAX 256
+
+typedef struct {
+    int           start;
+    int           length;
+    uint32_t      chars_written;
+    unsigned char key;
+    char          input_filename[JOB_NAME_MAX];
+} Job;
+
+/* Trabajo que contiene text_index (búsqueda binaria), -1 si ninguno */
+static inline int job_find(const Job* jobs, int count, int text_index) {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (text_index < jobs[mid].start) hi = mid - 1;
+        else if (text_index >= jobs[mid].start + jobs[mid].length) lo = mid + 1;
+        else return mid;
+    }
+    return -1;
+}
+
+typedef struct {
+    unsigned char ascii_value;
+    int           slot_index;
+    int           is_valid;
+    int           text_index;
+    pid_t         emisor_pid;
+    uint64_t      emit_ns;      // Instante de emisión (ns desde la época del run)
+} CharacterSlot;
+
+typedef struct {
+    int slot_index;
+    int text_index;
+} SlotRef;
+
+/*
+ * Modo carriles (lane_count > 0): cada emisor es dueño de un carril, un
+ * anillo de un único productor sobre una porción fija del buffer de slots
+ * (slots [first_slot, first_slot + capacity)). El ítem n del carril usa el
+ * slot first_slot + n % capacity:
+ *  - tail: ítems publicados; sólo lo escribe el emisor dueño (release).
+ *  - head: ítems reclamados; los receptores lo avanzan con CAS, empezando
+ *    por su carril propio y robando de los demás.
+ *  - El slot vuelve al emisor cuando el receptor limpia is_valid; el
+ *    emisor duerme en la palabra futex freed mientras su próximo slot
+ *    siga ocupado.
+ * DECRYPT_ITEMS sigue contando ítems de todos los carriles, así que los
+ * receptores se bloquean igual que con la cola compartida.
+ */
+#define MAX_LANES 64
+
+typedef struct {
+    _Alignas(64) uint32_t tail;
+    pid_t    owner;             // Emisor dueño (0 = libre)
+    int      first_slot;
+    int      capacity;
+    _Alignas(64) uint32_t head;
+    _Alignas(64) uint32_t freed;          // Palabra futex: +1 por slot liberado
+    uint32_t producer_waiting;
+} Lane;
+
+typedef struct {
+    int      head;
+    int      tail;
+    int      size;
+    int      capacity;
+    size_t   array_offset;
+    uint32_t seq;           // Seqlock: impar mientras se modifica (ver seq_write_begin)
+} Queue;
+
+/*
+ * Etapas intermedias (inicializador --stages ARCHIVO): entre emisores y
+ * receptores cada slot pasa, en orden, por stage_count etapas. La etapa k
+ * tiene su cola de entrada (anillo de SlotRef de capacidad buffer_size,
+ * que nunca se llena) y dos semáforos propios, SEM_NAME_STAGE_QUEUE y
+ * SEM_NAME_STAGE_ITEMS con el número de etapa (ver instance_sem_n).
+ * Los emisores publican en la cola de la etapa 0; cada proceso etapa
+ * (08etapa) toma un slot, transforma su byte en el lugar y publica la
+ * referencia en la cola siguiente, la de desencriptación después de la
+ * última. El slot nunca se copia.
+ *  - op / param: transformación (STAGE_OP_*) del byte en claro; entre
+ *    etapas el slot sigue cifrado con la clave de su trabajo.
+ *  - enqueued / end_of_stream / eos_relays: como chars_enqueued y el fin
+ *    de flujo de la cola de desencriptación, para la cola de la etapa.
+ *  - passed: caracteres que ya salieron de la etapa.
+ *  - workers: procesos que atendieron la etapa (históricos).
+ *  - digest_offset: STAGE_OP_CHECKSUM acumula un ChunkDigest por bloque
+ *    de lo que entra a la etapa, como los receptores con la salida.
+ */
+#define MAX_STAGES 8
+
+#define STAGE_OP_XOR      1   // Cifrado: XOR con param
+#define STAGE_OP_UPPER    2   // Mayúsculas ASCII
+#define STAGE_OP_LOWER    3   // Minúsculas ASCII
+#define STAGE_OP_FILTER   4   // Bytes no imprimibles -> param (conserva \t \n \r)
+#define STAGE_OP_CHECKSUM 5   // Sin cambios: CRC32C por bloque
+
+typedef struct {
+    Queue         queue;
+    int           op;
+    unsigned char param;
+    uint32_t      enqueued;
+    int           end_of_stream;
+    uint32_t      eos_relays;
+    uint32_t      passed;
+    int           workers;
+    size_t        digest_offset;    // 0 = sin resúmenes
+    uint32_t      digest_root;      // Raíz Merkle esperada (checksum)
+} Stage;
+
+/* Byte en claro después de la transformación op */
+static inline unsigned char stage_apply(int op, unsigned char param, unsigned char b) {
+    switch (op) {
+    case STAGE_OP_XOR:    return (unsigned char)(b ^ param);
+    case STAGE_OP_UPPER:  return (b >= 'a' && b <= 'z') ? (unsigned char)(b - 32) : b;
+    case STAGE_OP_LOWER:  return (b >= 'A' && b <= 'Z') ? (unsigned char)(b + 32) : b;
+    case STAGE_OP_FILTER: return ((b >= 32 && b < 127) || b == '\t' || b == '\n' || b == '\r') ? b : param;
+    default:              return b;
+    }
+}
+
+static inline const char* stage_op_name(int op) {
+    switch (op) {
+    case STAGE_OP_XOR:      return "xor";
+    case STAGE_OP_UPPER:    return "upper";
+    case STAGE_OP_LOWER:    return "lower";
+    case STAGE_OP_FILTER:   return "filter";
+    case STAGE_OP_CHECKSUM: return "checksum";
+    default:                return "?";
+    }
+}
+
+/*
+ * Difusión (inicializador --groups N): cada carácter lo ven N grupos de
+ * receptores independientes (por ejemplo uno que escribe el archivo y
+ * otro que lo reenvía) en vez de un único receptor, sin correr el
+ * pipeline N veces. La cola de desencriptación pasa a ser un anillo
+ * numerado: los emisores encolan como siempre, así que la publicación n
+ * ocupa la posición n % capacity, y los receptores no la reordenan.
+ *  - next: próxima publicación del grupo; cada receptor reclama la suya
+ *    con un fetch_add. Un número >= total_chars_in_file es el fin de
+ *    flujo del grupo.
+ *  - written: caracteres que escribió el grupo.
+ *  - receptors: receptores que se unieron al grupo (históricos).
+ *  - digest_offset: resúmenes de integridad propios del grupo (el grupo 0
+ *    usa los de integrity_offset).
+ * Cada grupo tiene su semáforo de items (SEM_NAME_GROUP_ITEMS con el
+ * número de grupo) y los emisores depositan un token en cada uno. Quien
+ * termina la publicación n marca el bit de su grupo en bcast_done; el
+ * slot vuelve a la cola de encriptación recién cuando la terminaron todos
+ * los grupos, en orden de publicación: bcast_reclaimed sigue al grupo
+ * más lento y el anillo nunca tiene más de buffer_size publicaciones vivas.
+ */
+#define MAX_GROUPS 8
+
+typedef struct {
+    _Alignas(64) uint32_t next;
+    uint32_t written;
+    int      receptors;
+    size_t   digest_offset;
+} ReceptorGroup;
+
+/*
+ * Seqlock de un único escritor a la vez (el escritor ya está serializado
+ * por el semáforo de la cola o es el único dueño del bloque). Permite a
+ * los monitores copiar colas y estadísticas sin tomar semáforos: si seq
+ * era impar o cambió durante la copia, la copia se descarta y se repite.
+ * En x86 ambas funciones se reducen a barreras del compilador.
+ */
+static inline void seq_write_begin(uint32_t* seq) {
+    __atomic_store_n(seq, __atomic_load_n(seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void seq_write_end(uint32_t* seq) {
+    __atomic_store_n(seq, __atomic_load_n(seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Base de tiempo del run, fijada por el inicializador al crear el segmento.
+ * Todos los campos *_ns de la SHM son nanosegundos desde mono_epoch_ns;
+ * sumando wall_epoch_ns se obtiene la hora de pared (CLOCK_REALTIME).
+ */
+typedef struct {
+    int      source;          // TIME_SOURCE_TSC o TIME_SOURCE_MONOTONIC
+    uint64_t mono_epoch_ns;   // CLOCK_MONOTONIC en el instante de referencia
+    int64_t  wall_epoch_ns;   // CLOCK_REALTIME en el mismo instante
+    uint64_t tsc_epoch;       // Lectura del TSC en el mismo instante
+    double   ns_per_tick;     // Calibración del TSC (0 si no se usa)
+} TimeBase;
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t buckets[HIST_BUCKETS];
+} LatencyHistogram;
+
+/*
+ * Bloque de estadísticas propio de cada emisor/receptor.
+ *  - Alineado a línea de caché: cada proceso escribe sólo su bloque.
+ *  - Un único escritor por bloque; los lectores (finalizador) leen sin
+ *    semáforos porque cada contador es una palabra de 64 bits alineada.
+ *  - seq permite al monitor copiar el bloque completo de forma consistente.
+ */
+typedef struct {
+    _Alignas(64) pid_t pid;
+    int      in_use;
+    uint32_t seq;               // Seqlock del bloque (lecturas consistentes del monitor)
+    int32_t  blocked_on;        // SEM_IDX_* en el que está bloqueado, -1 si no
+    uint64_t blocked_since_ns;  // Inicio del bloqueo actual
+    int32_t  inflight_text_index; // Índice de texto en manos del proceso, -1 si ninguno
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t first_ns;          // Primer carácter terminado (0 = ninguno todavía)
+
+    uint64_t chars;
+    uint64_t batches;
+    uint64_t sem_waits[SEM_COUNT];
+    uint64_t sem_blocked_ns[SEM_COUNT];
+
+    LatencyHistogram service;
+} WorkerStats;
+
+/*
+ * Latencias de extremo a extremo medidas por un receptor (mismo índice
+ * que su bloque en receptor_stats). Todas en ns de la base de tiempo:
+ *  - e2e:        emisión (store_character) -> escritura en el archivo
+ *  - queue:      emisión -> extracción de la cola de desencriptación
+ *  - processing: extracción -> escritura en el archivo
+ */
+typedef struct {
+    LatencyHistogram e2e;
+    LatencyHistogram queue;
+    LatencyHistogram processing;
+} ReceptorLatency;
+
+typedef struct {
+    int            shm_id;
+    char           instance[INSTANCE_NAME_MAX];  // Instancia dueña del segmento ("" = por omisión)
+    TimeBase       timebase;
+    int            buffer_size;
+    unsigned char  encryption_key;  // Clave del primer trabajo
+
+    int current_txt_index;
+    int total_chars_in_file;
+    int total_chars_processed;
+
+    int  total_emisores;
+    int  active_emisores;
+    int  total_receptores;
+    int  active_receptores;
+    uint32_t workers_exit_seq;  // Palabra futex: +1 en cada desregistro (FUTEX_WAKE)
+
+    int  shutdown_flag;
+    uint32_t shutdown_relays;   // Tokens de finalización reenviados por trabajadores (despertar en cadena)
+
+    // Fin de flujo (poison pill): el emisor que encola el último carácter
+    // activa end_of_stream y deposita un marcador en DECRYPT_ITEMS
+    uint32_t chars_enqueued;    // Caracteres publicados en la cola de desencriptación
+    int      end_of_stream;
+    uint32_t eos_relays;        // Marcadores reenviados por receptores (uno por receptor que sale)
+
+    char  input_filename[256];  // Primer trabajo (ver Job)
+    int   file_data_size;
+    int      integrity_chunks;  // Cantidad de ChunkDigest en integrity_offset
+    uint32_t integrity_root;    // Raíz Merkle de los CRC32C esperados
+    int      job_count;         // Entradas de la tabla de trabajos (>= 1)
+
+    // Modo demonio (inicializador --daemon): el segmento se reutiliza para
+    // varios lotes de entrada sin recrear SHM, semáforos ni colas
+    pid_t    daemon_pid;        // Inicializador que publica los lotes (0 = corrida única)
+    uint32_t batch_seq;         // Palabra futex: 2·lote, impar mientras se reemplaza la entrada
+    uint32_t batch_done;        // Último lote completo (palabra futex del demonio)
+    uint32_t batch_written;     // Caracteres escritos del lote en curso
+    int      file_capacity;     // Bytes reservados para file_data (>= file_data_size)
+    int      job_capacity;      // Entradas reservadas en la tabla de trabajos
+
+    // Fuente en streaming (inicializador --stream): file_data es un anillo
+    // de file_capacity bytes (el índice i vive en i % file_capacity) y
+    // total_chars_in_file crece a medida que llega la entrada
+    int      stream;            // 1 = entrada en streaming
+    int      stream_eof;        // La fuente terminó: total_chars_in_file es definitivo
+    pid_t    stream_feeder_pid; // Inicializador que alimenta el anillo
+    uint32_t stream_seq;        // Palabra futex: +1 por cada publicación del alimentador
+    uint32_t stream_waiters;    // Emisores dormidos en stream_seq
+    int      stream_feeder_waiting; // El alimentador duerme en current_txt_index (anillo lleno)
+    int      stream_wake_at;    // current_txt_index que le deja el espacio que espera
+
+    // Salida ordenada (inicializador --sink): los receptores dejan cada byte
+    // en una ventana de reordenamiento y el receptor dueño del destino
+    // (receptor --sink DESTINO) envía el prefijo contiguo en orden de text_index
+    int      sink_window;       // Bytes de la ventana (0 = salida a archivos)
+    pid_t    sink_pid;          // Receptor dueño del destino (0 = ninguno)
+    int      sink_committed;    // Prefijo ya enviado (palabra futex de los emisores)
+    uint32_t sink_waiters;      // Emisores esperando lugar en la ventana
+    uint32_t sink_seq;          // Palabra futex del volcador
+    int      sink_flusher_waiting; // El volcador duerme en sink_seq
+    int      sink_wake_at;      // Índice cuyo byte despierta al volcador
+    uint64_t sink_writes;       // Llamadas writev al destino
+    uint32_t sink_dropped;      // Bytes descartados porque el destino se cerró
+
+    pid_t emisor_pids[MAX_WORKERS];
+    pid_t receptor_pids[MAX_WORKERS];
+
+    // Bloques de estadísticas por proceso (uno por emisor/receptor histórico)
+    WorkerStats emisor_stats[MAX_WORKERS];
+    WorkerStats receptor_stats[MAX_WORKERS];
+    ReceptorLatency receptor_latency[MAX_WORKERS];
+    int emisor_stats_count;
+    int receptor_stats_count;
+
+    int sem_global_mutex;
+    int sem_encrypt_queue;
+    int sem_decrypt_queue;
+    int sem_encrypt_spaces;
+    int sem_decrypt_items;
+
+    Queue encrypt_queue;
+    Queue decrypt_queue;
+
+    int  lane_count;            // 0 = colas compartidas (modo clásico)
+    Lane lanes[MAX_LANES];
+
+    // Etapas intermedias (ver Stage): la última publica en decrypt_queue
+    int   stage_count;          // 0 = emisores -> receptores sin etapas
+    Stage stages[MAX_STAGES];
+    pid_t stage_pids[MAX_WORKERS];
+    int   total_etapas;
+    int   active_etapas;
+
+    // Difusión (ver ReceptorGroup): 0 = cada carácter lo consume un receptor
+    int           group_count;
+    ReceptorGroup groups[MAX_GROUPS];
+    uint32_t      bcast_reclaimed;   // Publicaciones cuyos slots ya se devolvieron
+    size_t        bcast_done_offset; // uint32_t por posición del anillo: grupos que la terminaron
+
+    size_t buffer_offset;
+    size_t file_data_offset;
+    size_t integrity_offset;
+    size_t jobs_offset;
+    size_t sink_offset;         // [datos: sink_window bytes][listos: sink_window bytes]
+
+} SharedMemory;
+
+/*
+ * Lote de entrada en curso (1 = el que cargó el inicializador). Mientras
+ * el demonio reemplaza la entrada batch_seq es impar y ya cuenta el lote
+ * nuevo: todo carácter publicado después pertenece a él.
+ */
+static inline uint32_t batch_current(const SharedMemory* shm) {
+    return (__atomic_load_n(&shm->batch_seq, __ATOMIC_ACQUIRE) + 1) / 2;
+}
+
+#endif // STRUCTURES_H
\ No newline at end of file
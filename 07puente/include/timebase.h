@@ -0,0 +1,25 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "structures.h"
+
+/*
+ * Reloj de alta resolución y bajo costo compartido por los cuatro programas:
+ *  - timebase_calibrate: (inicializador) elige TSC o CLOCK_MONOTONIC y fija la época.
+ *  - timebase_attach: adopta la base de tiempo guardada en la SHM.
+ *  - timebase_now_ns: ns desde la época del run.
+ *  - timebase_to_wall_s: convierte un timestamp del run a segundos UNIX.
+ *  - timebase_format_hms: "HH:MM:SS" local sin llamar a localtime().
+ *  - timebase_source_name: nombre legible de la fuente elegida.
+ */
+void        timebase_calibrate(TimeBase* tb);
+void        timebase_attach(const TimeBase* tb);
+uint64_t    timebase_now_ns(void);
+time_t      timebase_to_wall_s(uint64_t run_ns);
+void        timebase_format_hms(uint64_t run_ns, char* buf, size_t n);
+const char* timebase_source_name(const TimeBase* tb);
+
+#endif // TIMEBASE_H
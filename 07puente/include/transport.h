@@ -0,0 +1,28 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+/*
+ * Conexión entre los dos extremos del puente. Direcciones:
+ *   HOST:PUERTO o tcp:HOST:PUERTO  TCP (HOST vacío = todas las interfaces al escuchar)
+ *   unix:RUTA                      socket Unix de flujo
+ *  - transport_set_stop: bandera que corta las esperas (SIGINT/SIGTERM/SIGUSR1).
+ *  - transport_listen / transport_accept: lado que recibe (una conexión).
+ *  - transport_connect: lado que envía; reintenta hasta CONNECT_TIMEOUT_MS.
+ *  - transport_write: envía todo el vector (writev).
+ *  - transport_read: lee exactamente len bytes (ERROR si el otro extremo cerró).
+ *  - transport_wait: 1 si hay datos para leer, 0 si venció el plazo.
+ * Las esperas usan poll con POLL_INTERVAL_MS para ver la bandera de stop.
+ */
+void transport_set_stop(volatile sig_atomic_t* stop);
+int  transport_listen(const char* addr);
+int  transport_accept(int listen_fd);
+int  transport_connect(const char* addr);
+int  transport_write(int fd, struct iovec* iov, int iovcnt);
+int  transport_read(int fd, void* buf, size_t len);
+int  transport_wait(int fd, int timeout_ms);
+
+#endif // TRANSPORT_H
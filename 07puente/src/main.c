@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+#include "constants.h"
+#include "bridge.h"
+#include "transport.h"
+#include "instance.h"
+
+/**
+ * Puente entre dos Pipelines
+ *
+ * Une dos instancias (en el mismo host o en dos hosts) a través de un
+ * socket TCP o Unix. Los caracteres viajan todavía cifrados: lo que un
+ * receptor del origen sacaría de su cola de desencriptación aparece en la
+ * cola de desencriptación del destino, donde lo toman sus receptores.
+ *
+ * Modos:
+ *  - enviar: receptor de la instancia de origen; conecta y reenvía en lotes.
+ *  - recibir: emisor de la instancia de destino; escucha e inyecta. Con
+ *    --buffer crea el segmento de destino con la entrada del origen.
+ */
+
+static volatile sig_atomic_t should_terminate = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    should_terminate = 1;
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s recibir DIRECCION [--credits N] [--buffer N]\n", argv0);
+    fprintf(stderr, "  %s enviar DIRECCION [--batch N]\n", argv0);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  DIRECCION        HOST:PUERTO, tcp:HOST:PUERTO o unix:RUTA\n");
+    fprintf(stderr, "  --credits N      Caracteres en vuelo que concede el destino (1..%d, por omisión %d)\n",
+            MAX_CREDITS, DEFAULT_CREDITS);
+    fprintf(stderr, "  --buffer N       Crea la instancia de destino con N slots y la entrada del origen\n");
+    fprintf(stderr, "                   (sin --buffer, la instancia ya inicializada con los mismos archivos)\n");
+    fprintf(stderr, "  --batch N        Caracteres por lote (1..%d, por omisión %d)\n",
+            MAX_BATCH, DEFAULT_BATCH);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --instance NOMBRE (o IPC_INSTANCE) elige la instancia local: la de origen\n");
+    fprintf(stderr, "  para enviar, la de destino para recibir\n");
+}
+
+/**
+ * @brief Parsea un entero dentro de un rango
+ *
+ * @return 1 si es válido, 0 si no
+ */
+static int parse_int_range(const char* s, int lo, int hi, int* out) {
+    char* end = NULL;
+    long v = strtol(s, &end, 10);
+    if (!s[0] || *end != '\0' || v < lo || v > hi) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int sending = strcmp(argv[1], "enviar") == 0;
+    if (!sending && strcmp(argv[1], "recibir") != 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char* addr = argv[2];
+
+    int batch = DEFAULT_BATCH;
+    int credits = DEFAULT_CREDITS;
+    int buffer_size = 0;
+    for (int i = 3; i < argc; i++) {
+        if (sending && strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            if (!parse_int_range(argv[++i], 1, MAX_BATCH, &batch)) {
+                fprintf(stderr, RED "[ERROR] Tamaño de lote inválido: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (!sending && strcmp(argv[i], "--credits") == 0 && i + 1 < argc) {
+            if (!parse_int_range(argv[++i], 1, MAX_CREDITS, &credits)) {
+                fprintf(stderr, RED "[ERROR] Créditos inválidos: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (!sending && strcmp(argv[i], "--buffer") == 0 && i + 1 < argc) {
+            if (!parse_int_range(argv[++i], 1, INT_MAX, &buffer_size)) {
+                fprintf(stderr, RED "[ERROR] Tamaño de buffer inválido: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Sin SA_RESTART: las esperas en semáforos y sockets vuelven con EINTR
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);  // Un extremo caído se ve como EPIPE en writev
+    transport_set_stop(&should_terminate);
+
+    int rc = sending ? bridge_send(addr, batch, &should_terminate)
+                     : bridge_receive(addr, credits, buffer_size, &should_terminate);
+    return rc == SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
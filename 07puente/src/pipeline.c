@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "pipeline.h"
+#include "constants.h"
+#include "instance.h"
+#include "timebase.h"
+
+/**
+ * Módulo de Acceso al Pipeline (puente)
+ *
+ * El puente no agrega ningún mecanismo a la SHM: del lado que envía se
+ * comporta como un receptor (DECRYPT_ITEMS, extracción ordenada, slot de
+ * vuelta a la cola de encriptación) y del lado que recibe como un emisor
+ * (ENCRYPT_SPACES, slot libre, cola de desencriptación, marcador de fin de
+ * flujo con el último carácter). Las operaciones de cola son las mismas
+ * que las de 02emisor y 03receptor, con los mismos semáforos tomados.
+ */
+
+static SlotRef* enc_array(SharedMemory* shm) {
+    return (SlotRef*)((char*)shm + shm->encrypt_queue.array_offset);
+}
+
+static SlotRef* dec_array(SharedMemory* shm) {
+    return (SlotRef*)((char*)shm + shm->decrypt_queue.array_offset);
+}
+
+static CharacterSlot* slots(SharedMemory* shm) {
+    return (CharacterSlot*)((char*)shm + shm->buffer_offset);
+}
+
+static int stop_requested(Pipeline* p) {
+    return *p->stop || __atomic_load_n(&p->shm->shutdown_flag, __ATOMIC_ACQUIRE);
+}
+
+/* ========================= Colas (semáforo tomado) ========================= */
+
+/* Menor text_index de la cola de desencriptación (ver 03receptor) */
+static int dequeue_decrypt_ordered(SharedMemory* shm, int* text_index) {
+    Queue* q = &shm->decrypt_queue;
+    if (q->size == 0) return -1;
+
+    SlotRef* arr = dec_array(shm);
+    int best_pos = -1;
+    int best_text = INT_MAX;
+    for (int i = 0, pos = q->head; i < q->size; i++, pos = (pos + 1) % q->capacity) {
+        if (arr[pos].text_index < best_text) {
+            best_text = arr[pos].text_index;
+            best_pos = pos;
+        }
+    }
+    if (best_pos == -1) return -1;
+
+    seq_write_begin(&q->seq);
+    while (q->head != best_pos) {
+        SlotRef tmp = arr[q->head];
+        q->head = (q->head + 1) % q->capacity;
+        arr[q->tail] = tmp;
+        q->tail = (q->tail + 1) % q->capacity;
+    }
+    int slot = arr[q->head].slot_index;
+    *text_index = arr[q->head].text_index;
+    q->head = (q->head + 1) % q->capacity;
+    q->size--;
+    seq_write_end(&q->seq);
+    return slot;
+}
+
+static int dequeue_encrypt(SharedMemory* shm) {
+    Queue* q = &shm->encrypt_queue;
+    if (q->size == 0) return -1;
+    int slot = enc_array(shm)[q->head].slot_index;
+    seq_write_begin(&q->seq);
+    q->head = (q->head + 1) % q->capacity;
+    q->size--;
+    seq_write_end(&q->seq);
+    return slot;
+}
+
+static void enqueue(Queue* q, SlotRef* arr, int slot_index, int text_index) {
+    if (q->size >= q->capacity) return;  // No debería pasar: los semáforos cuentan slots
+    seq_write_begin(&q->seq);
+    arr[q->tail].slot_index = slot_index;
+    arr[q->tail].text_index = text_index;
+    q->tail = (q->tail + 1) % q->capacity;
+    q->size++;
+    seq_write_end(&q->seq);
+}
+
+/* ============================ Registro ============================ */
+
+static int register_self(Pipeline* p) {
+    SharedMemory* shm = p->shm;
+    pid_t* pids = p->role == PIPELINE_EMISOR ? shm->emisor_pids : shm->receptor_pids;
+    int ok = 0;
+    sem_wait(p->global);
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (pids[i] == 0) {
+            pids[i] = p->pid;
+            ok = 1;
+            break;
+        }
+    }
+    if (ok && p->role == PIPELINE_EMISOR) {
+        shm->active_emisores++;
+        shm->total_emisores++;
+    } else if (ok) {
+        shm->active_receptores++;
+        shm->total_receptores++;
+    }
+    sem_post(p->global);
+    return ok ? SUCCESS : ERROR;
+}
+
+static void unregister_self(Pipeline* p) {
+    SharedMemory* shm = p->shm;
+    pid_t* pids = p->role == PIPELINE_EMISOR ? shm->emisor_pids : shm->receptor_pids;
+    sem_wait(p->global);
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (pids[i] == p->pid) {
+            pids[i] = 0;
+            if (p->role == PIPELINE_EMISOR) shm->active_emisores--;
+            else shm->active_receptores--;
+            // El finalizador espera las salidas en esta palabra futex
+            __atomic_add_fetch(&shm->workers_exit_seq, 1, __ATOMIC_RELEASE);
+            syscall(SYS_futex, &shm->workers_exit_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+            break;
+        }
+    }
+    sem_post(p->global);
+}
+
+/* Modos cuyo avance no pasa por las colas compartidas o no tiene un total fijo */
+static const char* unsupported_mode(const SharedMemory* shm, int role) {
+    if (shm->lane_count > 0) return "carriles (--lanes)";
+    // Del lado de destino lo inyectado saltearía las etapas: sólo se admiten en el origen
+    if (shm->stage_count > 0 && role == PIPELINE_EMISOR) return "etapas intermedias (--stages) en el destino";
+    if (shm->daemon_pid)     return "demonio (--daemon)";
+    if (shm->stream)         return "streaming (--stream)";
+    if (shm->sink_window)    return "salida ordenada (--sink)";
+    if (shm->group_count)    return "difusión (--groups)";
+    return NULL;
+}
+
+/**
+ * @brief Se conecta a la instancia actual como receptor o emisor
+ *
+ * @param p Estado del pipeline (salida)
+ * @param role PIPELINE_RECEPTOR (envía) o PIPELINE_EMISOR (recibe)
+ * @param stop Bandera de terminación del proceso
+ * @return SUCCESS o ERROR
+ */
+int pipeline_open(Pipeline* p, int role, volatile sig_atomic_t* stop) {
+    memset(p, 0, sizeof(*p));
+    p->role = role;
+    p->stop = stop;
+    p->pid = getpid();
+
+    int shmid = shmget(instance_shm_key(), 0, 0);
+    if (shmid == -1) {
+        fprintf(stderr, RED "[ERROR] No se encontró la memoria compartida de la instancia '%s': %s\n" RESET,
+                instance_name(), strerror(errno));
+        return ERROR;
+    }
+    p->shm = shmat(shmid, NULL, 0);
+    if (p->shm == (void*)-1) {
+        fprintf(stderr, RED "[ERROR] shmat falló: %s\n" RESET, strerror(errno));
+        p->shm = NULL;
+        return ERROR;
+    }
+    if (instance_check(p->shm) != SUCCESS) goto fail;
+    const char* mode = unsupported_mode(p->shm, role);
+    if (mode) {
+        fprintf(stderr, RED "[ERROR] El puente no admite el modo %s\n" RESET, mode);
+        goto fail;
+    }
+    timebase_attach(&p->shm->timebase);
+
+    p->global         = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    p->encrypt_queue  = sem_open(instance_sem(SEM_NAME_ENCRYPT_QUEUE), 0);
+    p->decrypt_queue  = sem_open(instance_sem(SEM_NAME_DECRYPT_QUEUE), 0);
+    p->encrypt_spaces = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    p->decrypt_items  = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+    if (p->global == SEM_FAILED || p->encrypt_queue == SEM_FAILED || p->decrypt_queue == SEM_FAILED ||
+        p->encrypt_spaces == SEM_FAILED || p->decrypt_items == SEM_FAILED) {
+        fprintf(stderr, RED "[ERROR] No se pudieron abrir los semáforos: %s\n" RESET, strerror(errno));
+        goto fail;
+    }
+    if (register_self(p) != SUCCESS) {
+        fprintf(stderr, RED "[ERROR] No hay lugar para registrar otro %s\n" RESET,
+                role == PIPELINE_EMISOR ? "emisor" : "receptor");
+        goto fail;
+    }
+    return SUCCESS;
+
+fail:
+    if (p->global         && p->global         != SEM_FAILED) sem_close(p->global);
+    if (p->encrypt_queue  && p->encrypt_queue  != SEM_FAILED) sem_close(p->encrypt_queue);
+    if (p->decrypt_queue  && p->decrypt_queue  != SEM_FAILED) sem_close(p->decrypt_queue);
+    if (p->encrypt_spaces && p->encrypt_spaces != SEM_FAILED) sem_close(p->encrypt_spaces);
+    if (p->decrypt_items  && p->decrypt_items  != SEM_FAILED) sem_close(p->decrypt_items);
+    shmdt(p->shm);
+    p->shm = NULL;
+    return ERROR;
+}
+
+/**
+ * @brief Saca el próximo carácter cifrado, como un receptor
+ *
+ * El slot vuelve a los emisores en cuanto se copió su carácter: desde ese
+ * momento el carácter sólo existe en el lote del puente.
+ *
+ * @param p Pipeline abierto como PIPELINE_RECEPTOR
+ * @param block 0 = no esperar si DECRYPT_ITEMS está en cero
+ * @param text_index Índice del carácter (salida)
+ * @param byte Carácter cifrado (salida)
+ * @return TAKE_ITEM, TAKE_EMPTY o TAKE_END
+ */
+int pipeline_take(Pipeline* p, int block, int* text_index, unsigned char* byte) {
+    SharedMemory* shm = p->shm;
+    for (;;) {
+        int rc = block ? sem_wait(p->decrypt_items) : sem_trywait(p->decrypt_items);
+        if (rc != 0) {
+            if (errno == EAGAIN) return TAKE_EMPTY;
+            if (errno == EINTR && !stop_requested(p)) continue;
+            return TAKE_END;
+        }
+        // Token de finalización: se reenvía al siguiente bloqueado
+        if (__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) {
+            __atomic_add_fetch(&shm->shutdown_relays, 1, __ATOMIC_RELAXED);
+            sem_post(p->decrypt_items);
+            return TAKE_END;
+        }
+
+        sem_wait(p->decrypt_queue);
+        int slot = dequeue_decrypt_ordered(shm, text_index);
+        sem_post(p->decrypt_queue);
+        if (slot < 0) {
+            // Cola vacía con un token en la mano: marcador de fin de flujo
+            if (__atomic_load_n(&shm->end_of_stream, __ATOMIC_ACQUIRE)) {
+                __atomic_add_fetch(&shm->eos_relays, 1, __ATOMIC_RELAXED);
+                sem_post(p->decrypt_items);
+                p->end_of_stream = 1;
+                return TAKE_END;
+            }
+            continue;
+        }
+
+        CharacterSlot* s = &slots(shm)[slot];
+        *byte = s->ascii_value;
+        s->is_valid = 0;
+        s->ascii_value = 0;
+        sem_wait(p->encrypt_queue);
+        enqueue(&shm->encrypt_queue, enc_array(shm), slot, -1);
+        sem_post(p->encrypt_queue);
+        sem_post(p->encrypt_spaces);
+        return TAKE_ITEM;
+    }
+}
+
+/**
+ * @brief Publica un carácter cifrado, como un emisor
+ *
+ * current_txt_index avanza hasta el mayor índice inyectado: el monitor y
+ * el finalizador ven el progreso igual que con emisores locales. El que
+ * completa total_chars_in_file deposita el marcador de fin de flujo.
+ *
+ * @param p Pipeline abierto como PIPELINE_EMISOR
+ * @param text_index Índice del carácter en la entrada
+ * @param byte Carácter cifrado
+ * @return SUCCESS, o ERROR si hay que terminar
+ */
+int pipeline_inject(Pipeline* p, int text_index, unsigned char byte) {
+    SharedMemory* shm = p->shm;
+    int slot = -1;
+    while (slot < 0) {
+        if (sem_wait(p->encrypt_spaces) != 0) {
+            if (errno == EINTR && !stop_requested(p)) continue;
+            return ERROR;
+        }
+        if (__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) {
+            __atomic_add_fetch(&shm->shutdown_relays, 1, __ATOMIC_RELAXED);
+            sem_post(p->encrypt_spaces);
+            return ERROR;
+        }
+        sem_wait(p->encrypt_queue);
+        slot = dequeue_encrypt(shm);
+        sem_post(p->encrypt_queue);
+        if (slot < 0) sem_post(p->encrypt_spaces);
+    }
+
+    CharacterSlot* s = &slots(shm)[slot];
+    s->ascii_value = byte;
+    s->slot_index = slot + 1;
+    s->is_valid = 1;
+    s->text_index = text_index;
+    s->emisor_pid = p->pid;
+    s->emit_ns = timebase_now_ns();
+
+    int seen = __atomic_load_n(&shm->current_txt_index, __ATOMIC_RELAXED);
+    while (seen <= text_index &&
+           !__atomic_compare_exchange_n(&shm->current_txt_index, &seen, text_index + 1, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    __atomic_add_fetch(&shm->total_chars_processed, 1, __ATOMIC_RELAXED);
+
+    sem_wait(p->decrypt_queue);
+    enqueue(&shm->decrypt_queue, dec_array(shm), slot, text_index);
+    sem_post(p->decrypt_queue);
+    sem_post(p->decrypt_items);
+
+    uint32_t done = __atomic_add_fetch(&shm->chars_enqueued, 1, __ATOMIC_SEQ_CST);
+    if (done == (uint32_t)shm->total_chars_in_file) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&shm->end_of_stream, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            sem_post(p->decrypt_items);
+        }
+    }
+    return SUCCESS;
+}
+
+void pipeline_close(Pipeline* p) {
+    if (!p->shm) return;
+    unregister_self(p);
+    sem_close(p->global);
+    sem_close(p->encrypt_queue);
+    sem_close(p->decrypt_queue);
+    sem_close(p->encrypt_spaces);
+    sem_close(p->decrypt_items);
+    shmdt(p->shm);
+    p->shm = NULL;
+}
+
+const char* pipeline_label(void) {
+    return instance_name()[0] ? instance_name() : "por omisión";
+}
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <arpa/inet.h>
+#include "protocol.h"
+#include "transport.h"
+#include "constants.h"
+
+/**
+ * Módulo de Protocolo (puente)
+ *
+ * Tramas de longitud conocida por la cabecera. Una trama DATA sale con un
+ * único writev (cabecera, índices y bytes): los índices ya vienen en orden
+ * de red desde el lote del emisor del puente. El saludo lleva la tabla de
+ * trabajos y los CRC32C por bloque del origen, con los que el destino
+ * crea su segmento o comprueba el que ya tiene.
+ */
+
+static const Job* segment_jobs(const SharedMemory* shm) {
+    return (const Job*)((const char*)shm + shm->jobs_offset);
+}
+
+static const ChunkDigest* segment_digests(const SharedMemory* shm) {
+    return (const ChunkDigest*)((const char*)shm + shm->integrity_offset);
+}
+
+static void put_u32(unsigned char* p, uint32_t v) {
+    v = htonl(v);
+    memcpy(p, &v, sizeof(v));
+}
+
+static uint32_t get_u32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return ntohl(v);
+}
+
+/**
+ * @brief Envía el saludo: forma del segmento, tabla de trabajos y CRC32C por bloque
+ *
+ * Los CRC son los esperados de la salida (con etapas intermedias, los de
+ * la entrada transformada), que es lo que verifica el finalizador del destino.
+ *
+ * @param fd Conexión con el destino
+ * @param shm Segmento de origen
+ * @param batch Caracteres por lote pedidos
+ * @return SUCCESS o ERROR
+ */
+int input_send(int fd, const SharedMemory* shm, uint32_t batch) {
+    uint32_t job_count = (uint32_t)shm->job_count;
+    uint32_t chunk_count = (uint32_t)shm->integrity_chunks;
+    uint32_t hello[8] = {
+        htonl(BRIDGE_MAGIC), htonl(BRIDGE_VERSION), htonl((uint32_t)shm->total_chars_in_file), htonl(job_count),
+        htonl(shm->integrity_root), htonl(shm->encryption_key), htonl(batch), htonl(chunk_count),
+    };
+    unsigned char* jobs = calloc(job_count, JOB_WIRE_SIZE);
+    uint32_t* crcs = malloc(MAX(chunk_count, 1u) * sizeof(uint32_t));
+    if (!jobs || !crcs) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para el saludo\n" RESET);
+        free(jobs);
+        free(crcs);
+        return ERROR;
+    }
+
+    const Job* table = segment_jobs(shm);
+    for (uint32_t j = 0; j < job_count; j++) {
+        unsigned char* w = jobs + (size_t)j * JOB_WIRE_SIZE;
+        put_u32(w, (uint32_t)table[j].start);
+        put_u32(w + 4, (uint32_t)table[j].length);
+        put_u32(w + 8, table[j].key);
+        memcpy(w + 12, table[j].input_filename, JOB_NAME_MAX - 1);
+    }
+    const ChunkDigest* digests = segment_digests(shm);
+    for (uint32_t c = 0; c < chunk_count; c++) crcs[c] = htonl(digests[c].expected_crc);
+
+    int rc = frame_send(fd, FRAME_HELLO, sizeof(hello), hello, sizeof(hello)) == SUCCESS &&
+             frame_send(fd, FRAME_JOBS, job_count, jobs, (size_t)job_count * JOB_WIRE_SIZE) == SUCCESS &&
+             frame_send(fd, FRAME_DIGESTS, chunk_count, crcs, (size_t)chunk_count * sizeof(uint32_t)) == SUCCESS
+           ? SUCCESS : ERROR;
+    free(jobs);
+    free(crcs);
+    return rc;
+}
+
+/* Tabla de trabajos recibida: contigua desde 0 y con el total del saludo */
+static int decode_jobs(const unsigned char* wire, BridgeInput* in, char* why, size_t n) {
+    uint32_t total = in->hello.total_chars;
+    uint32_t next = 0;
+    for (uint32_t j = 0; j < in->hello.job_count; j++) {
+        const unsigned char* w = wire + (size_t)j * JOB_WIRE_SIZE;
+        Job* job = &in->jobs[j];
+        uint32_t start = get_u32(w), length = get_u32(w + 4), key = get_u32(w + 8);
+        if (start != next || length > total - start || key > 0xFF) {
+            snprintf(why, n, "tabla de trabajos inválida en el trabajo %u (desde %u, %u bytes, de %u)",
+                     j + 1, start, length, total);
+            return ERROR;
+        }
+        job->start = (int)start;
+        job->length = (int)length;
+        job->key = (unsigned char)key;
+        memcpy(job->input_filename, w + 12, JOB_NAME_MAX - 1);
+        job->input_filename[JOB_NAME_MAX - 1] = '\0';
+        next = start + length;
+    }
+    if (next != total) {
+        snprintf(why, n, "la tabla de trabajos cubre %u de %u caracteres", next, total);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Recibe y valida el saludo del origen
+ *
+ * @param fd Conexión con el origen
+ * @param in Entrada descrita (salida; liberar con input_free)
+ * @param why Motivo si el saludo es inválido (vacío si se cortó la conexión)
+ * @param n Tamaño de why
+ * @return SUCCESS o ERROR
+ */
+int input_recv(int fd, BridgeInput* in, char* why, size_t n) {
+    memset(in, 0, sizeof(*in));
+    why[0] = '\0';
+
+    FrameHeader h;
+    uint32_t wire[8];
+    if (frame_recv(fd, &h) != SUCCESS) return ERROR;
+    if (h.type != FRAME_HELLO || h.count != sizeof(wire)) {
+        snprintf(why, n, "protocolo desconocido (trama %u de %u bytes; este puente habla la versión %d)",
+                 h.type, h.count, BRIDGE_VERSION);
+        return ERROR;
+    }
+    if (transport_read(fd, wire, sizeof(wire)) != SUCCESS) return ERROR;
+    BridgeHello* hello = &in->hello;
+    hello->magic = ntohl(wire[0]);
+    hello->version = ntohl(wire[1]);
+    hello->total_chars = ntohl(wire[2]);
+    hello->job_count = ntohl(wire[3]);
+    hello->integrity_root = ntohl(wire[4]);
+    hello->key = ntohl(wire[5]);
+    hello->batch = ntohl(wire[6]);
+    hello->chunk_count = ntohl(wire[7]);
+    uint64_t chunks = ((uint64_t)hello->total_chars + INTEGRITY_CHUNK_SIZE - 1) / INTEGRITY_CHUNK_SIZE;
+    if (hello->magic != BRIDGE_MAGIC || hello->version != BRIDGE_VERSION) {
+        snprintf(why, n, "protocolo desconocido (versión %u; este puente habla la %d)", hello->version, BRIDGE_VERSION);
+        return ERROR;
+    }
+    if (hello->total_chars == 0 || hello->total_chars > INT_MAX || hello->job_count == 0 ||
+        hello->job_count > MAX_JOBS || hello->chunk_count != chunks) {
+        snprintf(why, n, "saludo inválido (%u caracteres, %u trabajos, %u bloques)",
+                 hello->total_chars, hello->job_count, hello->chunk_count);
+        return ERROR;
+    }
+
+    size_t jobs_bytes = (size_t)hello->job_count * JOB_WIRE_SIZE;
+    unsigned char* jobs_wire = malloc(jobs_bytes);
+    in->jobs = calloc(hello->job_count, sizeof(Job));
+    in->chunk_crcs = malloc((size_t)hello->chunk_count * sizeof(uint32_t));
+    if (!jobs_wire || !in->jobs || !in->chunk_crcs) {
+        snprintf(why, n, "el destino no tiene memoria para %u trabajos", hello->job_count);
+        free(jobs_wire);
+        input_free(in);
+        return ERROR;
+    }
+
+    int rc = ERROR;
+    if (frame_recv(fd, &h) != SUCCESS) goto out;
+    if (h.type != FRAME_JOBS || h.count != hello->job_count) {
+        snprintf(why, n, "se esperaba la tabla de %u trabajos (trama %u)", hello->job_count, h.type);
+        goto out;
+    }
+    if (transport_read(fd, jobs_wire, jobs_bytes) != SUCCESS) goto out;
+    if (decode_jobs(jobs_wire, in, why, n) != SUCCESS) goto out;
+
+    if (frame_recv(fd, &h) != SUCCESS) goto out;
+    if (h.type != FRAME_DIGESTS || h.count != hello->chunk_count) {
+        snprintf(why, n, "se esperaban los CRC32C de %u bloques (trama %u)", hello->chunk_count, h.type);
+        goto out;
+    }
+    if (transport_read(fd, in->chunk_crcs, (size_t)h.count * sizeof(uint32_t)) != SUCCESS) goto out;
+    for (uint32_t c = 0; c < h.count; c++) in->chunk_crcs[c] = ntohl(in->chunk_crcs[c]);
+    rc = SUCCESS;
+
+out:
+    free(jobs_wire);
+    if (rc != SUCCESS) input_free(in);
+    return rc;
+}
+
+void input_free(BridgeInput* in) {
+    free(in->jobs);
+    free(in->chunk_crcs);
+    in->jobs = NULL;
+    in->chunk_crcs = NULL;
+}
+
+/**
+ * @brief Compara la entrada del origen con la de un segmento ya inicializado
+ *
+ * Los receptores del destino escriben según su propia tabla de trabajos
+ * y el finalizador verifica con sus propios CRC: un segmento inicializado
+ * con otra entrada produciría una salida distinta. Se informa la primera
+ * diferencia (trabajos, claves o contenido de un bloque) y cómo seguir.
+ *
+ * @return 0 si es la misma entrada; si no, 1 y el motivo en why
+ */
+int input_mismatch(const SharedMemory* shm, const BridgeInput* in, char* why, size_t n) {
+    const BridgeHello* h = &in->hello;
+    const Job* jobs = segment_jobs(shm);
+    int count = shm->job_count;
+    char detail[384];
+
+    if (h->total_chars != (uint32_t)shm->total_chars_in_file || h->job_count != (uint32_t)count) {
+        snprintf(detail, sizeof(detail), "el origen tiene %u caracteres en %u trabajos y el destino %d en %d",
+                 h->total_chars, h->job_count, shm->total_chars_in_file, count);
+    } else {
+        detail[0] = '\0';
+        for (int j = 0; j < count && !detail[0]; j++) {
+            const Job* a = &in->jobs[j];
+            const Job* b = &jobs[j];
+            if (a->start != b->start || a->length != b->length || a->key != b->key) {
+                snprintf(detail, sizeof(detail),
+                         "el trabajo %d es %.64s (%d bytes, clave 0x%02X) en el origen y %.64s (%d bytes, clave 0x%02X) en el destino",
+                         j + 1, a->input_filename, a->length, a->key, b->input_filename, b->length, b->key);
+            }
+        }
+        const ChunkDigest* digests = segment_digests(shm);
+        for (uint32_t c = 0; c < h->chunk_count && !detail[0]; c++) {
+            if (in->chunk_crcs[c] == digests[c].expected_crc) continue;
+            // Un bloque puede abarcar el final de un trabajo y el principio del siguiente
+            int first = (int)(c * INTEGRITY_CHUNK_SIZE);
+            int last = (int)MIN((uint64_t)first + INTEGRITY_CHUNK_SIZE, h->total_chars) - 1;
+            int a = job_find(in->jobs, count, first);
+            int b = job_find(in->jobs, count, last);
+            const Job* from = &in->jobs[a < 0 ? 0 : a];
+            const Job* to = &in->jobs[b < 0 ? 0 : b];
+            snprintf(detail, sizeof(detail),
+                     "el bloque %u (byte %d de %.64s a byte %d de %.64s) tiene otro contenido: "
+                     "CRC32C %08x en el origen y %08x en el destino",
+                     c, first - from->start, from->input_filename, last - to->start, to->input_filename,
+                     in->chunk_crcs[c], digests[c].expected_crc);
+        }
+        if (!detail[0]) return 0;
+    }
+    snprintf(why, n, "la instancia de destino se inicializó con otra entrada: %s. "
+                     "Inicialícela con los mismos archivos y claves que el origen, "
+                     "o deje que el puente la cree con recibir --buffer N", detail);
+    return 1;
+}
+
+int frame_send(int fd, uint32_t type, uint32_t count, const void* payload, size_t len) {
+    FrameHeader h = { htonl(type), htonl(count) };
+    struct iovec iov[2] = {
+        { .iov_base = &h,              .iov_len = sizeof(h) },
+        { .iov_base = (void*)payload,  .iov_len = len },
+    };
+    return transport_write(fd, iov, len ? 2 : 1);
+}
+
+int frame_send_data(int fd, const uint32_t* net_indices, const unsigned char* bytes, uint32_t n) {
+    FrameHeader h = { htonl(FRAME_DATA), htonl(n) };
+    struct iovec iov[3] = {
+        { .iov_base = &h,                  .iov_len = sizeof(h) },
+        { .iov_base = (void*)net_indices,  .iov_len = (size_t)n * sizeof(uint32_t) },
+        { .iov_base = (void*)bytes,        .iov_len = n },
+    };
+    return transport_write(fd, iov, 3);
+}
+
+int frame_recv(int fd, FrameHeader* h) {
+    if (transport_read(fd, h, sizeof(*h)) != SUCCESS) return ERROR;
+    h->type = ntohl(h->type);
+    h->count = ntohl(h->count);
+    return SUCCESS;
+}
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "bridge.h"
+#include "pipeline.h"
+#include "protocol.h"
+#include "transport.h"
+#include "constants.h"
+#include "instance.h"
+#include "setup.h"
+#include "shared_memory_init.h"
+
+/**
+ * Módulo Receptor del Puente (lado de destino)
+ *
+ * Acepta una sola conexión. Cada lote DATA se lee entero y se inyecta
+ * carácter por carácter en la cola de desencriptación; recién entonces se
+ * devuelven sus créditos. Si los receptores del destino no dan abasto,
+ * pipeline_inject espera un slot libre, el socket deja de leerse y el
+ * origen se queda sin créditos: la contrapresión llega hasta sus emisores
+ * sin que ningún lado acumule más de --credits caracteres.
+ *
+ * Los índices que llegan son de la entrada del origen, así que el segmento
+ * de destino tiene que describir la misma entrada: con --buffer el puente
+ * lo crea a partir de la tabla de trabajos y los CRC32C del saludo (como
+ * el inicializador, pero sin leer archivos); sin --buffer usa el que ya
+ * existe y rechaza la conexión si se inicializó con otra entrada.
+ */
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void reject(int fd, const char* why) {
+    fprintf(stderr, RED "[PUENTE] Conexión rechazada: %s\n" RESET, why);
+    frame_send(fd, FRAME_REJECT, (uint32_t)strlen(why) + 1, why, strlen(why) + 1);
+}
+
+/* Segmento recién inicializado: los índices que llegan son absolutos */
+static int check_fresh(const SharedMemory* shm) {
+    if (__atomic_load_n(&shm->chars_enqueued, __ATOMIC_ACQUIRE) != 0 ||
+        __atomic_load_n(&shm->current_txt_index, __ATOMIC_ACQUIRE) != 0) {
+        fprintf(stderr, RED "[ERROR] La instancia %s ya tiene caracteres publicados: "
+                            "el puente necesita un segmento recién inicializado\n" RESET, pipeline_label());
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+/* Crea el segmento de destino con la entrada que describe el origen */
+static int create_from_input(const BridgeInput* in, int buffer_size) {
+    SharedMemory* created = setup_from_jobs(buffer_size, (unsigned char)in->hello.key, in->jobs,
+                                            (int)in->hello.job_count, in->chunk_crcs, (int)in->hello.chunk_count);
+    if (!created) return ERROR;
+    printf(GREEN "✓ Segmento de la instancia %s creado desde el origen: %u caracteres en %u trabajos, %d slots\n" RESET,
+           pipeline_label(), in->hello.total_chars, in->hello.job_count, buffer_size);
+    detach_shared_memory(created);
+    return SUCCESS;
+}
+
+int bridge_receive(const char* addr, int credits, int buffer_size, volatile sig_atomic_t* stop) {
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    BridgeInput in;
+    memset(&in, 0, sizeof(in));
+    int rc = ERROR;
+    int fd = -1;
+    uint32_t* indices = NULL;
+    unsigned char* bytes = NULL;
+    char why[512];
+
+    // Sin --buffer el segmento ya existe: se comprueba antes de escuchar
+    if (!buffer_size) {
+        if (pipeline_open(&p, PIPELINE_EMISOR, stop) != SUCCESS || check_fresh(p.shm) != SUCCESS) goto out;
+    }
+
+    int lfd = transport_listen(addr);
+    if (lfd == -1) goto out;
+    printf(CYAN "[PUENTE] Escuchando en %s...\n" RESET, addr);
+    fd = transport_accept(lfd);
+    close(lfd);
+    if (strncmp(addr, "unix:", 5) == 0) unlink(addr + 5);
+    if (fd == -1) goto out;
+
+    if (input_recv(fd, &in, why, sizeof(why)) != SUCCESS) {
+        if (why[0]) reject(fd, why);
+        else if (!*stop) fprintf(stderr, RED "[PUENTE] El origen cerró la conexión durante el saludo\n" RESET);
+        goto out;
+    }
+    if (buffer_size) {
+        if (create_from_input(&in, buffer_size) != SUCCESS) {
+            snprintf(why, sizeof(why), "no se pudo crear el segmento de la instancia %s", pipeline_label());
+            reject(fd, why);
+            goto out;
+        }
+        if (pipeline_open(&p, PIPELINE_EMISOR, stop) != SUCCESS) goto out;
+    } else if (input_mismatch(p.shm, &in, why, sizeof(why))) {
+        reject(fd, why);
+        goto out;
+    }
+    SharedMemory* shm = p.shm;
+    printf(GREEN "✓ Registrado como emisor de la instancia %s (PID %d): %d caracteres\n" RESET,
+           pipeline_label(), (int)p.pid, shm->total_chars_in_file);
+
+    // Un lote nunca supera los créditos concedidos
+    uint32_t cap = MIN(in.hello.batch, (uint32_t)credits);
+    indices = malloc((size_t)cap * sizeof(uint32_t));
+    bytes = malloc((size_t)cap);
+    if (!indices || !bytes) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para el lote\n" RESET);
+        goto out;
+    }
+    if (frame_send(fd, FRAME_CREDIT, (uint32_t)credits, NULL, 0) != SUCCESS) goto out;
+    printf(GREEN "✓ Origen conectado: lotes de hasta %u caracteres, %d créditos\n" RESET, cap, credits);
+
+    uint32_t total = (uint32_t)shm->total_chars_in_file;
+    uint64_t injected = 0, frames = 0;
+    int finished = 0;
+    double t0 = now_s();
+    while (!finished) {
+        FrameHeader h;
+        if (frame_recv(fd, &h) != SUCCESS) {
+            if (!*stop) fprintf(stderr, RED "[PUENTE] El origen cerró la conexión\n" RESET);
+            break;
+        }
+        if (h.type == FRAME_END) {
+            finished = 1;
+            break;
+        }
+        if (h.type != FRAME_DATA || h.count == 0 || h.count > cap) {
+            fprintf(stderr, RED "[PUENTE] Trama inválida del origen (tipo %u, %u caracteres)\n" RESET,
+                    h.type, h.count);
+            break;
+        }
+        if (transport_read(fd, indices, (size_t)h.count * sizeof(uint32_t)) != SUCCESS ||
+            transport_read(fd, bytes, h.count) != SUCCESS) {
+            fprintf(stderr, RED "[PUENTE] Lote incompleto del origen\n" RESET);
+            break;
+        }
+
+        uint32_t i = 0;
+        for (; i < h.count; i++) {
+            uint32_t text_index = ntohl(indices[i]);
+            if (text_index >= total) {
+                fprintf(stderr, RED "[PUENTE] Índice %u fuera de la entrada (%u caracteres)\n" RESET,
+                        text_index, total);
+                break;
+            }
+            if (pipeline_inject(&p, (int)text_index, bytes[i]) != SUCCESS) break;
+        }
+        injected += i;
+        frames++;
+        if (i < h.count) break;
+        if (frame_send(fd, FRAME_CREDIT, h.count, NULL, 0) != SUCCESS) break;
+    }
+    if (finished) frame_send(fd, FRAME_END, (uint32_t)injected, NULL, 0);
+    double elapsed = now_s() - t0;
+
+    printf(BOLD CYAN "\n[PUENTE] Receptor del puente terminado\n" RESET);
+    printf("  • Inyectados: %llu de %u caracteres en %llu lotes\n",
+           (unsigned long long)injected, total, (unsigned long long)frames);
+    if (elapsed > 0) printf("  • Velocidad: %.0f chars/s\n", (double)injected / elapsed);
+    if (injected < total) {
+        fprintf(stderr, YELLOW "[PUENTE] Faltan %llu caracteres: los receptores de la instancia %s siguen esperando "
+                               "(el finalizador los libera)\n" RESET,
+                (unsigned long long)(total - injected), pipeline_label());
+    }
+    rc = (finished && injected == total) ? SUCCESS : ERROR;
+
+out:
+    input_free(&in);
+    free(indices);
+    free(bytes);
+    if (fd != -1) close(fd);
+    pipeline_close(&p);
+    return rc;
+}
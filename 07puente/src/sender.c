@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "bridge.h"
+#include "pipeline.h"
+#include "protocol.h"
+#include "transport.h"
+#include "constants.h"
+#include "instance.h"
+
+/**
+ * Módulo Emisor del Puente (lado de origen)
+ *
+ * Cada carácter que saca de la cola de desencriptación consume un crédito.
+ * El lote sale cuando se llena, cuando se acaban los créditos o cuando la
+ * cola local queda vacía (así un emisor lento no deja caracteres esperando
+ * un lote completo). Nunca espera la confirmación de un lote: mientras
+ * haya créditos sigue sacando y enviando, y lee las devoluciones de
+ * crédito sin bloquear entre lotes.
+ */
+
+typedef struct {
+    int       fd;
+    uint64_t  granted;      // Créditos concedidos en total
+    uint64_t  sent;         // Caracteres enviados
+    uint32_t* indices;      // Lote en curso (orden de red)
+    unsigned char* bytes;
+    int       n;
+    uint64_t  frames;
+    uint64_t  credit_waits; // Veces que el lote esperó créditos
+    int       peer_end;     // El destino respondió END
+    uint32_t  peer_count;
+} Sender;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Lee las tramas de control que llegaron del destino
+ *
+ * @param s Estado del emisor
+ * @param wait 1 = esperar al menos una trama
+ * @return SUCCESS, o ERROR si el destino rechazó o cortó la conexión
+ */
+static int read_control(Sender* s, int wait) {
+    while (wait || transport_wait(s->fd, 0) == 1) {
+        FrameHeader h;
+        if (frame_recv(s->fd, &h) != SUCCESS) {
+            fprintf(stderr, RED "[PUENTE] El destino cerró la conexión\n" RESET);
+            return ERROR;
+        }
+        if (h.type == FRAME_CREDIT) {
+            s->granted += h.count;
+        } else if (h.type == FRAME_END) {
+            s->peer_end = 1;
+            s->peer_count = h.count;
+            return SUCCESS;
+        } else if (h.type == FRAME_REJECT) {
+            char why[512] = "";
+            size_t len = MIN(h.count, sizeof(why) - 1);
+            transport_read(s->fd, why, len);
+            fprintf(stderr, RED "[PUENTE] El destino rechazó la conexión: %s\n" RESET, why);
+            return ERROR;
+        } else {
+            fprintf(stderr, RED "[PUENTE] Trama inesperada del destino (%u)\n" RESET, h.type);
+            return ERROR;
+        }
+        wait = 0;
+    }
+    return SUCCESS;
+}
+
+static int flush_batch(Sender* s) {
+    if (s->n == 0) return SUCCESS;
+    if (frame_send_data(s->fd, s->indices, s->bytes, (uint32_t)s->n) != SUCCESS) {
+        fprintf(stderr, RED "[PUENTE] No se pudo enviar un lote de %d caracteres\n" RESET, s->n);
+        return ERROR;
+    }
+    s->sent += (uint64_t)s->n;
+    s->frames++;
+    s->n = 0;
+    return SUCCESS;
+}
+
+int bridge_send(const char* addr, int batch, volatile sig_atomic_t* stop) {
+    Pipeline p;
+    if (pipeline_open(&p, PIPELINE_RECEPTOR, stop) != SUCCESS) return ERROR;
+    printf(GREEN "✓ Registrado como receptor de la instancia %s (PID %d): %d caracteres\n" RESET,
+           pipeline_label(), (int)p.pid, p.shm->total_chars_in_file);
+
+    Sender s;
+    memset(&s, 0, sizeof(s));
+    int rc = ERROR;
+    printf(CYAN "[PUENTE] Conectando a %s...\n" RESET, addr);
+    s.fd = transport_connect(addr);
+    if (s.fd == -1) goto out;
+
+    if (input_send(s.fd, p.shm, (uint32_t)batch) != SUCCESS || read_control(&s, 1) != SUCCESS) goto out;
+    if (s.peer_end || s.granted == 0) {
+        fprintf(stderr, RED "[PUENTE] El destino no concedió créditos\n" RESET);
+        goto out;
+    }
+    batch = (int)MIN((uint64_t)batch, s.granted);
+    printf(GREEN "✓ Conectado: lotes de hasta %d caracteres, %llu créditos iniciales\n" RESET,
+           batch, (unsigned long long)s.granted);
+
+    s.indices = malloc((size_t)batch * sizeof(uint32_t));
+    s.bytes = malloc((size_t)batch);
+    if (!s.indices || !s.bytes) {
+        fprintf(stderr, RED "[ERROR] Sin memoria para el lote\n" RESET);
+        goto out;
+    }
+
+    double t0 = now_s();
+    int failed = 0;
+    for (;;) {
+        // Sin créditos: el lote en curso sale y se espera una devolución
+        while (s.granted == s.sent + (uint64_t)s.n) {
+            if (s.n > 0) {
+                if (flush_batch(&s) != SUCCESS) break;
+                continue;
+            }
+            s.credit_waits++;
+            if (read_control(&s, 1) != SUCCESS || s.peer_end) break;
+        }
+        if (s.granted == s.sent + (uint64_t)s.n) {
+            failed = 1;
+            break;
+        }
+
+        int text_index;
+        unsigned char byte;
+        int r = pipeline_take(&p, 0, &text_index, &byte);
+        if (r == TAKE_EMPTY) {
+            if (flush_batch(&s) != SUCCESS || read_control(&s, 0) != SUCCESS) {
+                failed = 1;
+                break;
+            }
+            r = pipeline_take(&p, 1, &text_index, &byte);
+        }
+        if (r == TAKE_END) break;
+
+        s.indices[s.n] = htonl((uint32_t)text_index);
+        s.bytes[s.n] = byte;
+        s.n++;
+        if (s.n == batch && flush_batch(&s) != SUCCESS) {
+            failed = 1;
+            break;
+        }
+    }
+    int in_batch = s.n;
+    if (!failed && flush_batch(&s) == SUCCESS) {
+        // El destino responde END cuando inyectó todo lo enviado
+        if (frame_send(s.fd, FRAME_END, (uint32_t)s.sent, NULL, 0) == SUCCESS) {
+            while (!s.peer_end && read_control(&s, 1) == SUCCESS) {
+            }
+        }
+    }
+    double elapsed = now_s() - t0;
+
+    printf(BOLD CYAN "\n[PUENTE] Emisor del puente terminado%s\n" RESET,
+           p.end_of_stream ? " (fin de flujo)" : "");
+    printf("  • Enviados: %llu caracteres en %llu lotes (%.1f por lote)\n",
+           (unsigned long long)s.sent, (unsigned long long)s.frames,
+           s.frames ? (double)s.sent / (double)s.frames : 0.0);
+    printf("  • Esperas de crédito: %llu\n", (unsigned long long)s.credit_waits);
+    if (elapsed > 0) printf("  • Velocidad: %.0f chars/s\n", (double)s.sent / elapsed);
+    if (s.peer_end) {
+        printf("  • Inyectados en el destino: %u\n", s.peer_count);
+    } else {
+        fprintf(stderr, YELLOW "[PUENTE] El destino no confirmó el final: %d caracteres del último lote "
+                               "y los lotes en vuelo pueden haberse perdido\n" RESET, in_batch);
+    }
+    rc = (p.end_of_stream && s.peer_end && s.peer_count == s.sent) ? SUCCESS : ERROR;
+
+out:
+    free(s.indices);
+    free(s.bytes);
+    if (s.fd > 0) close(s.fd);
+    pipeline_close(&p);
+    return rc;
+}
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "timebase.h"
+
+/**
+ * Módulo de Base de Tiempo
+ *
+ * time(NULL) y localtime() en el bucle caliente cuestan una llamada al
+ * sistema (o una consulta de zona horaria) por carácter y sólo dan
+ * resolución de segundos. Este módulo ofrece un reloj en nanosegundos:
+ *  - Si el CPU tiene TSC invariante (constant_tsc + nonstop_tsc) y el
+ *    kernel lo usa como clocksource, se lee el TSC directamente y se
+ *    convierte con una calibración hecha una sola vez por el inicializador.
+ *  - En otro caso se usa CLOCK_MONOTONIC (vDSO, sin cambio de contexto).
+ *
+ * La época (lectura TSC/monotónica + hora de pared del mismo instante)
+ * vive en SharedMemory, así que cualquier proceso convierte timestamps
+ * del run a hora de pared sin volver a calibrar.
+ */
+
+#define CALIBRATION_NS 20000000ULL  // 20 ms de ventana de calibración
+
+static const TimeBase* g_tb = NULL;
+static long g_utc_offset_s = 0;     // Desplazamiento de zona horaria cacheado
+
+static uint64_t clock_ns(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t read_tsc(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Busca un flag exacto en la línea "flags" de /proc/cpuinfo */
+static int cpu_has_flag(const char* flags, const char* flag) {
+    size_t len = strlen(flag);
+    for (const char* p = strstr(flags, flag); p; p = strstr(p + 1, flag)) {
+        if ((p == flags || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\n' || p[len] == '\0')) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* El TSC sólo es seguro entre procesos/CPUs si es invariante y el kernel confía en él */
+static int tsc_is_usable(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    const char* env = getenv("IPC_TIMEBASE");
+    if (env && strcmp(env, "monotonic") == 0) return 0;
+
+    int invariant = 0;
+    FILE* f = fopen("/proc/cpuinfo", "r");
+    if (f) {
+        char line[4096];
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, "flags", 5) == 0) {
+                invariant = cpu_has_flag(line, "constant_tsc") && cpu_has_flag(line, "nonstop_tsc");
+                break;
+            }
+        }
+        fclose(f);
+    }
+    if (!invariant) return 0;
+
+    char src[32] = {0};
+    f = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (f) {
+        if (!fgets(src, sizeof(src), f)) src[0] = '\0';
+        fclose(f);
+    }
+    return strncmp(src, "tsc", 3) == 0;
+#else
+    return 0;
+#endif
+}
+
+static void cache_utc_offset(const TimeBase* tb) {
+    time_t now = (time_t)(tb->wall_epoch_ns / 1000000000LL);
+    struct tm tmp;
+    g_utc_offset_s = localtime_r(&now, &tmp) ? tmp.tm_gmtoff : 0;
+}
+
+/**
+ * @brief Elige la fuente de tiempo y fija la época del run
+ *
+ * Llamada una vez por el inicializador al crear el segmento. Si el TSC
+ * es utilizable lo calibra contra CLOCK_MONOTONIC durante ~20 ms.
+ *
+ * @param tb Base de tiempo dentro de la SharedMemory
+ */
+void timebase_calibrate(TimeBase* tb) {
+    if (!tb) return;
+    memset(tb, 0, sizeof(*tb));
+    tb->source = TIME_SOURCE_MONOTONIC;
+
+    if (tsc_is_usable()) {
+        uint64_t m0 = clock_ns(CLOCK_MONOTONIC);
+        uint64_t c0 = read_tsc();
+        struct timespec pause = { 0, (long)CALIBRATION_NS };
+        nanosleep(&pause, NULL);
+        uint64_t m1 = clock_ns(CLOCK_MONOTONIC);
+        uint64_t c1 = read_tsc();
+
+        if (c1 > c0 && m1 > m0) {
+            tb->source      = TIME_SOURCE_TSC;
+            tb->ns_per_tick = (double)(m1 - m0) / (double)(c1 - c0);
+        }
+    }
+
+    tb->mono_epoch_ns = clock_ns(CLOCK_MONOTONIC);
+    tb->tsc_epoch     = read_tsc();
+    tb->wall_epoch_ns = (int64_t)clock_ns(CLOCK_REALTIME);
+
+    timebase_attach(tb);
+}
+
+/**
+ * @brief Adopta la base de tiempo publicada en la memoria compartida
+ *
+ * @param tb Base de tiempo de la SharedMemory (NULL vuelve a CLOCK_MONOTONIC crudo)
+ */
+void timebase_attach(const TimeBase* tb) {
+    g_tb = (tb && (tb->mono_epoch_ns != 0 || tb->tsc_epoch != 0)) ? tb : NULL;
+    if (g_tb) cache_utc_offset(g_tb);
+}
+
+/**
+ * @brief Lee el reloj del run en nanosegundos
+ *
+ * Con TSC cuesta una instrucción rdtsc y una multiplicación; sin TSC,
+ * una lectura vDSO de CLOCK_MONOTONIC. Sin base adjunta devuelve
+ * CLOCK_MONOTONIC absoluto.
+ *
+ * @return Nanosegundos desde la época del run
+ */
+uint64_t timebase_now_ns(void) {
+    const TimeBase* tb = g_tb;
+    if (!tb) return clock_ns(CLOCK_MONOTONIC);
+
+    if (tb->source == TIME_SOURCE_TSC) {
+        uint64_t c = read_tsc();
+        return c > tb->tsc_epoch ? (uint64_t)((double)(c - tb->tsc_epoch) * tb->ns_per_tick) : 0;
+    }
+    uint64_t m = clock_ns(CLOCK_MONOTONIC);
+    return m > tb->mono_epoch_ns ? m - tb->mono_epoch_ns : 0;
+}
+
+/**
+ * @brief Convierte un timestamp del run a segundos UNIX
+ *
+ * @param run_ns Nanosegundos desde la época del run
+ * @return Hora de pared en segundos (time(NULL) si no hay base adjunta)
+ */
+time_t timebase_to_wall_s(uint64_t run_ns) {
+    if (!g_tb) return time(NULL);
+    return (time_t)((g_tb->wall_epoch_ns + (int64_t)run_ns) / 1000000000LL);
+}
+
+/**
+ * @brief Formatea un timestamp del run como "HH:MM:SS" en hora local
+ *
+ * Usa el desplazamiento de zona horaria cacheado al adjuntar la base,
+ * por lo que no consulta la zona horaria en cada carácter (un cambio de
+ * horario de verano durante el run no se refleja).
+ *
+ * @param run_ns Nanosegundos desde la época del run
+ * @param buf Buffer de salida (>= 9 bytes)
+ * @param n Tamaño del buffer
+ */
+void timebase_format_hms(uint64_t run_ns, char* buf, size_t n) {
+    if (!buf || n < 9) return;
+    long long secs = (long long)timebase_to_wall_s(run_ns) + g_utc_offset_s;
+    int day_s = (int)(((secs % 86400) + 86400) % 86400);
+    int h = day_s / 3600, m = (day_s / 60) % 60, s = day_s % 60;
+
+    buf[0] = (char)('0' + h / 10); buf[1] = (char)('0' + h % 10); buf[2] = ':';
+    buf[3] = (char)('0' + m / 10); buf[4] = (char)('0' + m % 10); buf[5] = ':';
+    buf[6] = (char)('0' + s / 10); buf[7] = (char)('0' + s % 10); buf[8] = '\0';
+}
+
+/**
+ * @brief Nombre legible de la fuente de tiempo
+ */
+const char* timebase_source_name(const TimeBase* tb) {
+    if (!tb) return "CLOCK_MONOTONIC (sin base)";
+    return tb->source == TIME_SOURCE_TSC ? "TSC invariante (calibrado)" : "CLOCK_MONOTONIC";
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "transport.h"
+#include "constants.h"
+
+/**
+ * Módulo de Transporte (puente)
+ *
+ * Sockets de flujo bloqueantes: las esperas se hacen con poll en tramos de
+ * POLL_INTERVAL_MS para que una señal de terminación no quede esperando a
+ * un extremo remoto que nunca contesta. En TCP se desactiva Nagle: el
+ * puente ya agrupa los caracteres en lotes y un lote parcial (la cola
+ * local se vació) debe salir sin demora.
+ */
+
+static volatile sig_atomic_t* g_stop = NULL;
+
+static int stopped(void) {
+    return g_stop && *g_stop;
+}
+
+void transport_set_stop(volatile sig_atomic_t* stop) {
+    g_stop = stop;
+}
+
+/**
+ * @brief Resuelve una dirección del puente
+ *
+ * @param addr Dirección (ver transport.h)
+ * @param passive 1 para escuchar
+ * @param out Lista de direcciones (liberar con freeaddrinfo), o NULL si es unix:
+ * @param un Dirección Unix (si addr empieza con "unix:")
+ * @return SUCCESS o ERROR
+ */
+static int resolve(const char* addr, int passive, struct addrinfo** out, struct sockaddr_un* un) {
+    *out = NULL;
+    if (strncmp(addr, "unix:", 5) == 0) {
+        memset(un, 0, sizeof(*un));
+        un->sun_family = AF_UNIX;
+        if (addr[5] == '\0' || strlen(addr + 5) >= sizeof(un->sun_path)) {
+            fprintf(stderr, RED "[ERROR] Ruta de socket inválida: %s\n" RESET, addr);
+            return ERROR;
+        }
+        strcpy(un->sun_path, addr + 5);
+        return SUCCESS;
+    }
+    if (strncmp(addr, "tcp:", 4) == 0) addr += 4;
+
+    const char* colon = strrchr(addr, ':');
+    if (!colon || colon[1] == '\0') {
+        fprintf(stderr, RED "[ERROR] Dirección inválida '%s': use HOST:PUERTO o unix:RUTA\n" RESET, addr);
+        return ERROR;
+    }
+    char host[256];
+    size_t hlen = (size_t)(colon - addr);
+    if (hlen >= sizeof(host)) hlen = sizeof(host) - 1;
+    memcpy(host, addr, hlen);
+    host[hlen] = '\0';
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    int rc = getaddrinfo(hlen ? host : NULL, colon + 1, &hints, out);
+    if (rc != 0) {
+        fprintf(stderr, RED "[ERROR] No se pudo resolver '%s': %s\n" RESET, addr, gai_strerror(rc));
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+static void tune_tcp(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+int transport_listen(const char* addr) {
+    struct addrinfo* list;
+    struct sockaddr_un un;
+    if (resolve(addr, 1, &list, &un) != SUCCESS) return -1;
+
+    int fd = -1;
+    if (!list) {
+        unlink(un.sun_path);  // Socket de una corrida anterior
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd != -1 && (bind(fd, (struct sockaddr*)&un, sizeof(un)) == -1 || listen(fd, LISTEN_BACKLOG) == -1)) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        for (struct addrinfo* ai = list; ai && fd == -1; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+            if (fd == -1) continue;
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == -1 || listen(fd, LISTEN_BACKLOG) == -1) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(list);
+    }
+    if (fd == -1) fprintf(stderr, RED "[ERROR] No se pudo escuchar en %s: %s\n" RESET, addr, strerror(errno));
+    return fd;
+}
+
+int transport_accept(int listen_fd) {
+    for (;;) {
+        int ready = transport_wait(listen_fd, POLL_INTERVAL_MS);
+        if (ready < 0 || stopped()) return -1;
+        if (ready == 0) continue;
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            fprintf(stderr, RED "[ERROR] accept: %s\n" RESET, strerror(errno));
+            return -1;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        tune_tcp(fd);  // En un socket Unix falla sin efecto
+        return fd;
+    }
+}
+
+/* Un intento de conexión a cada dirección resuelta */
+static int connect_once(struct addrinfo* list, const struct sockaddr_un* un) {
+    if (!list) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd != -1 && connect(fd, (const struct sockaddr*)un, sizeof(*un)) == -1) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+    for (struct addrinfo* ai = list; ai; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd == -1) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            tune_tcp(fd);
+            return fd;
+        }
+        close(fd);
+    }
+    return -1;
+}
+
+int transport_connect(const char* addr) {
+    struct addrinfo* list;
+    struct sockaddr_un un;
+    if (resolve(addr, 0, &list, &un) != SUCCESS) return -1;
+
+    int fd = -1;
+    int waited = 0;
+    while ((fd = connect_once(list, &un)) == -1 && !stopped() && waited < CONNECT_TIMEOUT_MS) {
+        // El otro extremo todavía no escucha: se reintenta
+        struct timespec ts = { 0, POLL_INTERVAL_MS * 1000000L };
+        nanosleep(&ts, NULL);
+        waited += POLL_INTERVAL_MS;
+    }
+    if (fd == -1) fprintf(stderr, RED "[ERROR] No se pudo conectar a %s: %s\n" RESET, addr, strerror(errno));
+    if (list) freeaddrinfo(list);
+    return fd;
+}
+
+int transport_wait(int fd, int timeout_ms) {
+    struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+    int rc = poll(&pfd, 1, timeout_ms);
+    if (rc < 0) return errno == EINTR ? 0 : -1;
+    return rc > 0;
+}
+
+int transport_write(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t w = writev(fd, iov, iovcnt);
+        if (w < 0) {
+            if (errno == EINTR && !stopped()) continue;
+            if (errno == EAGAIN) {
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+                poll(&pfd, 1, POLL_INTERVAL_MS);
+                if (!stopped()) continue;
+            }
+            return ERROR;
+        }
+        size_t done = (size_t)w;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return SUCCESS;
+}
+
+int transport_read(int fd, void* buf, size_t len) {
+    char* p = buf;
+    while (len > 0) {
+        int ready = transport_wait(fd, POLL_INTERVAL_MS);
+        if (ready < 0 || stopped()) return ERROR;
+        if (ready == 0) continue;
+        ssize_t r = read(fd, p, len);
+        if (r < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return ERROR;
+        }
+        if (r == 0) {
+            errno = ECONNRESET;
+            return ERROR;
+        }
+        p += r;
+        len -= (size_t)r;
+    }
+    return SUCCESS;
+}
@@ -0,0 +1,16 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "structures.h"
+
+/*
+ * Resúmenes de una etapa checksum (mismo esquema que la integridad de los
+ * receptores, sobre los ChunkDigest de la etapa):
+ *  - checksum_bind: prepara la tabla de desplazamientos y apunta a los
+ *    resúmenes de la etapa (sin efecto si la etapa no es checksum).
+ *  - checksum_record: suma la contribución de un byte en claro.
+ */
+int  checksum_bind(SharedMemory* shm, const Stage* stage);
+void checksum_record(int text_index, unsigned char ch);
+
+#endif // CHECKSUM_H
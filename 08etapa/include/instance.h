@@ -0,0 +1,29 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include "structures.h"
+
+/*
+ * Instancias: varias tuberías independientes en el mismo host.
+ *  - instance_init: toma el nombre de "--instance NOMBRE" (y lo quita de
+ *    argv) o de IPC_INSTANCE; lo valida y lo exporta en IPC_INSTANCE para
+ *    los procesos hijos. Sin nombre se usa la instancia por omisión.
+ *  - instance_name: nombre actual ("" = por omisión).
+ *  - instance_shm_key: clave System V de la instancia.
+ *  - instance_sem: nombre del semáforo SEM_NAME_* en la instancia.
+ *  - instance_sem_n: nombre del semáforo numerado base<n> en la instancia
+ *    (etapa intermedia o grupo de receptores; búfer estático que rota
+ *    entre cuatro).
+ *  - instance_check: verifica que el segmento adjuntado sea de la instancia.
+ * Archivo idéntico en los nueve programas.
+ */
+int         instance_init(int* argc, char* argv[]);
+const char* instance_name(void);
+key_t       instance_shm_key(void);
+const char* instance_sem(const char* base);
+const char* instance_sem_n(const char* base, int n);
+int         instance_check(const SharedMemory* shm);
+
+#endif // INSTANCE_H
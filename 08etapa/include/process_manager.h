@@ -0,0 +1,19 @@
+#ifndef PROCESS_MANAGER_H
+#define PROCESS_MANAGER_H
+
+#include <sys/types.h>
+#include <semaphore.h>
+#include "structures.h"
+
+/*
+ * Registro de procesos etapa:
+ *  - register_etapa: ocupa una entrada de stage_pids y cuenta al proceso
+ *    en active_etapas, total_etapas y en los trabajadores de su etapa.
+ *  - unregister_etapa: libera la entrada y avisa al finalizador.
+ *  - relay_shutdown: reconoce (y reenvía) el token de finalización.
+ */
+int register_etapa(SharedMemory* shm, pid_t pid, int k, sem_t* sem_global);
+int unregister_etapa(SharedMemory* shm, pid_t pid, sem_t* sem_global);
+int relay_shutdown(SharedMemory* shm, sem_t* sem);
+
+#endif // PROCESS_MANAGER_H
@@ -0,0 +1,45 @@
+#ifndef STAGE_H
+#define STAGE_H
+
+#include <signal.h>
+#include <semaphore.h>
+#include "structures.h"
+
+/*
+ * Enlace de una etapa intermedia con sus dos colas:
+ *  - stage_open: abre los semáforos de la cola de entrada (etapa k) y de
+ *    la de salida (etapa k + 1, o la de desencriptación si k es la última).
+ *  - stage_take: espera un slot de la cola de entrada. STAGE_ITEM con ref
+ *    válido; STAGE_END si llegó el fin de flujo (ya reenviado a los demás
+ *    procesos de la etapa); STAGE_STOP por señal o finalización.
+ *  - stage_transform: aplica la operación de la etapa al byte del slot
+ *    (en claro, con la clave de su trabajo) y lo deja cifrado otra vez.
+ *  - stage_forward: publica el slot en la cola de salida y, si era el
+ *    último carácter, el fin de flujo de esa cola.
+ *  - stage_close: cierra los semáforos.
+ */
+#define STAGE_ITEM 0
+#define STAGE_END  1
+#define STAGE_STOP 2
+
+typedef struct {
+    SharedMemory* shm;
+    int       index;
+    Stage*    stage;
+    sem_t*    in_queue;
+    sem_t*    in_items;
+    sem_t*    out_queue;
+    sem_t*    out_items;
+    Queue*    out;
+    uint32_t* out_enqueued;
+    int*      out_end_of_stream;
+    volatile sig_atomic_t* stop;
+} StageLink;
+
+int  stage_open(StageLink* link, SharedMemory* shm, int k, volatile sig_atomic_t* stop);
+int  stage_take(StageLink* link, SlotRef* ref);
+void stage_transform(StageLink* link, const SlotRef* ref);
+void stage_forward(StageLink* link, const SlotRef* ref);
+void stage_close(StageLink* link);
+
+#endif // STAGE_H
@@ -0,0 +1,45 @@
+#include <stdlib.h>
+#include "checksum.h"
+#include "crc32c.h"
+#include "constants.h"
+
+/**
+ * Módulo de Resúmenes de Etapa
+ *
+ * Una etapa checksum no cambia el byte: acumula el CRC32C por bloque de
+ * lo que le llega, con la misma suma lineal de contribuciones crudas que
+ * usan los receptores (03receptor/src/integrity.c), así que el orden en
+ * que pasan los caracteres no importa. El inicializador dejó el CRC
+ * esperado de cada bloque en la entrada de la etapa y el finalizador los
+ * compara.
+ */
+
+static ChunkDigest* g_digests = NULL;
+static uint32_t*    g_shift = NULL;   // g_shift[d] = x^(8d) mod P
+static int          g_file_size = 0;
+
+int checksum_bind(SharedMemory* shm, const Stage* stage) {
+    g_digests = NULL;
+    if (stage->op != STAGE_OP_CHECKSUM || !stage->digest_offset) return SUCCESS;
+    g_shift = malloc(INTEGRITY_CHUNK_SIZE * sizeof(uint32_t));
+    if (!g_shift) return ERROR;
+
+    uint32_t x8 = crc32c_x8n(1);
+    g_shift[0] = crc32c_x8n(0);
+    for (int d = 1; d < INTEGRITY_CHUNK_SIZE; d++) g_shift[d] = crc32c_multiply(g_shift[d - 1], x8);
+
+    g_digests = (ChunkDigest*)((char*)shm + stage->digest_offset);
+    g_file_size = shm->file_data_size;
+    return SUCCESS;
+}
+
+void checksum_record(int text_index, unsigned char ch) {
+    if (!g_digests || text_index < 0 || text_index >= g_file_size) return;
+    int chunk = text_index / INTEGRITY_CHUNK_SIZE;
+    int chunk_end = MIN((chunk + 1) * INTEGRITY_CHUNK_SIZE, g_file_size);
+    uint32_t contrib = crc32c_multiply(g_shift[chunk_end - 1 - text_index], crc32c_byte_raw(ch));
+
+    ChunkDigest* d = &g_digests[chunk];
+    __atomic_fetch_xor(&d->written_crc, contrib, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&d->written_bytes, 1, __ATOMIC_RELEASE);
+}
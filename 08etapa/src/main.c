@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/shm.h>
+#include "constants.h"
+#include "structures.h"
+#include "stage.h"
+#include "checksum.h"
+#include "process_manager.h"
+#include "instance.h"
+
+/**
+ * Etapa Intermedia del Pipeline
+ *
+ * Atiende una de las etapas que el inicializador describió con --stages:
+ * toma cada slot de la cola de la etapa, aplica su transformación al
+ * byte en claro (xor, upper, lower, filter) o acumula su CRC32C
+ * (checksum), y lo publica en la cola de la etapa siguiente o, después de
+ * la última, en la de desencriptación. Los emisores y receptores no
+ * cambian: unos publican en la etapa 0 y los otros leen lo que sale de
+ * la última.
+ *
+ * Se pueden lanzar varios procesos por etapa; cada uno termina con el fin
+ * de flujo de su cola o cuando el finalizador lo pide.
+ */
+
+static volatile sig_atomic_t should_terminate = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    should_terminate = 1;
+}
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso: %s ETAPA [MS]\n", argv0);
+    fprintf(stderr, "  ETAPA   Número de etapa (0..cantidad de etapas - 1)\n");
+    fprintf(stderr, "  MS      Retardo por carácter en milisegundos (0..%d, por omisión 0)\n", MAX_DELAY_MS);
+    fprintf(stderr, "  --instance NOMBRE (o IPC_INSTANCE) elige la instancia\n");
+}
+
+/**
+ * @brief Parsea un entero dentro de un rango
+ *
+ * @return 1 si es válido, 0 si no
+ */
+static int parse_int_range(const char* s, int lo, int hi, int* out) {
+    char* end = NULL;
+    long v = strtol(s, &end, 10);
+    if (!s[0] || *end != '\0' || v < lo || v > hi) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
+    int k = 0, delay_ms = 0;
+    if (argc < 2 || argc > 3 || !parse_int_range(argv[1], 0, MAX_STAGES - 1, &k) ||
+        (argc == 3 && !parse_int_range(argv[2], 0, MAX_DELAY_MS, &delay_ms))) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int shmid = shmget(instance_shm_key(), 0, 0);
+    SharedMemory* shm = shmid == -1 ? (void*)-1 : shmat(shmid, NULL, 0);
+    if (shm == (void*)-1) {
+        fprintf(stderr, RED "[ERROR] No se pudo conectar a SHM. ¿Ejecutaste el inicializador?\n" RESET);
+        return EXIT_FAILURE;
+    }
+    if (instance_check(shm) != SUCCESS) {
+        shmdt(shm);
+        return EXIT_FAILURE;
+    }
+    if (k >= shm->stage_count) {
+        fprintf(stderr, RED "[ERROR] La instancia tiene %d etapas (inicializador --stages ARCHIVO)\n" RESET,
+                shm->stage_count);
+        shmdt(shm);
+        return EXIT_FAILURE;
+    }
+
+    // Sin SA_RESTART: sem_wait vuelve con EINTR y el bucle revisa la bandera
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    StageLink link;
+    sem_t* sem_global = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    if (sem_global == SEM_FAILED || stage_open(&link, shm, k, &should_terminate) != SUCCESS) {
+        if (sem_global != SEM_FAILED) sem_close(sem_global);
+        else fprintf(stderr, RED "[ERROR] No se pudo abrir el semáforo global\n" RESET);
+        shmdt(shm);
+        return EXIT_FAILURE;
+    }
+    pid_t my_pid = getpid();
+    if (register_etapa(shm, my_pid, k, sem_global) != SUCCESS) {
+        fprintf(stderr, RED "[ERROR] No se pudo registrar el proceso etapa (máximo %d)\n" RESET, MAX_WORKERS);
+        stage_close(&link);
+        sem_close(sem_global);
+        shmdt(shm);
+        return EXIT_FAILURE;
+    }
+    if (checksum_bind(shm, link.stage) != SUCCESS) {
+        fprintf(stderr, YELLOW "[ADVERTENCIA] Sin memoria para el CRC32C de la etapa; "
+                               "el finalizador verá sus bloques como faltantes\n" RESET);
+    }
+
+    const Stage* st = link.stage;
+    printf(CYAN "[ETAPA %d] Etapa %d de %d: %s", my_pid, k, shm->stage_count, stage_op_name(st->op));
+    if (st->op == STAGE_OP_XOR || st->op == STAGE_OP_FILTER) printf(" %02X", st->param);
+    printf(" → %s\n" RESET, k + 1 < shm->stage_count ? "siguiente etapa" : "receptores");
+    fflush(stdout);
+
+    uint64_t passed = 0;
+    int rc = STAGE_STOP;
+    double t0 = now_s();
+    SlotRef ref;
+    while ((rc = stage_take(&link, &ref)) == STAGE_ITEM) {
+        stage_transform(&link, &ref);
+        stage_forward(&link, &ref);
+        passed++;
+        if (delay_ms > 0) usleep((useconds_t)delay_ms * 1000);
+    }
+    double elapsed = now_s() - t0;
+
+    printf(BOLD CYAN "\n[ETAPA %d] Etapa %d terminada%s\n" RESET, my_pid, k,
+           rc == STAGE_END ? " (fin de flujo)" : "");
+    printf("  • Caracteres de este proceso: %llu (la etapa lleva %u)\n", (unsigned long long)passed,
+           __atomic_load_n(&shm->stages[k].passed, __ATOMIC_RELAXED));
+    if (elapsed > 0) printf("  • Velocidad: %.0f chars/s\n", (double)passed / elapsed);
+
+    unregister_etapa(shm, my_pid, sem_global);
+    stage_close(&link);
+    sem_close(sem_global);
+    shmdt(shm);
+    return rc == STAGE_END ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,83 @@
+/**
+ * Módulo de Gestión de Procesos Etapa
+ *
+ * Registro en stage_pids, igual que emisores y receptores en sus tablas:
+ * el finalizador lo usa para señalar y esperar a cada proceso etapa.
+ */
+
+#include <stdio.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "process_manager.h"
+#include "constants.h"
+
+/* Avisa al finalizador que un trabajador se desregistró (ver 03receptor) */
+static void notify_worker_exit(SharedMemory* shm) {
+    __atomic_add_fetch(&shm->workers_exit_seq, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &shm->workers_exit_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/**
+ * @brief Comprueba la finalización al despertar de un semáforo de conteo
+ *
+ * Mismo esquema en cadena que emisores y receptores: quien ve
+ * shutdown_flag devuelve el token para el siguiente bloqueado.
+ *
+ * @return 1 si hay que terminar (token reenviado), 0 si el token es real
+ */
+int relay_shutdown(SharedMemory* shm, sem_t* sem) {
+    if (!__atomic_load_n(&shm->shutdown_flag, __ATOMIC_ACQUIRE)) return 0;
+    __atomic_add_fetch(&shm->shutdown_relays, 1, __ATOMIC_RELAXED);
+    sem_post(sem);
+    return 1;
+}
+
+/**
+ * @brief Registra un proceso etapa
+ *
+ * @param shm Puntero a la memoria compartida
+ * @param pid PID del proceso
+ * @param k Etapa que atiende
+ * @param sem_global Semáforo global para sincronización
+ * @return SUCCESS o ERROR (tabla llena)
+ */
+int register_etapa(SharedMemory* shm, pid_t pid, int k, sem_t* sem_global) {
+    sem_wait(sem_global);
+    int ok = 0;
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (shm->stage_pids[i] == 0) {
+            shm->stage_pids[i] = pid;
+            ok = 1;
+            break;
+        }
+    }
+    if (ok) {
+        shm->active_etapas++;
+        shm->total_etapas++;
+        shm->stages[k].workers++;
+        printf(GREEN "[ETAPA %d] Registrado en la etapa %d (%d procesos etapa activos)\n" RESET,
+               pid, k, shm->active_etapas);
+    }
+    sem_post(sem_global);
+    return ok ? SUCCESS : ERROR;
+}
+
+int unregister_etapa(SharedMemory* shm, pid_t pid, sem_t* sem_global) {
+    sem_wait(sem_global);
+    int found = 0;
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        if (shm->stage_pids[i] == pid) {
+            shm->stage_pids[i] = 0;
+            found = 1;
+            break;
+        }
+    }
+    if (found) {
+        shm->active_etapas--;
+        notify_worker_exit(shm);
+    }
+    sem_post(sem_global);
+    return found ? SUCCESS : ERROR;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include "stage.h"
+#include "checksum.h"
+#include "process_manager.h"
+#include "constants.h"
+#include "instance.h"
+
+/**
+ * Módulo de Enlace de Etapa
+ *
+ * Entre dos colas sólo viaja el SlotRef: la etapa toma la referencia de
+ * su cola (FIFO), transforma el byte del slot en el lugar y publica la
+ * misma referencia en la cola siguiente. Como hay a lo sumo buffer_size
+ * slots en circulación y cada cola tiene esa capacidad, publicar nunca
+ * espera: la contrapresión sigue siendo la de ENCRYPT_SPACES en los
+ * emisores.
+ *
+ * El fin de flujo se propaga como entre emisores y receptores: quien
+ * publica el último carácter en una cola activa su end_of_stream y
+ * deposita un token extra; el proceso etapa que lo obtiene con la cola
+ * vacía lo reenvía a los demás de su etapa y termina.
+ */
+
+static SlotRef* queue_array(SharedMemory* shm, const Queue* q) {
+    return (SlotRef*)((char*)shm + q->array_offset);
+}
+
+int stage_open(StageLink* link, SharedMemory* shm, int k, volatile sig_atomic_t* stop) {
+    memset(link, 0, sizeof(*link));
+    link->shm = shm;
+    link->index = k;
+    link->stage = &shm->stages[k];
+    link->stop = stop;
+
+    link->in_queue = sem_open(instance_sem_n(SEM_NAME_STAGE_QUEUE, k), 0);
+    link->in_items = sem_open(instance_sem_n(SEM_NAME_STAGE_ITEMS, k), 0);
+    if (k + 1 < shm->stage_count) {
+        Stage* next = &shm->stages[k + 1];
+        link->out = &next->queue;
+        link->out_enqueued = &next->enqueued;
+        link->out_end_of_stream = &next->end_of_stream;
+        link->out_queue = sem_open(instance_sem_n(SEM_NAME_STAGE_QUEUE, k + 1), 0);
+        link->out_items = sem_open(instance_sem_n(SEM_NAME_STAGE_ITEMS, k + 1), 0);
+    } else {
+        link->out = &shm->decrypt_queue;
+        link->out_enqueued = &shm->chars_enqueued;
+        link->out_end_of_stream = &shm->end_of_stream;
+        link->out_queue = sem_open(instance_sem(SEM_NAME_DECRYPT_QUEUE), 0);
+        link->out_items = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+    }
+    if (link->in_queue == SEM_FAILED || link->in_items == SEM_FAILED ||
+        link->out_queue == SEM_FAILED || link->out_items == SEM_FAILED) {
+        fprintf(stderr, RED "[ERROR] No se pudieron abrir los semáforos de la etapa %d: %s\n" RESET,
+                k, strerror(errno));
+        stage_close(link);
+        return ERROR;
+    }
+    return SUCCESS;
+}
+
+void stage_close(StageLink* link) {
+    sem_t* sems[] = { link->in_queue, link->in_items, link->out_queue, link->out_items };
+    for (size_t i = 0; i < sizeof(sems) / sizeof(sems[0]); i++) {
+        if (sems[i] && sems[i] != SEM_FAILED) sem_close(sems[i]);
+    }
+    link->in_queue = link->in_items = link->out_queue = link->out_items = NULL;
+}
+
+int stage_take(StageLink* link, SlotRef* ref) {
+    SharedMemory* shm = link->shm;
+    Queue* q = &link->stage->queue;
+    for (;;) {
+        if (*link->stop) return STAGE_STOP;
+        if (sem_wait(link->in_items) != 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, RED "[ERROR] sem_wait(stage_items%d): %s\n" RESET, link->index, strerror(errno));
+            return STAGE_STOP;
+        }
+        if (relay_shutdown(shm, link->in_items)) return STAGE_STOP;
+
+        int got = 0;
+        sem_wait(link->in_queue);
+        if (q->size > 0) {
+            SlotRef* arr = queue_array(shm, q);
+            seq_write_begin(&q->seq);
+            *ref = arr[q->head];
+            q->head = (q->head + 1) % q->capacity;
+            q->size--;
+            seq_write_end(&q->seq);
+            got = 1;
+        }
+        sem_post(link->in_queue);
+        if (got) return STAGE_ITEM;
+
+        // Cola vacía con un token en la mano: el marcador de fin de flujo
+        if (__atomic_load_n(&link->stage->end_of_stream, __ATOMIC_ACQUIRE)) {
+            __atomic_add_fetch(&link->stage->eos_relays, 1, __ATOMIC_RELAXED);
+            sem_post(link->in_items);
+            return STAGE_END;
+        }
+    }
+}
+
+void stage_transform(StageLink* link, const SlotRef* ref) {
+    SharedMemory* shm = link->shm;
+    CharacterSlot* slot = (CharacterSlot*)((char*)shm + shm->buffer_offset) + ref->slot_index;
+    const Job* jobs = (const Job*)((char*)shm + shm->jobs_offset);
+    int job = job_find(jobs, shm->job_count, ref->text_index);
+    unsigned char key = job >= 0 ? jobs[job].key : shm->encryption_key;
+
+    unsigned char plain = (unsigned char)(slot->ascii_value ^ key);
+    if (link->stage->op == STAGE_OP_CHECKSUM) {
+        checksum_record(ref->text_index, plain);
+        return;
+    }
+    slot->ascii_value = (unsigned char)(stage_apply(link->stage->op, link->stage->param, plain) ^ key);
+}
+
+void stage_forward(StageLink* link, const SlotRef* ref) {
+    SharedMemory* shm = link->shm;
+    Queue* q = link->out;
+
+    sem_wait(link->out_queue);
+    SlotRef* arr = queue_array(shm, q);
+    seq_write_begin(&q->seq);
+    arr[q->tail] = *ref;
+    q->tail = (q->tail + 1) % q->capacity;
+    q->size++;
+    seq_write_end(&q->seq);
+    sem_post(link->out_queue);
+    sem_post(link->out_items);
+    __atomic_add_fetch(&link->stage->passed, 1, __ATOMIC_RELAXED);
+
+    uint32_t done = __atomic_add_fetch(link->out_enqueued, 1, __ATOMIC_SEQ_CST);
+    if (done != (uint32_t)__atomic_load_n(&shm->total_chars_in_file, __ATOMIC_ACQUIRE)) return;
+    int expected = 0;
+    if (__atomic_compare_exchange_n(link->out_end_of_stream, &expected, 1, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        sem_post(link->out_items);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef LAUNCHER_H
+#define LAUNCHER_H
+
+#include <stdint.h>
+#include "structures.h"
+
+#define LAUNCH_MAX_CPUS 1024
+
+/*
+ * Lanzamiento de una corrida completa:
+ *  - launch_check_init_args: rechaza opciones del inicializador que
+ *    necesitan procesos que el lanzador no crea (demonio, streaming,
+ *    salida ordenada, etapas).
+ *  - launch_parse_cpus: "auto" (las CPUs permitidas al lanzador) o una
+ *    lista "0,2,4-7"; el trabajador i queda en cpus[i % n].
+ *  - launch_pipeline: crea el segmento en el propio proceso (setup_pipeline
+ *    del inicializador) y hace fork sin exec de R receptores y E emisores
+ *    (receptor_run / emisor_run); espera a que terminen y mide arranque,
+ *    primer byte y tiempo total.
+ *  - launch_print_report: imprime las mediciones.
+ *  - launch_teardown: sem_unlink y IPC_RMID de la instancia (--rm).
+ */
+typedef struct {
+    const char*  input_path;
+    const char*  buffer;        // Tal como llega: lo valida el inicializador
+    const char*  key;
+    char* const* init_extra;    // Opciones del inicializador después de "--"
+    int          init_extra_n;
+    int          emisores;
+    int          receptores;
+    int          delay_ms;      // Retardo por carácter de los trabajadores
+    int          cpus[LAUNCH_MAX_CPUS];
+    int          cpu_count;     // 0 = sin pinning
+} LaunchConfig;
+
+typedef struct {
+    int      chars;             // Caracteres de la entrada
+    int      groups;            // Grupos de receptores (0 = sin difusión)
+    int      spawned;           // Trabajadores lanzados
+    int      failed;            // Terminaron con error o por señal
+    uint64_t written;           // Caracteres escritos por todos los receptores
+    double   init_ms;           // Lanzamiento -> inicializador terminado
+    double   fork_ms;           // Primer fork -> último fork de trabajador
+    double   ready_ms;          // Lanzamiento -> último trabajador registrado
+    double   ttfb_ms;           // Lanzamiento -> primer carácter de un receptor (-1 = ninguno)
+    double   wall_ms;           // Lanzamiento -> último trabajador recogido
+} LaunchReport;
+
+int  launch_check_init_args(char* const* args, int n);
+int  launch_parse_cpus(const char* spec, LaunchConfig* cfg);
+int  launch_pipeline(const LaunchConfig* cfg, LaunchReport* rep);
+void launch_print_report(const LaunchConfig* cfg, const LaunchReport* rep);
+void launch_teardown(void);
+
+#endif // LAUNCHER_H
@@ -0,0 +1,422 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include "launcher.h"
+#include "constants.h"
+#include "instance.h"
+#include "timebase.h"
+#include "setup.h"
+#include "emisor.h"
+#include "receptor.h"
+#include "groups.h"
+
+/**
+ * Módulo de Lanzamiento
+ *
+ * Reemplaza las cuatro terminales de una corrida corta. El segmento se
+ * crea en este mismo proceso con setup_pipeline (el código del
+ * inicializador, enlazado en el lanzador) y los semáforos se abren una
+ * sola vez; después cada receptor y cada emisor es un fork sin exec que
+ * hereda el mapeo y los semáforos y corre receptor_run o emisor_run. Así
+ * ningún trabajador vuelve a cargar un binario, a buscar el segmento ni
+ * a abrir semáforos. El pinning se aplica en el hijo antes de entrar al
+ * bucle, y los hijos corren con IPC_QUIET=1 y la salida estándar en
+ * /dev/null.
+ *
+ * Lo que mide sale de la SHM: start_ns de cada bloque WorkerStats
+ * (registro) y first_ns (primer carácter terminado), en la base de
+ * tiempo del run.
+ *
+ * Espera con sigwaitinfo sobre SIGCHLD, SIGINT y SIGTERM bloqueadas, sin
+ * sondeo. Una señal de terminación libera a los trabajadores como el
+ * finalizador (shutdown_flag, SIGUSR1 y un token por semáforo); una
+ * segunda los mata.
+ */
+
+#define MAX_CHILDREN (2 * MAX_WORKERS)
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static double ms_between(uint64_t a, uint64_t b) {
+    return b > a ? (double)(b - a) / 1e6 : 0.0;
+}
+
+/**
+ * @brief Rechaza opciones del inicializador que el lanzador no atiende
+ *
+ * Con --daemon o --stream el inicializador no termina (sigue aceptando
+ * lotes o alimentando el flujo); --sink necesita un receptor volcador y
+ * --stages procesos 08etapa.
+ *
+ * @return SUCCESS o ERROR
+ */
+int launch_check_init_args(char* const* args, int n) {
+    static const char* unsupported[] = { "--daemon", "--stream", "--sink", "--stages" };
+    for (int i = 0; i < n; i++) {
+        for (size_t u = 0; u < sizeof(unsupported) / sizeof(unsupported[0]); u++) {
+            if (strcmp(args[i], unsupported[u]) != 0) continue;
+            fprintf(stderr, RED "[ERROR] El lanzador no admite %s del inicializador\n" RESET, args[i]);
+            return ERROR;
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+ * @brief Parsea la lista de CPUs del pinning
+ *
+ * @param spec "auto" o una lista "0,2,4-7"
+ * @param cfg Configuración (cpus, cpu_count)
+ * @return SUCCESS o ERROR si alguna CPU no está permitida al lanzador
+ */
+int launch_parse_cpus(const char* spec, LaunchConfig* cfg) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        fprintf(stderr, RED "[ERROR] sched_getaffinity: %s\n" RESET, strerror(errno));
+        return ERROR;
+    }
+    cfg->cpu_count = 0;
+    if (strcmp(spec, "auto") == 0) {
+        for (int c = 0; c < CPU_SETSIZE && cfg->cpu_count < LAUNCH_MAX_CPUS; c++) {
+            if (CPU_ISSET(c, &allowed)) cfg->cpus[cfg->cpu_count++] = c;
+        }
+        return cfg->cpu_count > 0 ? SUCCESS : ERROR;
+    }
+
+    const char* p = spec;
+    while (*p) {
+        char* end = NULL;
+        long lo = strtol(p, &end, 10);
+        long hi = lo;
+        if (end == p) goto invalid;
+        if (*end == '-') {
+            p = end + 1;
+            hi = strtol(p, &end, 10);
+            if (end == p || hi < lo) goto invalid;
+        }
+        for (long c = lo; c <= hi; c++) {
+            if (c < 0 || c >= CPU_SETSIZE || !CPU_ISSET((int)c, &allowed)) {
+                fprintf(stderr, RED "[ERROR] La CPU %ld no está disponible para el lanzador\n" RESET, c);
+                return ERROR;
+            }
+            if (cfg->cpu_count == LAUNCH_MAX_CPUS) goto invalid;
+            cfg->cpus[cfg->cpu_count++] = (int)c;
+        }
+        if (*end == ',') end++;
+        else if (*end != '\0') goto invalid;
+        p = end;
+    }
+    if (cfg->cpu_count > 0) return SUCCESS;
+invalid:
+    fprintf(stderr, RED "[ERROR] Lista de CPUs inválida: '%s' (use auto o p. ej. 0,2,4-7)\n" RESET, spec);
+    return ERROR;
+}
+
+void launch_teardown(void) {
+    static const char* names[] = {
+        SEM_NAME_GLOBAL_MUTEX, SEM_NAME_ENCRYPT_QUEUE, SEM_NAME_DECRYPT_QUEUE,
+        SEM_NAME_ENCRYPT_SPACES, SEM_NAME_DECRYPT_ITEMS
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) sem_unlink(instance_sem(names[i]));
+    // Sin segmento adjunto no se sabe cuántos grupos hubo: los que no existan fallan sin efecto
+    for (int g = 0; g < MAX_GROUPS; g++) sem_unlink(instance_sem_n(SEM_NAME_GROUP_ITEMS, g));
+
+    int shm_id = shmget(instance_shm_key(), 0, 0);
+    if (shm_id != -1) shmctl(shm_id, IPC_RMID, NULL);
+}
+
+/**
+ * @brief Crea el segmento en el propio proceso
+ *
+ * Arma "inicializador ARCHIVO BUFFER CLAVE [extras]" para setup_pipeline,
+ * con la salida estándar en /dev/null como la tenía el inicializador
+ * cuando era un hijo aparte; los errores siguen en la salida de error.
+ *
+ * @return Segmento adjunto, NULL en error
+ */
+static SharedMemory* create_segment(const LaunchConfig* cfg) {
+    char** argv = calloc((size_t)cfg->init_extra_n + 5, sizeof(char*));
+    if (!argv) return NULL;
+    int argc = 0;
+    argv[argc++] = "inicializador";
+    argv[argc++] = (char*)cfg->input_path;
+    argv[argc++] = (char*)cfg->buffer;
+    argv[argc++] = (char*)cfg->key;
+    for (int i = 0; i < cfg->init_extra_n; i++) argv[argc++] = cfg->init_extra[i];
+
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull != -1) {
+        dup2(devnull, STDOUT_FILENO);
+        close(devnull);
+    }
+    DaemonOptions daemon;
+    SharedMemory* shm = setup_pipeline(argc, argv, &daemon);
+    fflush(stdout);
+    if (saved != -1) {
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+    free(argv);
+    return shm;
+}
+
+/* Abre una vez los semáforos de la instancia; los hijos los heredan */
+static int open_sems(const SharedMemory* shm, EmisorSems* sems) {
+    sems->global         = sem_open(instance_sem(SEM_NAME_GLOBAL_MUTEX), 0);
+    sems->encrypt_queue  = sem_open(instance_sem(SEM_NAME_ENCRYPT_QUEUE), 0);
+    sems->decrypt_queue  = sem_open(instance_sem(SEM_NAME_DECRYPT_QUEUE), 0);
+    sems->encrypt_spaces = sem_open(instance_sem(SEM_NAME_ENCRYPT_SPACES), 0);
+    sems->decrypt_items  = sem_open(instance_sem(SEM_NAME_DECRYPT_ITEMS), 0);
+    int ok = sems->global != SEM_FAILED && sems->encrypt_queue != SEM_FAILED &&
+             sems->decrypt_queue != SEM_FAILED && sems->encrypt_spaces != SEM_FAILED &&
+             sems->decrypt_items != SEM_FAILED;
+    for (int g = 0; g < shm->group_count; g++) {
+        sems->group_items[g] = sem_open(instance_sem_n(SEM_NAME_GROUP_ITEMS, g), 0);
+        if (sems->group_items[g] == SEM_FAILED) ok = 0;
+    }
+    if (!ok) fprintf(stderr, RED "[LANZADOR] No se pudieron abrir los semáforos: %s\n" RESET, strerror(errno));
+    return ok ? SUCCESS : ERROR;
+}
+
+static void close_sems(const SharedMemory* shm, const EmisorSems* sems) {
+    sem_t* const all[] = { sems->global, sems->encrypt_queue, sems->decrypt_queue,
+                           sems->encrypt_spaces, sems->decrypt_items };
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) if (all[i] != SEM_FAILED) sem_close(all[i]);
+    for (int g = 0; g < shm->group_count; g++) {
+        if (sems->group_items[g] != SEM_FAILED) sem_close(sems->group_items[g]);
+    }
+}
+
+/**
+ * @brief fork de un trabajador, sin exec
+ *
+ * El hijo ya tiene el segmento adjunto (con la base de tiempo) y los
+ * semáforos abiertos: restaura la máscara, aplica el pinning, lleva la
+ * entrada y la salida estándar a /dev/null y corre el bucle.
+ *
+ * @param receptor 1 = receptor_run (grupo index % grupos), 0 = emisor_run
+ * @param cpu CPU del pinning, -1 = sin pinning
+ * @param unblock Máscara a restaurar en el hijo (el padre bloquea sus señales)
+ * @return PID del hijo, -1 en error
+ */
+static pid_t spawn_worker(SharedMemory* shm, const EmisorSems* sems, const LaunchConfig* cfg,
+                          int receptor, int index, int cpu, const sigset_t* unblock) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    sigprocmask(SIG_SETMASK, unblock, NULL);
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            fprintf(stderr, YELLOW "[LANZADOR] Sin pinning en la CPU %d: %s\n" RESET, cpu, strerror(errno));
+        }
+    }
+    int devnull = open("/dev/null", O_RDWR);
+    if (devnull != -1) {
+        dup2(devnull, STDIN_FILENO);
+        dup2(devnull, STDOUT_FILENO);
+        if (devnull > STDERR_FILENO) close(devnull);
+    }
+    setenv("IPC_QUIET", "1", 1);
+
+    int rc;
+    if (receptor) {
+        int groups = shm->group_count;
+        int group = groups > 0 ? index % groups : 0;
+        ReceptorSems rs = { sems->global, sems->encrypt_queue, sems->decrypt_queue, sems->encrypt_spaces,
+                            groups > 0 ? sems->group_items[group] : sems->decrypt_items };
+        ReceptorOptions ro = { MODE_AUTO, 0, 0, cfg->delay_ms, group, NULL };
+        rc = (groups > 0 && group_join(shm, group) != SUCCESS) ? ERROR : receptor_run(shm, &rs, &ro);
+    } else {
+        EmisorOptions eo = { MODE_AUTO, 0, 0, cfg->delay_ms };
+        rc = emisor_run(shm, sems, &eo);
+    }
+    _exit(rc == SUCCESS ? 0 : 1);
+}
+
+/* Libera a los trabajadores bloqueados, como el finalizador (ver relay_shutdown) */
+static void release_workers(SharedMemory* shm, const EmisorSems* sems, const pid_t* pids, int n) {
+    __atomic_store_n(&shm->shutdown_flag, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < n; i++) if (pids[i] > 0) kill(pids[i], SIGUSR1);
+
+    sem_post(sems->encrypt_spaces);
+    sem_post(sems->decrypt_items);
+    for (int g = 0; g < shm->group_count; g++) sem_post(sems->group_items[g]);
+}
+
+/**
+ * @brief Recoge a los trabajadores
+ *
+ * Duerme en sigwaitinfo: SIGCHLD al terminar uno, SIGINT/SIGTERM para
+ * liberarlos (la segunda vez, SIGKILL).
+ *
+ * @return Instante (monotónico) en que terminó el último
+ */
+static uint64_t reap_workers(SharedMemory* shm, const EmisorSems* sems, pid_t* pids, int n,
+                             const sigset_t* waitset, int* failed) {
+    int remaining = n;
+    int stops = 0;
+    while (remaining > 0) {
+        int status;
+        pid_t p = waitpid(-1, &status, WNOHANG);
+        if (p > 0) {
+            for (int i = 0; i < n; i++) if (pids[i] == p) pids[i] = 0;
+            remaining--;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) (*failed)++;
+            continue;
+        }
+        if (p < 0 && errno != EINTR) break;
+
+        int sig = sigwaitinfo(waitset, NULL);
+        if (sig != SIGINT && sig != SIGTERM) continue;
+        if (stops++ == 0) {
+            fprintf(stderr, YELLOW "\n[LANZADOR] Finalizando %d trabajadores...\n" RESET, remaining);
+            release_workers(shm, sems, pids, n);
+        } else {
+            for (int i = 0; i < n; i++) if (pids[i] > 0) kill(pids[i], SIGKILL);
+        }
+    }
+    return mono_ns();
+}
+
+/* Registro, primer byte y caracteres escritos, leídos de los bloques WorkerStats */
+static void collect_times(const SharedMemory* shm, uint64_t run_to_mono, uint64_t launch_ns, LaunchReport* rep) {
+    const WorkerStats* roles[2] = { shm->emisor_stats, shm->receptor_stats };
+    int counts[2] = { shm->emisor_stats_count, shm->receptor_stats_count };
+    uint64_t last_start = 0, first_byte = 0;
+    for (int r = 0; r < 2; r++) {
+        int n = counts[r] > MAX_WORKERS ? MAX_WORKERS : counts[r];
+        for (int i = 0; i < n; i++) {
+            const WorkerStats* ws = &roles[r][i];
+            uint64_t start = __atomic_load_n(&ws->start_ns, __ATOMIC_RELAXED);
+            if (start > last_start) last_start = start;
+            if (r == 0) continue;
+            uint64_t first = __atomic_load_n(&ws->first_ns, __ATOMIC_RELAXED);
+            if (first && (!first_byte || first < first_byte)) first_byte = first;
+            rep->written += __atomic_load_n(&ws->chars, __ATOMIC_RELAXED);
+        }
+    }
+    rep->ready_ms = last_start ? ms_between(launch_ns, last_start + run_to_mono) : -1.0;
+    rep->ttfb_ms  = first_byte ? ms_between(launch_ns, first_byte + run_to_mono) : -1.0;
+}
+
+/**
+ * @brief Ejecuta una corrida completa
+ *
+ * @param cfg Parámetros
+ * @param rep Mediciones (se sobrescriben)
+ * @return SUCCESS si la corrida pudo ejecutarse (ver rep->failed)
+ */
+int launch_pipeline(const LaunchConfig* cfg, LaunchReport* rep) {
+    memset(rep, 0, sizeof(*rep));
+
+    // Señales del padre bloqueadas: se atienden sólo en sigwaitinfo
+    sigset_t waitset, old;
+    sigemptyset(&waitset);
+    sigaddset(&waitset, SIGCHLD);
+    sigaddset(&waitset, SIGINT);
+    sigaddset(&waitset, SIGTERM);
+    sigprocmask(SIG_BLOCK, &waitset, &old);
+
+    uint64_t launch_ns = mono_ns();
+    SharedMemory* shm = create_segment(cfg);
+    if (!shm) {
+        fprintf(stderr, RED "[LANZADOR] No se pudo crear el segmento\n" RESET);
+        sigprocmask(SIG_SETMASK, &old, NULL);
+        return ERROR;
+    }
+    rep->init_ms = ms_between(launch_ns, mono_ns());
+
+    timebase_attach(&shm->timebase);
+    // Desplazamiento entre la base del run y CLOCK_MONOTONIC (mono = run + desplazamiento)
+    uint64_t run_to_mono = mono_ns() - timebase_now_ns();
+
+    rep->chars  = shm->total_chars_in_file;
+    rep->groups = shm->group_count;
+    EmisorSems sems;
+    int sems_ok = open_sems(shm, &sems) == SUCCESS;
+    if (!sems_ok || rep->groups > cfg->receptores) {
+        if (sems_ok) {
+            fprintf(stderr, RED "[LANZADOR] --groups %d necesita al menos %d receptores\n" RESET,
+                    rep->groups, rep->groups);
+        }
+        close_sems(shm, &sems);
+        shmdt(shm);
+        launch_teardown();   // Ningún trabajador llegó a usar el segmento
+        sigprocmask(SIG_SETMASK, &old, NULL);
+        return ERROR;
+    }
+
+    pid_t pids[MAX_CHILDREN];
+    int n = 0;
+    fflush(stdout);   // Lo pendiente no debe repetirse en cada hijo
+    uint64_t fork0 = mono_ns();
+    // Receptores primero: ya esperan cuando se publica el primer carácter
+    for (int i = 0; i < cfg->receptores && n < MAX_CHILDREN; i++) {
+        pid_t p = spawn_worker(shm, &sems, cfg, 1, i, cfg->cpu_count ? cfg->cpus[n % cfg->cpu_count] : -1, &old);
+        if (p > 0) pids[n++] = p;
+    }
+    for (int i = 0; i < cfg->emisores && n < MAX_CHILDREN; i++) {
+        pid_t p = spawn_worker(shm, &sems, cfg, 0, i, cfg->cpu_count ? cfg->cpus[n % cfg->cpu_count] : -1, &old);
+        if (p > 0) pids[n++] = p;
+    }
+    rep->fork_ms = ms_between(fork0, mono_ns());
+    rep->spawned = n;
+
+    uint64_t end_ns = reap_workers(shm, &sems, pids, n, &waitset, &rep->failed);
+    rep->wall_ms = ms_between(launch_ns, end_ns);
+    sigprocmask(SIG_SETMASK, &old, NULL);
+
+    collect_times(shm, run_to_mono, launch_ns, rep);
+    close_sems(shm, &sems);
+    shmdt(shm);
+    return SUCCESS;
+}
+
+void launch_print_report(const LaunchConfig* cfg, const LaunchReport* rep) {
+    printf(BOLD CYAN "╔══════════════════════════════════════════════════════╗\n" RESET);
+    printf(BOLD CYAN "║                 RESUMEN DEL LANZADOR                 ║\n" RESET);
+    printf(BOLD CYAN "╚══════════════════════════════════════════════════════╝\n" RESET);
+    printf("  • Trabajadores:      %d emisores, %d receptores", cfg->emisores, cfg->receptores);
+    if (rep->groups > 0) printf(" en %d grupos", rep->groups);
+    if (cfg->cpu_count > 0) printf(" (pinning en %d CPUs)", cfg->cpu_count);
+    printf("\n");
+    printf("  • Inicializador:     %10.3f ms\n", rep->init_ms);
+    printf("  • Forks:             %10.3f ms (%d procesos)\n", rep->fork_ms, rep->spawned);
+    if (rep->ready_ms >= 0.0) printf("  • Último registrado: %10.3f ms\n", rep->ready_ms);
+    if (rep->ttfb_ms >= 0.0) printf("  • Primer byte:       %10.3f ms\n", rep->ttfb_ms);
+    else                     printf("  • Primer byte:       ningún receptor escribió\n");
+    double run_s = (rep->wall_ms - rep->init_ms) / 1e3;
+    printf("  • Total:             %10.3f ms (%.0f chars/s escritos, sin el inicializador)\n",
+           rep->wall_ms, run_s > 0.0 ? (double)rep->written / run_s : 0.0);
+
+    uint64_t expected = (uint64_t)rep->chars * (uint64_t)(rep->groups > 0 ? rep->groups : 1);
+    if (rep->written == expected) {
+        printf(GREEN "  ✓ Escritos %llu de %llu caracteres\n" RESET,
+               (unsigned long long)rep->written, (unsigned long long)expected);
+    } else {
+        printf(YELLOW "  • Escritos %llu de %llu caracteres\n" RESET,
+               (unsigned long long)rep->written, (unsigned long long)expected);
+    }
+    if (rep->failed > 0) printf(RED "  ✗ %d trabajadores terminaron con error\n" RESET, rep->failed);
+}
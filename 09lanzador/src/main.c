@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constants.h"
+#include "launcher.h"
+#include "instance.h"
+
+/**
+ * Lanzador del Pipeline
+ *
+ * Una corrida en un solo comando: crea el segmento con el código del
+ * inicializador, lanza R receptores y E emisores como hijos de fork
+ * (opcionalmente fijos a CPUs), los recoge e informa cuánto tardó cada
+ * fase, el primer byte escrito y el total. Pensado para medir y reducir
+ * el arranque de trabajos cortos.
+ *
+ * El segmento queda para el finalizador, salvo con --rm.
+ */
+
+static void print_usage(const char* argv0) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s [opciones] ARCHIVO BUFFER CLAVE [-- OPCIONES DEL INICIALIZADOR]\n", argv0);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  --emisores N      Emisores a lanzar (1..%d, por omisión %d)\n", MAX_WORKERS, DEFAULT_EMISORES);
+    fprintf(stderr, "  --receptores N    Receptores a lanzar (1..%d, por omisión %d)\n", MAX_WORKERS, DEFAULT_RECEPTORES);
+    fprintf(stderr, "  --delay MS        Retardo por carácter de los trabajadores (0..%d, por omisión 0)\n", MAX_DELAY_MS);
+    fprintf(stderr, "  --pin auto|LISTA  Fija el trabajador i a la CPU LISTA[i %% n] (auto = las permitidas)\n");
+    fprintf(stderr, "  --rm              Elimina el segmento y los semáforos al terminar\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  Después de '--' van opciones del inicializador (--lanes, --job, --jobs, --groups);\n");
+    fprintf(stderr, "  --daemon, --stream, --sink y --stages no se admiten.\n");
+    fprintf(stderr, "  --instance NOMBRE (o IPC_INSTANCE) elige la instancia.\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Ejemplo: %s --emisores 4 --receptores 4 --pin auto --rm in.txt 500 AA -- --lanes 4\n", argv0);
+}
+
+/**
+ * @brief Parsea un entero dentro de un rango
+ *
+ * @return 1 si es válido, 0 si no
+ */
+static int parse_int_range(const char* s, int lo, int hi, int* out) {
+    char* end = NULL;
+    long v = strtol(s, &end, 10);
+    if (!s[0] || *end != '\0' || v < lo || v > hi) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (instance_init(&argc, argv) != SUCCESS) return EXIT_FAILURE;
+
+    static LaunchConfig cfg;
+    cfg.emisores   = DEFAULT_EMISORES;
+    cfg.receptores = DEFAULT_RECEPTORES;
+    const char* positional[3];
+    int npos = 0;
+    int remove_ipc = 0;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        const char* opt = argv[i];
+        int has_val = i + 1 < argc;
+        if (strcmp(opt, "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(opt, "--emisores") == 0 && has_val) {
+            if (!parse_int_range(argv[++i], 1, MAX_WORKERS, &cfg.emisores)) {
+                fprintf(stderr, RED "[ERROR] Cantidad de emisores inválida: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(opt, "--receptores") == 0 && has_val) {
+            if (!parse_int_range(argv[++i], 1, MAX_WORKERS, &cfg.receptores)) {
+                fprintf(stderr, RED "[ERROR] Cantidad de receptores inválida: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(opt, "--delay") == 0 && has_val) {
+            if (!parse_int_range(argv[++i], 0, MAX_DELAY_MS, &cfg.delay_ms)) {
+                fprintf(stderr, RED "[ERROR] Retardo inválido: %s\n" RESET, argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(opt, "--pin") == 0 && has_val) {
+            if (launch_parse_cpus(argv[++i], &cfg) != SUCCESS) return EXIT_FAILURE;
+        } else if (strcmp(opt, "--rm") == 0) {
+            remove_ipc = 1;
+        } else if (opt[0] == '-' && opt[1] == '-') {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        } else if (npos < 3) {
+            positional[npos++] = opt;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (npos != 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    cfg.input_path   = positional[0];
+    cfg.buffer       = positional[1];
+    cfg.key          = positional[2];
+    cfg.init_extra   = argv + i;
+    cfg.init_extra_n = argc - i;
+    if (launch_check_init_args(cfg.init_extra, cfg.init_extra_n) != SUCCESS) return EXIT_FAILURE;
+
+    LaunchReport rep;
+    if (launch_pipeline(&cfg, &rep) != SUCCESS) return EXIT_FAILURE;
+    launch_print_report(&cfg, &rep);
+
+    if (remove_ipc) {
+        launch_teardown();
+        printf(GREEN "  ✓ Segmento y semáforos eliminados\n" RESET);
+    } else {
+        const char* name = instance_name();
+        printf("  • Finalizador: ../04finalizador/bin/finalizador%s%s\n",
+               name[0] ? " --instance " : "", name);
+    }
+
+    uint64_t expected = (uint64_t)rep.chars * (uint64_t)(rep.groups > 0 ? rep.groups : 1);
+    return rep.failed == 0 && rep.written == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+}